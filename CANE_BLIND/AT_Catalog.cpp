@@ -0,0 +1,91 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "AT_Catalog.h"
+#include "URC_Dispatcher.h"
+#include "GPS_Nmea.h"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Finds the response line starting with tag and decodes its fields */
+static uint8_t findResponseFields(const char* response, const char* tag,
+                                  UrcField* fields, uint8_t maxFields) {
+    const char* line = strstr(response, tag);
+    if (line == NULL) {
+        return 0U;
+    }
+    const char* lineEnd = strchr(line, '\n');
+    size_t length = (lineEnd != NULL) ? (size_t)(lineEnd - line) : strlen(line);
+    return UrcDispatcher::decodeFields(line, length, fields, maxFields);
+}
+
+/******************************************************************************
+ * RESPONSE PARSERS
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Parses "+CSQ: <rssi>,<ber>" into an int8_t RSSI (0..31, 99 = unknown).
+*
+* @param[in]    response    Intermediate response of AT+CSQ.
+* @param[out]   out         Pointer to an int8_t.
+*
+* @return       bool        True if the RSSI was found.
+*/
+/*================================================================================================*/
+bool atParseSignalQuality(const char* response, void* out) {
+    UrcField fields[2];
+    if (findResponseFields(response, "+CSQ:", fields, 2U) == 0U) {
+        return false;
+    }
+    int32_t rssi = UrcDispatcher::fieldToInt(fields[0], -1);
+    if (rssi < 0) {
+        return false;
+    }
+    *(int8_t*)out = (int8_t)rssi;
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Parses "+CMGS: <mr>" into an int16_t message reference.
+*
+* @param[in]    response    Intermediate response of AT+CMGS.
+* @param[out]   out         Pointer to an int16_t.
+*
+* @return       bool        True if the message reference was found.
+*/
+/*================================================================================================*/
+bool atParseMessageReference(const char* response, void* out) {
+    UrcField fields[1];
+    if (findResponseFields(response, "+CMGS:", fields, 1U) == 0U) {
+        return false;
+    }
+    int32_t reference = UrcDispatcher::fieldToInt(fields[0], -1);
+    if (reference < 0) {
+        return false;
+    }
+    *(int16_t*)out = (int16_t)reference;
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Parses "+CGPSINFO: <lat>,<N/S>,<lon>,<E/W>,<date>,<utc>,<alt>,..." into a GnssFix.
+* @details      Runs the response through a GnssParser of its own, so the result does not depend
+*               on, and does not change, the state of gnssParser.
+*
+* @param[in]    response    Intermediate response of AT+CGPSINFO.
+* @param[out]   out         Pointer to a GnssFix.
+*
+* @return       bool        True if the module reported a fix (the fields are empty without).
+*/
+/*================================================================================================*/
+bool atParseGnssInfo(const char* response, void* out) {
+    GnssParser parser;
+    if (parser.feedLine(response, strlen(response)) == 0U || !parser.fix().valid) {
+        return false;
+    }
+    *(GnssFix*)out = parser.fix();
+    return true;
+}
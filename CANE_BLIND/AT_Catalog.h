@@ -0,0 +1,175 @@
+#ifndef AT_CATALOG_H
+#define AT_CATALOG_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Maximum length of a complete AT command line (without the trailing CR) */
+#define AT_COMMAND_MAX_LEN        64U
+
+/* Final result codes that may complete a command (bit mask) */
+#define AT_TERM_OK                0x01U   /* "OK" */
+#define AT_TERM_ERROR             0x02U   /* "ERROR", "+CME ERROR: <n>", "+CMS ERROR: <n>" */
+#define AT_TERM_PROMPT            0x04U   /* "> " data prompt */
+#define AT_TERM_DEFAULT           (AT_TERM_OK | AT_TERM_ERROR)
+#define AT_TERM_ALL               (AT_TERM_OK | AT_TERM_ERROR | AT_TERM_PROMPT)
+
+/* Deadlines (in milliseconds) shared by the catalog entries */
+#define AT_TIMEOUT_PROBE_MS       300U    /* Plain "AT" while the module may still be booting */
+#define AT_TIMEOUT_CONFIG_MS      800U    /* Configuration and query commands */
+#define AT_TIMEOUT_CALL_MS        5000U   /* ATD until the module accepts the call */
+#define AT_TIMEOUT_SMS_PROMPT_MS  2000U   /* AT+CMGS until the "> " prompt (or ESC confirmed) */
+#define AT_TIMEOUT_SMS_SEND_MS    60000U  /* AT+CMGS body until the network accepts the message */
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Command classes used to group latency statistics */
+typedef enum {
+    AT_CLASS_BASIC = 0,     /* AT, ATE0 */
+    AT_CLASS_CONFIG,        /* Settings and their queries */
+    AT_CLASS_STATUS,        /* Network/signal status queries */
+    AT_CLASS_CALL,          /* ATD, ATH */
+    AT_CLASS_SMS,           /* AT+CMGS */
+    AT_CLASS_GNSS,          /* GNSS power and position queries */
+    AT_CLASS_RAW,           /* Free-form commands (e.g. from the console) */
+    AT_CLASS_COUNT
+} AtCommandClass;
+
+/* Decodes the intermediate response of a command into a caller supplied object */
+typedef bool (*AtResponseParser)(const char* response, void* out);
+
+/* Compile-time description of one AT command */
+typedef struct {
+    const char*      prefix;        /* Command text, or the part before the argument */
+    const char*      suffix;        /* Text after the argument, NULL for fixed commands */
+    uint8_t          terminators;   /* AT_TERM_* codes that complete the command */
+    uint32_t         timeoutMs;     /* Deadline from transmission to the final result code */
+    AtResponseParser parser;        /* Optional response parser, NULL if none */
+    AtCommandClass   commandClass;  /* Statistics group */
+} AtCommandDesc;
+
+/******************************************************************************
+ * RESPONSE PARSERS
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Parses "+CSQ: <rssi>,<ber>" into an int8_t RSSI (0..31, 99 = unknown).
+*
+* @param[in]    response    Intermediate response of AT+CSQ.
+* @param[out]   out         Pointer to an int8_t.
+*
+* @return       bool        True if the RSSI was found.
+*/
+/*================================================================================================*/
+bool atParseSignalQuality(const char* response, void* out);
+
+/*================================================================================================*/
+/**
+* @brief        Parses "+CMGS: <mr>" into an int16_t message reference.
+*
+* @param[in]    response    Intermediate response of AT+CMGS.
+* @param[out]   out         Pointer to an int16_t.
+*
+* @return       bool        True if the message reference was found.
+*/
+/*================================================================================================*/
+bool atParseMessageReference(const char* response, void* out);
+
+/*================================================================================================*/
+/**
+* @brief        Parses "+CGPSINFO: <lat>,<N/S>,<lon>,<E/W>,<date>,<utc>,<alt>,..." into a GnssFix.
+*
+* @param[in]    response    Intermediate response of AT+CGPSINFO.
+* @param[out]   out         Pointer to a GnssFix.
+*
+* @return       bool        True if the module reported a fix (the fields are empty without).
+*/
+/*================================================================================================*/
+bool atParseGnssInfo(const char* response, void* out);
+
+/******************************************************************************
+ * COMPILE-TIME VALIDATION
+ ******************************************************************************/
+/* Length of a string literal */
+constexpr size_t atTextLength(const char* text) {
+    return (*text == '\0') ? 0U : 1U + atTextLength(text + 1);
+}
+
+/* True if the text contains no CR, LF or Ctrl+Z (the engine adds the terminator) */
+constexpr bool atTextIsClean(const char* text) {
+    return (*text == '\0') ? true
+         : ((*text != '\r') && (*text != '\n') && (*text != '\x1A') && atTextIsClean(text + 1));
+}
+
+/* True if a descriptor can be issued as-is by AtEngine (no deadline beyond the longest one,
+   which the engine clamps every command to) */
+constexpr bool atDescriptorIsValid(const AtCommandDesc& desc) {
+    return (desc.prefix != nullptr) && (desc.prefix[0] == 'A') && (desc.prefix[1] == 'T') &&
+           atTextIsClean(desc.prefix) &&
+           ((desc.suffix == nullptr) || atTextIsClean(desc.suffix)) &&
+           (atTextLength(desc.prefix) + ((desc.suffix == nullptr) ? 0U : atTextLength(desc.suffix)) < AT_COMMAND_MAX_LEN) &&
+           ((desc.terminators & AT_TERM_ALL) != 0U) &&
+           (desc.timeoutMs > 0U) && (desc.timeoutMs <= AT_TIMEOUT_SMS_SEND_MS) &&
+           (desc.commandClass < AT_CLASS_COUNT);
+}
+
+/* Declares a catalog entry and checks it at compile time */
+#define AT_CATALOG_ENTRY(name, prefix, suffix, terminators, timeoutMs, parser, commandClass)         \
+    constexpr AtCommandDesc name = { prefix, suffix, terminators, timeoutMs, parser, commandClass }; \
+    static_assert(atDescriptorIsValid(name), #name " is not a valid AT command descriptor")
+
+/******************************************************************************
+ * CATALOG
+ ******************************************************************************/
+/* Basic commands */
+AT_CATALOG_ENTRY(AT_CMD_ATTENTION,         "AT",                 nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_PROBE_MS,  nullptr, AT_CLASS_BASIC);
+AT_CATALOG_ENTRY(AT_CMD_ECHO_OFF,          "ATE0",               nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_BASIC);
+
+/* Serial link: AT+IPR argument is the baud rate */
+AT_CATALOG_ENTRY(AT_CMD_SET_BAUD_RATE,     "AT+IPR=",            "",      AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_FLOW_CONTROL_ON,   "AT+IFC=2,2",         nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_FLOW_CONTROL_OFF,  "AT+IFC=0,0",         nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+
+/* SMS configuration */
+AT_CATALOG_ENTRY(AT_CMD_CHARSET_GSM,       "AT+CSCS=\"GSM\"",    nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_CHARSET_QUERY,     "AT+CSCS?",           nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_SMS_TEXT_MODE,     "AT+CMGF=1",          nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_SMS_PDU_MODE,      "AT+CMGF=0",          nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_SMS_MODE_QUERY,    "AT+CMGF?",           nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_SMS_INDICATION,    "AT+CNMI=2,2,0,0,0",  nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_SMS_INDICATION_QUERY, "AT+CNMI?",        nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+
+/* Call configuration */
+AT_CATALOG_ENTRY(AT_CMD_CLIP_ON,           "AT+CLIP=1",          nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_CLIP_QUERY,        "AT+CLIP?",           nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_CALL_REPORT_ON,    "AT+CLCC=1",          nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_CALL_REPORT_QUERY, "AT+CLCC?",           nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+
+/* Signal quality */
+AT_CATALOG_ENTRY(AT_CMD_SIGNAL_QUALITY,    "AT+CSQ",             nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, atParseSignalQuality, AT_CLASS_STATUS);
+AT_CATALOG_ENTRY(AT_CMD_AUTO_CSQ_ON,       "AT+AUTOCSQ=1,1",     nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+AT_CATALOG_ENTRY(AT_CMD_AUTO_CSQ_QUERY,    "AT+AUTOCSQ?",        nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CONFIG);
+
+/* GNSS receiver power and position */
+AT_CATALOG_ENTRY(AT_CMD_GNSS_POWER_ON,     "AT+CGPS=1",          nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_GNSS);
+AT_CATALOG_ENTRY(AT_CMD_GNSS_POWER_QUERY,  "AT+CGPS?",           nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_GNSS);
+AT_CATALOG_ENTRY(AT_CMD_GNSS_INFO,         "AT+CGPSINFO",        nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, atParseGnssInfo, AT_CLASS_GNSS);
+
+/* Voice call: argument is the phone number */
+AT_CATALOG_ENTRY(AT_CMD_DIAL,              "ATD",                ";",     AT_TERM_DEFAULT, AT_TIMEOUT_CALL_MS,   nullptr, AT_CLASS_CALL);
+AT_CATALOG_ENTRY(AT_CMD_HANG_UP,           "ATH",                nullptr, AT_TERM_DEFAULT, AT_TIMEOUT_CONFIG_MS, nullptr, AT_CLASS_CALL);
+
+/* SMS submission: argument is the phone number, the message body is the submit payload.
+   The body is written on the "> " prompt; the command completes on "+CMGS: <mr>" + OK. */
+AT_CATALOG_ENTRY(AT_CMD_SMS_SEND,          "AT+CMGS=\"",         "\"",    AT_TERM_DEFAULT, AT_TIMEOUT_SMS_SEND_MS, atParseMessageReference, AT_CLASS_SMS);
+
+/* PDU-mode submission: argument is the TPDU length in octets, the payload the PDU as hex */
+AT_CATALOG_ENTRY(AT_CMD_SMS_SEND_PDU,      "AT+CMGS=",           "",      AT_TERM_DEFAULT, AT_TIMEOUT_SMS_SEND_MS, atParseMessageReference, AT_CLASS_SMS);
+
+#endif /* AT_CATALOG_H */
@@ -0,0 +1,651 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "AT_Engine.h"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Returns true if the line is exactly the given literal */
+static bool lineEquals(const char* line, size_t length, const char* literal) {
+    size_t literalLength = strlen(literal);
+    return (length == literalLength) && (memcmp(line, literal, literalLength) == 0);
+}
+
+/* Returns true if the line starts with the given literal */
+static bool lineStartsWith(const char* line, size_t length, const char* literal) {
+    size_t literalLength = strlen(literal);
+    return (length >= literalLength) && (memcmp(line, literal, literalLength) == 0);
+}
+
+/* Parses the decimal error code following "+CME ERROR:" / "+CMS ERROR:" */
+static int16_t parseErrorCode(const char* line, size_t length) {
+    int16_t code = 0;
+    bool found = false;
+    for (size_t i = 11; i < length; i++) {
+        if (line[i] >= '0' && line[i] <= '9') {
+            code = (int16_t)(code * 10 + (line[i] - '0'));
+            found = true;
+        } else if (found) {
+            break;
+        }
+    }
+    return found ? code : -1;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the AtEngine class.
+* @details      Only stores the port reference, so the engine may be constructed before the
+*               serial port has been started.
+*
+* @param[in]    port      Serial stream connected to the GSM/GNSS module.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+AtEngine::AtEngine(Stream& port)
+    : port(port), activeIndex(-1), nextSequence(0U), lineSource(NULL), sentCount(0U),
+      forceUnsolicited(false), detachedPending(false), detachedAckSeen(false), detachedAtMs(0U),
+      unsolicitedHandler(NULL), unsolicitedContext(NULL) {
+    memset(slots, 0, sizeof(slots));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Queues an AT command for transmission.
+* @details      Copies the command into a free slot and starts it immediately if the modem is
+*               idle. Otherwise the command is sent as soon as all earlier commands complete.
+*               Any final result code (including the prompt) completes a free-form command.
+*
+* @param[in]    command     AT command text without line terminator.
+* @param[in]    timeoutMs   Maximum time to wait for the final result code, at most
+*                           AT_ENGINE_MAX_TIMEOUT_MS.
+*
+* @return       AtHandle    Handle of the queued command, or AT_INVALID_HANDLE.
+*/
+/*================================================================================================*/
+AtHandle AtEngine::submit(const char* command, uint32_t timeoutMs) {
+    return enqueue("", command, "", AT_TERM_ALL, timeoutMs, NULL, AT_CLASS_RAW, NULL, false);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Queues a catalog command.
+* @details      The descriptor text stays in flash and is written to the modem directly; only
+*               the optional argument (e.g. a phone number) is copied into the slot. With a
+*               payload the prompt must arrive within AT_TIMEOUT_SMS_PROMPT_MS; the descriptor
+*               deadline then runs from the end of the payload.
+*
+* @param[in]    command     Catalog descriptor.
+* @param[in]    argument    Text placed between prefix and suffix, or NULL.
+* @param[in]    payload     Data sent followed by Ctrl+Z on the "> " prompt, or NULL. Not copied.
+*
+* @return       AtHandle    Handle of the queued command, or AT_INVALID_HANDLE.
+*/
+/*================================================================================================*/
+AtHandle AtEngine::submit(const AtCommandDesc& command, const char* argument, const char* payload) {
+    return enqueue(command.prefix, (argument != NULL) ? argument : "",
+                   (command.suffix != NULL) ? command.suffix : "",
+                   command.terminators, command.timeoutMs, command.parser, command.commandClass,
+                   payload, false);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Queues a catalog command ahead of every normal command.
+* @details      Takes the reserved slot if the others are in use. An AT+CMGS on the wire is
+*               cancelled or detached by preemptActive(); any other command on the wire
+*               finishes first, so the new command is written within AT_ENGINE_URGENT_WAIT_MS.
+*
+* @param[in]    command     Catalog descriptor.
+* @param[in]    argument    Text placed between prefix and suffix, or NULL.
+* @param[in]    payload     Data sent followed by Ctrl+Z on the "> " prompt, or NULL. Not copied.
+*
+* @return       AtHandle    Handle of the queued command, or AT_INVALID_HANDLE.
+*/
+/*================================================================================================*/
+AtHandle AtEngine::submitUrgent(const AtCommandDesc& command, const char* argument,
+                                const char* payload) {
+    AtHandle handle = enqueue(command.prefix, (argument != NULL) ? argument : "",
+                              (command.suffix != NULL) ? command.suffix : "",
+                              command.terminators, command.timeoutMs, command.parser,
+                              command.commandClass, payload, true);
+    if (handle != AT_INVALID_HANDLE && activeIndex >= 0 && !slots[activeIndex].urgent) {
+        preemptActive();
+    }
+    return handle;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Drives the engine: reads modem bytes, completes commands and checks deadlines.
+* @details      Takes the lines framed by the attached line source, or pumps modem bytes
+*               through the engine's own framer when there is none, and classifies them.
+*               Afterwards the deadline of the active command is checked.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void AtEngine::poll() {
+    LineView line;
+
+    if (lineSource != NULL) {
+        while (lineSource->nextLine(line)) {
+            processLine(line);
+        }
+    } else {
+        framer.pump(port);
+        while (framer.nextLine(line)) {
+            processLine(line);
+        }
+    }
+
+    /* Check the deadline of the command on the wire */
+    if (activeIndex >= 0) {
+        Slot& slot = slots[activeIndex];
+        if ((uint32_t)(millis() - slot.waitFromMs) >= slot.timeoutMs) {
+            complete(slot, AT_RESULT_TIMEOUT, -1);
+        }
+    }
+
+    /* A detached submission the modem never answered owes nothing any more */
+    if (detachedPending && (uint32_t)(millis() - detachedAtMs) >= AT_TIMEOUT_SMS_SEND_MS) {
+        detachedPending = false;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Blocks (polling the engine) until the given command has completed.
+* @details      Sleeps between polls so lower priority tasks still get CPU time. With a line
+*               source attached the sleep ends as soon as the next line arrives.
+*
+* @param[in]    handle      Handle returned by submit().
+*
+* @return       AtResult    Final result of the command.
+*/
+/*================================================================================================*/
+AtResult AtEngine::waitFor(AtHandle handle) {
+    AtResult current = result(handle);
+    while (current == AT_RESULT_PENDING) {
+        poll();
+        current = result(handle);
+        if (current == AT_RESULT_PENDING) {
+            idle(AT_ENGINE_WAIT_SLICE_MS);
+        }
+    }
+    return current;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the current result of a command (AT_RESULT_PENDING while running).
+*/
+/*================================================================================================*/
+AtResult AtEngine::result(AtHandle handle) const {
+    const Slot* slot = slotFor(handle);
+    return (slot != NULL) ? slot->result : AT_RESULT_INVALID;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the intermediate response lines of a command, separated by '\n'.
+*/
+/*================================================================================================*/
+const char* AtEngine::response(AtHandle handle) const {
+    const Slot* slot = slotFor(handle);
+    return (slot != NULL) ? slot->response : "";
+}
+
+/*================================================================================================*/
+/**
+* @brief        Runs the catalog parser of a completed command on its response.
+*
+* @param[in]    handle      Handle of a command submitted from the catalog.
+* @param[out]   out         Object filled by the descriptor's parser.
+*
+* @return       bool        True if the command has a parser and it succeeded.
+*/
+/*================================================================================================*/
+bool AtEngine::parse(AtHandle handle, void* out) const {
+    const Slot* slot = slotFor(handle);
+    if (slot == NULL || slot->parser == NULL || slot->state != SLOT_DONE) {
+        return false;
+    }
+    return slot->parser(slot->response, out);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the numeric code of a +CME/+CMS error, or -1 if none.
+*/
+/*================================================================================================*/
+int16_t AtEngine::errorCode(AtHandle handle) const {
+    const Slot* slot = slotFor(handle);
+    return (slot != NULL) ? slot->errorCode : -1;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the time between sending a command and its completion (ms).
+*/
+/*================================================================================================*/
+uint32_t AtEngine::latencyMs(AtHandle handle) const {
+    const Slot* slot = slotFor(handle);
+    if (slot == NULL || slot->state != SLOT_DONE) {
+        return 0U;
+    }
+    return slot->doneAtMs - slot->sentAtMs;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Releases a command slot. Pending commands are cancelled.
+* @details      Releasing the command on the wire does not abort it in the modem; its result
+*               code is simply dropped and the next queued command is started.
+*/
+/*================================================================================================*/
+void AtEngine::release(AtHandle handle) {
+    Slot* slot = slotFor(handle);
+    if (slot == NULL) {
+        return;
+    }
+    bool wasActive = (slot->state == SLOT_ACTIVE);
+    slot->state = SLOT_FREE;
+    if (wasActive) {
+        activeIndex = -1;
+        startNext();
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns true when no command is queued or in flight.
+*/
+/*================================================================================================*/
+bool AtEngine::isIdle() const {
+    for (uint8_t i = 0; i < AT_ENGINE_QUEUE_DEPTH; i++) {
+        if (slots[i].state == SLOT_QUEUED || slots[i].state == SLOT_ACTIVE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Registers the handler for lines that do not belong to the active command.
+*/
+/*================================================================================================*/
+void AtEngine::setUnsolicitedHandler(AtUnsolicitedHandler handler, void* context) {
+    unsolicitedHandler = handler;
+    unsolicitedContext = context;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Discards partially received input (e.g. garbage after a baud rate change).
+* @details      Drops bytes waiting in the UART driver, the ring buffer and the partial line, or
+*               asks the attached line source to do so.
+*/
+/*================================================================================================*/
+void AtEngine::resetInput() {
+    if (lineSource != NULL) {
+        lineSource->reset();
+    } else {
+        while (port.available() > 0) {
+            port.read();
+        }
+        framer.reset();
+    }
+    forceUnsolicited = false;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the total number of bytes received from the modem.
+*/
+/*================================================================================================*/
+uint32_t AtEngine::bytesReceived() const {
+    return (lineSource != NULL) ? lineSource->bytesReceived() : framer.bytesReceived();
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sleeps until a modem line arrives or maxMs expires.
+* @details      Without a line source there is nothing to wake on, so it sleeps one tick.
+*
+* @param[in]    maxMs       Maximum sleep time.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void AtEngine::idle(uint32_t maxMs) {
+    if (lineSource != NULL) {
+        lineSource->waitForLine(maxMs);
+    } else {
+        delay(1);
+    }
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Claims a free slot for a command made of prefix + argument + suffix */
+AtHandle AtEngine::enqueue(const char* prefix, const char* argument, const char* suffix,
+                           uint8_t terminators, uint32_t timeoutMs, AtResponseParser parser,
+                           AtCommandClass commandClass, const char* payload, bool urgent) {
+    size_t argumentLength = strlen(argument);
+    if (strlen(prefix) + argumentLength + strlen(suffix) > AT_COMMAND_MAX_LEN) {
+        return AT_INVALID_HANDLE;
+    }
+
+    /* Normal commands leave the reserved slots to submitUrgent() */
+    if (!urgent) {
+        uint8_t freeCount = 0U;
+        for (uint8_t i = 0; i < AT_ENGINE_QUEUE_DEPTH; i++) {
+            if (slots[i].state == SLOT_FREE) {
+                freeCount++;
+            }
+        }
+        if (freeCount <= AT_ENGINE_URGENT_RESERVE) {
+            return AT_INVALID_HANDLE;
+        }
+    }
+
+    for (uint8_t i = 0; i < AT_ENGINE_QUEUE_DEPTH; i++) {
+        Slot& slot = slots[i];
+        if (slot.state != SLOT_FREE) {
+            continue;
+        }
+
+        /* Claim the slot; the generation makes stale handles detectable */
+        slot.generation++;
+        slot.state = SLOT_QUEUED;
+        slot.result = AT_RESULT_PENDING;
+        slot.errorCode = -1;
+        slot.timeoutMs = (timeoutMs < AT_ENGINE_MAX_TIMEOUT_MS) ? timeoutMs
+                                                                : AT_ENGINE_MAX_TIMEOUT_MS;
+        /* With a payload the prompt has its own deadline; the command's starts with the body */
+        slot.ackTimeoutMs = slot.timeoutMs;
+        if (payload != NULL && slot.timeoutMs > AT_TIMEOUT_SMS_PROMPT_MS) {
+            slot.timeoutMs = AT_TIMEOUT_SMS_PROMPT_MS;
+        }
+        slot.sentAtMs = 0U;
+        slot.waitFromMs = 0U;
+        slot.doneAtMs = 0U;
+        slot.sequence = nextSequence++;
+        slot.responseLength = 0U;
+        slot.response[0] = '\0';
+        slot.terminators = terminators;
+        slot.urgent = urgent;
+        slot.aborting = false;
+        slot.payloadSent = false;
+        slot.prefix = prefix;
+        slot.suffix = suffix;
+        slot.parser = parser;
+        slot.commandClass = commandClass;
+        slot.payload = payload;
+        memcpy(slot.argument, argument, argumentLength + 1U);
+
+        if (activeIndex < 0) {
+            startNext();
+        }
+        return (AtHandle)(((uint16_t)slot.generation << 8) | i);
+    }
+
+    /* Queue is full */
+    return AT_INVALID_HANDLE;
+}
+
+/* Cancels an AT+CMGS on the wire whose body was not sent yet, so the urgent command behind it
+   is written as soon as the modem confirms, or detaches one waiting for the network */
+void AtEngine::preemptActive() {
+    Slot& slot = slots[activeIndex];
+
+    /* Still waiting for the "> " prompt: ESC cancels the message in the modem, which confirms
+       with a result code; the body is never sent. The prompt deadline is left alone: ending the
+       command before that result code arrives would let it complete the urgent command. */
+    if (slot.payload != NULL && !slot.aborting) {
+        sentCount += port.write('\x1B');
+        slot.payload = NULL;
+        slot.aborting = true;
+        return;
+    }
+
+    /* Handed to the network: stop tracking it and write the urgent command now. Its result
+       ("+CMGS: <mr>" + OK, or +CMS ERROR) is recognised and dropped by dropDetachedLine(). */
+    if (slot.payloadSent && !detachedPending) {
+        detachedPending = true;
+        detachedAckSeen = false;
+        detachedAtMs = millis();
+        slot.aborting = true;
+        complete(slot, AT_RESULT_ABORTED, -1);
+    }
+
+    /* Anything else finishes normally */
+}
+
+/* Drops the result lines of a detached AT+CMGS; returns true if the line was one of them */
+bool AtEngine::dropDetachedLine(const char* line, size_t length) {
+    if (lineStartsWith(line, length, "+CMGS:")) {
+        detachedAckSeen = true;
+        return true;
+    }
+    if (lineStartsWith(line, length, "+CMS ERROR:") ||
+        (detachedAckSeen && lineEquals(line, length, "OK"))) {
+        detachedPending = false;
+        return true;
+    }
+    return false;
+}
+
+/* Resolves a handle to its slot, rejecting stale handles */
+AtEngine::Slot* AtEngine::slotFor(AtHandle handle) {
+    return const_cast<Slot*>(static_cast<const AtEngine*>(this)->slotFor(handle));
+}
+
+const AtEngine::Slot* AtEngine::slotFor(AtHandle handle) const {
+    uint8_t index = (uint8_t)(handle & 0xFFU);
+    uint8_t generation = (uint8_t)(handle >> 8);
+    if (handle == AT_INVALID_HANDLE || index >= AT_ENGINE_QUEUE_DEPTH) {
+        return NULL;
+    }
+    const Slot& slot = slots[index];
+    if (slot.state == SLOT_FREE || slot.generation != generation) {
+        return NULL;
+    }
+    return &slot;
+}
+
+/* Writes the oldest queued urgent command, or else the oldest queued command, to the modem */
+void AtEngine::startNext() {
+    int8_t oldest = -1;
+    for (uint8_t i = 0; i < AT_ENGINE_QUEUE_DEPTH; i++) {
+        if (slots[i].state != SLOT_QUEUED) {
+            continue;
+        }
+        if (oldest < 0 || (slots[i].urgent && !slots[oldest].urgent) ||
+            (slots[i].urgent == slots[oldest].urgent &&
+             (int32_t)(slots[i].sequence - slots[oldest].sequence) < 0)) {
+            oldest = (int8_t)i;
+        }
+    }
+    if (oldest < 0) {
+        return;
+    }
+
+    Slot& slot = slots[oldest];
+    slot.state = SLOT_ACTIVE;
+    slot.sentAtMs = millis();
+    slot.waitFromMs = slot.sentAtMs;
+    activeIndex = oldest;
+
+    /* Write the command straight from flash and the slot, without building a string */
+    sentCount += port.write(slot.prefix, strlen(slot.prefix));
+    sentCount += port.write(slot.argument, strlen(slot.argument));
+    sentCount += port.write(slot.suffix, strlen(slot.suffix));
+    sentCount += port.write('\r');
+}
+
+/* Records the final result of a command and starts the next one */
+void AtEngine::complete(Slot& slot, AtResult result, int16_t errorCode) {
+    /* Whatever ends a cancelled command (OK, ERROR or its deadline), it was aborted */
+    if (slot.aborting) {
+        result = AT_RESULT_ABORTED;
+        errorCode = -1;
+    }
+    slot.state = SLOT_DONE;
+    slot.result = result;
+    slot.errorCode = errorCode;
+    slot.doneAtMs = millis();
+    activeIndex = -1;
+
+    AtOutcome outcome = AT_OUTCOME_OK;
+    if (result == AT_RESULT_ERROR) {
+        outcome = AT_OUTCOME_ERROR;
+    } else if (result == AT_RESULT_CME_ERROR) {
+        outcome = AT_OUTCOME_CME_ERROR;
+    } else if (result == AT_RESULT_CMS_ERROR) {
+        outcome = AT_OUTCOME_CMS_ERROR;
+    } else if (result == AT_RESULT_TIMEOUT) {
+        outcome = AT_OUTCOME_TIMEOUT;
+    }
+    if (result != AT_RESULT_ABORTED) {
+        latency.record(slot.commandClass, outcome, slot.doneAtMs - slot.sentAtMs, errorCode);
+    }
+
+    startNext();
+}
+
+/* Sends the payload of the active command and keeps waiting for its final result code */
+void AtEngine::writePayload(Slot& slot) {
+    sentCount += port.write(slot.payload, strlen(slot.payload));
+    sentCount += port.write('\x1A');
+    slot.payload = NULL;
+    slot.payloadSent = true;
+    slot.waitFromMs = millis();
+    slot.timeoutMs = slot.ackTimeoutMs;
+}
+
+/* Answers or completes the active command on the "> " prompt, otherwise classifies the line */
+void AtEngine::processLine(const LineView& line) {
+    if (line.isPrompt && activeIndex >= 0 && !forceUnsolicited) {
+        Slot& slot = slots[activeIndex];
+        if (slot.payload != NULL) {
+            writePayload(slot);
+            return;
+        }
+        if (slot.aborting) {
+            /* The modem took the ESC before the command and now waits for the body: cancel again */
+            sentCount += port.write('\x1B');
+            return;
+        }
+        if ((slot.terminators & AT_TERM_PROMPT) != 0U) {
+            complete(slot, AT_RESULT_PROMPT, -1);
+            return;
+        }
+    }
+    handleLine(line.data, line.length);
+}
+
+/* Classifies one received line */
+void AtEngine::handleLine(const char* line, size_t length) {
+    if (forceUnsolicited) {
+        forceUnsolicited = false;
+    } else if (detachedPending && dropDetachedLine(line, length)) {
+        return;
+    } else if (activeIndex >= 0) {
+        Slot& slot = slots[activeIndex];
+
+        /* Final result codes */
+        if ((slot.terminators & AT_TERM_OK) != 0U && lineEquals(line, length, "OK")) {
+            complete(slot, AT_RESULT_OK, -1);
+            return;
+        }
+        if ((slot.terminators & AT_TERM_ERROR) != 0U) {
+            if (lineEquals(line, length, "ERROR")) {
+                complete(slot, AT_RESULT_ERROR, -1);
+                return;
+            }
+            if (lineStartsWith(line, length, "+CME ERROR:")) {
+                complete(slot, AT_RESULT_CME_ERROR, parseErrorCode(line, length));
+                return;
+            }
+            if (lineStartsWith(line, length, "+CMS ERROR:")) {
+                complete(slot, AT_RESULT_CMS_ERROR, parseErrorCode(line, length));
+                return;
+            }
+        }
+
+        /* Command echo (before ATE0 takes effect) */
+        if (isEcho(slot, line, length)) {
+            return;
+        }
+
+        /* Intermediate response: keep it with the command */
+        if (belongsToActive(slot, line, length)) {
+            size_t room = AT_RESPONSE_MAX_LEN - slot.responseLength;
+            if (slot.responseLength > 0U && room > 0U) {
+                slot.response[slot.responseLength++] = '\n';
+                room--;
+            }
+            size_t copyLength = (length < room) ? length : room;
+            memcpy(&slot.response[slot.responseLength], line, copyLength);
+            slot.responseLength = (uint16_t)(slot.responseLength + copyLength);
+            slot.response[slot.responseLength] = '\0';
+            return;
+        }
+    }
+
+    /* Everything else is unsolicited */
+    if (unsolicitedHandler != NULL) {
+        unsolicitedHandler(line, length, unsolicitedContext);
+    }
+}
+
+/* Returns true if the line is the modem echoing the active command */
+bool AtEngine::isEcho(const Slot& slot, const char* line, size_t length) const {
+    size_t prefixLength = strlen(slot.prefix);
+    size_t argumentLength = strlen(slot.argument);
+    size_t suffixLength = strlen(slot.suffix);
+    return (length == prefixLength + argumentLength + suffixLength) &&
+           (memcmp(line, slot.prefix, prefixLength) == 0) &&
+           (memcmp(line + prefixLength, slot.argument, argumentLength) == 0) &&
+           (memcmp(line + prefixLength + argumentLength, slot.suffix, suffixLength) == 0);
+}
+
+/* Decides whether a non-final line is part of the active command's response */
+bool AtEngine::belongsToActive(const Slot& slot, const char* line, size_t length) const {
+    if (line[0] == '+') {
+        /* "+XXX: ..." belongs to "AT+XXX..."; free-form commands keep their text in argument */
+        const char* command = (slot.prefix[0] != '\0') ? slot.prefix : slot.argument;
+        if (strlen(command) < 3U) {
+            return false;
+        }
+        const char* name = &command[2];
+        size_t nameLength = strcspn(name, "=?");
+        return (nameLength > 1U) && (length > nameLength) &&
+               (memcmp(line, name, nameLength) == 0) && (line[nameLength] == ':');
+    }
+
+    /* NMEA sentences (AT+CGPSINFOCFG) stream in regardless of the command on the wire */
+    if (line[0] == '$') {
+        return false;
+    }
+
+    /* Plain-text unsolicited codes the modem may emit at any time */
+    if (lineEquals(line, length, "RING") || lineEquals(line, length, "NO CARRIER") ||
+        lineEquals(line, length, "BUSY") || lineEquals(line, length, "NO ANSWER") ||
+        lineEquals(line, length, "RDY") || lineEquals(line, length, "SMS DONE") ||
+        lineEquals(line, length, "PB DONE")) {
+        return false;
+    }
+
+    /* Plain responses such as IMEI or model strings */
+    return true;
+}
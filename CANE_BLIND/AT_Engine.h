@@ -0,0 +1,383 @@
+#ifndef AT_ENGINE_H
+#define AT_ENGINE_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "UART_Framer.h"
+#include "AT_Catalog.h"
+#include "AT_Stats.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Maximum number of commands that can be queued or awaiting collection at once */
+#define AT_ENGINE_QUEUE_DEPTH     6
+
+/* Maximum number of intermediate response bytes kept per command */
+#define AT_RESPONSE_MAX_LEN       192
+
+/* Handle value returned when a command could not be queued */
+#define AT_INVALID_HANDLE         0xFFFFU
+
+/* Longest single sleep of waitFor() while a line source is attached (ms) */
+#define AT_ENGINE_WAIT_SLICE_MS   10U
+
+/* Slots only submitUrgent() may take, so an urgent command never finds the queue full */
+#define AT_ENGINE_URGENT_RESERVE  1U
+
+/* Longest deadline of any command (ms); longer timeouts are clamped */
+#define AT_ENGINE_MAX_TIMEOUT_MS  AT_TIMEOUT_SMS_SEND_MS
+
+/* Longest time a catalog command on the wire holds up an urgent one (ms), unless another urgent
+   command is ahead of it: a query ends within its own deadline, an AT+CMGS waiting for its
+   prompt is cancelled and ends within AT_TIMEOUT_SMS_PROMPT_MS, and one already handed to the
+   network is detached at once. Free-form commands keep the deadline given to submit(). */
+#define AT_ENGINE_URGENT_WAIT_MS  AT_TIMEOUT_SMS_PROMPT_MS
+
+static_assert(AT_TIMEOUT_PROBE_MS <= AT_ENGINE_URGENT_WAIT_MS &&
+              AT_TIMEOUT_CONFIG_MS <= AT_ENGINE_URGENT_WAIT_MS,
+              "a normal query may hold an urgent command longer than AT_ENGINE_URGENT_WAIT_MS");
+
+static_assert(AT_ENGINE_URGENT_RESERVE < AT_ENGINE_QUEUE_DEPTH, "no slot left for normal commands");
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Final outcome of an AT command */
+typedef enum {
+    AT_RESULT_PENDING = 0,   /* Queued or waiting for the final result code */
+    AT_RESULT_OK,            /* "OK" received */
+    AT_RESULT_ERROR,         /* "ERROR" received */
+    AT_RESULT_CME_ERROR,     /* "+CME ERROR: <n>" received, code in errorCode() */
+    AT_RESULT_CMS_ERROR,     /* "+CMS ERROR: <n>" received, code in errorCode() */
+    AT_RESULT_PROMPT,        /* "> " data prompt received */
+    AT_RESULT_TIMEOUT,       /* Deadline expired before any final result code */
+    AT_RESULT_ABORTED,       /* Cancelled to make way for an urgent command */
+    AT_RESULT_INVALID        /* Unknown or already released handle */
+} AtResult;
+
+/* Opaque command handle: slot index in the low byte, slot generation in the high byte */
+typedef uint16_t AtHandle;
+
+/* Callback invoked for every modem line that does not belong to the active command */
+typedef void (*AtUnsolicitedHandler)(const char* line, size_t length, void* context);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class AtEngine
+* @brief Non-blocking AT command engine for the GSM/GNSS module.
+* @details Commands are submitted into a fixed-size queue and sent one at a time. Each command
+* completes as soon as its final result code (OK, ERROR, +CME ERROR, +CMS ERROR or the "> "
+* prompt) arrives, or when its own deadline expires. Urgent commands (submitUrgent()) are sent
+* before every normal one: an AT+CMGS on the wire that has not sent its body yet is cancelled,
+* and one waiting for the network is detached, so an urgent command waits at most
+* AT_ENGINE_URGENT_WAIT_MS for a normal one.
+* Lines that do not belong to the active command are forwarded to an optional unsolicited
+* handler. The engine never allocates memory.
+*
+* @api
+*/
+/*================================================================================================*/
+class AtEngine {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the AtEngine class.
+    *
+    * @param[in]    port      Serial stream connected to the GSM/GNSS module.
+    */
+    /*============================================================================================*/
+    AtEngine(Stream& port);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Queues an AT command for transmission.
+    * @details      The command text is copied, so the caller's buffer may be reused immediately.
+    *               The deadline starts when the command is actually written to the modem.
+    *
+    * @param[in]    command     AT command text without line terminator.
+    * @param[in]    timeoutMs   Maximum time to wait for the final result code, at most
+    *                           AT_ENGINE_MAX_TIMEOUT_MS.
+    *
+    * @return       AtHandle    Handle of the queued command, or AT_INVALID_HANDLE if the queue
+    *                           is full or the command is too long.
+    */
+    /*============================================================================================*/
+    AtHandle submit(const char* command, uint32_t timeoutMs);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Queues a catalog command.
+    * @details      The descriptor text stays in flash and is written to the modem directly;
+    *               only the optional argument (e.g. a phone number) is copied into the slot.
+    *               A payload (e.g. an SMS body) is written followed by Ctrl+Z when the "> "
+    *               prompt arrives, and the command then continues to its final result code.
+    *               The prompt is awaited for at most AT_TIMEOUT_SMS_PROMPT_MS; the descriptor
+    *               deadline starts when the payload has been written.
+    *               The payload is not copied and must stay valid until the command completes.
+    *
+    * @param[in]    command     Catalog descriptor.
+    * @param[in]    argument    Text placed between prefix and suffix, or NULL.
+    * @param[in]    payload     Data sent on the prompt, or NULL.
+    *
+    * @return       AtHandle    Handle of the queued command, or AT_INVALID_HANDLE.
+    */
+    /*============================================================================================*/
+    AtHandle submit(const AtCommandDesc& command, const char* argument = NULL,
+                    const char* payload = NULL);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Queues a catalog command ahead of every normal command.
+    * @details      An AT+CMGS on the wire still waiting for its prompt is cancelled with ESC
+    *               and completes as AT_RESULT_ABORTED once the modem confirms. One already
+    *               handed to the network completes as AT_RESULT_ABORTED at once: its outcome
+    *               is no longer tracked and its +CMGS/+CMS ERROR result is dropped when it
+    *               arrives. Any other command finishes first: its result code would otherwise
+    *               complete the urgent command. Urgent commands keep FIFO order among
+    *               themselves and never preempt each other.
+    *
+    * @param[in]    command     Catalog descriptor.
+    * @param[in]    argument    Text placed between prefix and suffix, or NULL.
+    * @param[in]    payload     Data sent on the prompt, or NULL (see submit()).
+    *
+    * @return       AtHandle    Handle of the queued command, or AT_INVALID_HANDLE.
+    */
+    /*============================================================================================*/
+    AtHandle submitUrgent(const AtCommandDesc& command, const char* argument = NULL,
+                          const char* payload = NULL);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Drives the engine: reads modem bytes, completes commands and checks deadlines.
+    * @details      Must be called repeatedly; never blocks.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void poll();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Blocks (polling the engine) until the given command has completed.
+    *
+    * @param[in]    handle      Handle returned by submit().
+    *
+    * @return       AtResult    Final result of the command.
+    */
+    /*============================================================================================*/
+    AtResult waitFor(AtHandle handle);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the current result of a command (AT_RESULT_PENDING while running).
+    */
+    /*============================================================================================*/
+    AtResult result(AtHandle handle) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the intermediate response lines of a command, separated by '\n'.
+    * @details      The returned pointer stays valid until the handle is released.
+    */
+    /*============================================================================================*/
+    const char* response(AtHandle handle) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Runs the catalog parser of a completed command on its response.
+    *
+    * @param[in]    handle      Handle of a command submitted from the catalog.
+    * @param[out]   out         Object filled by the descriptor's parser.
+    *
+    * @return       bool        True if the command has a parser and it succeeded.
+    */
+    /*============================================================================================*/
+    bool parse(AtHandle handle, void* out) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the numeric code of a +CME/+CMS error, or -1 if none.
+    */
+    /*============================================================================================*/
+    int16_t errorCode(AtHandle handle) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the time between sending a command and its completion (ms).
+    */
+    /*============================================================================================*/
+    uint32_t latencyMs(AtHandle handle) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Releases a command slot. Pending commands are cancelled.
+    */
+    /*============================================================================================*/
+    void release(AtHandle handle);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns true when no command is queued or in flight.
+    */
+    /*============================================================================================*/
+    bool isIdle() const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Registers the handler for lines that do not belong to the active command.
+    */
+    /*============================================================================================*/
+    void setUnsolicitedHandler(AtUnsolicitedHandler handler, void* context);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Routes the next received line to the unsolicited handler unconditionally.
+    * @details      Used for two-line URCs (+CMT) whose body line must not be mistaken for a
+    *               command response.
+    */
+    /*============================================================================================*/
+    void routeNextLineUnsolicited() { forceUnsolicited = true; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the receive framer (for its byte/line/drop statistics).
+    */
+    /*============================================================================================*/
+    const LineFramer& rxFramer() const { return framer; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Discards partially received input (e.g. garbage after a baud rate change).
+    */
+    /*============================================================================================*/
+    void resetInput();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the total number of command bytes written to the modem.
+    */
+    /*============================================================================================*/
+    uint32_t bytesSent() const { return sentCount; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the total number of bytes received from the modem.
+    */
+    /*============================================================================================*/
+    uint32_t bytesReceived() const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Takes lines from a receive task instead of reading the port in poll().
+    *
+    * @param[in]    source      Line producer, or NULL to read the port directly again.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void setLineSource(LineSource* source) { lineSource = source; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Sleeps until a modem line arrives or maxMs expires.
+    *
+    * @param[in]    maxMs       Maximum sleep time.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void idle(uint32_t maxMs);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the per-class round-trip histograms of completed commands.
+    */
+    /*============================================================================================*/
+    AtLatencyStats& latencyStats() { return latency; }
+    const AtLatencyStats& latencyStats() const { return latency; }
+
+private:
+    /* Lifecycle of a command slot */
+    typedef enum {
+        SLOT_FREE = 0,
+        SLOT_QUEUED,
+        SLOT_ACTIVE,
+        SLOT_DONE
+    } SlotState;
+
+    /* One queued, running or completed command */
+    typedef struct {
+        SlotState state;
+        uint8_t   generation;
+        AtResult  result;
+        int16_t   errorCode;
+        uint32_t  timeoutMs;
+        uint32_t  ackTimeoutMs;
+        uint32_t  sentAtMs;
+        uint32_t  waitFromMs;
+        uint32_t  doneAtMs;
+        uint32_t  sequence;
+        uint16_t  responseLength;
+        uint8_t   terminators;
+        bool      urgent;
+        bool      aborting;
+        bool      payloadSent;
+        AtCommandClass commandClass;
+        const char* prefix;
+        const char* suffix;
+        AtResponseParser parser;
+        const char* payload;
+        char      argument[AT_COMMAND_MAX_LEN + 1];
+        char      response[AT_RESPONSE_MAX_LEN + 1];
+    } Slot;
+
+    AtHandle enqueue(const char* prefix, const char* argument, const char* suffix,
+                     uint8_t terminators, uint32_t timeoutMs, AtResponseParser parser,
+                     AtCommandClass commandClass, const char* payload, bool urgent);
+    void preemptActive();
+    bool dropDetachedLine(const char* line, size_t length);
+    Slot* slotFor(AtHandle handle);
+    const Slot* slotFor(AtHandle handle) const;
+    void startNext();
+    void complete(Slot& slot, AtResult result, int16_t errorCode);
+    void writePayload(Slot& slot);
+    void processLine(const LineView& line);
+    void handleLine(const char* line, size_t length);
+    bool isEcho(const Slot& slot, const char* line, size_t length) const;
+    bool belongsToActive(const Slot& slot, const char* line, size_t length) const;
+
+    /* Serial stream connected to the modem */
+    Stream& port;
+    /* Command slots */
+    Slot slots[AT_ENGINE_QUEUE_DEPTH];
+    /* Index of the command currently on the wire, or -1 */
+    int8_t activeIndex;
+    /* Monotonic submit counter used to keep commands in FIFO order */
+    uint32_t nextSequence;
+    /* Receive ring buffer and line framer */
+    LineFramer framer;
+    /* Optional producer of framed lines; replaces framer when set */
+    LineSource* lineSource;
+    /* Number of command bytes written to the modem */
+    uint32_t sentCount;
+    /* Set when the next line is known to be part of a URC */
+    bool forceUnsolicited;
+    /* An AT+CMGS detached for an urgent command still owes its result (until detachedAtMs +
+       AT_TIMEOUT_SMS_SEND_MS); its "+CMGS:" line has arrived and the OK is still due */
+    bool detachedPending;
+    bool detachedAckSeen;
+    uint32_t detachedAtMs;
+    /* Handler for unsolicited lines */
+    AtUnsolicitedHandler unsolicitedHandler;
+    void* unsolicitedContext;
+    /* Round-trip histograms per command class */
+    AtLatencyStats latency;
+};
+
+#endif /* AT_ENGINE_H */
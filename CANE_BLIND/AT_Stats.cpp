@@ -0,0 +1,209 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "AT_Stats.h"
+#include <stdarg.h>
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Names of the command classes, indexed by AtCommandClass */
+static const char* const AT_CLASS_NAMES[] = {
+    "basic", "config", "status", "call", "sms", "gnss", "raw"
+};
+static_assert(sizeof(AT_CLASS_NAMES) / sizeof(AT_CLASS_NAMES[0]) == AT_CLASS_COUNT,
+              "AT_CLASS_NAMES must name every command class");
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Maps a round trip to its log2 bucket */
+static uint8_t bucketFor(uint32_t latencyMs) {
+    if (latencyMs < 4U) {
+        return 0U;
+    }
+    uint8_t bucket = (uint8_t)(31 - __builtin_clz(latencyMs) - 1);
+    return (bucket < AT_STATS_BUCKET_COUNT) ? bucket : (uint8_t)(AT_STATS_BUCKET_COUNT - 1U);
+}
+
+/* Appends formatted text to a buffer; tracks overflow in *used */
+static void appendf(char* buffer, size_t size, size_t* used, const char* format, ...) {
+    if (*used >= size) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(&buffer[*used], size - *used, format, args);
+    va_end(args);
+    *used = (written < 0) ? size : (*used + (size_t)written);
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the AtLatencyStats class.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+AtLatencyStats::AtLatencyStats() {
+    reset();
+}
+
+/*================================================================================================*/
+/**
+* @brief        Records one completed command.
+*
+* @param[in]    commandClass    Class of the command.
+* @param[in]    outcome         How the command ended.
+* @param[in]    latencyMs       Time from transmission to completion.
+* @param[in]    errorCode       +CME/+CMS code, or -1.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void AtLatencyStats::record(AtCommandClass commandClass, AtOutcome outcome, uint32_t latencyMs,
+                            int16_t errorCode) {
+    if (commandClass >= AT_CLASS_COUNT) {
+        return;
+    }
+    AtClassStats& stats = classes[commandClass];
+
+    stats.count++;
+    switch (outcome) {
+    case AT_OUTCOME_OK:        stats.okCount++;      break;
+    case AT_OUTCOME_ERROR:     stats.errorCount++;   break;
+    case AT_OUTCOME_CME_ERROR: stats.cmeCount++;     break;
+    case AT_OUTCOME_CMS_ERROR: stats.cmsCount++;     break;
+    case AT_OUTCOME_TIMEOUT:   stats.timeoutCount++; break;
+    }
+    if (errorCode >= 0) {
+        stats.lastErrorCode = errorCode;
+    }
+
+    if (latencyMs < stats.minMs) {
+        stats.minMs = latencyMs;
+    }
+    if (latencyMs > stats.maxMs) {
+        stats.maxMs = latencyMs;
+    }
+    stats.totalMs += latencyMs;
+    stats.buckets[bucketFor(latencyMs)]++;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Clears every counter.
+*/
+/*================================================================================================*/
+void AtLatencyStats::reset() {
+    memset(classes, 0, sizeof(classes));
+    for (uint8_t i = 0; i < AT_CLASS_COUNT; i++) {
+        classes[i].lastErrorCode = -1;
+        classes[i].minMs = UINT32_MAX;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints one summary line and the non-empty buckets per used class.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void AtLatencyStats::printReport(Print& out) const {
+    out.println("[AT] class   count    ok  err  cme  cms  tmo  last   min   avg   max (ms)");
+    for (uint8_t i = 0; i < AT_CLASS_COUNT; i++) {
+        const AtClassStats& stats = classes[i];
+        if (stats.count == 0U) {
+            continue;
+        }
+        out.printf("[AT] %-6s %6lu %5lu %4lu %4lu %4lu %4lu %5d %5lu %5lu %5lu\n",
+                   AT_CLASS_NAMES[i], (unsigned long)stats.count, (unsigned long)stats.okCount,
+                   (unsigned long)stats.errorCount, (unsigned long)stats.cmeCount,
+                   (unsigned long)stats.cmsCount, (unsigned long)stats.timeoutCount,
+                   stats.lastErrorCode, (unsigned long)stats.minMs,
+                   (unsigned long)(stats.totalMs / stats.count), (unsigned long)stats.maxMs);
+        out.print("[AT]        ");
+        for (uint8_t b = 0; b < AT_STATS_BUCKET_COUNT; b++) {
+            if (stats.buckets[b] != 0U) {
+                out.printf(" >=%lums:%lu", (unsigned long)bucketFloorMs(b),
+                           (unsigned long)stats.buckets[b]);
+            }
+        }
+        out.println();
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Writes the statistics as a JSON object.
+* @details      Format: {"bucketFloorsMs":[...],"classes":{"call":{"count":..,"ok":..,...,
+*               "histogram":[...]},...}}. Every class is listed so the layout is fixed.
+*
+* @param[out]   buffer      Destination buffer.
+* @param[in]    size        Size of buffer.
+*
+* @return       size_t      Length written (without the NUL), or 0 if the buffer was too small.
+*/
+/*================================================================================================*/
+size_t AtLatencyStats::formatJson(char* buffer, size_t size) const {
+    size_t used = 0U;
+
+    appendf(buffer, size, &used, "{\"bucketFloorsMs\":[");
+    for (uint8_t b = 0; b < AT_STATS_BUCKET_COUNT; b++) {
+        appendf(buffer, size, &used, "%s%lu", (b == 0U) ? "" : ",", (unsigned long)bucketFloorMs(b));
+    }
+    appendf(buffer, size, &used, "],\"classes\":{");
+
+    for (uint8_t i = 0; i < AT_CLASS_COUNT; i++) {
+        const AtClassStats& stats = classes[i];
+        appendf(buffer, size, &used,
+                "%s\"%s\":{\"count\":%lu,\"ok\":%lu,\"error\":%lu,\"cme\":%lu,\"cms\":%lu,"
+                "\"timeout\":%lu,\"lastErrorCode\":%d,\"minMs\":%lu,\"avgMs\":%lu,\"maxMs\":%lu,"
+                "\"histogram\":[",
+                (i == 0U) ? "" : ",", AT_CLASS_NAMES[i], (unsigned long)stats.count,
+                (unsigned long)stats.okCount, (unsigned long)stats.errorCount,
+                (unsigned long)stats.cmeCount, (unsigned long)stats.cmsCount,
+                (unsigned long)stats.timeoutCount, stats.lastErrorCode,
+                (unsigned long)((stats.count != 0U) ? stats.minMs : 0U),
+                (unsigned long)((stats.count != 0U) ? stats.totalMs / stats.count : 0U),
+                (unsigned long)stats.maxMs);
+        for (uint8_t b = 0; b < AT_STATS_BUCKET_COUNT; b++) {
+            appendf(buffer, size, &used, "%s%lu", (b == 0U) ? "" : ",",
+                    (unsigned long)stats.buckets[b]);
+        }
+        appendf(buffer, size, &used, "]}");
+    }
+    appendf(buffer, size, &used, "}}");
+
+    if (used >= size) {
+        if (size > 0U) {
+            buffer[0] = '\0';
+        }
+        return 0U;
+    }
+    return used;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the name of a command class, e.g. "call".
+*/
+/*================================================================================================*/
+const char* AtLatencyStats::className(AtCommandClass commandClass) {
+    return (commandClass < AT_CLASS_COUNT) ? AT_CLASS_NAMES[commandClass] : "?";
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the lower bound of a bucket in ms.
+*/
+/*================================================================================================*/
+uint32_t AtLatencyStats::bucketFloorMs(uint8_t bucket) {
+    return (bucket == 0U) ? 0U : (1UL << (bucket + 1U));
+}
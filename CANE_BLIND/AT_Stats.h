@@ -0,0 +1,129 @@
+#ifndef AT_STATS_H
+#define AT_STATS_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "AT_Catalog.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Number of latency buckets; bucket 0 is < 4 ms, bucket i is [2^(i+1), 2^(i+2)) ms, the last is open */
+#define AT_STATS_BUCKET_COUNT     16U
+
+/* Buffer size that always fits formatJson() output */
+#define AT_STATS_JSON_MAX_LEN     3072U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* How a command ended, as far as the statistics are concerned */
+typedef enum {
+    AT_OUTCOME_OK = 0,          /* OK or the "> " prompt */
+    AT_OUTCOME_ERROR,           /* Plain ERROR */
+    AT_OUTCOME_CME_ERROR,       /* +CME ERROR: <n> */
+    AT_OUTCOME_CMS_ERROR,       /* +CMS ERROR: <n> */
+    AT_OUTCOME_TIMEOUT          /* Deadline expired */
+} AtOutcome;
+
+/* Counters of one command class */
+typedef struct {
+    uint32_t count;                             /* Completed commands */
+    uint32_t okCount;                           /* Completed with OK or the prompt */
+    uint32_t errorCount;                        /* Plain ERROR */
+    uint32_t cmeCount;                          /* +CME ERROR */
+    uint32_t cmsCount;                          /* +CMS ERROR */
+    uint32_t timeoutCount;                      /* Deadline expired */
+    int16_t  lastErrorCode;                     /* Last +CME/+CMS code, -1 if none */
+    uint32_t minMs;                             /* Fastest round trip */
+    uint32_t maxMs;                             /* Slowest round trip */
+    uint32_t totalMs;                           /* Sum of round trips (for the mean) */
+    uint32_t buckets[AT_STATS_BUCKET_COUNT];    /* Round-trip histogram */
+} AtClassStats;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class AtLatencyStats
+* @brief Fixed-size round-trip histograms and outcome counters per AT command class.
+* @details record() is O(1): a few counter updates and one count-leading-zeros to pick the
+* log2 bucket. Nothing is allocated; the reports are written into caller supplied buffers.
+*
+* @api
+*/
+/*================================================================================================*/
+class AtLatencyStats {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the AtLatencyStats class.
+    */
+    /*============================================================================================*/
+    AtLatencyStats();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Records one completed command.
+    *
+    * @param[in]    commandClass    Class of the command.
+    * @param[in]    outcome         How the command ended.
+    * @param[in]    latencyMs       Time from transmission to completion.
+    * @param[in]    errorCode       +CME/+CMS code, or -1.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void record(AtCommandClass commandClass, AtOutcome outcome, uint32_t latencyMs, int16_t errorCode);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Clears every counter.
+    */
+    /*============================================================================================*/
+    void reset();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the counters of one class.
+    */
+    /*============================================================================================*/
+    const AtClassStats& forClass(AtCommandClass commandClass) const { return classes[commandClass]; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints one summary line and the non-empty buckets per used class.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printReport(Print& out) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Writes the statistics as a JSON object.
+    *
+    * @param[out]   buffer      Destination buffer.
+    * @param[in]    size        Size of buffer.
+    *
+    * @return       size_t      Length written (without the NUL), or 0 if the buffer was too small.
+    */
+    /*============================================================================================*/
+    size_t formatJson(char* buffer, size_t size) const;
+
+    /* Name of a command class, e.g. "call" */
+    static const char* className(AtCommandClass commandClass);
+
+    /* Lower bound of a bucket in ms */
+    static uint32_t bucketFloorMs(uint8_t bucket);
+
+private:
+    AtClassStats classes[AT_CLASS_COUNT];
+};
+
+#endif /* AT_STATS_H */
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "BTN_Capture.h"
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the ButtonCapture class.
+*
+* @param[in]    pin             GPIO of the button.
+* @param[in]    pressedLevel    Pin level while the button is pressed.
+* @param[in]    debounceUs      Time the level must stay unchanged before an edge counts.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+ButtonCapture::ButtonCapture(uint8_t pin, uint8_t pressedLevel, uint32_t debounceUs)
+    : pin(pin), pressedLevel(pressedLevel), debounceUs(debounceUs), edgeListener(NULL),
+      edgeListenerContext(NULL), head(0U), tail(0U), droppedCount(0U), edgeCount(0U),
+      stableLevel((uint8_t)!pressedLevel), burstOpen(false), burstLevel(0U), burstStartUs(0U),
+      burstLastUs(0U), bounceCount(0U), lastTransitionUs(0U) {
+    memset(edges, 0, sizeof(edges));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Reads the current level and attaches the CHANGE interrupt.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ButtonCapture::begin() {
+    stableLevel = (uint8_t)digitalRead(pin);
+    lastTransitionUs = micros();
+    attachInterruptArg(digitalPinToInterrupt(pin), onEdge, this, CHANGE);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sets the function the interrupt calls after each edge (NULL to remove it).
+* @details      The context is published before the function so the interrupt never pairs a new
+*               function with an old context.
+*
+* @param[in]    listener    IRAM_ATTR function; must not block.
+* @param[in]    context     Passed to listener.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ButtonCapture::setEdgeListener(ButtonEdgeListener listener, void* context) {
+    edgeListener = NULL;
+    edgeListenerContext = context;
+    edgeListener = listener;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the next debounced transition; never blocks.
+* @details      A burst is settled by the first later edge that comes at least debounceUs
+*               after its last edge, or by the clock once the queue is empty. The clock is read
+*               before the queue so an edge arriving in between cannot be overlooked.
+*
+* @param[out]   event       Filled when a transition is returned.
+*
+* @return       bool        False when no settled transition is waiting.
+*/
+/*================================================================================================*/
+bool ButtonCapture::nextEvent(ButtonEvent& event) {
+    while (true) {
+        uint32_t nowUs = micros();
+        ButtonEdge edge;
+        bool haveEdge = peekEdge(edge);
+        if (haveEdge) {
+            nowUs = edge.timestampUs;
+        }
+
+        if (burstOpen && (uint32_t)(nowUs - burstLastUs) >= debounceUs && settle(event)) {
+            return true;
+        }
+        if (!haveEdge) {
+            return false;
+        }
+
+        popEdge();
+        edgeCount++;
+        if (burstOpen) {
+            bounceCount++;
+        } else {
+            burstOpen = true;
+            burstStartUs = edge.timestampUs;
+        }
+        burstLevel = edge.level;
+        burstLastUs = edge.timestampUs;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Records one raw edge (the interrupt body).
+* @details      A full ring drops the edge; the next one still carries the absolute level.
+*
+* @param[in]    level           Pin level after the edge.
+* @param[in]    timestampUs     micros() of the edge.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void IRAM_ATTR ButtonCapture::pushEdge(uint8_t level, uint32_t timestampUs) {
+    uint32_t position = head.load(std::memory_order_relaxed);
+    if (position - tail.load(std::memory_order_acquire) >= BUTTON_EDGE_QUEUE_SIZE) {
+        droppedCount.fetch_add(1U, std::memory_order_relaxed);
+        return;
+    }
+    ButtonEdge& edge = edges[position & (BUTTON_EDGE_QUEUE_SIZE - 1U)];
+    edge.timestampUs = timestampUs;
+    edge.level = level;
+    head.store(position + 1U, std::memory_order_release);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the edge, bounce and drop counters.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ButtonCapture::printStats(Print& out) const {
+    out.printf("[BTN] %lu edges, %lu bounces filtered, %lu dropped, %s\n",
+               (unsigned long)edgeCount, (unsigned long)bounceCount,
+               (unsigned long)edgesDropped(), isPressed() ? "pressed" : "released");
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* CHANGE interrupt of the button pin */
+void IRAM_ATTR ButtonCapture::onEdge(void* context) {
+    ButtonCapture* self = static_cast<ButtonCapture*>(context);
+    self->pushEdge((uint8_t)digitalRead(self->pin), (uint32_t)micros());
+    ButtonEdgeListener listener = self->edgeListener;
+    if (listener != NULL) {
+        listener(self->edgeListenerContext);
+    }
+}
+
+/* Copies the oldest queued edge without removing it */
+bool ButtonCapture::peekEdge(ButtonEdge& edge) const {
+    uint32_t position = tail.load(std::memory_order_relaxed);
+    if (position == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    edge = edges[position & (BUTTON_EDGE_QUEUE_SIZE - 1U)];
+    return true;
+}
+
+/* Frees the oldest queued edge for the interrupt */
+void ButtonCapture::popEdge() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+}
+
+/* Closes the open burst; true if it changed the debounced level */
+bool ButtonCapture::settle(ButtonEvent& event) {
+    burstOpen = false;
+    if (burstLevel == stableLevel) {
+        /* A glitch that came back to where it started */
+        bounceCount++;
+        return false;
+    }
+    stableLevel = burstLevel;
+    event.type = isPressed() ? BUTTON_EVENT_PRESS : BUTTON_EVENT_RELEASE;
+    event.timestampUs = burstStartUs;
+    event.durationUs = burstStartUs - lastTransitionUs;
+    lastTransitionUs = burstStartUs;
+    return true;
+}
@@ -0,0 +1,176 @@
+#ifndef BTN_CAPTURE_H
+#define BTN_CAPTURE_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <atomic>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Number of raw edges the interrupt can queue ahead of the loop (must be a power of two) */
+#define BUTTON_EDGE_QUEUE_SIZE    32U
+
+/* Default time the level must stay unchanged before an edge counts (us) */
+#define BUTTON_DEBOUNCE_US        50000UL
+
+static_assert((BUTTON_EDGE_QUEUE_SIZE & (BUTTON_EDGE_QUEUE_SIZE - 1U)) == 0U,
+              "BUTTON_EDGE_QUEUE_SIZE must be a power of two");
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Raw pin change recorded by the interrupt */
+typedef struct {
+    uint32_t timestampUs;   /* micros() when the interrupt ran */
+    uint8_t  level;         /* Pin level read in the interrupt */
+} ButtonEdge;
+
+/* Debounced button transition */
+typedef enum {
+    BUTTON_EVENT_PRESS = 0,
+    BUTTON_EVENT_RELEASE
+} ButtonEventType;
+
+/* One debounced transition, timed from the first edge of its bounce burst */
+typedef struct {
+    ButtonEventType type;
+    uint32_t        timestampUs;    /* micros() of the transition */
+    uint32_t        durationUs;     /* Release: how long the button was held.
+                                       Press: how long it was released before. */
+} ButtonEvent;
+
+/* Called from the interrupt after each queued edge; must be IRAM_ATTR and must not block */
+typedef void (*ButtonEdgeListener)(void* context);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class ButtonCapture
+* @brief Interrupt-driven push button with debouncing on the recorded edge stream.
+* @details A CHANGE interrupt stores the pin level and micros() of every edge in a lock-free
+* single-producer / single-consumer ring, so no edge depends on how often loop() runs.
+* nextEvent() debounces that stream: a burst of edges counts as one transition once the
+* level has stayed unchanged for the debounce time, and the transition is timestamped with
+* the first edge of the burst. Press durations are therefore accurate to the interrupt
+* latency even when the loop is blocked for seconds.
+*
+* @api
+*/
+/*================================================================================================*/
+class ButtonCapture {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the ButtonCapture class.
+    *
+    * @param[in]    pin             GPIO of the button.
+    * @param[in]    pressedLevel    Pin level while the button is pressed.
+    * @param[in]    debounceUs      Time the level must stay unchanged before an edge counts.
+    */
+    /*============================================================================================*/
+    ButtonCapture(uint8_t pin, uint8_t pressedLevel = LOW,
+                  uint32_t debounceUs = BUTTON_DEBOUNCE_US);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Reads the current level and attaches the CHANGE interrupt.
+    * @details      The pin mode must already be set.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void begin();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the next debounced transition; never blocks.
+    *
+    * @param[out]   event       Filled when a transition is returned.
+    *
+    * @return       bool        False when no settled transition is waiting.
+    */
+    /*============================================================================================*/
+    bool nextEvent(ButtonEvent& event);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Records one raw edge (the interrupt body).
+    * @details      Public so that recorded or synthetic edge traces can be replayed.
+    *
+    * @param[in]    level           Pin level after the edge.
+    * @param[in]    timestampUs     micros() of the edge.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void IRAM_ATTR pushEdge(uint8_t level, uint32_t timestampUs);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Sets the function the interrupt calls after each edge (NULL to remove it).
+    * @details      Lets the consumer sleep until the button moves instead of polling it.
+    */
+    /*============================================================================================*/
+    void setEdgeListener(ButtonEdgeListener listener, void* context);
+
+    /* True while edges wait to be settled, i.e. nextEvent() must be called again within the
+       debounce time */
+    bool isSettling() const {
+        return burstOpen ||
+               (tail.load(std::memory_order_relaxed) != head.load(std::memory_order_acquire));
+    }
+
+    /* True while the debounced state is pressed */
+    bool isPressed() const { return stableLevel == pressedLevel; }
+
+    /* Statistics */
+    uint32_t edgesDropped() const { return droppedCount.load(std::memory_order_relaxed); }
+    uint32_t bouncesFiltered() const { return bounceCount; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the edge, bounce and drop counters.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+private:
+    static void IRAM_ATTR onEdge(void* context);
+    bool peekEdge(ButtonEdge& edge) const;
+    void popEdge();
+    bool settle(ButtonEvent& event);
+
+    uint8_t pin;
+    uint8_t pressedLevel;
+    uint32_t debounceUs;
+    ButtonEdgeListener volatile edgeListener;
+    void* volatile edgeListenerContext;
+
+    /* Edge ring: head is written by the interrupt only, tail by nextEvent() only */
+    ButtonEdge edges[BUTTON_EDGE_QUEUE_SIZE];
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> droppedCount;
+    uint32_t edgeCount;
+
+    /* Debouncer: settled level, and the burst of edges not settled yet */
+    uint8_t stableLevel;
+    bool burstOpen;
+    uint8_t burstLevel;
+    uint32_t burstStartUs;
+    uint32_t burstLastUs;
+    uint32_t bounceCount;
+    /* Timestamp of the last settled transition */
+    uint32_t lastTransitionUs;
+};
+
+#endif /* BTN_CAPTURE_H */
@@ -0,0 +1,218 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "BTN_Gesture.h"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Recognizer states; the number of clicks so far is part of the state */
+enum {
+    GS_IDLE = 0,        /* Released, nothing in progress */
+    GS_DOWN_1,          /* First press */
+    GS_UP_1,            /* One click, waiting for another */
+    GS_DOWN_2,          /* Second press */
+    GS_UP_2,            /* Two clicks, waiting for another */
+    GS_DOWN_3,          /* Third press */
+    GS_HELD,            /* Hold reported, waiting for the release */
+    GS_COUNT
+};
+
+/* Inputs of the transition table */
+enum {
+    GI_PRESS = 0,       /* Button pressed */
+    GI_RELEASE_SHORT,   /* Released before the long press time */
+    GI_RELEASE_LONG,    /* Released after the long press time */
+    GI_TIMEOUT,         /* The timeout of the state expired (see GESTURE_STATE_TIMEOUT) */
+    GI_COUNT
+};
+
+/* Timeout of a state */
+enum {
+    GT_NONE = 0,
+    GT_CLICK_GAP,       /* Pause after a click */
+    GT_HOLD             /* Button held down */
+};
+
+/* One cell of the transition table */
+typedef struct {
+    uint8_t next;
+    Gesture gesture;
+} GestureTransition;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Next state and emitted gesture for every state and input */
+static constexpr GestureTransition GESTURE_TABLE[GS_COUNT][GI_COUNT] = {
+    /*              PRESS                     RELEASE_SHORT                    RELEASE_LONG                     TIMEOUT                          */
+    /* IDLE   */ { { GS_DOWN_1, GESTURE_NONE }, { GS_IDLE, GESTURE_NONE },         { GS_IDLE, GESTURE_NONE },       { GS_IDLE, GESTURE_NONE }         },
+    /* DOWN_1 */ { { GS_DOWN_1, GESTURE_NONE }, { GS_UP_1, GESTURE_NONE },         { GS_IDLE, GESTURE_LONG_PRESS }, { GS_HELD, GESTURE_HOLD }         },
+    /* UP_1   */ { { GS_DOWN_2, GESTURE_NONE }, { GS_IDLE, GESTURE_NONE },         { GS_IDLE, GESTURE_NONE },       { GS_IDLE, GESTURE_SINGLE_CLICK } },
+    /* DOWN_2 */ { { GS_DOWN_2, GESTURE_NONE }, { GS_UP_2, GESTURE_NONE },         { GS_IDLE, GESTURE_LONG_PRESS }, { GS_HELD, GESTURE_HOLD }         },
+    /* UP_2   */ { { GS_DOWN_3, GESTURE_NONE }, { GS_IDLE, GESTURE_NONE },         { GS_IDLE, GESTURE_NONE },       { GS_IDLE, GESTURE_DOUBLE_CLICK } },
+    /* DOWN_3 */ { { GS_DOWN_3, GESTURE_NONE }, { GS_IDLE, GESTURE_TRIPLE_CLICK }, { GS_IDLE, GESTURE_LONG_PRESS }, { GS_HELD, GESTURE_HOLD }         },
+    /* HELD   */ { { GS_HELD, GESTURE_NONE },   { GS_IDLE, GESTURE_NONE },         { GS_IDLE, GESTURE_NONE },       { GS_HELD, GESTURE_NONE }         }
+};
+
+/* Which timeout each state waits for */
+static constexpr uint8_t GESTURE_STATE_TIMEOUT[GS_COUNT] = {
+    GT_NONE, GT_HOLD, GT_CLICK_GAP, GT_HOLD, GT_CLICK_GAP, GT_HOLD, GT_NONE
+};
+
+/* Gesture names, indexed by Gesture */
+static const char* const GESTURE_NAMES[GESTURE_COUNT] = {
+    "none", "single click", "double click", "triple click", "long press", "hold"
+};
+
+/******************************************************************************
+ * COMPILE-TIME VALIDATION
+ ******************************************************************************/
+/* True if every cell of the table leads to a valid state and gesture */
+static constexpr bool gestureCellIsValid(uint8_t index) {
+    return (GESTURE_TABLE[index / GI_COUNT][index % GI_COUNT].next < GS_COUNT) &&
+           (GESTURE_TABLE[index / GI_COUNT][index % GI_COUNT].gesture < GESTURE_COUNT);
+}
+
+static constexpr bool gestureTableIsValid(uint8_t index) {
+    return (index >= GS_COUNT * GI_COUNT) ? true
+         : (gestureCellIsValid(index) && gestureTableIsValid((uint8_t)(index + 1U)));
+}
+
+static_assert(gestureTableIsValid(0U), "GESTURE_TABLE leads to an invalid state or gesture");
+static_assert(GESTURE_TABLE[GS_IDLE][GI_PRESS].next == GS_DOWN_1, "a press must start a gesture");
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the GestureRecognizer class.
+*
+* @param[in]    timing      Gesture timing.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+GestureRecognizer::GestureRecognizer(const GestureTiming& timing)
+    : timing(timing), state(GS_IDLE), lastEdgeUs(0U) {
+    memset(actions, 0, sizeof(actions));
+    memset(contexts, 0, sizeof(contexts));
+    memset(counters, 0, sizeof(counters));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns GESTURE_CLICK_GAP_MS, GESTURE_LONG_PRESS_MS and GESTURE_HOLD_MS.
+*/
+/*================================================================================================*/
+GestureTiming GestureRecognizer::defaultTiming() {
+    GestureTiming timing = { GESTURE_CLICK_GAP_MS, GESTURE_LONG_PRESS_MS, GESTURE_HOLD_MS };
+    return timing;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sets the action of one gesture (NULL to remove it).
+*/
+/*================================================================================================*/
+void GestureRecognizer::setAction(Gesture gesture, GestureAction action, void* context) {
+    if (gesture >= GESTURE_COUNT) {
+        return;
+    }
+    actions[gesture] = action;
+    contexts[gesture] = context;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Feeds one debounced button event.
+* @details      A timeout that expired before the event is applied first, so an event fed late
+*               cannot merge two separate gestures.
+*
+* @param[in]    event       Event in timestamp order.
+*
+* @return       Gesture     Last gesture recognized by this call, or GESTURE_NONE.
+*/
+/*================================================================================================*/
+Gesture GestureRecognizer::feed(const ButtonEvent& event) {
+    Gesture timedOut = expire(event.timestampUs);
+    uint8_t input = GI_PRESS;
+    if (event.type == BUTTON_EVENT_RELEASE) {
+        input = (event.durationUs >= timing.longPressMs * 1000UL) ? GI_RELEASE_LONG
+                                                                   : GI_RELEASE_SHORT;
+    }
+    Gesture gesture = apply(input, event.timestampUs);
+    return (gesture != GESTURE_NONE) ? gesture : timedOut;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Fires the timeouts that have expired by the given time.
+*
+* @param[in]    nowUs       Time up to which no further event can arrive (micros()).
+*
+* @return       Gesture     Gesture recognized, or GESTURE_NONE.
+*/
+/*================================================================================================*/
+Gesture GestureRecognizer::poll(uint32_t nowUs) {
+    return expire(nowUs);
+}
+
+/*================================================================================================*/
+/**
+* @brief        True while the current state ends by a timeout, i.e. poll() must be called again.
+*/
+/*================================================================================================*/
+bool GestureRecognizer::waitsForTimeout() const {
+    return GESTURE_STATE_TIMEOUT[state] != GT_NONE;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the name of a gesture (for logs and the console).
+*/
+/*================================================================================================*/
+const char* gestureName(Gesture gesture) {
+    return (gesture < GESTURE_COUNT) ? GESTURE_NAMES[gesture] : "?";
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Takes one transition and dispatches the gesture it emits */
+Gesture GestureRecognizer::apply(uint8_t input, uint32_t timestampUs) {
+    const GestureTransition& transition = GESTURE_TABLE[state][input];
+    state = transition.next;
+    if (input != GI_TIMEOUT) {
+        lastEdgeUs = timestampUs;
+    }
+
+    Gesture gesture = transition.gesture;
+    if (gesture != GESTURE_NONE) {
+        counters[gesture]++;
+        if (actions[gesture] != NULL) {
+            actions[gesture](gesture, contexts[gesture]);
+        }
+    }
+    return gesture;
+}
+
+/* Applies the timeout of the current state if it expired by nowUs */
+Gesture GestureRecognizer::expire(uint32_t nowUs) {
+    uint32_t limitMs;
+    switch (GESTURE_STATE_TIMEOUT[state]) {
+    case GT_CLICK_GAP:
+        limitMs = timing.clickGapMs;
+        break;
+    case GT_HOLD:
+        limitMs = timing.holdMs;
+        break;
+    default:
+        return GESTURE_NONE;
+    }
+    if ((int32_t)(nowUs - lastEdgeUs) < (int32_t)(limitMs * 1000UL)) {
+        return GESTURE_NONE;
+    }
+    return apply(GI_TIMEOUT, nowUs);
+}
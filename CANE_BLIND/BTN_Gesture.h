@@ -0,0 +1,143 @@
+#ifndef BTN_GESTURE_H
+#define BTN_GESTURE_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "BTN_Capture.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Default timing of the gestures (ms) */
+#define GESTURE_CLICK_GAP_MS      400UL   /* Longest pause between the clicks of a multi-click */
+#define GESTURE_LONG_PRESS_MS     650UL   /* Shortest hold released as a long press */
+#define GESTURE_HOLD_MS           3000UL  /* Hold reported while the button is still down */
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Recognized gestures */
+typedef enum {
+    GESTURE_NONE = 0,
+    GESTURE_SINGLE_CLICK,
+    GESTURE_DOUBLE_CLICK,
+    GESTURE_TRIPLE_CLICK,
+    GESTURE_LONG_PRESS,       /* Released after GESTURE_LONG_PRESS_MS */
+    GESTURE_HOLD,             /* Still pressed after GESTURE_HOLD_MS; the release is ignored */
+    GESTURE_COUNT
+} Gesture;
+
+/* Gesture timing (ms) */
+typedef struct {
+    uint32_t clickGapMs;
+    uint32_t longPressMs;
+    uint32_t holdMs;
+} GestureTiming;
+
+/* Called when a gesture is recognized */
+typedef void (*GestureAction)(Gesture gesture, void* context);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class GestureRecognizer
+* @brief Finite-state recognizer of clicks, multi-clicks, long presses and holds.
+* @details Debounced button events (ButtonCapture) and the two timeouts (the pause after a
+* click, the hold while pressed) are mapped to inputs of a constexpr transition table, which
+* gives the next state and the gesture to emit. Timeouts are evaluated against the event
+* timestamps, so gestures come out the same however late the events are fed. Every gesture
+* dispatches to the action set for it; nothing is allocated.
+*
+* @api
+*/
+/*================================================================================================*/
+class GestureRecognizer {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the GestureRecognizer class.
+    *
+    * @param[in]    timing      Gesture timing.
+    */
+    /*============================================================================================*/
+    GestureRecognizer(const GestureTiming& timing = defaultTiming());
+
+    /* GESTURE_CLICK_GAP_MS, GESTURE_LONG_PRESS_MS, GESTURE_HOLD_MS */
+    static GestureTiming defaultTiming();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Sets the action of one gesture (NULL to remove it).
+    */
+    /*============================================================================================*/
+    void setAction(Gesture gesture, GestureAction action, void* context);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Changes the timing; applies from the next press.
+    */
+    /*============================================================================================*/
+    void setTiming(const GestureTiming& newTiming) { timing = newTiming; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Feeds one debounced button event.
+    *
+    * @param[in]    event       Event in timestamp order.
+    *
+    * @return       Gesture     Last gesture recognized by this call, or GESTURE_NONE.
+    */
+    /*============================================================================================*/
+    Gesture feed(const ButtonEvent& event);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Fires the timeouts that have expired by the given time.
+    *
+    * @param[in]    nowUs       Time up to which no further event can arrive (micros()).
+    *
+    * @return       Gesture     Gesture recognized, or GESTURE_NONE.
+    */
+    /*============================================================================================*/
+    Gesture poll(uint32_t nowUs);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Drops a gesture in progress.
+    */
+    /*============================================================================================*/
+    void reset() { state = 0U; }
+
+    /* True while the current state ends by a timeout, i.e. poll() must be called again */
+    bool waitsForTimeout() const;
+
+    /* Number of times each gesture was recognized */
+    uint32_t count(Gesture gesture) const {
+        return (gesture < GESTURE_COUNT) ? counters[gesture] : 0U;
+    }
+
+private:
+    Gesture apply(uint8_t input, uint32_t timestampUs);
+    Gesture expire(uint32_t nowUs);
+
+    GestureTiming timing;
+    uint8_t state;
+    /* Timestamp of the last press or release */
+    uint32_t lastEdgeUs;
+    GestureAction actions[GESTURE_COUNT];
+    void* contexts[GESTURE_COUNT];
+    uint32_t counters[GESTURE_COUNT];
+};
+
+/*================================================================================================*/
+/**
+* @brief        Returns the name of a gesture (for logs and the console).
+*/
+/*================================================================================================*/
+const char* gestureName(Gesture gesture);
+
+#endif /* BTN_GESTURE_H */
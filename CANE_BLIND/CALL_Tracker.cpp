@@ -0,0 +1,333 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "CALL_Tracker.h"
+#include "Generic_API.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* +CLCC: <id>,<dir>,<stat>,<mode>,... field indexes and values (3GPP TS 27.007) */
+#define CLCC_FIELD_DIR            1U
+#define CLCC_FIELD_STAT           2U
+#define CLCC_FIELD_MODE           3U
+#define CLCC_DIR_MOBILE_ORIGINATED 0
+#define CLCC_MODE_VOICE           0
+#define CLCC_STAT_ACTIVE          0
+#define CLCC_STAT_DIALING         2
+#define CLCC_STAT_ALERTING        3
+#define CLCC_STAT_DISCONNECT      6
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Voice calls on the GSM module */
+CallTracker callTracker(gsmAtEngine);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Adds one sample to a latency record */
+static void recordLatency(CallLatency& latency, uint32_t valueMs) {
+    latency.lastMs = valueMs;
+    latency.totalMs += valueMs;
+    if (latency.count == 0U || valueMs < latency.minMs) {
+        latency.minMs = valueMs;
+    }
+    if (valueMs > latency.maxMs) {
+        latency.maxMs = valueMs;
+    }
+    latency.count++;
+}
+
+/* Prints one latency record */
+static void printLatency(Print& out, const char* name, const CallLatency& latency) {
+    if (latency.count == 0U) {
+        return;
+    }
+    out.printf("[CALL] %s last %lu, min %lu, avg %lu, max %lu ms\n", name,
+               (unsigned long)latency.lastMs, (unsigned long)latency.minMs,
+               (unsigned long)(latency.totalMs / latency.count), (unsigned long)latency.maxMs);
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the CallTracker class.
+*
+* @param[in]    engine      AT engine of the GSM module.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+CallTracker::CallTracker(AtEngine& engine)
+    : engine(engine), dialHandle(AT_INVALID_HANDLE), lateDialHandle(AT_INVALID_HANDLE),
+      hangUpHandle(AT_INVALID_HANDLE), callState(CALL_STATE_IDLE), reason(CALL_END_NONE),
+      ringTimeoutMs(CALL_RING_TIMEOUT_MS), dialledAtMs(0U), callReported(false),
+      disconnectSeen(false), disconnectAtMs(0U), stateHandler(NULL), stateContext(NULL) {
+    memset(&counters, 0, sizeof(counters));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Registers the +CLCC, BUSY, NO ANSWER and NO CARRIER handlers.
+* @details      The +CLCC reports need AT+CLCC=1 (part of the modem boot script). Without them
+*               the tracker still ends calls on the result codes, but never sees ALERTING.
+*
+* @param[in]    dispatcher  URC dispatcher of the GSM module.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void CallTracker::begin(UrcDispatcher& dispatcher) {
+    dispatcher.registerHandler(URC_CLCC, onClccUrc, this);
+    dispatcher.registerHandler(URC_NO_CARRIER, onEndUrc, this);
+    dispatcher.registerHandler(URC_BUSY, onEndUrc, this);
+    dispatcher.registerHandler(URC_NO_ANSWER, onEndUrc, this);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Places a voice call. Returns immediately.
+* @details      Calls are only placed for alerts, so ATD goes out as an urgent command: it is
+*               written ahead of queued SMS and queries and cancels an AT+CMGS still waiting
+*               for its prompt. When the ATD of the previous call has not answered yet, ATD
+*               goes out after it and the ATH that ended that call.
+*
+* @param[in]    phoneNumber     The number to call.
+*
+* @return       bool            False if a call is in progress or ATD could not be queued.
+*/
+/*================================================================================================*/
+bool CallTracker::dial(const char* phoneNumber) {
+    if (inProgress()) {
+        return false;
+    }
+    if (dialHandle != AT_INVALID_HANDLE) {
+        /* ATD of the call that just ended has not answered; ATH is queued behind it and the
+           new ATD goes behind ATH */
+        if (lateDialHandle != AT_INVALID_HANDLE) {
+            return false;
+        }
+        lateDialHandle = dialHandle;
+        dialHandle = AT_INVALID_HANDLE;
+    }
+    dialHandle = engine.submitUrgent(AT_CMD_DIAL, phoneNumber);
+    if (dialHandle == AT_INVALID_HANDLE) {
+        return false;
+    }
+    dialledAtMs = millis();
+    callReported = false;
+    disconnectSeen = false;
+    reason = CALL_END_NONE;
+    counters.dialled++;
+    enter(CALL_STATE_DIALING);
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Hangs up the call in progress, if any.
+* @details      The call ends at once; ATH is written after ATD has answered, if it has not.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void CallTracker::hangUp() {
+    if (!inProgress()) {
+        return;
+    }
+    sendHangUp();
+    end((callState == CALL_STATE_ACTIVE) ? CALL_END_HUNG_UP : CALL_END_NO_CARRIER);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Follows ATD and ATH and enforces the ring timeout; never blocks.
+* @details      ATD answering OK only means the module started the call; ERROR, or no answer
+*               at all while no +CLCC progress was seen, ends it as rejected.
+*
+* @return       CallState   Current state.
+*/
+/*================================================================================================*/
+CallState CallTracker::poll() {
+    uint32_t now = millis();
+
+    if (dialHandle != AT_INVALID_HANDLE) {
+        AtResult result = engine.result(dialHandle);
+        if (result != AT_RESULT_PENDING) {
+            engine.release(dialHandle);
+            dialHandle = AT_INVALID_HANDLE;
+            bool noProgress = (callState == CALL_STATE_DIALING);
+            if (result != AT_RESULT_OK && (result != AT_RESULT_TIMEOUT || noProgress)) {
+                if (inProgress()) {
+                    end(CALL_END_REJECTED);
+                }
+            }
+        }
+    }
+
+    if (lateDialHandle != AT_INVALID_HANDLE && engine.result(lateDialHandle) != AT_RESULT_PENDING) {
+        engine.release(lateDialHandle);
+        lateDialHandle = AT_INVALID_HANDLE;
+    }
+
+    if (hangUpHandle != AT_INVALID_HANDLE && engine.result(hangUpHandle) != AT_RESULT_PENDING) {
+        engine.release(hangUpHandle);
+        hangUpHandle = AT_INVALID_HANDLE;
+    }
+
+    if (disconnectSeen && (now - disconnectAtMs) >= CALL_DISCONNECT_GRACE_MS && inProgress()) {
+        /* The module reported the disconnect but no result code followed */
+        end((callState == CALL_STATE_ACTIVE) ? CALL_END_HUNG_UP : CALL_END_NO_CARRIER);
+    }
+
+    if ((callState == CALL_STATE_DIALING || callState == CALL_STATE_ALERTING) &&
+        (now - dialledAtMs) >= ringTimeoutMs) {
+        sendHangUp();
+        end(CALL_END_RING_TIMEOUT);
+    }
+    return callState;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sets the callback invoked on every state change (NULL to remove it).
+*/
+/*================================================================================================*/
+void CallTracker::setStateHandler(CallStateHandler handler, void* context) {
+    stateHandler = handler;
+    stateContext = context;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the call counters and setup latency.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void CallTracker::printStats(Print& out) const {
+    out.printf("[CALL] %lu dialled, %lu answered, %lu rejected, %lu busy, %lu not answered\n",
+               (unsigned long)counters.dialled, (unsigned long)counters.answered,
+               (unsigned long)counters.rejected, (unsigned long)counters.busy,
+               (unsigned long)counters.noAnswer);
+    printLatency(out, "dial to ringing", counters.toAlerting);
+    printLatency(out, "dial to answer ", counters.toAnswer);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* +CLCC: <id>,<dir>,<stat>,<mode>,<mpty>[,<number>,<type>] - progress of our voice call */
+void CallTracker::onClccUrc(const UrcEvent& event, void* context) {
+    CallTracker* self = static_cast<CallTracker*>(context);
+    if (event.fieldCount <= CLCC_FIELD_MODE || !self->inProgress() ||
+        UrcDispatcher::fieldToInt(event.fields[CLCC_FIELD_DIR], -1) != CLCC_DIR_MOBILE_ORIGINATED ||
+        UrcDispatcher::fieldToInt(event.fields[CLCC_FIELD_MODE], -1) != CLCC_MODE_VOICE) {
+        return;
+    }
+    /* While ATD or ATH of the previous call has not answered, the reports are of that call */
+    if (self->lateDialHandle != AT_INVALID_HANDLE || self->hangUpHandle != AT_INVALID_HANDLE) {
+        return;
+    }
+
+    switch (UrcDispatcher::fieldToInt(event.fields[CLCC_FIELD_STAT], -1)) {
+    case CLCC_STAT_DIALING:
+        self->callReported = true;
+        break;
+    case CLCC_STAT_ALERTING:
+        self->callReported = true;
+        if (self->callState == CALL_STATE_DIALING) {
+            recordLatency(self->counters.toAlerting, millis() - self->dialledAtMs);
+            self->enter(CALL_STATE_ALERTING);
+        }
+        break;
+    case CLCC_STAT_ACTIVE:
+        self->callReported = true;
+        if (self->callState != CALL_STATE_ACTIVE) {
+            recordLatency(self->counters.toAnswer, millis() - self->dialledAtMs);
+            self->counters.answered++;
+            self->enter(CALL_STATE_ACTIVE);
+        }
+        break;
+    case CLCC_STAT_DISCONNECT:
+        /* Before this call was reported, it is the previous call ending (e.g. the report of
+           the ATH that made way for this one) */
+        if (!self->callReported) {
+            break;
+        }
+        /* BUSY / NO ANSWER / NO CARRIER normally follows and gives the reason */
+        self->disconnectSeen = true;
+        self->disconnectAtMs = millis();
+        break;
+    default:
+        break;
+    }
+}
+
+/* BUSY, NO ANSWER, NO CARRIER - the call is over */
+void CallTracker::onEndUrc(const UrcEvent& event, void* context) {
+    CallTracker* self = static_cast<CallTracker*>(context);
+    if (!self->inProgress()) {
+        return;
+    }
+    /* A call can end before ATD has answered; the result code is then ATD's own, so nothing
+       more comes for it */
+    if (self->dialHandle != AT_INVALID_HANDLE) {
+        self->engine.release(self->dialHandle);
+        self->dialHandle = AT_INVALID_HANDLE;
+    }
+    if (event.type == URC_BUSY) {
+        self->end(CALL_END_BUSY);
+    } else if (event.type == URC_NO_ANSWER) {
+        self->end(CALL_END_NO_ANSWER);
+    } else {
+        self->end((self->callState == CALL_STATE_ACTIVE) ? CALL_END_HUNG_UP : CALL_END_NO_CARRIER);
+    }
+}
+
+/* Changes state, logs the transition and notifies the handler */
+void CallTracker::enter(CallState next) {
+    LOG_INFO("[CALL] state %u -> %u (reason %u)", (unsigned)callState, (unsigned)next,
+             (unsigned)reason);
+    callState = next;
+    if (stateHandler != NULL) {
+        stateHandler(callState, reason, stateContext);
+    }
+}
+
+/* Ends the call in progress with the given reason */
+void CallTracker::end(CallEndReason why) {
+    reason = why;
+    disconnectSeen = false;
+    switch (why) {
+    case CALL_END_REJECTED:
+        counters.rejected++;
+        break;
+    case CALL_END_BUSY:
+        counters.busy++;
+        break;
+    case CALL_END_NO_ANSWER:
+    case CALL_END_RING_TIMEOUT:
+    case CALL_END_NO_CARRIER:
+        counters.noAnswer++;
+        break;
+    default:
+        break;
+    }
+    enter(CALL_STATE_ENDED);
+}
+
+/* Queues ATH (urgent, like ATD); the result is collected by poll(). An ATD still waiting for
+   its answer is kept: urgent commands go out in order, so ATH is written once ATD answered
+   (or timed out) and the late OK of ATD is not taken for the one of ATH */
+void CallTracker::sendHangUp() {
+    if (hangUpHandle == AT_INVALID_HANDLE) {
+        hangUpHandle = engine.submitUrgent(AT_CMD_HANG_UP);
+    }
+}
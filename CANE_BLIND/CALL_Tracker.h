@@ -0,0 +1,210 @@
+#ifndef CALL_TRACKER_H
+#define CALL_TRACKER_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "AT_Engine.h"
+#include "URC_Dispatcher.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Default time from ATD until the call must be answered before it is hung up */
+#define CALL_RING_TIMEOUT_MS          30000UL
+
+/* Wait for BUSY / NO ANSWER / NO CARRIER after "+CLCC: ...,6" before ending anyway */
+#define CALL_DISCONNECT_GRACE_MS      1000UL
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* State of the outgoing call */
+typedef enum {
+    CALL_STATE_IDLE = 0,      /* No call placed yet */
+    CALL_STATE_DIALING,       /* ATD sent, the network is setting the call up */
+    CALL_STATE_ALERTING,      /* The called phone is ringing */
+    CALL_STATE_ACTIVE,        /* Answered */
+    CALL_STATE_ENDED          /* Over; see endReason() */
+} CallState;
+
+/* Why the last call ended */
+typedef enum {
+    CALL_END_NONE = 0,        /* Not ended */
+    CALL_END_REJECTED,        /* ATD answered ERROR or nothing (no network, bad number) */
+    CALL_END_BUSY,            /* BUSY */
+    CALL_END_NO_ANSWER,       /* NO ANSWER from the network */
+    CALL_END_RING_TIMEOUT,    /* Not answered within the ring timeout, hung up with ATH */
+    CALL_END_NO_CARRIER,      /* NO CARRIER before the call was answered */
+    CALL_END_HUNG_UP          /* Ended after being answered (by either side) */
+} CallEndReason;
+
+/* Called on every state change */
+typedef void (*CallStateHandler)(CallState state, CallEndReason reason, void* context);
+
+/* Min / max / sum of one latency (ms) */
+typedef struct {
+    uint32_t count;
+    uint32_t lastMs;
+    uint32_t minMs;
+    uint32_t maxMs;
+    uint32_t totalMs;
+} CallLatency;
+
+/* Call counters and setup latency */
+typedef struct {
+    uint32_t    dialled;      /* ATD sent */
+    uint32_t    answered;
+    uint32_t    rejected;
+    uint32_t    busy;
+    uint32_t    noAnswer;     /* NO ANSWER, ring timeout or NO CARRIER before answering */
+    CallLatency toAlerting;   /* ATD until the called phone rings */
+    CallLatency toAnswer;     /* ATD until the call is answered */
+} CallStats;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class CallTracker
+* @brief Non-blocking outgoing voice call state machine.
+* @details dial() queues ATD and returns. The progress comes from the +CLCC reports enabled
+* by AT+CLCC=1 (dialing, alerting, active, disconnected) and from the BUSY, NO ANSWER and
+* NO CARRIER result codes, all received as URCs. poll() hangs up a call that is not answered
+* within the ring timeout, so the caller can move on to another number. ATD and ATH are
+* urgent engine commands: they never wait behind queued SMS or queries, only for the command
+* already on the wire.
+*
+* @api
+*/
+/*================================================================================================*/
+class CallTracker {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the CallTracker class.
+    *
+    * @param[in]    engine      AT engine of the GSM module.
+    */
+    /*============================================================================================*/
+    CallTracker(AtEngine& engine);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Registers the +CLCC, BUSY, NO ANSWER and NO CARRIER handlers.
+    *
+    * @param[in]    dispatcher  URC dispatcher of the GSM module.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void begin(UrcDispatcher& dispatcher);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Places a voice call. Returns immediately.
+    *
+    * @param[in]    phoneNumber     The number to call.
+    *
+    * @return       bool            False if a call is in progress or ATD could not be queued.
+    */
+    /*============================================================================================*/
+    bool dial(const char* phoneNumber);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Hangs up the call in progress, if any.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void hangUp();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Follows ATD and ATH and enforces the ring timeout; never blocks.
+    *
+    * @return       CallState   Current state.
+    */
+    /*============================================================================================*/
+    CallState poll();
+
+    /* Current state, and why the last call ended */
+    CallState state() const { return callState; }
+    CallEndReason endReason() const { return reason; }
+
+    /* True from dial() until the call has ended */
+    bool inProgress() const {
+        return (callState == CALL_STATE_DIALING) || (callState == CALL_STATE_ALERTING) ||
+               (callState == CALL_STATE_ACTIVE);
+    }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Sets how long a call may ring before it is hung up (applies to later calls).
+    */
+    /*============================================================================================*/
+    void setRingTimeout(uint32_t timeoutMs) { ringTimeoutMs = timeoutMs; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Sets the callback invoked on every state change (NULL to remove it).
+    */
+    /*============================================================================================*/
+    void setStateHandler(CallStateHandler handler, void* context);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the call counters and setup latency.
+    */
+    /*============================================================================================*/
+    const CallStats& stats() const { return counters; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the call counters and setup latency.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+private:
+    static void onClccUrc(const UrcEvent& event, void* context);
+    static void onEndUrc(const UrcEvent& event, void* context);
+    void enter(CallState next);
+    void end(CallEndReason why);
+    void sendHangUp();
+
+    AtEngine& engine;
+    /* ATD and ATH in flight, or AT_INVALID_HANDLE */
+    AtHandle dialHandle;
+    /* ATD of an ended call still waiting for its answer when the next call was placed */
+    AtHandle lateDialHandle;
+    AtHandle hangUpHandle;
+    CallState callState;
+    CallEndReason reason;
+    uint32_t ringTimeoutMs;
+    /* millis() of dial() */
+    uint32_t dialledAtMs;
+    /* A +CLCC report of this call (dialing, alerting or active) was received */
+    bool callReported;
+    /* "+CLCC: ...,6" received and still waiting for its result code, and when */
+    bool disconnectSeen;
+    uint32_t disconnectAtMs;
+    CallStateHandler stateHandler;
+    void* stateContext;
+    CallStats counters;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Voice calls on the GSM module */
+extern CallTracker callTracker;
+
+#endif /* CALL_TRACKER_H */
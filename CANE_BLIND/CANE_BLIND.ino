@@ -2,11 +2,37 @@
 *                          INCLUDES
 ==================================================================================================*/
 #include <Arduino.h>
+#include <Wire.h>
 #include "GPS_Feature.h"
 #include "CALL_SOS_Feature.h"
 #include "SMS_Feature.h"
+#include "SMS_Outbox.h"
+#include "SOS_Contacts.h"
+#include "SMS_Commands.h"
+#include "CALL_Tracker.h"
 #include "WEB_Portal.h"
 #include "WIFI_Manager.h"
+#include "MODEM_Init.h"
+#include "MODEM_Link.h"
+#include "MODEM_RxTask.h"
+#include "TASK_Scheduler.h"
+
+/*==================================================================================================
+*                          MACROS
+==================================================================================================*/
+/* Tasklet periods (ms); the button and modem tasklets are also triggered by their events */
+#define PORTAL_TASKLET_PERIOD_MS    10U
+#define MODEM_TASKLET_PERIOD_MS     50U
+
+/* GNSS query interval once the fix is stable; faster while acquiring or moving (ms) */
+#define GNSS_STABLE_INTERVAL_MS     30000UL
+
+/* Tasklet deadlines: lateness beyond which a run is counted as a miss (ms) */
+#define BUTTON_TASKLET_DEADLINE_MS  10U
+#define MODEM_TASKLET_DEADLINE_MS   20U
+#define PORTAL_TASKLET_DEADLINE_MS  20U
+#define GNSS_TASKLET_DEADLINE_MS    100U
+#define LINK_TASKLET_DEADLINE_MS    100U
 
 /*==================================================================================================
 *                          GLOBAL VARIABLES
@@ -22,10 +48,109 @@ WifiManagerCustom wifiManager;
     */
 WebPortal portal(&wifiManager);
 
+/* Negotiates baud rate and flow control on gsmSerialPort */
+ModemLink modemLink(gsmSerialPort, gsmAtEngine);
+
+/* Drains gsmSerialPort on UART events and queues framed lines for the AT engine */
+ModemRxTask modemRxTask(gsmSerialPort);
+
+/* Runs the modem bring-up script on the AT engine */
+ModemInitRunner modemInit(gsmAtEngine);
+
+/* Modem bring-up script: each step is sent as soon as the previous one has answered */
+static const ModemInitStep MODEM_BOOT_SCRIPT[] = {
+  /* Columns: command, probe, text expected in probe response, retries, required */
+  /* Test communication with GSM module (retried while the module boots) */
+  { &AT_CMD_ATTENTION,       NULL,                         NULL,                 20, true  },
+  /* Disable command echo */
+  { &AT_CMD_ECHO_OFF,        NULL,                         NULL,                 2,  true  },
+  /* Set character set to GSM */
+  { &AT_CMD_CHARSET_GSM,     &AT_CMD_CHARSET_QUERY,        "\"GSM\"",            2,  true  },
+  /* Set SMS mode to text */
+  { &AT_CMD_SMS_TEXT_MODE,   &AT_CMD_SMS_MODE_QUERY,       "+CMGF: 1",           2,  true  },
+  /* Configure new message indications: display directly on Serial */
+  { &AT_CMD_SMS_INDICATION,  &AT_CMD_SMS_INDICATION_QUERY, "+CNMI: 2,2,0,0,0",   2,  true  },
+  /* Enable Caller Line Identification Presentation (CLIP) */
+  { &AT_CMD_CLIP_ON,         &AT_CMD_CLIP_QUERY,           "+CLIP: 1",           2,  false },
+  /* Report call progress as +CLCC URCs (dialing, alerting, active, disconnected) */
+  { &AT_CMD_CALL_REPORT_ON,  &AT_CMD_CALL_REPORT_QUERY,    "+CLCC: 1",           2,  false },
+  /* Test signal quality */
+  { &AT_CMD_SIGNAL_QUALITY,  NULL,                         NULL,                 0,  false },
+  /* Report signal quality changes as +CSQ URCs */
+  { &AT_CMD_AUTO_CSQ_ON,     &AT_CMD_AUTO_CSQ_QUERY,       "+AUTOCSQ: 1,1",      1,  false },
+  /* Power the GNSS receiver so AT+CGPSINFO reports a position */
+  { &AT_CMD_GNSS_POWER_ON,   &AT_CMD_GNSS_POWER_QUERY,     "+CGPS: 1",           1,  false },
+};
+
 /* Global variable to track WiFi connection status */
 bool wifiConnectedStatus = false;
 String connectedSSID = "";
 
+/* Tasklets woken by events (button edges, modem lines) */
+static TaskletId buttonTasklet = TASKLET_INVALID_ID;
+static TaskletId modemTasklet = TASKLET_INVALID_ID;
+
+/* Tasklet that reschedules itself at the time the GNSS poller asks for */
+static TaskletId gnssTasklet = TASKLET_INVALID_ID;
+
+/*==================================================================================================
+*                          TASKLETS
+==================================================================================================*/
+/* Button interrupt: run the button tasklet now */
+static void IRAM_ATTR wakeButtonTasklet(void* context) {
+  loopScheduler.trigger(buttonTasklet);
+}
+
+/* Modem RX task queued lines: run the modem tasklet now */
+static void wakeModemTasklet(void* context) {
+  loopScheduler.trigger(modemTasklet);
+}
+
+/* Gestures of the SOS button and the beeps acknowledging them; runs on button edges and comes
+   back only while a press settles, a gesture waits for its timeout or a beep pattern plays */
+static void runButtonTasklet(void* context) {
+  uint32_t nextMs = serviceSosButton() ? SOS_BUTTON_RECHECK_MS : 0U;
+  uint32_t beepMs = serviceBuzzer();
+  if (beepMs > 0U && (nextMs == 0U || beepMs < nextMs)) {
+    nextMs = beepMs;
+  }
+  if (nextMs > 0U) {
+    loopScheduler.runIn(buttonTasklet, nextMs);
+  }
+
+  /* Commands queued by a gesture (the alert) are written by the modem tasklet */
+  if (!gsmAtEngine.isIdle()) {
+    loopScheduler.trigger(modemTasklet);
+  }
+}
+
+/* AT engine, console passthrough and everything following modem results: the alert, SMS
+   commands, the outbox and call progress; runs on modem lines and for their timeouts */
+static void runModemTasklet(void* context) {
+  handleATPassthrough();
+  serviceSosAlert();
+  smsCommands.poll();
+  smsOutbox.poll();
+  callTracker.poll();
+}
+
+/* HTTP requests: the configuration portal in AP mode, '/stats' in either mode */
+static void runPortalTasklet(void* context) {
+  portal.handleClient();
+}
+
+/* GNSS queries, at the rate the fix state calls for */
+static void runGnssTasklet(void* context) {
+  uint32_t waitMs = requestGpsLocation(systemCurrentTimeMs, GNSS_STABLE_INTERVAL_MS,
+                                       DEBUG_MODE_ENABLED);
+  loopScheduler.runIn(gnssTasklet, waitMs);
+}
+
+/* Modem link throughput */
+static void runLinkTasklet(void* context) {
+  modemLink.sample();
+}
+
 /****************************************************************************************
  *  Function Name    : setup
  *  Description      : Arduino system initialization function. It is executed once at 
@@ -45,11 +170,18 @@ void setup() {
   /* Initialize the debug serial port at baud rate 115200 */
   Serial.begin(115200);
 
+  /* Start the log drain task; LOG_* calls only queue binary records from here on */
+  systemLog.begin(Serial);
+
   Wire.begin(21, 22); /* Init I2C with SDA=21, SCL=22 */
 
   /* Configure the button pin as input with an internal  pull-up resistor */
   pinMode(BUTTON_PIN, INPUT);
 
+  /* Record button edges by interrupt and bind the gestures from here on */
+  initSosButton();
+  sosButton.setEdgeListener(wakeButtonTasklet, NULL);
+
   /* Configure the buzzer pin as output and set its initial state to LOW */
   pinMode(BUZZER_PIN, OUTPUT); /* Set buzzer pin as output */
 
@@ -62,30 +194,47 @@ void setup() {
   Serial.print(F("Hello! AT command Start Init"));
 
 
-  /* Initialize the GSM/GNSS serial port (UART2) with baud rate 115200, 
-       8 data bits, no parity, 1 stop bit, and assigned RX/TX pins */
-  gsmSerialPort.begin(115200, SERIAL_8N1, PIN_GSM_UART_RECEIVE, PIN_GSM_UART_TRANSMIT);
+  /* Echo modem lines that no pending command claims and act on known URCs */
+  initGsmUrcHandlers();
+  callTracker.begin(gsmUrcDispatcher);
+  gsmAtEngine.setUnsolicitedHandler(dispatchGsmLine, NULL);
 
-  /* Test communication with GSM module */
-  sendGsmCommand("AT", GSM_COMMAND_WAIT_MS);
+  /* Open the GSM/GNSS serial port (UART1), wait for the module to boot and move it to the
+       fastest rate it answers reliably, with RTS/CTS when the pins are wired */
+  if (!modemLink.begin(PIN_GSM_UART_RECEIVE, PIN_GSM_UART_TRANSMIT, PIN_GSM_UART_RTS,
+                       PIN_GSM_UART_CTS)) {
+    Serial.println("[LINK] Module not answering: staying at 115200 baud without flow control");
+  }
+  modemLink.printStats(Serial);
 
-  /* Disable command echo */
-  sendGsmCommand("ATE0", GSM_COMMAND_WAIT_MS);
+  /* From now on modem bytes are read by the RX task as soon as they arrive */
+  modemRxTask.setLineListener(wakeModemTasklet, NULL);
+  if (modemRxTask.start()) {
+    gsmAtEngine.setLineSource(&modemRxTask);
+  }
 
-  /* Set character set to GSM */
-  sendGsmCommand("AT+CSCS=\"GSM\"", GSM_COMMAND_WAIT_MS);
+  /* Bring up the modem: every step is sent as soon as the previous one answered */
+  modemInit.begin(MODEM_BOOT_SCRIPT, sizeof(MODEM_BOOT_SCRIPT) / sizeof(MODEM_BOOT_SCRIPT[0]));
+  while (!modemInit.poll()) {
+    delay(1);
+  }
 
-  /* Set SMS mode to text */
-  sendGsmCommand("AT+CMGF=1", GSM_COMMAND_WAIT_MS);
+  /* Report per-step and total time-to-ready */
+  modemInit.printReport(Serial);
 
-  /* Configure new message indications: display directly on Serial */
-  sendGsmCommand("AT+CNMI=2,2,0,0,0", GSM_COMMAND_WAIT_MS);
+  /* Resend messages that were still queued when the device last went down */
+  smsOutbox.begin();
 
-  /* Enable Caller Line Identification Presentation (CLIP) */
-  sendGsmCommand("AT+CLIP=1", GSM_COMMAND_WAIT_MS);
+  /* Load the emergency contacts (SOS_PHONE_NUMBER until some are configured) */
+  sosContacts.begin();
+  sosContacts.print(Serial);
 
-  /* Test signal quality */
-  sendGsmCommand("AT+CSQ", GSM_COMMAND_WAIT_MS);
+  /* Last location known before the restart, sent at once if SOS fires before a fix */
+  locationCache.begin();
+  locationCache.print(Serial);
+
+  /* Answer WHERE / STATUS messages from the contacts (replaces the default +CMT handler) */
+  smsCommands.begin(gsmUrcDispatcher);
 
   /* Print message indicating the start of LTE CAT1 test */
   Serial.println("ESP32-S3 4G LTE CAT1 complete init!");
@@ -114,21 +263,40 @@ void setup() {
 
     /* Log the success message. The device is now ready for its main application logic. */
     Serial.println("WiFi Connected OK!");
+
+    /* Keep the modem statistics ('/stats') reachable on the joined network. */
+    portal.startStatsServer();
   }
 
 
   /* Beep the buzzer twice to indicate system initialization is complete */
   beepBuzzer(10);
+
+  /* Register the work of loop(); tasklets run in this order when due together */
+  loopScheduler.begin();
+  buttonTasklet = loopScheduler.add("button", runButtonTasklet, NULL, 0U, BUTTON_TASKLET_DEADLINE_MS);
+  modemTasklet = loopScheduler.add("modem", runModemTasklet, NULL, MODEM_TASKLET_PERIOD_MS,
+                                   MODEM_TASKLET_DEADLINE_MS);
+  loopScheduler.add("portal", runPortalTasklet, NULL, PORTAL_TASKLET_PERIOD_MS,
+                    PORTAL_TASKLET_DEADLINE_MS);
+  gnssTasklet = loopScheduler.add("gnss", runGnssTasklet, NULL, 0U, GNSS_TASKLET_DEADLINE_MS);
+  loopScheduler.add("link", runLinkTasklet, NULL, MODEM_LINK_SAMPLE_MS, LINK_TASKLET_DEADLINE_MS);
+
+  /* Presses made during setup are waiting in the edge queue; the first GNSS query is due now */
+  loopScheduler.trigger(buttonTasklet);
+  loopScheduler.trigger(gnssTasklet);
 }
 
 /****************************************************************************************
  *  Function Name    : loop
- *  Description      : Arduino main execution loop. This function runs continuously after 
- *                     system initialization. It periodically requests GNSS (GPS) information 
- *                     from the GSM/GNSS module every 30 seconds and generates a Google Maps 
- *                     URL from the response. In addition, it forwards data between the debug 
- *                     Serial (USB) and the GSM serial port, enabling transparent communication 
- *                     for debugging and testing.
+ *  Description      : Arduino main execution loop. Runs the tasklets registered in setup()
+ *                     that are due: the SOS button and buzzer (on button edges), the AT
+ *                     engine with console passthrough, SOS alert, SMS and call progress (on
+ *                     modem lines and every 50 ms), the web portal ('/stats', and the
+ *                     configuration in AP mode), the GNSS queries (every 2 s without a fix,
+ *                     5 s while moving, 30 s once stable) and the link throughput sample.
+ *                     Then the loop task sleeps exactly until the next tasklet is due or an
+ *                     event triggers one. "!stats" prints the run time and lateness of each.
  *
  *  Input Parameters :
  *    None
@@ -137,18 +305,5 @@ void setup() {
  *    None
  ****************************************************************************************/
 void loop() {
-
-  /* If the Web Portal is running (device is in AP mode), this continuously services 
-   incoming DNS and HTTP requests from the connected client (e.g., a phone/laptop). 
-   This ensures the portal page loads and the Save button works. 
-    */
-  portal.handleClient();
-
-  /* Call the GPS request handler function */
-  requestGpsLocation(systemCurrentTimeMs, 30000UL, DEBUG_MODE_ENABLED);
-
-  handleCallAndATPassthrough(BUTTON_PIN, DEBUG_MODE_ENABLED,
-                             wifiConnectedStatus, connectedSSID.c_str());
-
-  delay(175);
-}
\ No newline at end of file
+  loopScheduler.runOnce();
+}
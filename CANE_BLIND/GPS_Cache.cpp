@@ -0,0 +1,192 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "GPS_Cache.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Last known location of the device */
+LocationCache locationCache;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Horizontal error estimate from the HDOP (m), 0 if the HDOP is unknown */
+static uint16_t accuracyFromHdop(uint16_t hdopX100) {
+    if (hdopX100 == 0U) {
+        return 0U;
+    }
+    uint32_t metres = ((uint32_t)hdopX100 * LOCATION_UERE_M + 50U) / 100U;
+    if (metres == 0U) {
+        return 1U;
+    }
+    return (metres > UINT16_MAX) ? (uint16_t)UINT16_MAX : (uint16_t)metres;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the LocationCache class.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+LocationCache::LocationCache()
+    : known(false), fromThisBoot(false), fixMs(0U), savedThisBoot(false), savedMs(0U),
+      saves(0U) {
+    memset(&record, 0, sizeof(record));
+    memset(&savedPosition, 0, sizeof(savedPosition));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Loads the location stored before the last restart, if any.
+*
+* @return       bool        True if a location was loaded.
+*/
+/*================================================================================================*/
+bool LocationCache::begin() {
+    /* Opening a namespace read-only fails until something was written to it */
+    if (prefs.begin(LOCATION_CACHE_NAMESPACE, true)) {
+        LocationRecord stored;
+        if (prefs.getBytesLength("fix") == sizeof(stored)) {
+            prefs.getBytes("fix", &stored, sizeof(stored));
+            if (geoIsValid(stored.position)) {
+                record = stored;
+                savedPosition = stored.position;
+                known = true;
+                fromThisBoot = false;
+            }
+        }
+        prefs.end();
+    }
+    return known;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Takes a fix; invalid fixes are ignored.
+* @details      The fix replaces the cached location at once; it is written to NVS only for the
+*               first fix since boot, after a move of LOCATION_SAVE_DISTANCE_M or once the
+*               stored one is LOCATION_SAVE_INTERVAL_MS old.
+*
+* @param[in]    fix         Fix decoded by a GnssParser.
+*
+* @return       bool        True if the fix was valid and is now the cached location.
+*/
+/*================================================================================================*/
+bool LocationCache::update(const GnssFix& fix) {
+    if (!fix.valid || !geoIsValid(fix.position)) {
+        return false;
+    }
+    record.position = fix.position;
+    record.accuracyM = accuracyFromHdop(fix.hdopX100);
+    record.utcDate = fix.utcDate;
+    record.utcTimeMs = fix.utcTimeMs;
+    known = true;
+    fromThisBoot = true;
+    fixMs = (fix.updatedMs != 0U) ? fix.updatedMs : millis();
+
+    if (!savedThisBoot ||
+        geoDistanceM(savedPosition, record.position) >= LOCATION_SAVE_DISTANCE_M ||
+        millis() - savedMs >= LOCATION_SAVE_INTERVAL_MS) {
+        save();
+    }
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the age of the cached location.
+*
+* @return       uint32_t    Seconds since the fix, or LOCATION_AGE_UNKNOWN for a location
+*                           loaded from NVS (or none at all).
+*/
+/*================================================================================================*/
+uint32_t LocationCache::ageSeconds() const {
+    if (!known || !fromThisBoot) {
+        return LOCATION_AGE_UNKNOWN;
+    }
+    return (millis() - fixMs) / 1000U;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Describes age and accuracy for a message, e.g. "3 min old, accuracy 15 m".
+*
+* @param[out]   out         Destination, at least LOCATION_DESCRIPTION_MAX_LEN + 1 bytes.
+* @param[in]    size        Size of out.
+*
+* @return       size_t      Length written.
+*/
+/*================================================================================================*/
+size_t LocationCache::describe(char* out, size_t size) const {
+    if (size == 0U) {
+        return 0U;
+    }
+    int length;
+    if (fromThisBoot) {
+        uint32_t ageS = ageSeconds();
+        if (ageS < 120U) {
+            length = snprintf(out, size, "%lu s old", (unsigned long)ageS);
+        } else if (ageS < 7200U) {
+            length = snprintf(out, size, "%lu min old", (unsigned long)(ageS / 60U));
+        } else {
+            length = snprintf(out, size, "%lu h old", (unsigned long)(ageS / 3600U));
+        }
+    } else if (record.utcDate != 0U) {
+        uint32_t minutes = record.utcTimeMs / 60000UL;
+        length = snprintf(out, size, "%02lu/%02lu %02lu:%02lu UTC",
+                          (unsigned long)(record.utcDate / 10000UL),
+                          (unsigned long)((record.utcDate / 100UL) % 100UL),
+                          (unsigned long)(minutes / 60U), (unsigned long)(minutes % 60U));
+    } else {
+        length = snprintf(out, size, "before restart");
+    }
+
+    if (length >= 0 && record.accuracyM != 0U && (size_t)length < size) {
+        int extra = snprintf(&out[length], size - (size_t)length, ", accuracy %u m",
+                             (unsigned)record.accuracyM);
+        length = (extra < 0) ? length : length + extra;
+    }
+    return (length < 0) ? 0U : ((size_t)length < size ? (size_t)length : size - 1U);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the cached location, its age, accuracy and the NVS writes.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void LocationCache::print(Print& out) const {
+    if (!known) {
+        out.printf("[GNSS] no known location, %lu NVS writes\n", (unsigned long)saves);
+        return;
+    }
+    char link[GEO_MAP_LINK_MAX_LEN + 1U];
+    char description[LOCATION_DESCRIPTION_MAX_LEN + 1U];
+    geoFormatMapLink(record.position, link, sizeof(link));
+    describe(description, sizeof(description));
+    out.printf("[GNSS] last known %s (%s), %lu NVS writes\n", link, description,
+               (unsigned long)saves);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Writes the cached location to NVS */
+void LocationCache::save() {
+    prefs.begin(LOCATION_CACHE_NAMESPACE, false);
+    prefs.putBytes("fix", &record, sizeof(record));
+    prefs.end();
+    savedPosition = record.position;
+    savedThisBoot = true;
+    savedMs = millis();
+    saves++;
+}
@@ -0,0 +1,146 @@
+#ifndef GPS_CACHE_H
+#define GPS_CACHE_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <Preferences.h>
+#include "GPS_Nmea.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* NVS namespace of the last known location */
+#define LOCATION_CACHE_NAMESPACE      "location"
+
+/* User equivalent range error of an autonomous GNSS fix; accuracy = HDOP x UERE (m) */
+#define LOCATION_UERE_M               5U
+
+/* The cached location is written to NVS when it moved this far from the stored one (m)... */
+#define LOCATION_SAVE_DISTANCE_M      100U
+
+/* ...or when the stored one is this old; bounds the flash writes of a device at rest (ms) */
+#define LOCATION_SAVE_INTERVAL_MS     900000UL
+
+/* Longest description written by describe(), without the terminator */
+#define LOCATION_DESCRIPTION_MAX_LEN  40U
+
+/* Age reported when it cannot be known (a fix from before the last restart) */
+#define LOCATION_AGE_UNKNOWN          UINT32_MAX
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Last valid fix, as kept in RAM and NVS */
+typedef struct {
+    GeoCoord position;      /* Position of the fix */
+    uint16_t accuracyM;     /* Estimated horizontal error (m), 0 if unknown */
+    uint32_t utcDate;       /* UTC date of the fix as ddmmyy, 0 if unknown */
+    uint32_t utcTimeMs;     /* UTC time of day of the fix (ms since midnight) */
+} LocationRecord;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class LocationCache
+* @brief Last known good location, with its age and accuracy, kept across restarts.
+* @details update() keeps every valid fix in RAM and writes it to NVS when the position
+* moved LOCATION_SAVE_DISTANCE_M from the stored one or the stored one is older than
+* LOCATION_SAVE_INTERVAL_MS, so a device at rest does not wear the flash. The age of a fix
+* taken since boot is measured with millis(); a fix loaded from NVS only carries its UTC time,
+* which describe() prints instead of an age.
+*
+* @api
+*/
+/*================================================================================================*/
+class LocationCache {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the LocationCache class.
+    */
+    /*============================================================================================*/
+    LocationCache();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Loads the location stored before the last restart, if any.
+    *
+    * @return       bool        True if a location was loaded.
+    */
+    /*============================================================================================*/
+    bool begin();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Takes a fix; invalid fixes are ignored.
+    *
+    * @param[in]    fix         Fix decoded by a GnssParser.
+    *
+    * @return       bool        True if the fix was valid and is now the cached location.
+    */
+    /*============================================================================================*/
+    bool update(const GnssFix& fix);
+
+    /* True once a location is known (from this boot or from NVS) */
+    bool hasLocation() const { return known; }
+
+    /* Cached location; meaningful only when hasLocation() */
+    const LocationRecord& location() const { return record; }
+
+    /* True if the cached location was measured since boot */
+    bool isFromThisBoot() const { return fromThisBoot; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the age of the cached location.
+    *
+    * @return       uint32_t    Seconds since the fix, or LOCATION_AGE_UNKNOWN for a location
+    *                           loaded from NVS (or none at all).
+    */
+    /*============================================================================================*/
+    uint32_t ageSeconds() const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Describes age and accuracy for a message, e.g. "3 min old, accuracy 15 m".
+    * @details      A location from before the restart is described by its UTC time instead
+    *               ("16/10 08:41 UTC"), or as "before restart" without one. The accuracy is
+    *               left out when unknown. Plain ASCII, so the text stays in the GSM alphabet.
+    *
+    * @param[out]   out         Destination, at least LOCATION_DESCRIPTION_MAX_LEN + 1 bytes.
+    * @param[in]    size        Size of out.
+    *
+    * @return       size_t      Length written.
+    */
+    /*============================================================================================*/
+    size_t describe(char* out, size_t size) const;
+
+    /* Prints the cached location, its age, accuracy and the NVS writes */
+    void print(Print& out) const;
+
+private:
+    void save();
+
+    Preferences prefs;
+    LocationRecord record;
+    bool known;
+    bool fromThisBoot;
+    uint32_t fixMs;             /* millis() of the fix, valid when fromThisBoot */
+
+    /* Last record written to NVS */
+    GeoCoord savedPosition;
+    bool savedThisBoot;
+    uint32_t savedMs;
+    uint32_t saves;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+extern LocationCache locationCache;     /* Last known location of the device */
+
+#endif /* GPS_CACHE_H */
@@ -0,0 +1,249 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "GPS_Coord.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+#define GEO_E6                    1000000L
+
+/* Metres per millionth of a degree of a great circle (mean Earth radius 6371008.8 m) x 1e6 */
+#define GEO_METRES_PER_E6_X1E6    111195ULL
+
+/* Fixed-point unit of the cosine table */
+#define GEO_Q15_ONE               32768U
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* cos(d) x 32768 for d = 0..90 degrees */
+static const uint16_t GEO_COSINE_Q15[91] = {
+    32768, 32763, 32748, 32723, 32688, 32643, 32588, 32524, 32449, 32365,
+    32270, 32166, 32052, 31928, 31795, 31651, 31499, 31336, 31164, 30983,
+    30792, 30592, 30382, 30163, 29935, 29698, 29452, 29197, 28932, 28660,
+    28378, 28088, 27789, 27482, 27166, 26842, 26510, 26170, 25822, 25466,
+    25102, 24730, 24351, 23965, 23571, 23170, 22763, 22348, 21926, 21498,
+    21063, 20622, 20174, 19720, 19261, 18795, 18324, 17847, 17364, 16877,
+    16384, 15886, 15384, 14876, 14365, 13848, 13328, 12803, 12275, 11743,
+    11207, 10668, 10126,  9580,  9032,  8481,  7927,  7371,  6813,  6252,
+     5690,  5126,  4560,  3993,  3425,  2856,  2286,  1715,  1144,   572,
+        0
+};
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* cos(latitude) x 32768, interpolated between whole degrees */
+static uint32_t cosineQ15(int32_t latitudeE6) {
+    uint32_t magnitude = (latitudeE6 < 0) ? (uint32_t)(-(int64_t)latitudeE6) : (uint32_t)latitudeE6;
+    uint32_t degrees = magnitude / GEO_E6;
+    if (degrees >= 90U) {
+        return 0U;
+    }
+    uint32_t fraction = magnitude % GEO_E6;
+    uint32_t step = GEO_COSINE_Q15[degrees] - GEO_COSINE_Q15[degrees + 1U];
+    return GEO_COSINE_Q15[degrees] - (step * fraction) / GEO_E6;
+}
+
+/* Floor of the square root */
+static uint64_t squareRoot(uint64_t value) {
+    uint64_t root = 0U;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0U) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/* East and north offsets from one position to the other, in millionths of a degree of a
+   great circle; the east offset is scaled by the cosine of the mean latitude */
+static void flatOffsets(const GeoCoord& from, const GeoCoord& to, int64_t* east, int64_t* north) {
+    int64_t deltaLongitude = (int64_t)to.longitudeE6 - from.longitudeE6;
+    if (deltaLongitude > 180LL * GEO_E6) {
+        deltaLongitude -= 360LL * GEO_E6;
+    } else if (deltaLongitude < -180LL * GEO_E6) {
+        deltaLongitude += 360LL * GEO_E6;
+    }
+    int32_t meanLatitude = (int32_t)(((int64_t)from.latitudeE6 + to.latitudeE6) / 2);
+    *east = deltaLongitude * (int64_t)cosineQ15(meanLatitude) / (int64_t)GEO_Q15_ONE;
+    *north = (int64_t)to.latitudeE6 - from.latitudeE6;
+}
+
+/* Appends a string; false if it does not fit with the terminator */
+static bool appendText(char* out, size_t size, size_t* length, const char* text) {
+    size_t textLength = strlen(text);
+    if (*length + textLength >= size) {
+        return false;
+    }
+    memcpy(&out[*length], text, textLength);
+    *length += textLength;
+    return true;
+}
+
+/* Appends millionths of a degree as a decimal with 6 digits after the point */
+static bool appendDegrees(char* out, size_t size, size_t* length, int32_t valueE6) {
+    char digits[12];
+    uint8_t index = sizeof(digits);
+    uint32_t magnitude = (valueE6 < 0) ? (uint32_t)(-(int64_t)valueE6) : (uint32_t)valueE6;
+
+    digits[--index] = '\0';
+    for (uint8_t i = 0; i < 6U; i++) {
+        digits[--index] = (char)('0' + magnitude % 10U);
+        magnitude /= 10U;
+    }
+    digits[--index] = '.';
+    do {
+        digits[--index] = (char)('0' + magnitude % 10U);
+        magnitude /= 10U;
+    } while (magnitude != 0U);
+    if (valueE6 < 0) {
+        digits[--index] = '-';
+    }
+    return appendText(out, size, length, &digits[index]);
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Returns true if both components are within their range.
+*
+* @param[in]    coord       Position to check.
+*
+* @return       bool        True for a valid position.
+*
+* @api
+*/
+/*================================================================================================*/
+bool geoIsValid(const GeoCoord& coord) {
+    return coord.latitudeE6 >= -90L * GEO_E6 && coord.latitudeE6 <= 90L * GEO_E6 &&
+           coord.longitudeE6 >= -180L * GEO_E6 && coord.longitudeE6 <= 180L * GEO_E6;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Distance between two positions, in integer arithmetic.
+* @details      Equirectangular approximation: the longitude difference is scaled by the
+*               cosine of the mean latitude (table, linear interpolation) and the length of the
+*               offset is taken with an integer square root.
+*
+* @param[in]    from        First position.
+* @param[in]    to          Second position.
+*
+* @return       uint32_t    Distance (m), saturated at UINT32_MAX.
+*
+* @api
+*/
+/*================================================================================================*/
+uint32_t geoDistanceM(const GeoCoord& from, const GeoCoord& to) {
+    int64_t east;
+    int64_t north;
+    flatOffsets(from, to, &east, &north);
+    uint64_t lengthE6 = squareRoot((uint64_t)(east * east) + (uint64_t)(north * north));
+    uint64_t metres = (lengthE6 * GEO_METRES_PER_E6_X1E6 + (uint64_t)GEO_E6 / 2U) / (uint64_t)GEO_E6;
+    return (metres > UINT32_MAX) ? UINT32_MAX : (uint32_t)metres;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Initial bearing from one position to another, in integer arithmetic.
+* @details      The angle inside the octant comes from atan(r) ~ 45 r + 15.64 r (1 - r)
+*               degrees (r <= 1, error below 0.25 degrees), then is unfolded to the quadrant.
+*
+* @param[in]    from        Start position.
+* @param[in]    to          Target position.
+*
+* @return       uint16_t    Degrees clockwise from north, 0..359; 0 for equal positions.
+*
+* @api
+*/
+/*================================================================================================*/
+uint16_t geoBearingDeg(const GeoCoord& from, const GeoCoord& to) {
+    int64_t east;
+    int64_t north;
+    flatOffsets(from, to, &east, &north);
+    if (east == 0 && north == 0) {
+        return 0U;
+    }
+
+    uint64_t absEast = (east < 0) ? (uint64_t)(-east) : (uint64_t)east;
+    uint64_t absNorth = (north < 0) ? (uint64_t)(-north) : (uint64_t)north;
+    bool steep = absEast > absNorth;
+    uint64_t small = steep ? absNorth : absEast;
+    uint64_t large = steep ? absEast : absNorth;
+
+    /* Angle from the nearer axis in hundredths of a degree, ratio in Q15 */
+    uint32_t ratio = (uint32_t)((small * GEO_Q15_ONE) / large);
+    uint32_t centiDegrees = (4500U * ratio + (1564U * ratio / GEO_Q15_ONE) * (GEO_Q15_ONE - ratio)) /
+                            GEO_Q15_ONE;
+    if (steep) {
+        centiDegrees = 9000U - centiDegrees;
+    }
+    if (north < 0) {
+        centiDegrees = 18000U - centiDegrees;
+    }
+    if (east < 0) {
+        centiDegrees = 36000U - centiDegrees;
+    }
+    uint16_t degrees = (uint16_t)((centiDegrees + 50U) / 100U);
+    return (degrees >= 360U) ? (uint16_t)(degrees - 360U) : degrees;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Writes the Google Maps link of a position into a buffer.
+*
+* @param[in]    coord       Position.
+* @param[out]   out         Destination, always terminated when size > 0.
+* @param[in]    size        Size of out; GEO_MAP_LINK_MAX_LEN + 1 always fits.
+*
+* @return       size_t      Length written, 0 if the link did not fit (out is then "").
+*
+* @api
+*/
+/*================================================================================================*/
+size_t geoFormatMapLink(const GeoCoord& coord, char* out, size_t size) {
+    return geoFormatMessage("", coord, out, size);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Writes a text followed by the Google Maps link of a position into a buffer.
+*
+* @param[in]    prefix      Text before the link (e.g. "SOS! My location: ").
+* @param[in]    coord       Position.
+* @param[out]   out         Destination, always terminated when size > 0.
+* @param[in]    size        Size of out.
+*
+* @return       size_t      Length written, 0 if the text did not fit (out is then "").
+*
+* @api
+*/
+/*================================================================================================*/
+size_t geoFormatMessage(const char* prefix, const GeoCoord& coord, char* out, size_t size) {
+    if (size == 0U) {
+        return 0U;
+    }
+    size_t length = 0U;
+    if (!appendText(out, size, &length, prefix) ||
+        !appendText(out, size, &length, GEO_MAP_LINK_PREFIX) ||
+        !appendDegrees(out, size, &length, coord.latitudeE6) ||
+        !appendText(out, size, &length, ",") ||
+        !appendDegrees(out, size, &length, coord.longitudeE6)) {
+        out[0] = '\0';
+        return 0U;
+    }
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,108 @@
+#ifndef GPS_COORD_H
+#define GPS_COORD_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Google Maps query link; the coordinates follow with 6 decimals */
+#define GEO_MAP_LINK_PREFIX       "https://www.google.com/maps?q="
+
+/* Longest map link, without the terminator: prefix, "-90.000000", "," and "-180.000000" */
+#define GEO_MAP_LINK_MAX_LEN      (sizeof(GEO_MAP_LINK_PREFIX) - 1U + 10U + 1U + 11U)
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* WGS84 position in millionths of a degree (about 0.11 m of latitude) */
+typedef struct {
+    int32_t latitudeE6;     /* North positive, -90000000 .. 90000000 */
+    int32_t longitudeE6;    /* East positive, -180000000 .. 180000000 */
+} GeoCoord;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Returns true if both components are within their range.
+*
+* @param[in]    coord       Position to check.
+*
+* @return       bool        True for a valid position.
+*
+* @api
+*/
+/*================================================================================================*/
+bool geoIsValid(const GeoCoord& coord);
+
+/*================================================================================================*/
+/**
+* @brief        Distance between two positions, in integer arithmetic.
+* @details      Equirectangular approximation with the cosine of the mean latitude from a
+*               table; within 1 % (plus the rounding to the metre) of the great circle up to
+*               about 50 km, which covers fix drift and walking distances.
+*
+* @param[in]    from        First position.
+* @param[in]    to          Second position.
+*
+* @return       uint32_t    Distance (m), saturated at UINT32_MAX.
+*
+* @api
+*/
+/*================================================================================================*/
+uint32_t geoDistanceM(const GeoCoord& from, const GeoCoord& to);
+
+/*================================================================================================*/
+/**
+* @brief        Initial bearing from one position to another, in integer arithmetic.
+* @details      Same flat approximation as geoDistanceM(); within 1 degree over the same
+*               range, rounding included.
+*
+* @param[in]    from        Start position.
+* @param[in]    to          Target position.
+*
+* @return       uint16_t    Degrees clockwise from north, 0..359; 0 for equal positions.
+*
+* @api
+*/
+/*================================================================================================*/
+uint16_t geoBearingDeg(const GeoCoord& from, const GeoCoord& to);
+
+/*================================================================================================*/
+/**
+* @brief        Writes the Google Maps link of a position into a buffer.
+* @details      Formats the millionths of a degree digit by digit; no heap, no printf.
+*
+* @param[in]    coord       Position.
+* @param[out]   out         Destination, always terminated when size > 0.
+* @param[in]    size        Size of out; GEO_MAP_LINK_MAX_LEN + 1 always fits.
+*
+* @return       size_t      Length written, 0 if the link did not fit (out is then "").
+*
+* @api
+*/
+/*================================================================================================*/
+size_t geoFormatMapLink(const GeoCoord& coord, char* out, size_t size);
+
+/*================================================================================================*/
+/**
+* @brief        Writes a text followed by the Google Maps link of a position into a buffer.
+*
+* @param[in]    prefix      Text before the link (e.g. "SOS! My location: ").
+* @param[in]    coord       Position.
+* @param[out]   out         Destination, always terminated when size > 0.
+* @param[in]    size        Size of out.
+*
+* @return       size_t      Length written, 0 if the text did not fit (out is then "").
+*
+* @api
+*/
+/*================================================================================================*/
+size_t geoFormatMessage(const char* prefix, const GeoCoord& coord, char* out, size_t size);
+
+#endif /* GPS_COORD_H */
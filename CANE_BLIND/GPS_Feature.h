@@ -5,6 +5,9 @@
  * INCLUDES
  ******************************************************************************/
 #include "Generic_API.h"
+#include "GPS_Nmea.h"
+#include "GPS_Poller.h"
+#include "GPS_Cache.h"
 
 /******************************************************************************
  * GLOBAL VARIABLES
@@ -21,16 +24,12 @@ extern String googleMapUrl;
 
 /*================================================================================================*/
 /**
-* @brief        Parses GPS data and returns different preset Google Maps URLs based on call count.
-* @details      This function maintains an internal static counter. Each time the function is called,
-*               the counter increases by 1 (cycles from 0 → 9), and the function returns a different
-*               Google Maps URL according to the counter value. Used to test different URL outputs
-*               without real GPS data.
+* @brief        Returns the Google Maps URL of the latest position reported by the receiver.
 *
 * @param[in]    None
 * @param[out]   None
 *
-* @return       String      A Google Maps URL selected based on the internal counter.
+* @return       String      The map link, or an empty string while there is no fix.
 *
 * @api
 */
@@ -39,27 +38,32 @@ String parseGpsToMapLink();
 
 /*================================================================================================*/
 /**
-* @brief        Processes GPS map-link generation and performs AT-command passthrough.
-* @details      This function invokes the GPS parsing routine to generate a Google Maps URL
-*               from the most recently available GNSS data (currently a static or externally
-*               updated source). The function does not request new GNSS data nor handle timing
-*               intervals.  
+* @brief        Builds the Google Maps URL of a position reported by the GNSS receiver.
 *
-*               Additionally, it operates in full AT-command passthrough mode:
-*               - Forwards all characters received from the USB Serial Monitor to the GSM/GNSS module.
-*               - Forwards all data received from the GSM/GNSS module back to the USB Serial Monitor.
-*               This allows real-time debugging and manual AT interaction.
+* @param[in]    fix         Position decoded by a GnssParser.
 *
-* @param[in,out] systemCurrentTimeMs   Unused parameter; reserved for future GPS scheduling logic.
-* @param[in]     intervalMs            Unused parameter; reserved for periodic GNSS request handling.
-* @param[in]     debug                 If true, may be used in future expansion for debug printing.
+* @return       String      "https://www.google.com/maps?q=<lat>,<lon>" with 6 decimals.
+*
+* @api
+*/
+/*================================================================================================*/
+String gpsFixToMapLink(const GnssFix& fix);
+
+/*================================================================================================*/
+/**
+* @brief        Runs the GNSS poller and refreshes googleMapUrl when a new fix is published.
+* @details      The receiver is queried fast while acquiring, slower while tracking and every
+*               intervalMs once the fix is stable (see GnssPoller).
+*
+* @param[in,out] systemCurrentTimeMs   Set to the millis() of the latest GNSS query.
+* @param[in]     intervalMs            Query interval once the fix is stable.
+* @param[in]     debug                 If true, prints every newly published map link.
 * @param[out]    None
 *
-* @return        void
+* @return        uint32_t              Time until the poller has work again (ms).
 *
 * @api
 */
 /*================================================================================================*/
-
-void requestGpsLocation(unsigned long &systemCurrentTimeMs, unsigned long intervalMs, bool debug);
+uint32_t requestGpsLocation(unsigned long &systemCurrentTimeMs, unsigned long intervalMs, bool debug);
 #endif
\ No newline at end of file
@@ -0,0 +1,494 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "GPS_Nmea.h"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Parser states */
+enum {
+    GP_IDLE = 0,        /* At the start of a line */
+    GP_FIELDS,          /* Collecting the fields of a known or not yet identified sentence */
+    GP_CHECKSUM,        /* After '*', reading the two hex digits */
+    GP_SKIP             /* Ignoring the rest of the line */
+};
+
+/* Sentence kinds; the NMEA kinds come first */
+enum {
+    GK_NMEA = 0,        /* "$..." before the address field is complete */
+    GK_GGA,             /* Fix data: time, position, quality, satellites, HDOP, altitude */
+    GK_RMC,             /* Recommended minimum: time, status, position, date */
+    GK_GSA,             /* DOP and active satellites: fix type, HDOP */
+    GK_MODEM,           /* "+..." before the tag is complete */
+    GK_CGPSINFO,        /* "+CGPSINFO: <lat>,<N/S>,<lon>,<E/W>,<date>,<utc>,<alt>,..." */
+    GK_CGNSINF          /* "+CGNSINF: <run>,<fix>,<utc>,<lat>,<lon>,<alt>,...,<hdop>,..." */
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Receiver state fed by the modem line handlers */
+GnssParser gnssParser;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* True for sentences protected by a checksum */
+static inline bool isNmeaKind(uint8_t kind) {
+    return kind < GK_MODEM;
+}
+
+/* Value of a hex digit, or -1 */
+static int8_t hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return (int8_t)(c - '0');
+    }
+    if (c >= 'A' && c <= 'F') {
+        return (int8_t)(c - 'A' + 10);
+    }
+    if (c >= 'a' && c <= 'f') {
+        return (int8_t)(c - 'a' + 10);
+    }
+    return -1;
+}
+
+/* Reads exactly count decimal digits */
+static bool parseDigits(const char* text, uint8_t count, uint32_t* value) {
+    uint32_t result = 0U;
+    for (uint8_t i = 0; i < count; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        result = result * 10U + (uint32_t)(text[i] - '0');
+    }
+    *value = result;
+    return true;
+}
+
+/* Converts "[-]123.4567" to an integer scaled by 10^decimals; extra decimals are cut off */
+static bool parseScaled(const char* text, uint8_t decimals, int64_t* value) {
+    bool negative = (*text == '-');
+    if (negative || *text == '+') {
+        text++;
+    }
+    int64_t result = 0;
+    uint8_t fractionDigits = 0U;
+    uint8_t digits = 0U;
+    bool inFraction = false;
+    for (; *text != '\0'; text++) {
+        if (*text == '.' && !inFraction) {
+            inFraction = true;
+        } else if (*text < '0' || *text > '9') {
+            return false;
+        } else if (!inFraction || fractionDigits < decimals) {
+            if (++digits > 15U) {
+                return false;
+            }
+            result = result * 10 + (*text - '0');
+            fractionDigits = (uint8_t)(fractionDigits + (inFraction ? 1U : 0U));
+        }
+    }
+    if (digits == 0U) {
+        return false;
+    }
+    for (; fractionDigits < decimals; fractionDigits++) {
+        result *= 10;
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+/* parseScaled() for values that fit in 32 bits */
+static bool parseDecimal(const char* text, uint8_t decimals, int32_t* value) {
+    int64_t result;
+    if (!parseScaled(text, decimals, &result) || result > INT32_MAX || result < INT32_MIN) {
+        return false;
+    }
+    *value = (int32_t)result;
+    return true;
+}
+
+/* Converts "ddmm.mmmm" / "dddmm.mmmm" to millionths of a degree */
+static bool parseDegreesMinutes(const char* text, int32_t* valueE6) {
+    int64_t minutesE6;
+    if (!parseScaled(text, 6U, &minutesE6) || minutesE6 < 0) {
+        return false;
+    }
+    /* dddmm.mmmmmm x 1e6: the degrees are the part above 100 minutes */
+    uint32_t degrees = (uint32_t)(minutesE6 / 100000000LL);
+    uint32_t minutes = (uint32_t)(minutesE6 % 100000000LL);
+    if (minutes >= 60000000UL || degrees > 180U) {
+        return false;
+    }
+    *valueE6 = (int32_t)(degrees * 1000000UL + minutes / 60U);
+    return true;
+}
+
+/* Converts "hhmmss[.sss]" to milliseconds since midnight */
+static bool parseUtcTime(const char* text, uint32_t* timeMs) {
+    uint32_t hours, minutes, seconds;
+    if (!parseDigits(text, 2U, &hours) || !parseDigits(&text[2], 2U, &minutes) ||
+        !parseDigits(&text[4], 2U, &seconds) || hours > 23U || minutes > 59U || seconds > 60U) {
+        return false;
+    }
+    uint32_t milliseconds = 0U;
+    if (text[6] == '.') {
+        uint32_t scale = 100U;
+        for (const char* digit = &text[7]; *digit >= '0' && *digit <= '9' && scale > 0U; digit++) {
+            milliseconds += (uint32_t)(*digit - '0') * scale;
+            scale /= 10U;
+        }
+    }
+    *timeMs = ((hours * 60U + minutes) * 60U + seconds) * 1000U + milliseconds;
+    return true;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the GnssParser class.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+GnssParser::GnssParser()
+    : acceptedCount(0U), checksumErrorCount(0U), malformedCount(0U), ignoredCount(0U) {
+    reset();
+}
+
+/*================================================================================================*/
+/**
+* @brief        Consumes one byte.
+* @details      '$' always starts a new sentence, so the parser resynchronises after a lost
+*               line ending; '+' starts a modem line only at the beginning of a line.
+*
+* @param[in]    c           Next received character.
+*
+* @return       bool        True if it completed a sentence that updated the fix.
+*/
+/*================================================================================================*/
+bool GnssParser::feed(char c) {
+    if (c == '$') {
+        if (state == GP_FIELDS || state == GP_CHECKSUM) {
+            malformedCount++;
+        }
+        start(GK_NMEA);
+        return false;
+    }
+    if (c == '\r' || c == '\n') {
+        bool published = (state == GP_FIELDS || state == GP_CHECKSUM) && finish();
+        state = GP_IDLE;
+        return published;
+    }
+
+    switch (state) {
+    case GP_IDLE:
+        if (c == '+') {
+            start(GK_MODEM);
+        } else {
+            state = GP_SKIP;
+        }
+        return false;
+
+    case GP_FIELDS:
+        if (++sentenceLength > GNSS_SENTENCE_MAX_LEN) {
+            malformedCount++;
+            abandon();
+        } else if (c == '*' && isNmeaKind(kind)) {
+            if (endField()) {
+                state = GP_CHECKSUM;
+            }
+        } else {
+            if (isNmeaKind(kind)) {
+                checksum ^= (uint8_t)c;
+            }
+            if (c == ',' || (c == ':' && kind == GK_MODEM)) {
+                endField();
+            } else if (c == ' ' && fieldLength == 0U && !isNmeaKind(kind)) {
+                /* Space after "+CGPSINFO:" */
+            } else if (fieldLength >= GNSS_FIELD_MAX_LEN) {
+                malformedCount++;
+                abandon();
+            } else {
+                field[fieldLength++] = c;
+            }
+        }
+        return false;
+
+    case GP_CHECKSUM: {
+        int8_t digit = hexValue(c);
+        if (digit < 0 || checksumDigits >= 2U) {
+            malformedCount++;
+            abandon();
+        } else {
+            receivedChecksum = (uint8_t)((receivedChecksum << 4) | (uint8_t)digit);
+            checksumDigits++;
+        }
+        return false;
+    }
+
+    default:
+        return false;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Consumes a received line (or several) and terminates it.
+*
+* @param[in]    line        Line text, with or without the line ending.
+* @param[in]    length      Number of characters in line.
+*
+* @return       uint8_t     Number of sentences that updated the fix.
+*/
+/*================================================================================================*/
+uint8_t GnssParser::feedLine(const char* line, size_t length) {
+    uint8_t published = 0U;
+    for (size_t i = 0; i < length; i++) {
+        if (feed(line[i])) {
+            published++;
+        }
+    }
+    if (feed('\n')) {
+        published++;
+    }
+    return published;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Forgets the fix and any partial sentence.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void GnssParser::reset() {
+    memset(&current, 0, sizeof(current));
+    memset(&pending, 0, sizeof(pending));
+    memset(field, 0, sizeof(field));
+    state = GP_IDLE;
+    kind = GK_NMEA;
+    fieldIndex = 0U;
+    fieldLength = 0U;
+    sentenceLength = 0U;
+    checksum = 0U;
+    receivedChecksum = 0U;
+    checksumDigits = 0U;
+    latitudeE6 = 0;
+    longitudeE6 = 0;
+    latitudeSeen = false;
+    longitudeSeen = false;
+    fixReported = -1;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the fix and the sentence counters.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void GnssParser::printStats(Print& out) const {
+    out.printf("[GNSS] %s: %ld, %ld udeg, quality %u, type %u, %u sats, HDOP %u.%02u, "
+               "UTC %lu ms, date %06lu\n",
+               current.valid ? "fix" : "no fix", (long)current.position.latitudeE6,
+               (long)current.position.longitudeE6, (unsigned)current.quality,
+               (unsigned)current.fixType, (unsigned)current.satellites,
+               (unsigned)(current.hdopX100 / 100U), (unsigned)(current.hdopX100 % 100U),
+               (unsigned long)current.utcTimeMs, (unsigned long)current.utcDate);
+    out.printf("[GNSS] %lu sentences, %lu checksum errors, %lu malformed, %lu ignored\n",
+               (unsigned long)acceptedCount, (unsigned long)checksumErrorCount,
+               (unsigned long)malformedCount, (unsigned long)ignoredCount);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Begins a sentence on a copy of the published fix */
+void GnssParser::start(uint8_t sentenceKind) {
+    pending = current;
+    state = GP_FIELDS;
+    kind = sentenceKind;
+    fieldIndex = 0U;
+    fieldLength = 0U;
+    sentenceLength = 0U;
+    checksum = 0U;
+    receivedChecksum = 0U;
+    checksumDigits = 0U;
+    latitudeSeen = false;
+    longitudeSeen = false;
+    fixReported = -1;
+}
+
+/* Ends the sentence at the line ending; publishes the copy if it is complete and intact */
+bool GnssParser::finish() {
+    if (state == GP_FIELDS) {
+        if (isNmeaKind(kind)) {
+            /* GGA, RMC and GSA always carry a checksum */
+            malformedCount++;
+            return false;
+        }
+        if (!endField()) {
+            return false;
+        }
+    } else if (checksumDigits != 2U) {
+        malformedCount++;
+        return false;
+    } else if (receivedChecksum != checksum) {
+        checksumErrorCount++;
+        return false;
+    }
+    if (kind == GK_NMEA || kind == GK_MODEM) {
+        /* Ended inside the address field */
+        malformedCount++;
+        return false;
+    }
+
+    if (fixReported == 1 && latitudeSeen && longitudeSeen) {
+        pending.valid = true;
+        pending.position.latitudeE6 = latitudeE6;
+        pending.position.longitudeE6 = longitudeE6;
+        pending.updatedMs = millis();
+    } else if (fixReported == 0) {
+        pending.valid = false;
+    }
+    current = pending;
+    acceptedCount++;
+    return true;
+}
+
+/* Drops the sentence in progress */
+void GnssParser::abandon() {
+    state = GP_SKIP;
+}
+
+/* Terminates the collected field and decodes it; false if the sentence was dropped */
+bool GnssParser::endField() {
+    field[fieldLength] = '\0';
+    if (fieldIndex == 0U) {
+        if (kind == GK_NMEA && fieldLength == 5U) {
+            /* Any talker ("GP", "GN", "GL", ...) followed by the sentence type */
+            const char* type = &field[2];
+            kind = (strcmp(type, "GGA") == 0) ? GK_GGA
+                 : (strcmp(type, "RMC") == 0) ? GK_RMC
+                 : (strcmp(type, "GSA") == 0) ? GK_GSA : GK_NMEA;
+        } else if (kind == GK_MODEM) {
+            kind = (strcmp(field, "CGPSINFO") == 0) ? GK_CGPSINFO
+                 : (strcmp(field, "CGNSINF") == 0)  ? GK_CGNSINF : GK_MODEM;
+            /* +CGPSINFO states no fix by leaving the position empty */
+            if (kind == GK_CGPSINFO) {
+                fixReported = 0;
+                pending.quality = 0U;
+            }
+        }
+        if (kind == GK_NMEA || kind == GK_MODEM) {
+            ignoredCount++;
+            abandon();
+            return false;
+        }
+    } else if (fieldLength > 0U) {
+        applyField();
+    }
+    fieldIndex++;
+    fieldLength = 0U;
+    return true;
+}
+
+/* Decodes one non-empty field into the copy of the fix or the sentence position */
+void GnssParser::applyField() {
+    int32_t value;
+    uint32_t digits;
+
+    switch (kind) {
+    case GK_GGA:
+        switch (fieldIndex) {
+        case 1: parseUtcTime(field, &pending.utcTimeMs); break;
+        case 2: latitudeSeen = parseDegreesMinutes(field, &latitudeE6); break;
+        case 3: if (field[0] == 'S') { latitudeE6 = -latitudeE6; } break;
+        case 4: longitudeSeen = parseDegreesMinutes(field, &longitudeE6); break;
+        case 5: if (field[0] == 'W') { longitudeE6 = -longitudeE6; } break;
+        case 6:
+            if (parseDecimal(field, 0U, &value)) {
+                pending.quality = (uint8_t)value;
+                fixReported = (value > 0) ? 1 : 0;
+            }
+            break;
+        case 7: if (parseDecimal(field, 0U, &value)) { pending.satellites = (uint8_t)value; } break;
+        case 8: if (parseDecimal(field, 2U, &value)) { pending.hdopX100 = (uint16_t)value; } break;
+        case 9: if (parseDecimal(field, 1U, &value)) { pending.altitudeDm = value; } break;
+        default: break;
+        }
+        break;
+
+    case GK_RMC:
+        switch (fieldIndex) {
+        case 1: parseUtcTime(field, &pending.utcTimeMs); break;
+        case 2: fixReported = (field[0] == 'A') ? 1 : 0; break;
+        case 3: latitudeSeen = parseDegreesMinutes(field, &latitudeE6); break;
+        case 4: if (field[0] == 'S') { latitudeE6 = -latitudeE6; } break;
+        case 5: longitudeSeen = parseDegreesMinutes(field, &longitudeE6); break;
+        case 6: if (field[0] == 'W') { longitudeE6 = -longitudeE6; } break;
+        case 9: if (fieldLength == 6U && parseDigits(field, 6U, &digits)) { pending.utcDate = digits; } break;
+        default: break;
+        }
+        break;
+
+    case GK_GSA:
+        if (fieldIndex == 2U && parseDecimal(field, 0U, &value)) {
+            pending.fixType = (uint8_t)value;
+        } else if (fieldIndex == 16U && parseDecimal(field, 2U, &value)) {
+            pending.hdopX100 = (uint16_t)value;
+        }
+        break;
+
+    case GK_CGPSINFO:
+        switch (fieldIndex) {
+        case 1:
+            latitudeSeen = parseDegreesMinutes(field, &latitudeE6);
+            fixReported = latitudeSeen ? 1 : 0;
+            pending.quality = (uint8_t)fixReported;
+            break;
+        case 2: if (field[0] == 'S') { latitudeE6 = -latitudeE6; } break;
+        case 3: longitudeSeen = parseDegreesMinutes(field, &longitudeE6); break;
+        case 4: if (field[0] == 'W') { longitudeE6 = -longitudeE6; } break;
+        case 5: if (fieldLength == 6U && parseDigits(field, 6U, &digits)) { pending.utcDate = digits; } break;
+        case 6: parseUtcTime(field, &pending.utcTimeMs); break;
+        case 7: if (parseDecimal(field, 1U, &value)) { pending.altitudeDm = value; } break;
+        default: break;
+        }
+        break;
+
+    case GK_CGNSINF:
+        switch (fieldIndex) {
+        case 2:
+            fixReported = (field[0] == '1') ? 1 : 0;
+            pending.quality = (uint8_t)fixReported;
+            break;
+        case 3: {
+            /* yyyyMMddhhmmss.sss */
+            uint32_t year, month, day;
+            if (fieldLength >= 14U && parseDigits(field, 4U, &year) &&
+                parseDigits(&field[4], 2U, &month) && parseDigits(&field[6], 2U, &day)) {
+                pending.utcDate = day * 10000U + month * 100U + year % 100U;
+                parseUtcTime(&field[8], &pending.utcTimeMs);
+            }
+            break;
+        }
+        case 4: latitudeSeen = parseDecimal(field, 6U, &latitudeE6); break;
+        case 5: longitudeSeen = parseDecimal(field, 6U, &longitudeE6); break;
+        case 6: if (parseDecimal(field, 1U, &value)) { pending.altitudeDm = value; } break;
+        case 11: if (parseDecimal(field, 2U, &value)) { pending.hdopX100 = (uint16_t)value; } break;
+        case 16: if (parseDecimal(field, 0U, &value)) { pending.satellites = (uint8_t)value; } break;
+        default: break;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
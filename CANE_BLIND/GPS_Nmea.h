@@ -0,0 +1,145 @@
+#ifndef GPS_NMEA_H
+#define GPS_NMEA_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "GPS_Coord.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Longest field kept (the UTC stamp of +CGNSINF is the longest one used) */
+#define GNSS_FIELD_MAX_LEN        20U
+
+/* Longest sentence accepted; NMEA allows 82 characters, +CGNSINF lines are longer */
+#define GNSS_SENTENCE_MAX_LEN     128U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Latest receiver state assembled from GGA, RMC, GSA, +CGPSINFO and +CGNSINF */
+typedef struct {
+    bool     valid;         /* True while the receiver reports a position fix */
+    uint8_t  quality;       /* GGA fix quality: 0 none, 1 GNSS, 2 DGNSS, 4/5 RTK, 6 estimated */
+    uint8_t  fixType;       /* GSA fix type: 1 none, 2 = 2D, 3 = 3D, 0 if unknown */
+    uint8_t  satellites;    /* Satellites used in the fix, 0 if unknown */
+    uint16_t hdopX100;      /* Horizontal dilution of precision x 100, 0 if unknown */
+    GeoCoord position;      /* Last reported position */
+    int32_t  altitudeDm;    /* Altitude above mean sea level (decimetres) */
+    uint32_t utcTimeMs;     /* UTC time of day of the last sentence (ms since midnight) */
+    uint32_t utcDate;       /* UTC date as ddmmyy, 0 if unknown */
+    uint32_t updatedMs;     /* millis() when the position was last updated, 0 if never */
+} GnssFix;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class GnssParser
+* @brief Streaming parser of NMEA sentences and of the modem's GNSS responses.
+* @details Bytes are consumed one at a time; every field is decoded as soon as its comma
+* arrives, into a copy of the current fix, and the copy is published only when the sentence
+* ends with a matching checksum ("*hh"), so a corrupted sentence never changes the fix.
+* +CGPSINFO and +CGNSINF lines carry no checksum and are published at the end of the line.
+* Any other sentence is skipped. Coordinates are converted to millionths of a degree with
+* integer arithmetic; nothing is allocated.
+*
+* @api
+*/
+/*================================================================================================*/
+class GnssParser {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the GnssParser class.
+    */
+    /*============================================================================================*/
+    GnssParser();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Consumes one byte.
+    *
+    * @param[in]    c           Next received character.
+    *
+    * @return       bool        True if it completed a sentence that updated the fix.
+    */
+    /*============================================================================================*/
+    bool feed(char c);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Consumes a received line (or several) and terminates it.
+    *
+    * @param[in]    line        Line text, with or without the line ending.
+    * @param[in]    length      Number of characters in line.
+    *
+    * @return       uint8_t     Number of sentences that updated the fix.
+    */
+    /*============================================================================================*/
+    uint8_t feedLine(const char* line, size_t length);
+
+    /* Latest published state */
+    const GnssFix& fix() const { return current; }
+
+    /* Forgets the fix and any partial sentence */
+    void reset();
+
+    /* Statistics */
+    uint32_t sentencesAccepted() const { return acceptedCount; }
+    uint32_t checksumErrors() const { return checksumErrorCount; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the fix and the sentence counters.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+private:
+    void start(uint8_t sentenceKind);
+    bool finish();
+    void abandon();
+    bool endField();
+    void applyField();
+
+    GnssFix current;
+    GnssFix pending;
+
+    /* Sentence in progress */
+    uint8_t state;
+    uint8_t kind;
+    uint8_t fieldIndex;
+    uint8_t fieldLength;
+    uint8_t sentenceLength;
+    uint8_t checksum;
+    uint8_t receivedChecksum;
+    uint8_t checksumDigits;
+    char field[GNSS_FIELD_MAX_LEN + 1U];
+
+    /* Position and fix status of the sentence in progress, applied by finish() */
+    int32_t latitudeE6;
+    int32_t longitudeE6;
+    bool latitudeSeen;
+    bool longitudeSeen;
+    int8_t fixReported;     /* -1 not stated, 0 no fix, 1 fix */
+
+    uint32_t acceptedCount;
+    uint32_t checksumErrorCount;
+    uint32_t malformedCount;
+    uint32_t ignoredCount;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+extern GnssParser gnssParser;     /* Fed with the modem's NMEA lines and GNSS responses */
+
+#endif /* GPS_NMEA_H */
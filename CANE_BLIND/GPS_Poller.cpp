@@ -0,0 +1,229 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "GPS_Poller.h"
+#include "Generic_API.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Receiver of the GSM/GNSS module */
+GnssPoller gnssPoller(gsmAtEngine, gnssParser);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the GnssPoller class.
+*
+* @param[in]    engine      AT engine of the GSM/GNSS module.
+* @param[in]    parser      Parser that decodes the answers and holds the fix.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+GnssPoller::GnssPoller(AtEngine& engine, GnssParser& parser)
+    : engine(engine), parser(parser), handle(AT_INVALID_HANDLE), pollMode(GNSS_POLL_ACQUIRING),
+      stableCount(0U), stableIntervalMs(GNSS_POLL_STABLE_MS), nextQueryMs(0U), queryMs(0U),
+      scheduled(false), version(0U), statsStartMs(0U) {
+    memset(&anchor, 0, sizeof(anchor));
+    memset(&published, 0, sizeof(published));
+    memset(&counters, 0, sizeof(counters));
+    link[0] = '\0';
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sets the query interval used once the fix is stable.
+*
+* @param[in]    intervalMs  Interval (ms); raised to GNSS_POLL_TRACK_MS if shorter.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void GnssPoller::setStableInterval(uint32_t intervalMs) {
+    stableIntervalMs = (intervalMs > GNSS_POLL_TRACK_MS) ? intervalMs : GNSS_POLL_TRACK_MS;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Collects the answer of the query in flight, publishes a changed fix and
+*               sends the next query when it is due.
+* @details      The next query is timed from the end of the previous one, at the interval of
+*               the mode the answer left. When other commands are queued (an SOS, an SMS) the
+*               query waits GNSS_BUSY_RETRY_MS instead of adding to the queue.
+*
+* @return       uint32_t    Time until poll() has work again (ms).
+*/
+/*================================================================================================*/
+uint32_t GnssPoller::poll() {
+    uint32_t startUs = micros();
+    uint32_t waitMs = GNSS_RESULT_CHECK_MS;
+
+    if (handle != AT_INVALID_HANDLE) {
+        AtResult result = engine.result(handle);
+        if (result != AT_RESULT_PENDING) {
+            collect(result);
+            engine.release(handle);
+            handle = AT_INVALID_HANDLE;
+            nextQueryMs = millis() + interval();
+            scheduled = true;
+        }
+    }
+
+    /* Lines outside our queries (NMEA, URCs) may have changed the fix as well */
+    const GnssFix& latest = parser.fix();
+    if (latest.valid != published.valid ||
+        (latest.valid && (latest.position.latitudeE6 != published.position.latitudeE6 ||
+                          latest.position.longitudeE6 != published.position.longitudeE6))) {
+        publish();
+    } else {
+        published = latest;
+    }
+
+    if (handle == AT_INVALID_HANDLE) {
+        uint32_t nowMs = millis();
+        int32_t remaining = (int32_t)(nextQueryMs - nowMs);
+        if (scheduled && remaining > 0) {
+            waitMs = (uint32_t)remaining;
+        } else if (!engine.isIdle()) {
+            nextQueryMs = nowMs + GNSS_BUSY_RETRY_MS;
+            scheduled = true;
+            waitMs = GNSS_BUSY_RETRY_MS;
+        } else {
+            handle = engine.submit(AT_CMD_GNSS_INFO);
+            if (handle == AT_INVALID_HANDLE) {
+                counters.failures++;
+                nextQueryMs = nowMs + GNSS_BUSY_RETRY_MS;
+                scheduled = true;
+                waitMs = GNSS_BUSY_RETRY_MS;
+            } else {
+                counters.queries++;
+                counters.txBytes += strlen(AT_CMD_GNSS_INFO.prefix) + 1U;   /* With the CR */
+                queryMs = nowMs;
+            }
+        }
+    }
+
+    counters.busyUs += micros() - startUs;
+    return waitMs;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the mode, the query counters and the CPU time and modem traffic
+*               saved against the superloop and against fixed fast polling.
+* @details      The superloop rebuilt the map link every GNSS_LEGACY_LOOP_MS; its cost is
+*               estimated from the measured cost of one publish. Fixed fast polling would have
+*               queried every GNSS_POLL_ACQUIRE_MS at the measured bytes per query.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void GnssPoller::printStats(Print& out) const {
+    static const char* const modeNames[] = { "acquiring", "tracking", "stable" };
+    uint32_t elapsedMs = millis() - statsStartMs;
+
+    out.printf("[GNSS] %s, every %lu ms; %lu queries: %lu fix, %lu no fix, %lu failed; "
+               "%lu publishes\n",
+               modeNames[pollMode], (unsigned long)interval(), (unsigned long)counters.queries,
+               (unsigned long)counters.withFix, (unsigned long)counters.withoutFix,
+               (unsigned long)counters.failures, (unsigned long)counters.publishes);
+
+    uint32_t bytes = counters.txBytes + counters.rxBytes;
+    uint32_t fastQueries = elapsedMs / GNSS_POLL_ACQUIRE_MS;
+    uint32_t savedQueries = (fastQueries > counters.queries) ? fastQueries - counters.queries : 0U;
+    uint32_t bytesPerQuery = (counters.queries > 0U) ? bytes / counters.queries : 0U;
+    out.printf("[GNSS] modem traffic %lu B (%lu tx, %lu rx); %lu queries / ~%lu B saved "
+               "against a query every %lu ms\n",
+               (unsigned long)bytes, (unsigned long)counters.txBytes,
+               (unsigned long)counters.rxBytes, (unsigned long)savedQueries,
+               (unsigned long)(savedQueries * bytesPerQuery), (unsigned long)GNSS_POLL_ACQUIRE_MS);
+
+    uint32_t legacyBuilds = elapsedMs / GNSS_LEGACY_LOOP_MS;
+    uint32_t publishAvgUs = (counters.publishes > 0U) ? counters.publishUs / counters.publishes : 0U;
+    uint64_t legacyUs = (uint64_t)legacyBuilds * publishAvgUs;
+    uint64_t savedUs = (legacyUs > counters.busyUs) ? legacyUs - counters.busyUs : 0U;
+    out.printf("[GNSS] CPU %lu us in %lu ms (publish avg %lu us); ~%lu us saved against %lu "
+               "link rebuilds every %lu ms\n",
+               (unsigned long)counters.busyUs, (unsigned long)elapsedMs,
+               (unsigned long)publishAvgUs, (unsigned long)savedUs, (unsigned long)legacyBuilds,
+               (unsigned long)GNSS_LEGACY_LOOP_MS);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Clears the counters.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void GnssPoller::resetStats() {
+    memset(&counters, 0, sizeof(counters));
+    statsStartMs = millis();
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Feeds the answer of a finished query to the parser and picks the next mode */
+void GnssPoller::collect(AtResult result) {
+    const char* response = engine.response(handle);
+    size_t length = strlen(response);
+    counters.rxBytes += length;
+
+    if (result != AT_RESULT_OK || parser.feedLine(response, length) == 0U) {
+        /* No answer to judge the fix by: keep the rate */
+        counters.failures++;
+        return;
+    }
+
+    const GnssFix& fix = parser.fix();
+    if (!fix.valid) {
+        counters.withoutFix++;
+        stableCount = 0U;
+        pollMode = GNSS_POLL_ACQUIRING;
+        return;
+    }
+
+    counters.withFix++;
+    if (stableCount > 0U && geoDistanceM(anchor, fix.position) <= GNSS_STABLE_RADIUS_M) {
+        if (stableCount < GNSS_STABLE_FIXES) {
+            stableCount++;
+        }
+    } else {
+        /* First fix, or moved: measure stability from here */
+        stableCount = 1U;
+        anchor = fix.position;
+    }
+    pollMode = (stableCount >= GNSS_STABLE_FIXES) ? GNSS_POLL_STABLE : GNSS_POLL_TRACKING;
+}
+
+/* Takes the parser's fix and formats its map link once */
+void GnssPoller::publish() {
+    uint32_t startUs = micros();
+    published = parser.fix();
+    if (published.valid) {
+        geoFormatMapLink(published.position, link, sizeof(link));
+    } else {
+        link[0] = '\0';
+    }
+    version++;
+    counters.publishes++;
+    counters.publishUs += micros() - startUs;
+}
+
+/* Query interval of the current mode (ms) */
+uint32_t GnssPoller::interval() const {
+    switch (pollMode) {
+    case GNSS_POLL_TRACKING:
+        return GNSS_POLL_TRACK_MS;
+    case GNSS_POLL_STABLE:
+        return stableIntervalMs;
+    default:
+        return GNSS_POLL_ACQUIRE_MS;
+    }
+}
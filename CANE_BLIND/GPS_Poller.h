@@ -0,0 +1,165 @@
+#ifndef GPS_POLLER_H
+#define GPS_POLLER_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "AT_Engine.h"
+#include "GPS_Nmea.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Query intervals per mode (ms); the stable one is set by the caller */
+#define GNSS_POLL_ACQUIRE_MS      2000UL
+#define GNSS_POLL_TRACK_MS        5000UL
+#define GNSS_POLL_STABLE_MS       30000UL
+
+/* Consecutive fixes within GNSS_STABLE_RADIUS_M of each other before the fix counts as stable */
+#define GNSS_STABLE_FIXES         3U
+
+/* Largest move between two fixes that still counts as standing still (m) */
+#define GNSS_STABLE_RADIUS_M      10U
+
+/* Time between result checks while a query is in flight (ms) */
+#define GNSS_RESULT_CHECK_MS      20U
+
+/* Delay before retrying when the AT engine is busy with other commands (ms) */
+#define GNSS_BUSY_RETRY_MS        500U
+
+/* Period of the former superloop that rebuilt the map link on every pass (ms); the baseline
+   of the CPU time reported as saved */
+#define GNSS_LEGACY_LOOP_MS       175U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Query rate, chosen from the fix state */
+typedef enum {
+    GNSS_POLL_ACQUIRING = 0,   /* No fix: query fast */
+    GNSS_POLL_TRACKING,        /* Fix that is new or moving */
+    GNSS_POLL_STABLE           /* Fix that stayed in place for GNSS_STABLE_FIXES queries */
+} GnssPollMode;
+
+/* Receiver traffic and CPU time of the poller */
+typedef struct {
+    uint32_t queries;         /* AT+CGPSINFO commands sent */
+    uint32_t withFix;         /* Answers that carried a position */
+    uint32_t withoutFix;      /* Answers without a position */
+    uint32_t failures;        /* ERROR, timeout or no free command slot */
+    uint32_t txBytes;         /* Command bytes written to the modem */
+    uint32_t rxBytes;         /* Response text received */
+    uint32_t publishes;       /* New fixes published */
+    uint32_t publishUs;       /* Time spent publishing */
+    uint32_t busyUs;          /* Total time spent in poll() */
+} GnssPollStats;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class GnssPoller
+* @brief Queries the GNSS receiver at a rate that follows the fix state.
+* @details AT+CGPSINFO is sent every GNSS_POLL_ACQUIRE_MS while there is no fix, every
+* GNSS_POLL_TRACK_MS while the fix is new or moving, and at the stable interval once
+* GNSS_STABLE_FIXES answers in a row stayed within GNSS_STABLE_RADIUS_M. A lost fix returns to
+* acquisition. Answers are fed to the parser; a position is published (the map link formatted
+* once, the version bumped) only when the parser's fix changes, whatever line fed it. poll()
+* never blocks and returns how long the caller may wait before calling it again.
+*
+* @api
+*/
+/*================================================================================================*/
+class GnssPoller {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the GnssPoller class.
+    *
+    * @param[in]    engine      AT engine of the GSM/GNSS module.
+    * @param[in]    parser      Parser that decodes the answers and holds the fix.
+    */
+    /*============================================================================================*/
+    GnssPoller(AtEngine& engine, GnssParser& parser);
+
+    /* Query interval once the fix is stable (ms), at least GNSS_POLL_TRACK_MS */
+    void setStableInterval(uint32_t intervalMs);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Collects the answer of the query in flight, publishes a changed fix and
+    *               sends the next query when it is due.
+    *
+    * @return       uint32_t    Time until poll() has work again (ms).
+    */
+    /*============================================================================================*/
+    uint32_t poll();
+
+    /* Latest published position */
+    const GnssFix& fix() const { return published; }
+
+    /* Map link of the published position, "" without a fix */
+    const char* mapLink() const { return link; }
+
+    /* Incremented on every publish; consumers compare it to skip unchanged fixes */
+    uint32_t fixVersion() const { return version; }
+
+    /* Current query rate */
+    GnssPollMode mode() const { return pollMode; }
+
+    /* millis() when the last query was sent, 0 before the first */
+    uint32_t lastQueryMs() const { return queryMs; }
+
+    const GnssPollStats& stats() const { return counters; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the mode, the query counters and the CPU time and modem traffic
+    *               saved against the superloop and against fixed fast polling.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+    /* Clears the counters */
+    void resetStats();
+
+private:
+    void collect(AtResult result);
+    void publish();
+    uint32_t interval() const;
+
+    AtEngine& engine;
+    GnssParser& parser;
+
+    AtHandle handle;
+    GnssPollMode pollMode;
+    uint8_t stableCount;
+    uint32_t stableIntervalMs;
+    uint32_t nextQueryMs;       /* Valid once scheduled; the first query is due at once */
+    uint32_t queryMs;
+    bool scheduled;
+
+    /* First position of the current run of nearby fixes */
+    GeoCoord anchor;
+
+    /* Last published fix and its link */
+    GnssFix published;
+    uint32_t version;
+    char link[GEO_MAP_LINK_MAX_LEN + 1U];
+
+    GnssPollStats counters;
+    uint32_t statsStartMs;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+extern GnssPoller gnssPoller;     /* Queries the receiver of the GSM/GNSS module */
+
+#endif /* GPS_POLLER_H */
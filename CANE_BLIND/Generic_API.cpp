@@ -2,6 +2,14 @@
  * INCLUDES
  ******************************************************************************/
 #include "Generic_API.h"
+#include "SMS_Outbox.h"
+#include "SOS_Dispatch.h"
+#include "SMS_Commands.h"
+#include "CALL_SOS_Feature.h"
+#include "TASK_Scheduler.h"
+#include "GPS_Nmea.h"
+#include "GPS_Poller.h"
+#include "GPS_Cache.h"
 
 /******************************************************************************
  * GLOBAL VARIABLES
@@ -9,80 +17,296 @@
 /* Global system timestamp (milliseconds) */
 unsigned long systemCurrentTimeMs =0U;
 
+/* AT command engine bound to the GSM/GNSS UART */
+AtEngine gsmAtEngine(gsmSerialPort);
+
+/* Dispatcher for unsolicited result codes */
+UrcDispatcher gsmUrcDispatcher;
+
+/* Modem state maintained by the default URC handlers */
+GsmModemStatus gsmModemStatus = { 99, false, 0U, 0U, 0U, "" };
+
+/* Console command being typed on the debug Serial */
+static char consoleCommand[CONSOLE_COMMAND_MAX_LEN + 1];
+static uint8_t consoleCommandLength = 0U;
+static bool consoleInCommand = false;
+static bool consoleAtLineStart = true;
+
+/* Non-blocking beep pattern: buzzer edges left and millis() of the next one */
+static uint8_t buzzerEdgesLeft = 0U;
+static uint32_t buzzerNextEdgeMs = 0U;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* RING: count incoming call alerts */
+static void onRingUrc(const UrcEvent& event, void* context) {
+    (void)event;
+    (void)context;
+    gsmModemStatus.lastRingMs = millis();
+    gsmModemStatus.ringCount++;
+}
+
+/* +CLIP: "<number>",<type>,... - remember the caller */
+static void onClipUrc(const UrcEvent& event, void* context) {
+    (void)context;
+    if (event.fieldCount > 0U) {
+        UrcDispatcher::fieldToString(event.fields[0], gsmModemStatus.lastCaller, GSM_NUMBER_MAX_LEN);
+        LOG_INFO_TEXT("[URC] Incoming call from %s", gsmModemStatus.lastCaller,
+                      strlen(gsmModemStatus.lastCaller));
+    }
+}
+
+/* +CMT / +CMTI: count received messages */
+static void onSmsUrc(const UrcEvent& event, void* context) {
+    (void)context;
+    gsmModemStatus.smsReceived++;
+    if (event.body != NULL) {
+        LOG_INFO_TEXT("[URC] SMS: %s", event.body, event.bodyLength);
+    }
+}
+
+/* +CSQ: <rssi>,<ber> - track the signal quality */
+static void onCsqUrc(const UrcEvent& event, void* context) {
+    (void)context;
+    if (event.fieldCount > 0U) {
+        gsmModemStatus.signalRssi = (int8_t)UrcDispatcher::fieldToInt(event.fields[0], 99);
+    }
+}
+
+/* +CGPSINFO / +CGNSINF reported without a query: update the receiver state */
+static void onGnssUrc(const UrcEvent& event, void* context) {
+    (void)context;
+    gnssParser.feedLine(event.line, event.length);
+}
+
+/* +CPIN: <code> - track the SIM state */
+static void onCpinUrc(const UrcEvent& event, void* context) {
+    (void)context;
+    gsmModemStatus.simReady = (event.fieldCount > 0U) &&
+                              (event.fields[0].length == 5U) &&
+                              (memcmp(event.fields[0].data, "READY", 5U) == 0);
+}
+
+/* Executes one "!" console command */
+static void runConsoleCommand(const char* command) {
+    if (strcmp(command, "!stats") == 0) {
+        gsmAtEngine.latencyStats().printReport(Serial);
+        systemLog.printStats(Serial);
+        smsOutbox.printStats(Serial);
+        smsCommands.printStats(Serial);
+        callTracker.printStats(Serial);
+        sosButton.printStats(Serial);
+        Serial.printf("[BTN] gestures: %lu single, %lu double, %lu triple, %lu long, %lu hold\n",
+                      (unsigned long)buttonGestures.count(GESTURE_SINGLE_CLICK),
+                      (unsigned long)buttonGestures.count(GESTURE_DOUBLE_CLICK),
+                      (unsigned long)buttonGestures.count(GESTURE_TRIPLE_CLICK),
+                      (unsigned long)buttonGestures.count(GESTURE_LONG_PRESS),
+                      (unsigned long)buttonGestures.count(GESTURE_HOLD));
+        gnssParser.printStats(Serial);
+        gnssPoller.printStats(Serial);
+        loopScheduler.printStats(Serial);
+    } else if (strcmp(command, "!stats reset") == 0) {
+        gsmAtEngine.latencyStats().reset();
+        loopScheduler.resetStats();
+        gnssPoller.resetStats();
+        Serial.println("[AT] statistics cleared");
+    } else if (strcmp(command, "!contacts") == 0) {
+        sosContacts.print(Serial);
+    } else if (strncmp(command, "!contacts add ", 14) == 0) {
+        Serial.println(sosContacts.add(&command[14]) ? "[SOS] contact added"
+                                                     : "[SOS] contact not added");
+    } else if (strncmp(command, "!contacts del ", 14) == 0) {
+        if (sosContacts.count() <= 1U) {
+            Serial.println("[SOS] the last contact cannot be removed");
+        } else {
+            bool removed = isdigit((unsigned char)command[14]) &&
+                           sosContacts.remove((uint8_t)atoi(&command[14]));
+            Serial.println(removed ? "[SOS] contact removed" : "[SOS] no such contact");
+        }
+    } else if (strcmp(command, "!sos") == 0) {
+        sosDispatcher.printReport(Serial);
+        locationCache.print(Serial);
+    } else {
+        Serial.println("Console commands: !stats, !stats reset, !contacts, !contacts add <number>, "
+                       "!contacts del <index>, !sos");
+    }
+}
+
 /*================================================================================================*/
 /**
-* @brief        Sends an AT command to the GSM module and triggers response reading.
-* @details      Transmits the specified AT command to the GSM module through the GSM UART port,
-*               waits a configurable delay to allow the module to process the command, and then
-*               invokes readGsmResponse() to retrieve the response from the module.
-*               The function does not return the response directly; instead, response handling
-*               is deferred to the readGsmResponse() implementation.
+* @brief        Sends a catalog AT command to the GSM module and waits for its final result code.
+* @details      Queues the command on gsmAtEngine and polls the engine until the module answers
+*               with one of the descriptor's terminators (OK, ERROR, +CME ERROR, +CMS ERROR or
+*               the "> " prompt), or until the descriptor's deadline expires. The call returns as
+*               soon as the module has answered instead of sleeping for a fixed time.
 *
-* @param[in]    atCommand       The AT command string to send to the GSM module.
-* @param[in]    waitMs          Delay time (in milliseconds) after sending the command before
-*                               attempting to read the response.
+* @param[in]    command         Catalog descriptor of the command (see AT_Catalog.h).
+* @param[in]    argument        Argument for parameterised commands (e.g. a phone number),
+*                               or NULL.
 *
-* @return       void
+* @return       AtResult        Final result of the command.
 *
 * @note         Uses the GSM UART interface referenced as gsmSerialPort.
 */
 /*================================================================================================*/
 
-void sendGsmCommand(String atCommand, uint16_t waitMs) {
-    /* Send the AT command to the GSM module */
-    gsmSerialPort.println(atCommand);
+AtResult sendGsmCommand(const AtCommandDesc& command, const char* argument) {
+    /* Queue the AT command on the engine */
+    AtHandle handle = gsmAtEngine.submit(command, argument);
+    if (handle == AT_INVALID_HANDLE) {
+        return AT_RESULT_INVALID;
+    }
+
+    /* Wait until the module answers or the deadline expires */
+    AtResult result = gsmAtEngine.waitFor(handle);
 
-    /* Wait for the module to process the command */
-    delay(waitMs);
+    /* Print the intermediate response lines, if any */
+    const char* response = gsmAtEngine.response(handle);
+    if (response[0] != '\0') {
+        LOG_INFO_TEXT("%s", response, strlen(response));
+    }
 
-    /* Read and optionally print the response from the GSM module */
-    readGsmResponse(GSM_RESPONSE_TIMEOUT_MS);
+    gsmAtEngine.release(handle);
+    return result;
 }
 
 /*================================================================================================*/
 /**
 * @brief        Reads the response from the GSM module over the serial port.
-* @details      Continuously reads incoming characters from the GSM module via the 
-*               specified UART port until the specified timeout expires. All received 
-*               characters are accumulated in a String and optionally printed to the 
-*               debug Serial monitor if enabled.
+* @details      Polls gsmAtEngine until the specified timeout expires, waking as soon as the
+*               modem receive task delivers a line. No heap memory is used; each
+*               complete line that is not part of a pending command is handed to the engine's
+*               unsolicited handler (printGsmLine() by default).
 *
 * @param[in]    timeoutMs       Maximum waiting time in milliseconds for the response.
-* @param[in]    enableDebug     If true, prints each received character to the Serial monitor.
 *
-* @return       String          The full response collected from the GSM module.
+* @return       void
 *
-* @note         Non-blocking inside timeout window; relies on gsmSerialPort.available().
+* @note         Relies on gsmAtEngine.poll().
 */
 /*================================================================================================*/
-String readGsmResponse(uint16_t timeoutMs) {
+void readGsmResponse(uint16_t timeoutMs) {
     /* Record the starting time in milliseconds */
     uint32_t startTime = millis(); 
 
-    /* String buffer to accumulate the received response */
-    String response = "";
-
     /* Loop until the elapsed time reaches the timeout */
-    while (millis() - startTime < timeoutMs) {
-        
-        /* Check if the GSM module has data available */
-        while (gsmSerialPort.available()) {
-            
-            /* Read one character from the GSM module */
-            char receivedChar = gsmSerialPort.read(); 
-            
-            /* Append the received character to the response buffer */
-            response += receivedChar;
-
-            /* Optionally print the received character to the debug Serial monitor */
-            if (1) {
-                Serial.print(receivedChar);
+    uint32_t elapsed = 0U;
+    while (elapsed < timeoutMs) {
+        /* Frame and dispatch everything the GSM module has sent so far */
+        gsmAtEngine.poll();
+        gsmAtEngine.idle(timeoutMs - elapsed);
+        elapsed = millis() - startTime;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Logs one line received from the GSM module to the debug Serial monitor.
+* @details      Matches the AtUnsolicitedHandler signature so it can be registered on
+*               gsmAtEngine to echo modem output that no command has claimed. The line is copied
+*               into the log ring, so the caller never waits for USB-CDC.
+*
+* @param[in]    line            NUL-terminated line text.
+* @param[in]    length          Number of characters in line.
+* @param[in]    context         Unused.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void printGsmLine(const char* line, size_t length, void* context) {
+    (void)context;
+    LOG_INFO_TEXT("%s", line, length);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Echoes an unsolicited modem line and passes it to gsmUrcDispatcher (NMEA
+*               sentences to gnssParser).
+* @details      Registered on gsmAtEngine as the unsolicited handler. When the line starts a
+*               two-line URC (+CMT), the engine is told to route the following body line here
+*               as well.
+*
+* @param[in]    line            NUL-terminated line text.
+* @param[in]    length          Number of characters in line.
+* @param[in]    context         Unused.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void dispatchGsmLine(const char* line, size_t length, void* context) {
+    /* Keep the passthrough view of the modem on the debug serial */
+    printGsmLine(line, length, context);
+
+    /* NMEA sentences (AT+CGPSINFOCFG) go to the GNSS parser, unless the line is the text of
+       an SMS */
+    if (length > 0U && line[0] == '$' && !gsmUrcDispatcher.expectsBody()) {
+        gnssParser.feedLine(line, length);
+        return;
+    }
+
+    /* Act on recognised URCs */
+    gsmUrcDispatcher.dispatch(line, length);
+    if (gsmUrcDispatcher.expectsBody()) {
+        gsmAtEngine.routeNextLineUnsolicited();
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Registers the default URC handlers that keep gsmModemStatus up to date.
+* @details      Handles RING, +CLIP, +CMT, +CMTI, +CSQ, +CPIN, +CGPSINFO and +CGNSINF. Feature
+*               modules may replace individual handlers afterwards through
+*               gsmUrcDispatcher.registerHandler().
+*
+* @return       void
+*/
+/*================================================================================================*/
+void initGsmUrcHandlers() {
+    gsmUrcDispatcher.registerHandler(URC_RING, onRingUrc, NULL);
+    gsmUrcDispatcher.registerHandler(URC_CLIP, onClipUrc, NULL);
+    gsmUrcDispatcher.registerHandler(URC_CMT, onSmsUrc, NULL);
+    gsmUrcDispatcher.registerHandler(URC_CMTI, onSmsUrc, NULL);
+    gsmUrcDispatcher.registerHandler(URC_CSQ, onCsqUrc, NULL);
+    gsmUrcDispatcher.registerHandler(URC_CPIN, onCpinUrc, NULL);
+    gsmUrcDispatcher.registerHandler(URC_CGPSINFO, onGnssUrc, NULL);
+    gsmUrcDispatcher.registerHandler(URC_CGNSINF, onGnssUrc, NULL);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Forwards debug Serial input to the GSM module and runs "!" console commands.
+* @details      Lines starting with '!' are collected locally and executed on CR or LF; all other
+*               bytes are written to the modem unchanged, so manual AT passthrough keeps working.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void handleConsoleInput() {
+    while (Serial.available() > 0) {
+        char c = (char)Serial.read();
+
+        if (consoleAtLineStart && c == '!') {
+            consoleInCommand = true;
+            consoleCommandLength = 0U;
+        }
+
+        if (consoleInCommand) {
+            if (c == '\r' || c == '\n') {
+                consoleCommand[consoleCommandLength] = '\0';
+                consoleInCommand = false;
+                consoleAtLineStart = true;
+                runConsoleCommand(consoleCommand);
+            } else if (consoleCommandLength < CONSOLE_COMMAND_MAX_LEN) {
+                consoleCommand[consoleCommandLength++] = c;
             }
+            continue;
         }
-    }
 
-    /* Return the accumulated response */
-    return response;
+        gsmSerialPort.write((uint8_t)c);
+        consoleAtLineStart = (c == '\r' || c == '\n');
+        yield(); /* Allow background tasks to run */
+    }
 }
 
 /*================================================================================================*/
@@ -106,12 +330,63 @@ void beepBuzzer(int repeatCount) {
         digitalWrite(BUZZER_PIN, HIGH);
 
         /* Wait for 200 milliseconds */
-        delay(200);
+        delay(BUZZER_BEEP_MS);
 
         /* Turn the buzzer off */
         digitalWrite(BUZZER_PIN, LOW);
 
         /* Wait for another 200 milliseconds */
-        delay(200);
+        delay(BUZZER_BEEP_MS);
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Starts a beep pattern without blocking.
+* @details      Same pattern as beepBuzzer() (BUZZER_BEEP_MS on, BUZZER_BEEP_MS off), played by
+*               serviceBuzzer(). A new pattern replaces the one playing.
+*
+* @param[in]    repeatCount    The number of beeps.
+*
+* @return       None
+*
+* @api
+*/
+/*================================================================================================*/
+void startBuzzer(int repeatCount) {
+    if (repeatCount <= 0) {
+        buzzerEdgesLeft = 0U;
+        digitalWrite(BUZZER_PIN, LOW);
+        return;
+    }
+    /* First beep starts now; every beep is an on edge and an off edge */
+    digitalWrite(BUZZER_PIN, HIGH);
+    buzzerEdgesLeft = (uint8_t)((repeatCount > 127) ? 253 : (repeatCount * 2 - 1));
+    buzzerNextEdgeMs = millis() + BUZZER_BEEP_MS;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Advances the beep pattern started by startBuzzer(); call from loop().
+*
+* @return       uint32_t    Milliseconds until the next on/off edge, 0 when no pattern is playing.
+*
+* @api
+*/
+/*================================================================================================*/
+uint32_t serviceBuzzer() {
+    if (buzzerEdgesLeft == 0U) {
+        return 0U;
+    }
+    if ((int32_t)(millis() - buzzerNextEdgeMs) >= 0) {
+        buzzerEdgesLeft--;
+        /* Edges alternate off / on, ending with the buzzer off */
+        digitalWrite(BUZZER_PIN, ((buzzerEdgesLeft & 1U) == 0U) ? LOW : HIGH);
+        buzzerNextEdgeMs += BUZZER_BEEP_MS;
+        if (buzzerEdgesLeft == 0U) {
+            return 0U;
+        }
     }
+    int32_t remaining = (int32_t)(buzzerNextEdgeMs - millis());
+    return (remaining > 0) ? (uint32_t)remaining : 1U;
 }
\ No newline at end of file
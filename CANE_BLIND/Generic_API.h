@@ -5,9 +5,10 @@
  * INCLUDES
  ******************************************************************************/
 #include <Arduino.h>
-#include <HTTPClient.h>
-#include <ArduinoJson.h>
-#include <Wire.h>
+#include "AT_Engine.h"
+#include "URC_Dispatcher.h"
+#include "AT_Catalog.h"
+#include "LOG_Ring.h"
 
 
 /******************************************************************************
@@ -16,6 +17,8 @@
 /* Pin mapping for GSM/GNSS module (UART and control pins) */
 #define PIN_GSM_UART_RECEIVE           33  /* UART RX pin for GSM/GNSS module */
 #define PIN_GSM_UART_TRANSMIT          25  /* UART TX pin for GSM/GNSS module */
+#define PIN_GSM_UART_RTS               -1  /* UART RTS pin, -1 if flow control is not wired */
+#define PIN_GSM_UART_CTS               -1  /* UART CTS pin, -1 if flow control is not wired */
 
 /* Debug mode enable flag - Set to true to enable debug prints */
 #define DEBUG_MODE_ENABLED   true
@@ -23,15 +26,12 @@
 /* Pin mapping for the buzzer */
 #define BUZZER_PIN           26
 
+/* Length of one buzzer beep and of the pause after it */
+#define BUZZER_BEEP_MS       200U
+
 /* SOS phone number in international format */
 #define SOS_PHONE_NUMBER   "0387695355"
 
-/* Define a default timeout value for reading GSM response (in milliseconds) */
-#define GSM_RESPONSE_TIMEOUT_MS 1000
-
-/* Define default delay after sending AT command (in milliseconds) */
-#define GSM_COMMAND_WAIT_MS 800
-
 /* Task stack size (bytes) */
 #define TASK_STACK_SIZE 2048
 
@@ -55,53 +55,138 @@
 
 /* I2C Clock */
 #define I2C_CLOCK 100000
+
+/* Maximum length of a caller/sender number kept from URCs */
+#define GSM_NUMBER_MAX_LEN 24
+
+/* Maximum length of a "!" console command typed on the debug Serial */
+#define CONSOLE_COMMAND_MAX_LEN 40
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Modem state learned from unsolicited result codes */
+typedef struct {
+    int8_t   signalRssi;                        /* Last +CSQ <rssi> (0..31), 99 = unknown */
+    bool     simReady;                          /* True after "+CPIN: READY" */
+    uint32_t lastRingMs;                        /* millis() of the last RING, 0 = never */
+    uint16_t ringCount;                         /* Number of RING alerts received */
+    uint16_t smsReceived;                       /* Number of +CMT/+CMTI messages received */
+    char     lastCaller[GSM_NUMBER_MAX_LEN];    /* Number from the last +CLIP */
+} GsmModemStatus;
 /******************************************************************************
  * GLOBAL VARIABLES
  ******************************************************************************/
 /* Externally defined HardwareSerial instance for GSM/GNSS communication */
 extern HardwareSerial gsmSerialPort;
 
+/* AT command engine bound to gsmSerialPort */
+extern AtEngine gsmAtEngine;
+
+/* Dispatcher for unsolicited result codes received on gsmSerialPort */
+extern UrcDispatcher gsmUrcDispatcher;
+
+/* Modem state maintained by the default URC handlers */
+extern GsmModemStatus gsmModemStatus;
+
 /******************************************************************************
  * FUNCTIONS PROTOTYPES
  ******************************************************************************/
 /*================================================================================================*/
 /**
-* @brief        Sends an AT command to the GSM module and triggers response reading.
-* @details      Transmits the specified AT command to the GSM module through the GSM UART port,
-*               waits a configurable delay to allow the module to process the command, and then
-*               invokes readGsmResponse() to retrieve the response from the module.
-*               The function does not return the response directly; instead, response handling
-*               is deferred to the readGsmResponse() implementation.
+* @brief        Sends a catalog AT command to the GSM module and waits for its final result code.
+* @details      Queues the command on gsmAtEngine and polls the engine until the module answers
+*               with one of the descriptor's terminators (OK, ERROR, +CME ERROR, +CMS ERROR or
+*               the "> " prompt), or until the descriptor's deadline expires. The call returns as
+*               soon as the module has answered instead of sleeping for a fixed time.
 *
-* @param[in]    atCommand       The AT command string to send to the GSM module.
-* @param[in]    waitMs          Delay time (in milliseconds) after sending the command before
-*                               attempting to read the response.
+* @param[in]    command         Catalog descriptor of the command (see AT_Catalog.h).
+* @param[in]    argument        Argument for parameterised commands (e.g. a phone number),
+*                               or NULL.
 *
-* @return       void
+* @return       AtResult        Final result of the command.
 *
 * @note         Uses the GSM UART interface referenced as gsmSerialPort.
 */
 /*================================================================================================*/
 
-void sendGsmCommand(String atCommand, uint16_t waitMs);
+AtResult sendGsmCommand(const AtCommandDesc& command, const char* argument = NULL);
 
 /*================================================================================================*/
 /**
 * @brief        Reads the response from the GSM module over the serial port.
-* @details      Continuously reads incoming characters from the GSM module via the 
-*               specified UART port until the specified timeout expires. All received 
-*               characters are accumulated in a String and optionally printed to the 
-*               debug Serial monitor if enabled.
+* @details      Polls gsmAtEngine until the specified timeout expires. Received bytes go through
+*               the engine's fixed ring buffer and line framer, so no heap memory is used; each
+*               complete line that is not part of a pending command is handed to the engine's
+*               unsolicited handler (printGsmLine() by default).
 *
 * @param[in]    timeoutMs       Maximum waiting time in milliseconds for the response.
-* @param[in]    enableDebug     If true, prints each received character to the Serial monitor.
 *
-* @return       String          The full response collected from the GSM module.
+* @return       void
 *
-* @note         Non-blocking inside timeout window; relies on gsmSerialPort.available().
+* @note         Relies on gsmAtEngine.poll().
 */
 /*================================================================================================*/
-String readGsmResponse(uint16_t timeoutMs);
+void readGsmResponse(uint16_t timeoutMs);
+
+/*================================================================================================*/
+/**
+* @brief        Logs one line received from the GSM module to the debug Serial monitor.
+* @details      Matches the AtUnsolicitedHandler signature so it can be registered on
+*               gsmAtEngine to echo modem output that no command has claimed. The line is copied
+*               into the log ring, so the caller never waits for USB-CDC.
+*
+* @param[in]    line            NUL-terminated line text.
+* @param[in]    length          Number of characters in line.
+* @param[in]    context         Unused.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void printGsmLine(const char* line, size_t length, void* context);
+
+/*================================================================================================*/
+/**
+* @brief        Echoes an unsolicited modem line and passes it to gsmUrcDispatcher.
+* @details      Registered on gsmAtEngine as the unsolicited handler. When the line starts a
+*               two-line URC (+CMT), the engine is told to route the following body line here
+*               as well.
+*
+* @param[in]    line            NUL-terminated line text.
+* @param[in]    length          Number of characters in line.
+* @param[in]    context         Unused.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void dispatchGsmLine(const char* line, size_t length, void* context);
+
+/*================================================================================================*/
+/**
+* @brief        Registers the default URC handlers that keep gsmModemStatus up to date.
+* @details      Handles RING, +CLIP, +CMT, +CMTI, +CSQ, +CPIN, +CGPSINFO and +CGNSINF. Feature
+*               modules may replace individual handlers afterwards through
+*               gsmUrcDispatcher.registerHandler().
+*
+* @return       void
+*/
+/*================================================================================================*/
+void initGsmUrcHandlers();
+
+/*================================================================================================*/
+/**
+* @brief        Forwards debug Serial input to the GSM module and runs "!" console commands.
+* @details      Lines starting with '!' are not sent to the modem but handled locally:
+*               "!stats" prints the AT latency histograms and module statistics,
+*               "!stats reset" clears the histograms, "!contacts" lists the emergency contacts,
+*               "!contacts add <number>" and "!contacts del <index>" edit the list and "!sos"
+*               prints the last alert and the cached location. Everything else is passed
+*               through.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void handleConsoleInput();
 
 /*================================================================================================*/
 /**
@@ -119,4 +204,30 @@ String readGsmResponse(uint16_t timeoutMs);
 */
 /*================================================================================================*/
 void beepBuzzer(int repeatCount);
+
+/*================================================================================================*/
+/**
+* @brief        Starts a beep pattern without blocking.
+* @details      Same pattern as beepBuzzer() (BUZZER_BEEP_MS on, BUZZER_BEEP_MS off), played by
+*               serviceBuzzer(). A new pattern replaces the one playing.
+*
+* @param[in]    repeatCount    The number of beeps.
+*
+* @return       None
+*
+* @api
+*/
+/*================================================================================================*/
+void startBuzzer(int repeatCount);
+
+/*================================================================================================*/
+/**
+* @brief        Advances the beep pattern started by startBuzzer(); call from loop().
+*
+* @return       uint32_t    Milliseconds until the next on/off edge, 0 when no pattern is playing.
+*
+* @api
+*/
+/*================================================================================================*/
+uint32_t serviceBuzzer();
 #endif
\ No newline at end of file
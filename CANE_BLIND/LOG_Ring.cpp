@@ -0,0 +1,211 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "LOG_Ring.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static_assert(LOG_RING_SIZE > 0U && (LOG_RING_SIZE & (LOG_RING_SIZE - 1U)) == 0U,
+              "LOG_RING_SIZE must be a power of two");
+static_assert(sizeof(unsigned int) >= sizeof(uint32_t),
+              "log arguments are printed as unsigned int");
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* System-wide logger used by the LOG_* macros */
+LogRing systemLog;
+
+/* One-letter level tags, indexed by LOG_LEVEL_* */
+static const char LOG_LEVEL_TAGS[] = { '-', 'E', 'W', 'I', 'D' };
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the LogRing class.
+* @details      Cell i starts with sequence i, meaning "free for the producer at position i".
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+LogRing::LogRing()
+    : enqueuePosition(0U), dequeuePosition(0U), writtenCount(0U), droppedCount(0U),
+      producerCycles(0U), drainedCount(0U), drainMicros(0U), reportedDrops(0U), output(NULL) {
+    for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Starts the drain task printing to the given output.
+* @details      Records written before begin() stay in the ring and are printed once the task
+*               runs (older ones are dropped if the ring fills up first).
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       bool        True if the drain task is running.
+*/
+/*================================================================================================*/
+bool LogRing::begin(Print& out) {
+    output = &out;
+    return xTaskCreatePinnedToCore(taskEntry, "logDrain", LOG_DRAIN_TASK_STACK_SIZE, this,
+                                   LOG_DRAIN_TASK_PRIORITY, NULL, 1) == pdPASS;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Formats and prints every queued record (called by the drain task).
+* @details      Also reports newly dropped records, so gaps in the output are visible.
+*
+* @return       uint32_t    Number of records printed.
+*/
+/*================================================================================================*/
+uint32_t LogRing::drain() {
+    LogRecord record;
+    char line[LOG_LINE_MAX_LEN];
+    uint32_t printed = 0U;
+
+    if (output == NULL) {
+        return 0U;
+    }
+
+    while (pop(record)) {
+        uint32_t startUs = micros();
+        int length = snprintf(line, sizeof(line), "%6lu %c ", (unsigned long)record.timestampMs,
+                              LOG_LEVEL_TAGS[(record.level <= LOG_LEVEL_DEBUG) ? record.level : 0U]);
+        if (record.hasText) {
+            length += snprintf(&line[length], sizeof(line) - (size_t)length, record.format,
+                               record.text);
+        } else {
+            length += snprintf(&line[length], sizeof(line) - (size_t)length, record.format,
+                               (unsigned)record.args[0], (unsigned)record.args[1],
+                               (unsigned)record.args[2], (unsigned)record.args[3]);
+        }
+        if (length > (int)sizeof(line) - 1) {
+            length = (int)sizeof(line) - 1;
+        }
+        output->write((const uint8_t*)line, (size_t)length);
+        output->println();
+        drainMicros += micros() - startUs;
+        drainedCount++;
+        printed++;
+    }
+
+    uint32_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops) {
+        output->printf("[LOG] %lu record(s) dropped\n", (unsigned long)(dropped - reportedDrops));
+        reportedDrops = dropped;
+    }
+    return printed;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints record counts and the caller time saved by deferring the output.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void LogRing::printStats(Print& out) const {
+    uint32_t written = writtenCount.load(std::memory_order_relaxed);
+    uint32_t producerUs = producerCycles.load(std::memory_order_relaxed) / getCpuFreqMhz();
+    uint32_t savedUs = (drainMicros > producerUs) ? (drainMicros - producerUs) : 0U;
+
+    out.printf("[LOG] %lu written, %lu dropped, %lu printed\n", (unsigned long)written,
+               (unsigned long)recordsDropped(), (unsigned long)drainedCount);
+    out.printf("[LOG] callers spent %lu us writing records, printing took %lu us: %lu us saved\n",
+               (unsigned long)producerUs, (unsigned long)drainMicros, (unsigned long)savedUs);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Claims the cell at the enqueue position, fills it and publishes it */
+void LogRing::push(uint8_t level, const char* format, const uint32_t* args, uint8_t argCount,
+                   const char* text, size_t length) {
+    uint32_t startCycles = ESP.getCycleCount();
+    uint32_t position = enqueuePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    for (;;) {
+        cell = &cells[position & (LOG_RING_SIZE - 1U)];
+        int32_t difference = (int32_t)(cell->sequence.load(std::memory_order_acquire) - position);
+        if (difference == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1U,
+                                                      std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            /* Ring full: the consumer has not freed this cell yet */
+            droppedCount.fetch_add(1U, std::memory_order_relaxed);
+            return;
+        } else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    LogRecord& record = cell->record;
+    record.timestampMs = millis();
+    record.format = format;
+    record.level = level;
+    record.argCount = argCount;
+    for (uint8_t i = 0; i < LOG_MAX_ARGS; i++) {
+        record.args[i] = (i < argCount) ? args[i] : 0U;
+    }
+    record.hasText = (text != NULL);
+    if (record.hasText) {
+        size_t copyLength = (length < LOG_TEXT_MAX_LEN - 1U) ? length : (LOG_TEXT_MAX_LEN - 1U);
+        memcpy(record.text, text, copyLength);
+        record.text[copyLength] = '\0';
+    }
+
+    cell->sequence.store(position + 1U, std::memory_order_release);
+    writtenCount.fetch_add(1U, std::memory_order_relaxed);
+    producerCycles.fetch_add(ESP.getCycleCount() - startCycles, std::memory_order_relaxed);
+}
+
+/* Takes the cell at the dequeue position once its producer has published it */
+bool LogRing::pop(LogRecord& record) {
+    uint32_t position = dequeuePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    for (;;) {
+        cell = &cells[position & (LOG_RING_SIZE - 1U)];
+        int32_t difference = (int32_t)(cell->sequence.load(std::memory_order_acquire) -
+                                       (position + 1U));
+        if (difference == 0) {
+            if (dequeuePosition.compare_exchange_weak(position, position + 1U,
+                                                      std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            /* Empty, or the producer of this cell has not finished yet */
+            return false;
+        } else {
+            position = dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    record = cell->record;
+    cell->sequence.store(position + LOG_RING_SIZE, std::memory_order_release);
+    return true;
+}
+
+/* Drain task body: print everything queued, then sleep; report the statistics periodically */
+void LogRing::taskEntry(void* parameter) {
+    LogRing* ring = static_cast<LogRing*>(parameter);
+    uint32_t lastStatsMs = millis();
+    for (;;) {
+        ring->drain();
+        if (LOG_STATS_PERIOD_MS > 0U && (uint32_t)(millis() - lastStatsMs) >= LOG_STATS_PERIOD_MS) {
+            lastStatsMs = millis();
+            ring->printStats(*ring->output);
+        }
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+    }
+}
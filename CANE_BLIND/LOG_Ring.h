@@ -0,0 +1,228 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Log levels; records above LOG_LEVEL are removed at compile time */
+#define LOG_LEVEL_NONE            0
+#define LOG_LEVEL_ERROR           1
+#define LOG_LEVEL_WARN            2
+#define LOG_LEVEL_INFO            3
+#define LOG_LEVEL_DEBUG           4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL                 LOG_LEVEL_INFO
+#endif
+
+/* Number of records the ring holds (must be a power of two) */
+#define LOG_RING_SIZE             32U
+
+/* Maximum number of integer arguments per record */
+#define LOG_MAX_ARGS              4U
+
+/* Maximum length of the text payload copied into a record (including the NUL) */
+#define LOG_TEXT_MAX_LEN          96U
+
+/* Maximum length of one formatted output line */
+#define LOG_LINE_MAX_LEN          160U
+
+/* Drain task settings */
+#define LOG_DRAIN_TASK_STACK_SIZE 3072U
+#define LOG_DRAIN_TASK_PRIORITY   1U
+#define LOG_DRAIN_PERIOD_MS       20U
+
+/* Interval at which the drain task prints the logger statistics (ms), 0 to disable */
+#define LOG_STATS_PERIOD_MS       60000U
+
+/* Logging macros: format must be a string literal, arguments must be integers printed with
+   %u, %d or %x and no length modifier (they are stored in 32 bits and printed as unsigned int).
+   Disabled levels are still type-checked but compile to nothing. */
+#define LOG_DISCARD(call)         do { if (false) { call; } } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...)                        systemLog.write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_ERROR_TEXT(format, text, length)  systemLog.writeText(LOG_LEVEL_ERROR, format, text, length)
+#else
+#define LOG_ERROR(...)                        LOG_DISCARD(systemLog.write(LOG_LEVEL_ERROR, __VA_ARGS__))
+#define LOG_ERROR_TEXT(format, text, length)  LOG_DISCARD(systemLog.writeText(LOG_LEVEL_ERROR, format, text, length))
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...)                         systemLog.write(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_WARN_TEXT(format, text, length)   systemLog.writeText(LOG_LEVEL_WARN, format, text, length)
+#else
+#define LOG_WARN(...)                         LOG_DISCARD(systemLog.write(LOG_LEVEL_WARN, __VA_ARGS__))
+#define LOG_WARN_TEXT(format, text, length)   LOG_DISCARD(systemLog.writeText(LOG_LEVEL_WARN, format, text, length))
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...)                         systemLog.write(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_INFO_TEXT(format, text, length)   systemLog.writeText(LOG_LEVEL_INFO, format, text, length)
+#else
+#define LOG_INFO(...)                         LOG_DISCARD(systemLog.write(LOG_LEVEL_INFO, __VA_ARGS__))
+#define LOG_INFO_TEXT(format, text, length)   LOG_DISCARD(systemLog.writeText(LOG_LEVEL_INFO, format, text, length))
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)                        systemLog.write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_DEBUG_TEXT(format, text, length)  systemLog.writeText(LOG_LEVEL_DEBUG, format, text, length)
+#else
+#define LOG_DEBUG(...)                        LOG_DISCARD(systemLog.write(LOG_LEVEL_DEBUG, __VA_ARGS__))
+#define LOG_DEBUG_TEXT(format, text, length)  LOG_DISCARD(systemLog.writeText(LOG_LEVEL_DEBUG, format, text, length))
+#endif
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* One binary log record; formatting happens in the drain task */
+typedef struct {
+    uint32_t    timestampMs;                /* millis() when the record was written */
+    const char* format;                     /* printf format (string literal) */
+    uint8_t     level;                      /* LOG_LEVEL_* */
+    uint8_t     argCount;                   /* Number of valid entries in args */
+    bool        hasText;                    /* True if text holds a copied string */
+    uint32_t    args[LOG_MAX_ARGS];         /* Integer arguments, printed as unsigned int */
+    char        text[LOG_TEXT_MAX_LEN];     /* Optional copied text, consumed by the first %s */
+} LogRecord;
+
+/* Converts one log argument to a record word; rejects floats and pointers at compile time */
+template <typename T>
+inline uint32_t logArgument(T value) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "log arguments must be integers; scale floats and copy text with *_TEXT");
+    return (uint32_t)value;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class LogRing
+* @brief Asynchronous logger: callers store a small binary record, a low priority task prints it.
+* @details Records go into a bounded lock-free multi-producer/multi-consumer ring (one sequence
+* number per cell), so any task may log without taking a lock and without waiting for USB-CDC.
+* When the ring is full the record is dropped and counted. The logger also measures the time
+* callers spend writing records and the time the drain task spends formatting and printing
+* them, i.e. the time the callers no longer block for.
+*
+* @api
+*/
+/*================================================================================================*/
+class LogRing {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the LogRing class.
+    */
+    /*============================================================================================*/
+    LogRing();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Starts the drain task printing to the given output.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       bool        True if the drain task is running.
+    */
+    /*============================================================================================*/
+    bool begin(Print& out);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Stores a record with up to LOG_MAX_ARGS integer arguments. Never blocks.
+    *
+    * @param[in]    level       LOG_LEVEL_* of the record.
+    * @param[in]    format      printf format; must be a string literal.
+    * @param[in]    args        Integer arguments.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    template <typename... Args>
+    void write(uint8_t level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+        const uint32_t words[] = { 0U, logArgument(args)... };
+        push(level, format, &words[1], (uint8_t)sizeof...(Args), NULL, 0U);
+    }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Stores a record carrying a copy of text, consumed by the first %s of format.
+    *
+    * @param[in]    level       LOG_LEVEL_* of the record.
+    * @param[in]    format      printf format with exactly one %s; must be a string literal.
+    * @param[in]    text        Text to copy (truncated to LOG_TEXT_MAX_LEN - 1).
+    * @param[in]    length      Number of characters in text.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void writeText(uint8_t level, const char* format, const char* text, size_t length) {
+        push(level, format, NULL, 0U, text, length);
+    }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Formats and prints every queued record (called by the drain task).
+    *
+    * @return       uint32_t    Number of records printed.
+    */
+    /*============================================================================================*/
+    uint32_t drain();
+
+    /* Statistics */
+    uint32_t recordsWritten() const { return writtenCount.load(std::memory_order_relaxed); }
+    uint32_t recordsDropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints record counts and the caller time saved by deferring the output.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+private:
+    /* Ring cell: the sequence number tells producers and consumers whose turn it is */
+    typedef struct {
+        std::atomic<uint32_t> sequence;
+        LogRecord record;
+    } Cell;
+
+    void push(uint8_t level, const char* format, const uint32_t* args, uint8_t argCount,
+              const char* text, size_t length);
+    bool pop(LogRecord& record);
+    static void taskEntry(void* parameter);
+
+    Cell cells[LOG_RING_SIZE];
+    std::atomic<uint32_t> enqueuePosition;
+    std::atomic<uint32_t> dequeuePosition;
+    std::atomic<uint32_t> writtenCount;
+    std::atomic<uint32_t> droppedCount;
+    std::atomic<uint32_t> producerCycles;
+    uint32_t drainedCount;
+    uint32_t drainMicros;
+    uint32_t reportedDrops;
+    Print* output;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* System-wide logger used by the LOG_* macros */
+extern LogRing systemLog;
+
+#endif /* LOG_RING_H */
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "MODEM_Init.h"
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the ModemInitRunner class.
+*
+* @param[in]    engine      AT engine used to talk to the modem.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+ModemInitRunner::ModemInitRunner(AtEngine& engine)
+    : engine(engine), steps(NULL), stepCount(0U), currentStep(0U), probing(false),
+      finished(true), handle(AT_INVALID_HANDLE), beginMs(0U), endMs(0U), stepStartMs(0U) {
+    memset(status, 0, sizeof(status));
+    memset(durationMs, 0, sizeof(durationMs));
+    memset(attempts, 0, sizeof(attempts));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Starts running a script. The script array must outlive the run.
+* @details      Resets all per-step results and submits the first step immediately.
+*
+* @param[in]    steps       Array of steps.
+* @param[in]    count       Number of steps (at most MODEM_INIT_MAX_STEPS).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ModemInitRunner::begin(const ModemInitStep* steps, uint8_t count) {
+    this->steps = steps;
+    stepCount = (count > MODEM_INIT_MAX_STEPS) ? MODEM_INIT_MAX_STEPS : count;
+    currentStep = 0U;
+    finished = false;
+    handle = AT_INVALID_HANDLE;
+    beginMs = millis();
+    endMs = beginMs;
+    memset(status, 0, sizeof(status));
+    memset(durationMs, 0, sizeof(durationMs));
+    memset(attempts, 0, sizeof(attempts));
+
+    startStep();
+}
+
+/*================================================================================================*/
+/**
+* @brief        Advances the script; never blocks.
+* @details      Polls the engine and, once the current command has a result, decides whether to
+*               skip, retry, or move on. The next command is submitted in the same call, so the
+*               modem is never left idle between steps.
+*
+* @return       bool        True once every step has finished.
+*/
+/*================================================================================================*/
+bool ModemInitRunner::poll() {
+    if (finished) {
+        return true;
+    }
+
+    engine.poll();
+
+    AtResult result = engine.result(handle);
+    if (result == AT_RESULT_PENDING) {
+        return false;
+    }
+
+    const ModemInitStep& step = steps[currentStep];
+
+    if (probing) {
+        /* Probe answered: skip the step if the setting is already in effect */
+        bool inEffect = (result == AT_RESULT_OK) &&
+                        (strstr(engine.response(handle), step.probeExpect) != NULL);
+        engine.release(handle);
+        if (inEffect) {
+            finishStep(MODEM_STEP_SKIPPED);
+        } else {
+            probing = false;
+            submitCurrent();
+        }
+        return finished;
+    }
+
+    engine.release(handle);
+    if (result == AT_RESULT_OK) {
+        finishStep(MODEM_STEP_APPLIED);
+    } else if (attempts[currentStep] <= step.retries) {
+        submitCurrent();
+    } else {
+        finishStep(MODEM_STEP_FAILED);
+    }
+    return finished;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns true if the script finished and no required step failed.
+*/
+/*================================================================================================*/
+bool ModemInitRunner::isReady() const {
+    if (!finished) {
+        return false;
+    }
+    for (uint8_t i = 0; i < stepCount; i++) {
+        if (steps[i].required && status[i] == MODEM_STEP_FAILED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the time from begin() to the end of the script (or until now).
+*/
+/*================================================================================================*/
+uint32_t ModemInitRunner::totalMs() const {
+    return (finished ? endMs : millis()) - beginMs;
+}
+
+ModemStepStatus ModemInitRunner::stepStatus(uint8_t index) const {
+    return (index < stepCount) ? status[index] : MODEM_STEP_PENDING;
+}
+
+uint32_t ModemInitRunner::stepMs(uint8_t index) const {
+    return (index < stepCount) ? durationMs[index] : 0U;
+}
+
+uint8_t ModemInitRunner::stepAttempts(uint8_t index) const {
+    return (index < stepCount) ? attempts[index] : 0U;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints one line per step plus the total time-to-ready.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ModemInitRunner::printReport(Print& out) const {
+    static const char* const STATUS_NAMES[] = { "pending", "applied", "skipped", "FAILED" };
+
+    for (uint8_t i = 0; i < stepCount; i++) {
+        out.printf("[INIT] %-20s %-7s %5lu ms (%u attempt%s)\n", steps[i].command->prefix,
+                   STATUS_NAMES[status[i]], (unsigned long)durationMs[i], attempts[i],
+                   (attempts[i] == 1U) ? "" : "s");
+    }
+    out.printf("[INIT] Modem %s after %lu ms\n", isReady() ? "ready" : "NOT ready",
+               (unsigned long)totalMs());
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Begins the current step with its probe (if any) or its command */
+void ModemInitRunner::startStep() {
+    if (currentStep >= stepCount) {
+        finished = true;
+        endMs = millis();
+        return;
+    }
+
+    const ModemInitStep& step = steps[currentStep];
+    stepStartMs = millis();
+    probing = (step.probe != NULL) && (step.probeExpect != NULL);
+
+    if (probing) {
+        handle = engine.submit(*step.probe);
+        if (handle == AT_INVALID_HANDLE) {
+            probing = false;
+            submitCurrent();
+        }
+    } else {
+        submitCurrent();
+    }
+}
+
+/* Submits one attempt of the current step's command */
+void ModemInitRunner::submitCurrent() {
+    const ModemInitStep& step = steps[currentStep];
+    attempts[currentStep]++;
+    handle = engine.submit(*step.command);
+    if (handle == AT_INVALID_HANDLE) {
+        finishStep(MODEM_STEP_FAILED);
+    }
+}
+
+/* Records the result of the current step and starts the next one */
+void ModemInitRunner::finishStep(ModemStepStatus stepResult) {
+    status[currentStep] = stepResult;
+    durationMs[currentStep] = millis() - stepStartMs;
+    handle = AT_INVALID_HANDLE;
+    currentStep++;
+    startStep();
+}
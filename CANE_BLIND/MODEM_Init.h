@@ -0,0 +1,134 @@
+#ifndef MODEM_INIT_H
+#define MODEM_INIT_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "AT_Engine.h"
+#include "AT_Catalog.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Maximum number of steps in one init script */
+#define MODEM_INIT_MAX_STEPS      16
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* One declarative step of a modem init script */
+typedef struct {
+    const AtCommandDesc* command;       /* Catalog command that applies the setting */
+    const AtCommandDesc* probe;         /* Optional catalog query, NULL to always apply */
+    const char*          probeExpect;   /* Text in the probe response meaning "already in effect" */
+    uint8_t              retries;       /* Extra attempts after a failed apply */
+    bool                 required;      /* If true, the modem is not ready when this step fails */
+} ModemInitStep;
+
+/* Outcome of one step */
+typedef enum {
+    MODEM_STEP_PENDING = 0,     /* Not finished yet */
+    MODEM_STEP_APPLIED,         /* Command answered OK */
+    MODEM_STEP_SKIPPED,         /* Probe showed the setting was already in effect */
+    MODEM_STEP_FAILED           /* All attempts failed */
+} ModemStepStatus;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class ModemInitRunner
+* @brief Runs a declarative modem init script on top of AtEngine without fixed delays.
+* @details Each step is submitted as soon as the previous one has answered. Steps with a probe
+* are queried first and skipped if the expected setting is already active (for example after an
+* ESP32 reset while the modem stayed powered). Failed steps are retried, and per-step and total
+* time-to-ready are recorded.
+*
+* @api
+*/
+/*================================================================================================*/
+class ModemInitRunner {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the ModemInitRunner class.
+    *
+    * @param[in]    engine      AT engine used to talk to the modem.
+    */
+    /*============================================================================================*/
+    ModemInitRunner(AtEngine& engine);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Starts running a script. The script array must outlive the run.
+    *
+    * @param[in]    steps       Array of steps.
+    * @param[in]    count       Number of steps (at most MODEM_INIT_MAX_STEPS).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void begin(const ModemInitStep* steps, uint8_t count);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Advances the script; never blocks.
+    *
+    * @return       bool        True once every step has finished.
+    */
+    /*============================================================================================*/
+    bool poll();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns true if the script finished and no required step failed.
+    */
+    /*============================================================================================*/
+    bool isReady() const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the time from begin() to the end of the script (or until now).
+    */
+    /*============================================================================================*/
+    uint32_t totalMs() const;
+
+    /* Per-step results */
+    ModemStepStatus stepStatus(uint8_t index) const;
+    uint32_t stepMs(uint8_t index) const;
+    uint8_t stepAttempts(uint8_t index) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints one line per step plus the total time-to-ready.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printReport(Print& out) const;
+
+private:
+    void startStep();
+    void submitCurrent();
+    void finishStep(ModemStepStatus status);
+
+    AtEngine& engine;
+    const ModemInitStep* steps;
+    uint8_t stepCount;
+    uint8_t currentStep;
+    bool probing;
+    bool finished;
+    AtHandle handle;
+    uint32_t beginMs;
+    uint32_t endMs;
+    uint32_t stepStartMs;
+    ModemStepStatus status[MODEM_INIT_MAX_STEPS];
+    uint32_t durationMs[MODEM_INIT_MAX_STEPS];
+    uint8_t attempts[MODEM_INIT_MAX_STEPS];
+};
+
+#endif /* MODEM_INIT_H */
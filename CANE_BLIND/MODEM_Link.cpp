@@ -0,0 +1,237 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "MODEM_Link.h"
+#include "AT_Catalog.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Rates tried by the negotiation, fastest first; the last entry must be MODEM_BAUD_DEFAULT */
+static const uint32_t MODEM_BAUD_CANDIDATES[] = { 921600UL, 460800UL, 230400UL, 115200UL };
+static const uint8_t MODEM_BAUD_CANDIDATE_COUNT =
+    sizeof(MODEM_BAUD_CANDIDATES) / sizeof(MODEM_BAUD_CANDIDATES[0]);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the ModemLink class.
+*
+* @param[in]    serial      UART connected to the module.
+* @param[in]    engine      AT engine bound to the same UART.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+ModemLink::ModemLink(HardwareSerial& serial, AtEngine& engine)
+    : serial(serial), engine(engine), lastSampleMs(0U), lastSampleBytes(0U) {
+    memset(&linkStats, 0, sizeof(linkStats));
+    linkStats.baudRate = MODEM_BAUD_DEFAULT;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Opens the UART and negotiates the link (blocking, boot time only).
+* @details      AT+IPR is stored by the module, so after an ESP32 reset the module may already be
+*               on a higher rate; if it does not answer at the default rate, every candidate is
+*               scanned. Right after power-on the module answers at no rate for several
+*               seconds, so the scan is repeated until it answers or MODEM_LINK_READY_TIMEOUT_MS
+*               has passed. Flow control is enabled before raising the rate so the faster link
+*               is never run without it when the pins are wired.
+*
+* @param[in]    rxPin       UART RX pin.
+* @param[in]    txPin       UART TX pin.
+* @param[in]    rtsPin      RTS pin, or -1 to leave flow control off.
+* @param[in]    ctsPin      CTS pin, or -1 to leave flow control off.
+*
+* @return       bool        True if the module answered at some rate within
+*                           MODEM_LINK_READY_TIMEOUT_MS.
+*/
+/*================================================================================================*/
+bool ModemLink::begin(int8_t rxPin, int8_t txPin, int8_t rtsPin, int8_t ctsPin) {
+    uint32_t startMs = millis();
+
+    /* The driver buffer can only be resized while the UART is closed */
+    serial.setRxBufferSize(MODEM_UART_RX_BUFFER_SIZE);
+    serial.begin(MODEM_BAUD_DEFAULT, SERIAL_8N1, rxPin, txPin);
+    serial.onReceiveError([this](hardwareSerial_error_t error) {
+        if (error == UART_BUFFER_FULL_ERROR) {
+            linkStats.bufferOverruns++;
+        } else if (error == UART_FIFO_OVF_ERROR) {
+            linkStats.fifoOverflows++;
+        } else {
+            linkStats.lineErrors++;
+        }
+    });
+    engine.resetInput();
+    linkStats.baudRate = MODEM_BAUD_DEFAULT;
+
+    bool ready = probe(1U) || findCurrentRate();
+    while (!ready && (uint32_t)(millis() - startMs) < MODEM_LINK_READY_TIMEOUT_MS) {
+        ready = probe(1U) || findCurrentRate();
+    }
+    if (!ready) {
+        linkStats.negotiationMs = millis() - startMs;
+        return false;
+    }
+
+    if (rtsPin >= 0 && ctsPin >= 0) {
+        AtHandle handle = engine.submit(AT_CMD_FLOW_CONTROL_ON);
+        AtResult result = engine.waitFor(handle);
+        engine.release(handle);
+        if (result == AT_RESULT_OK) {
+            serial.setPins(rxPin, txPin, ctsPin, rtsPin);
+            serial.setHwFlowCtrlMode();
+            linkStats.flowControl = probe(MODEM_LINK_VERIFY_PROBES);
+            if (!linkStats.flowControl) {
+                /* Lines not wired as configured: run without flow control */
+                serial.setHwFlowCtrlMode(UART_HW_FLOWCTRL_DISABLE);
+                engine.resetInput();
+                handle = engine.submit(AT_CMD_FLOW_CONTROL_OFF);
+                engine.waitFor(handle);
+                engine.release(handle);
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < MODEM_BAUD_CANDIDATE_COUNT; i++) {
+        uint32_t rate = MODEM_BAUD_CANDIDATES[i];
+        if (rate > MODEM_BAUD_MAX || rate <= linkStats.baudRate) {
+            continue;
+        }
+        if (switchTo(rate)) {
+            break;
+        }
+        /* Stop raising the rate once the fallback could not bring the module back */
+        if (!probe(1U)) {
+            break;
+        }
+    }
+
+    bool answered = probe(1U) || findCurrentRate();
+    lastSampleMs = millis();
+    lastSampleBytes = engine.bytesReceived();
+    linkStats.negotiationMs = lastSampleMs - startMs;
+    return answered;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Updates the throughput measurement; call periodically from the main loop.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ModemLink::sample() {
+    uint32_t now = millis();
+    uint32_t elapsed = now - lastSampleMs;
+    if (elapsed < MODEM_LINK_SAMPLE_MS) {
+        return;
+    }
+
+    uint32_t received = engine.bytesReceived();
+    linkStats.rxBytesPerSec = (uint32_t)(((uint64_t)(received - lastSampleBytes) * 1000U) / elapsed);
+    if (linkStats.rxBytesPerSec > linkStats.peakRxBytesPerSec) {
+        linkStats.peakRxBytesPerSec = linkStats.rxBytesPerSec;
+    }
+    linkStats.rxBytes = received;
+    linkStats.txBytes = engine.bytesSent();
+    lastSampleMs = now;
+    lastSampleBytes = received;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the link state on one line.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ModemLink::printStats(Print& out) const {
+    out.printf("[LINK] %lu baud, flow control %s, negotiated in %lu ms\n",
+               (unsigned long)linkStats.baudRate, linkStats.flowControl ? "on" : "off",
+               (unsigned long)linkStats.negotiationMs);
+    out.printf("[LINK] rx %lu B (%lu B/s, peak %lu B/s), tx %lu B, overruns %lu/%lu, line errors %lu\n",
+               (unsigned long)linkStats.rxBytes, (unsigned long)linkStats.rxBytesPerSec,
+               (unsigned long)linkStats.peakRxBytesPerSec, (unsigned long)linkStats.txBytes,
+               (unsigned long)linkStats.bufferOverruns, (unsigned long)linkStats.fifoOverflows,
+               (unsigned long)linkStats.lineErrors);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Sends "AT" count times; true if every attempt answered OK */
+bool ModemLink::probe(uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        AtHandle handle = engine.submit(AT_CMD_ATTENTION);
+        if (handle == AT_INVALID_HANDLE) {
+            return false;
+        }
+        AtResult result = engine.waitFor(handle);
+        engine.release(handle);
+        if (result != AT_RESULT_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Scans every candidate rate until the module answers; leaves the default rate on failure */
+bool ModemLink::findCurrentRate() {
+    for (uint8_t i = 0; i < MODEM_BAUD_CANDIDATE_COUNT; i++) {
+        setLocalRate(MODEM_BAUD_CANDIDATES[i]);
+        if (probe(1U)) {
+            linkStats.baudRate = MODEM_BAUD_CANDIDATES[i];
+            return true;
+        }
+    }
+    setLocalRate(MODEM_BAUD_DEFAULT);
+    linkStats.baudRate = MODEM_BAUD_DEFAULT;
+    return false;
+}
+
+/* Moves both sides to baudRate; restores the previous rate if the new one is not reliable */
+bool ModemLink::switchTo(uint32_t baudRate) {
+    uint32_t previous = linkStats.baudRate;
+    char argument[12];
+    snprintf(argument, sizeof(argument), "%lu", (unsigned long)baudRate);
+
+    /* The module answers OK at the old rate, then switches */
+    AtHandle handle = engine.submit(AT_CMD_SET_BAUD_RATE, argument);
+    AtResult result = engine.waitFor(handle);
+    engine.release(handle);
+    if (result != AT_RESULT_OK) {
+        return false;
+    }
+
+    setLocalRate(baudRate);
+    if (probe(MODEM_LINK_VERIFY_PROBES)) {
+        linkStats.baudRate = baudRate;
+        return true;
+    }
+
+    /* Ask the module to go back; it may still understand us well enough */
+    snprintf(argument, sizeof(argument), "%lu", (unsigned long)previous);
+    handle = engine.submit(AT_CMD_SET_BAUD_RATE, argument);
+    engine.waitFor(handle);
+    engine.release(handle);
+
+    setLocalRate(previous);
+    if (!probe(1U)) {
+        findCurrentRate();
+    }
+    return false;
+}
+
+/* Changes the ESP32 side only and discards anything received at the old rate */
+void ModemLink::setLocalRate(uint32_t baudRate) {
+    serial.flush();
+    serial.updateBaudRate(baudRate);
+    delay(MODEM_LINK_SETTLE_MS);
+    engine.resetInput();
+}
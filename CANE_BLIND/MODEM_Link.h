@@ -0,0 +1,129 @@
+#ifndef MODEM_LINK_H
+#define MODEM_LINK_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "AT_Engine.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Baud rate the module uses out of the factory (and the safe fallback) */
+#define MODEM_BAUD_DEFAULT            115200UL
+
+/* Highest baud rate the negotiation will try */
+#define MODEM_BAUD_MAX                921600UL
+
+/* UART driver receive buffer; sized for long GNSS/SMS bursts between polls */
+#define MODEM_UART_RX_BUFFER_SIZE     4096U
+
+/* Consecutive "AT" round trips required before a baud rate is considered reliable */
+#define MODEM_LINK_VERIFY_PROBES      3U
+
+/* Longest wait for the module to answer after power-on, at any rate (ms) */
+#define MODEM_LINK_READY_TIMEOUT_MS   8000U
+
+/* Settle time after changing the baud rate on either side (ms) */
+#define MODEM_LINK_SETTLE_MS          20U
+
+/* Interval over which the receive throughput is averaged (ms) */
+#define MODEM_LINK_SAMPLE_MS          1000U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Measured link state */
+typedef struct {
+    uint32_t baudRate;          /* Baud rate in use on both sides */
+    bool     flowControl;       /* True if RTS/CTS is active on both sides */
+    uint32_t negotiationMs;     /* Time spent in begin() */
+    uint32_t rxBytesPerSec;     /* Receive throughput over the last sample interval */
+    uint32_t peakRxBytesPerSec; /* Highest receive throughput seen */
+    uint32_t txBytes;           /* Total command bytes sent */
+    uint32_t rxBytes;           /* Total bytes framed */
+    uint32_t bufferOverruns;    /* UART driver ring buffer full events */
+    uint32_t fifoOverflows;     /* UART hardware FIFO overflow events */
+    uint32_t lineErrors;        /* Framing, parity and break errors */
+} ModemLinkStats;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class ModemLink
+* @brief Sets up the UART link to the GSM/GNSS module at the highest reliable rate.
+* @details begin() finds the rate the module currently listens on, optionally enables RTS/CTS
+* on both sides, then steps the module up with AT+IPR. Every new rate must pass several "AT"
+* round trips; otherwise both sides fall back to the last rate that worked. The link also
+* counts UART errors and measures receive throughput.
+*
+* @api
+*/
+/*================================================================================================*/
+class ModemLink {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the ModemLink class.
+    *
+    * @param[in]    serial      UART connected to the module.
+    * @param[in]    engine      AT engine bound to the same UART.
+    */
+    /*============================================================================================*/
+    ModemLink(HardwareSerial& serial, AtEngine& engine);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Opens the UART and negotiates the link (blocking, boot time only).
+    *
+    * @param[in]    rxPin       UART RX pin.
+    * @param[in]    txPin       UART TX pin.
+    * @param[in]    rtsPin      RTS pin, or -1 to leave flow control off.
+    * @param[in]    ctsPin      CTS pin, or -1 to leave flow control off.
+    *
+    * @return       bool        True if the module answered at some rate within
+    *                           MODEM_LINK_READY_TIMEOUT_MS.
+    */
+    /*============================================================================================*/
+    bool begin(int8_t rxPin, int8_t txPin, int8_t rtsPin, int8_t ctsPin);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Updates the throughput measurement; call periodically from the main loop.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void sample();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the measured link state.
+    */
+    /*============================================================================================*/
+    const ModemLinkStats& stats() const { return linkStats; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the link state on one line.
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+private:
+    bool probe(uint8_t count);
+    bool findCurrentRate();
+    bool switchTo(uint32_t baudRate);
+    void setLocalRate(uint32_t baudRate);
+
+    HardwareSerial& serial;
+    AtEngine& engine;
+    ModemLinkStats linkStats;
+    uint32_t lastSampleMs;
+    uint32_t lastSampleBytes;
+};
+
+#endif /* MODEM_LINK_H */
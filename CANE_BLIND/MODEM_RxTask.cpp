@@ -0,0 +1,164 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "MODEM_RxTask.h"
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the ModemRxTask class.
+*
+* @param[in]    serial      UART connected to the module (already started).
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+ModemRxTask::ModemRxTask(HardwareSerial& serial)
+    : serial(serial), taskHandle(NULL), lineListener(NULL), lineListenerContext(NULL),
+      queue(NULL), resetRequested(false), queuedCount(0U), droppedCount(0U), highWater(0U),
+      wakeCount(0U) {
+    memset(&current, 0, sizeof(current));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Creates the queue and the task and hooks the UART receive callback.
+* @details      The Arduino core owns the UART driver event queue, so the task is woken from
+*               the core's onReceive() callback, which fires when the RX FIFO reaches its
+*               threshold and when the line goes idle after a burst (i.e. after each response).
+*               The task also wakes every MODEM_RX_IDLE_POLL_MS as a safety net.
+*
+* @return       bool        True if the task is running.
+*/
+/*================================================================================================*/
+bool ModemRxTask::start() {
+    if (taskHandle != NULL) {
+        return true;
+    }
+
+    queue = xQueueCreateStatic(MODEM_RX_QUEUE_DEPTH, sizeof(ModemRxLine), queueStorage,
+                               &queueControl);
+    if (queue == NULL) {
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(taskEntry, "modemRx", MODEM_RX_TASK_STACK_SIZE, this,
+                                MODEM_RX_TASK_PRIORITY, &taskHandle, MODEM_RX_TASK_CORE) != pdPASS) {
+        taskHandle = NULL;
+        return false;
+    }
+
+    serial.onReceive([this]() {
+        xTaskNotifyGive(taskHandle);
+    });
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Takes the next framed line from the queue without blocking.
+*
+* @param[out]   line        View of the line; valid until the next call.
+*
+* @return       bool        True if a line was taken.
+*/
+/*================================================================================================*/
+bool ModemRxTask::nextLine(LineView& line) {
+    if (queue == NULL || xQueueReceive(queue, &current, 0) != pdTRUE) {
+        return false;
+    }
+    line.data = current.data;
+    line.length = current.length;
+    line.isPrompt = current.isPrompt;
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sleeps until a line is queued or timeoutMs expires.
+*
+* @param[in]    timeoutMs   Maximum sleep time.
+*
+* @return       bool        True if a line is waiting.
+*/
+/*================================================================================================*/
+bool ModemRxTask::waitForLine(uint32_t timeoutMs) {
+    if (queue == NULL) {
+        delay(1);
+        return false;
+    }
+    /* Peek into the consumer buffer; nextLine() overwrites it anyway */
+    return xQueuePeek(queue, &current, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Discards queued lines and asks the task to drop its partial input.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void ModemRxTask::reset() {
+    if (queue == NULL) {
+        framer.reset();
+        return;
+    }
+    resetRequested = true;
+    xTaskNotifyGive(taskHandle);
+    xQueueReset(queue);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+void ModemRxTask::taskEntry(void* parameter) {
+    static_cast<ModemRxTask*>(parameter)->run();
+}
+
+/* Task body: wait for a UART event, frame the bytes and queue complete lines */
+void ModemRxTask::run() {
+    ModemRxLine record;
+    LineView line;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MODEM_RX_IDLE_POLL_MS));
+        wakeCount++;
+
+        if (resetRequested) {
+            resetRequested = false;
+            while (serial.available() > 0) {
+                serial.read();
+            }
+            framer.reset();
+            continue;
+        }
+
+        /* Drain the driver completely; the ring may fill up before the driver is empty */
+        uint32_t queuedBefore = queuedCount;
+        uint16_t moved;
+        do {
+            moved = framer.pump(serial);
+            while (framer.nextLine(line)) {
+                record.length = line.length;
+                record.isPrompt = line.isPrompt;
+                memcpy(record.data, line.data, (size_t)line.length + 1U);
+                if (xQueueSend(queue, &record, 0) == pdTRUE) {
+                    queuedCount++;
+                } else {
+                    droppedCount++;
+                }
+            }
+            uint32_t waiting = uxQueueMessagesWaiting(queue);
+            if (waiting > highWater) {
+                highWater = waiting;
+            }
+        } while (moved > 0U);
+
+        /* One wake-up of the consumer per burst */
+        if (queuedCount != queuedBefore && lineListener != NULL) {
+            lineListener(lineListenerContext);
+        }
+    }
+}
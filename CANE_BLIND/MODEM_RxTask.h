@@ -0,0 +1,123 @@
+#ifndef MODEM_RX_TASK_H
+#define MODEM_RX_TASK_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "UART_Framer.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Number of framed lines the queue holds between the RX task and the consumer */
+#define MODEM_RX_QUEUE_DEPTH          16U
+
+/* Stack size of the RX task (bytes) */
+#define MODEM_RX_TASK_STACK_SIZE      3072U
+
+/* Priority of the RX task; above loopTask so bytes are drained while loop() blocks */
+#define MODEM_RX_TASK_PRIORITY        5U
+
+/* Core the RX task runs on (same core as loop() and the engine) */
+#define MODEM_RX_TASK_CORE            1
+
+/* Longest time the task sleeps without a UART event before checking the port anyway (ms) */
+#define MODEM_RX_IDLE_POLL_MS         50U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* One framed line as it travels through the queue */
+typedef struct {
+    uint16_t length;                        /* Number of characters in data */
+    bool     isPrompt;                      /* True for the "> " data prompt */
+    char     data[UART_LINE_MAX_LEN + 1U];  /* NUL-terminated line text */
+} ModemRxLine;
+
+/* Called by the RX task after it queued lines; must not block */
+typedef void (*ModemLineListener)(void* context);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class ModemRxTask
+* @brief FreeRTOS task that drains the modem UART as soon as the driver reports data.
+* @details The UART receive callback (FIFO threshold or RX idle timeout) notifies the task, which
+* frames the bytes and pushes complete lines into a statically allocated queue. AtEngine consumes
+* the queue through the LineSource interface, so responses and URCs are captured even while
+* loop() is busy or sleeping.
+*
+* @api
+*/
+/*================================================================================================*/
+class ModemRxTask : public LineSource {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the ModemRxTask class.
+    *
+    * @param[in]    serial      UART connected to the module (already started).
+    */
+    /*============================================================================================*/
+    ModemRxTask(HardwareSerial& serial);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Creates the queue and the task and hooks the UART receive callback.
+    *
+    * @return       bool        True if the task is running.
+    */
+    /*============================================================================================*/
+    bool start();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Sets the function the RX task calls after queueing lines (NULL to remove it).
+    * @details      Lets the consumer sleep until a response or URC arrives instead of polling.
+    *               Set it before start().
+    */
+    /*============================================================================================*/
+    void setLineListener(ModemLineListener listener, void* context) {
+        lineListener = listener;
+        lineListenerContext = context;
+    }
+
+    /* LineSource interface (consumer side, single consumer) */
+    bool nextLine(LineView& line);
+    bool waitForLine(uint32_t timeoutMs);
+    void reset();
+    uint32_t bytesReceived() const { return framer.bytesReceived(); }
+
+    /* Statistics */
+    uint32_t linesQueued() const { return queuedCount; }
+    uint32_t linesDropped() const { return droppedCount; }
+    uint32_t queueHighWater() const { return highWater; }
+    uint32_t wakeups() const { return wakeCount; }
+
+private:
+    static void taskEntry(void* parameter);
+    void run();
+
+    HardwareSerial& serial;
+    LineFramer framer;
+    TaskHandle_t taskHandle;
+    ModemLineListener lineListener;
+    void* lineListenerContext;
+    QueueHandle_t queue;
+    StaticQueue_t queueControl;
+    uint8_t queueStorage[MODEM_RX_QUEUE_DEPTH * sizeof(ModemRxLine)];
+    ModemRxLine current;
+    volatile bool resetRequested;
+    volatile uint32_t queuedCount;
+    volatile uint32_t droppedCount;
+    volatile uint32_t highWater;
+    volatile uint32_t wakeCount;
+};
+
+#endif /* MODEM_RX_TASK_H */
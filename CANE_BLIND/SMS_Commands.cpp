@@ -0,0 +1,239 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "SMS_Commands.h"
+#include "SOS_Dispatch.h"
+#include "GPS_Feature.h"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Entry of the command table */
+typedef struct {
+    const char* keyword;
+    uint8_t     length;
+    SmsCommand  command;
+} SmsCommandEntry;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Commands from the emergency contacts */
+SmsCommandInterpreter smsCommands(smsOutbox, sosContacts);
+
+/* Keywords, compared case-insensitively against the trimmed body */
+static const SmsCommandEntry SMS_COMMAND_TABLE[] = {
+    { "WHERE",  5U, SMS_COMMAND_WHERE  },
+    { "STATUS", 6U, SMS_COMMAND_STATUS }
+};
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the SmsCommandInterpreter class.
+*
+* @param[in]    outbox      Outbox that delivers the replies.
+* @param[in]    contacts    Numbers allowed to send commands.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+SmsCommandInterpreter::SmsCommandInterpreter(SmsOutbox& outbox, EmergencyContacts& contacts)
+    : outbox(outbox), contacts(contacts), head(0U), count(0U) {
+    memset(requests, 0, sizeof(requests));
+    memset(&counters, 0, sizeof(counters));
+    memset(&delivered, 0, sizeof(delivered));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Registers the interpreter as the +CMT handler.
+* @details      Replaces the default handler installed by initGsmUrcHandlers(), so it must be
+*               called afterwards. gsmModemStatus.smsReceived is still counted here.
+*
+* @param[in]    dispatcher  URC dispatcher of the GSM module.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void SmsCommandInterpreter::begin(UrcDispatcher& dispatcher) {
+    dispatcher.registerHandler(URC_CMT, onCmtUrc, this);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Checks the sender and queues the command of one received message.
+* @details      Messages from numbers that are not emergency contacts are ignored (never
+*               answered, so the device cannot be used to send SMS to arbitrary numbers).
+*
+* @param[in]    sender          Sender number (not NUL-terminated).
+* @param[in]    senderLength    Characters in sender.
+* @param[in]    body            Message text (not NUL-terminated).
+* @param[in]    bodyLength      Characters in body.
+*
+* @return       bool            True if a reply was queued.
+*/
+/*================================================================================================*/
+bool SmsCommandInterpreter::handleMessage(const char* sender, size_t senderLength,
+                                          const char* body, size_t bodyLength) {
+    counters.received++;
+    if (senderLength == 0U || senderLength > SMS_RECIPIENT_MAX_LEN ||
+        !contacts.contains(sender, senderLength)) {
+        counters.rejected++;
+        LOG_WARN_TEXT("[SMS] command from unknown sender %s ignored", sender, senderLength);
+        return false;
+    }
+
+    SmsCommand command = parseCommand(body, bodyLength);
+    if (command == SMS_COMMAND_UNKNOWN) {
+        counters.unknown++;
+    }
+    if (count >= SMS_COMMAND_QUEUE_DEPTH) {
+        counters.dropped++;
+        LOG_WARN("[SMS] command queue full, command %u dropped", (unsigned)command);
+        return false;
+    }
+
+    Request& request = requests[(head + count) % SMS_COMMAND_QUEUE_DEPTH];
+    request.command = command;
+    memcpy(request.sender, sender, senderLength);
+    request.sender[senderLength] = '\0';
+    count++;
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Answers the oldest queued command; never blocks.
+* @details      One reply per call keeps the loop iteration short; the outbox merges it with
+*               anything else waiting for the same contact.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void SmsCommandInterpreter::poll() {
+    if (count == 0U) {
+        return;
+    }
+    const Request& request = requests[head];
+    char reply[SMS_COMMAND_REPLY_MAX_LEN + 1];
+    buildReply(request.command, reply, sizeof(reply));
+    if (outbox.enqueue(request.sender, reply)) {
+        counters.answered++;
+    }
+    head = (uint8_t)((head + 1U) % SMS_COMMAND_QUEUE_DEPTH);
+    count--;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Matches a message body against the command table.
+* @details      Leading and trailing blanks (including CR/LF) are skipped and the keyword must
+*               make up the whole remaining body.
+*
+* @param[in]    body        Message text (not NUL-terminated).
+* @param[in]    length      Characters in body.
+*
+* @return       SmsCommand  Matching command, or SMS_COMMAND_UNKNOWN.
+*/
+/*================================================================================================*/
+SmsCommand SmsCommandInterpreter::parseCommand(const char* body, size_t length) {
+    if (body == NULL) {
+        return SMS_COMMAND_UNKNOWN;
+    }
+    while (length > 0U && isspace((unsigned char)body[0])) {
+        body++;
+        length--;
+    }
+    while (length > 0U && isspace((unsigned char)body[length - 1U])) {
+        length--;
+    }
+    for (size_t i = 0; i < sizeof(SMS_COMMAND_TABLE) / sizeof(SMS_COMMAND_TABLE[0]); i++) {
+        const SmsCommandEntry& entry = SMS_COMMAND_TABLE[i];
+        if (length == entry.length && strncasecmp(body, entry.keyword, length) == 0) {
+            return entry.command;
+        }
+    }
+    return SMS_COMMAND_UNKNOWN;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the interpreter counters.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void SmsCommandInterpreter::printStats(Print& out) const {
+    out.printf("[SMS] commands: %lu received, %lu rejected, %lu unknown, %lu dropped, "
+               "%lu answered\n",
+               (unsigned long)counters.received, (unsigned long)counters.rejected,
+               (unsigned long)counters.unknown, (unsigned long)counters.dropped,
+               (unsigned long)counters.answered);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Text mode: +CMT: "<oa>",<alpha>,"<scts>" + body line. PDU mode: +CMT: <alpha>,<length> +
+   SMSC and SMS-DELIVER as hex */
+void SmsCommandInterpreter::onCmtUrc(const UrcEvent& event, void* context) {
+    SmsCommandInterpreter* self = static_cast<SmsCommandInterpreter*>(context);
+    gsmModemStatus.smsReceived++;
+    if (event.fieldCount == 0U || event.body == NULL) {
+        return;
+    }
+    if (event.fieldCount == 2U) {
+        SmsDeliver& message = self->delivered;
+        if (!smsPduDecodeDeliver(event.body, event.bodyLength, message)) {
+            self->counters.received++;
+            self->counters.rejected++;
+            LOG_WARN("[SMS] undecodable PDU ignored (%u digits)", (unsigned)event.bodyLength);
+            return;
+        }
+        self->handleMessage(message.sender, strlen(message.sender), message.text,
+                            message.textLength);
+        return;
+    }
+    self->handleMessage(event.fields[0].data, event.fields[0].length, event.body,
+                        event.bodyLength);
+}
+
+/* Formats the reply to one command */
+size_t SmsCommandInterpreter::buildReply(SmsCommand command, char* reply, size_t size) const {
+    int length;
+    switch (command) {
+    case SMS_COMMAND_WHERE: {
+        const GnssFix& fix = gnssPoller.fix();
+        if (fix.valid) {
+            length = (int)geoFormatMessage("Location: ", fix.position, reply, size);
+        } else if (locationCache.hasLocation()) {
+            char prefix[LOCATION_DESCRIPTION_MAX_LEN + 32U];
+            char description[LOCATION_DESCRIPTION_MAX_LEN + 1U];
+            locationCache.describe(description, sizeof(description));
+            snprintf(prefix, sizeof(prefix), "Last known location (%s): ", description);
+            length = (int)geoFormatMessage(prefix, locationCache.location().position, reply, size);
+        } else {
+            length = snprintf(reply, size, "Location unavailable");
+        }
+        break;
+    }
+    case SMS_COMMAND_STATUS:
+        length = snprintf(reply, size,
+                          "Status: signal %d/31, SIM %s, outbox %u, SOS %s, up %lu min",
+                          (int)gsmModemStatus.signalRssi,
+                          gsmModemStatus.simReady ? "ready" : "not ready",
+                          (unsigned)outbox.depth(),
+                          sosDispatcher.isActive() ? "active" : "idle",
+                          (unsigned long)(millis() / 60000UL));
+        break;
+    default:
+        length = snprintf(reply, size, "Commands: WHERE, STATUS");
+        break;
+    }
+    return (length < 0) ? 0U : ((size_t)length < size ? (size_t)length : size - 1U);
+}
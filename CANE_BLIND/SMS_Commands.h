@@ -0,0 +1,157 @@
+#ifndef SMS_COMMANDS_H
+#define SMS_COMMANDS_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "URC_Dispatcher.h"
+#include "SMS_Outbox.h"
+#include "SOS_Contacts.h"
+#include "SMS_Pdu.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Commands accepted but not yet answered */
+#define SMS_COMMAND_QUEUE_DEPTH   4U
+
+/* Longest reply built by the interpreter */
+#define SMS_COMMAND_REPLY_MAX_LEN 160U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Commands understood in an incoming SMS (the whole body, case and blanks ignored) */
+typedef enum {
+    SMS_COMMAND_UNKNOWN = 0,  /* Anything else: answered with the list of commands */
+    SMS_COMMAND_WHERE,        /* "WHERE": reply with the current location link */
+    SMS_COMMAND_STATUS        /* "STATUS": reply with signal, SIM, outbox and SOS state */
+} SmsCommand;
+
+/* Interpreter counters */
+typedef struct {
+    uint32_t received;        /* +CMT messages seen */
+    uint32_t rejected;        /* Sender not an emergency contact, or PDU not decodable */
+    uint32_t unknown;         /* Body not a known command */
+    uint32_t dropped;         /* Command queue full */
+    uint32_t answered;        /* Replies handed to the outbox */
+} SmsCommandStats;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class SmsCommandInterpreter
+* @brief Runs commands received by SMS from the emergency contacts.
+* @details The +CMT handler works on the URC fields and body in place: the sender is checked
+* against the contact list and the body matched against the command table without copying
+* either. A +CMT in PDU mode (AT+CMGF=0, left by a long or Unicode alert) is decoded into one
+* buffer first. Only the sender number and the command are queued; poll() builds the reply from the
+* main loop and hands it to the SMS outbox, so neither the URC path nor the loop waits for the
+* network.
+*
+* @api
+*/
+/*================================================================================================*/
+class SmsCommandInterpreter {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the SmsCommandInterpreter class.
+    *
+    * @param[in]    outbox      Outbox that delivers the replies.
+    * @param[in]    contacts    Numbers allowed to send commands.
+    */
+    /*============================================================================================*/
+    SmsCommandInterpreter(SmsOutbox& outbox, EmergencyContacts& contacts);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Registers the interpreter as the +CMT handler.
+    *
+    * @param[in]    dispatcher  URC dispatcher of the GSM module.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void begin(UrcDispatcher& dispatcher);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Checks the sender and queues the command of one received message.
+    *
+    * @param[in]    sender          Sender number (not NUL-terminated).
+    * @param[in]    senderLength    Characters in sender.
+    * @param[in]    body            Message text (not NUL-terminated).
+    * @param[in]    bodyLength      Characters in body.
+    *
+    * @return       bool            True if a reply was queued.
+    */
+    /*============================================================================================*/
+    bool handleMessage(const char* sender, size_t senderLength, const char* body,
+                       size_t bodyLength);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Answers the oldest queued command; never blocks.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void poll();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Matches a message body against the command table.
+    */
+    /*============================================================================================*/
+    static SmsCommand parseCommand(const char* body, size_t length);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the interpreter counters.
+    */
+    /*============================================================================================*/
+    const SmsCommandStats& stats() const { return counters; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the interpreter counters.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+private:
+    /* A command waiting for its reply */
+    typedef struct {
+        SmsCommand command;
+        char       sender[SMS_RECIPIENT_MAX_LEN + 1];
+    } Request;
+
+    static void onCmtUrc(const UrcEvent& event, void* context);
+    size_t buildReply(SmsCommand command, char* reply, size_t size) const;
+
+    SmsOutbox& outbox;
+    EmergencyContacts& contacts;
+    /* Ring of pending requests */
+    Request requests[SMS_COMMAND_QUEUE_DEPTH];
+    uint8_t head;
+    uint8_t count;
+    SmsCommandStats counters;
+    /* Last PDU-mode +CMT, decoded; kept here rather than on the URC path stack */
+    SmsDeliver delivered;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Commands from the emergency contacts */
+extern SmsCommandInterpreter smsCommands;
+
+#endif /* SMS_COMMANDS_H */
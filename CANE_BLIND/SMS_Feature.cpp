@@ -3,44 +3,230 @@
  ******************************************************************************/
 #include "SMS_Feature.h"
 
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* SMS sender on the GSM module */
+SmsSender gsmSmsSender(gsmAtEngine);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
 /*================================================================================================*/
 /**
-* @brief        Sends a text message via the GSM module.
-* @details      Configures the GSM module in text mode, sends the recipient's phone number,
-*               writes the message content, and finally sends the SMS by transmitting Ctrl+Z.
-*               Waits appropriate delays between commands and reads the module's response.
+* @brief        Constructor for the SmsSender class.
 *
-* @param[in]    phoneNumber     The recipient's phone number as a String.
-* @param[in]    messageText     The content of the SMS as a String.
-* @param[out]   None
+* @param[in]    engine      AT engine of the GSM module.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+SmsSender::SmsSender(AtEngine& engine)
+    : engine(engine), handle(AT_INVALID_HANDLE), phase(PHASE_TEXT), urgent(false),
+      state(SMS_STATUS_IDLE),
+      reference(-1), cmsError(-1), startedAtMs(0U), durationMs(0U), outcome(SMS_STATUS_IDLE),
+      segmentIndex(0U), concatReference(0U) {
+    recipient[0] = '\0';
+    body[0] = '\0';
+    lengthArgument[0] = '\0';
+}
+
+/*================================================================================================*/
+/**
+* @brief        Starts sending a text message. Returns immediately.
+* @details      The number and the body are copied, so the caller's buffers may be reused.
+*               Ctrl+Z and ESC would end or abort a text-mode submission early and are replaced
+*               by spaces. The message goes out in text mode if it fits one plain SMS, otherwise
+*               the module is switched to PDU mode first.
 *
-* @return       None
+* @param[in]    phoneNumber     The recipient's phone number.
+* @param[in]    messageText     The content in UTF-8, at most SMS_TEXT_MAX_LEN bytes.
+* @param[in]    urgent          Alert message: its commands are submitted as urgent, so a
+*                               call never cancels or detaches them.
 *
-* @note         Uses gsmSerialPort as the GSM UART port and macros for delay/timeout values.
+* @return       SmsStatus       SMS_STATUS_SENDING, or SMS_STATUS_FAILED if not started.
 */
 /*================================================================================================*/
-void sendTextMessage(String phoneNumber, String messageText) {
-    /* Set GSM module to Text Mode for SMS */
-    sendGsmCommand("AT+CMGF=1", GSM_COMMAND_WAIT_MS);                        
+SmsStatus SmsSender::start(const char* phoneNumber, const char* messageText, bool urgent) {
+    if (state == SMS_STATUS_SENDING) {
+        return SMS_STATUS_FAILED;
+    }
 
-    /* Start sending SMS command with recipient's phone number */
-    gsmSerialPort.print("AT+CMGS=\"");
-    gsmSerialPort.print(phoneNumber);
-    gsmSerialPort.println("\"");
-    delay(GSM_SMS_COMMAND_DELAY_MS);
+    size_t numberLength = strlen(phoneNumber);
+    size_t length = strlen(messageText);
+    if (numberLength >= sizeof(recipient) || length > SMS_TEXT_MAX_LEN) {
+        LOG_ERROR("SMS not started: number %u, body %u bytes", (unsigned)numberLength,
+                  (unsigned)length);
+        return SMS_STATUS_FAILED;
+    }
+    memcpy(recipient, phoneNumber, numberLength + 1U);
+    for (size_t i = 0; i < length; i++) {
+        char c = messageText[i];
+        body[i] = (c == '\x1A' || c == '\x1B') ? ' ' : c;
+    }
+    body[length] = '\0';
 
-    /* Send the SMS content */
-    gsmSerialPort.print(messageText);
-    delay(GSM_SMS_TEXT_DELAY_MS);
+    if (!encoder.begin(recipient, body, concatReference)) {
+        LOG_ERROR("SMS not started: bad number or more than %u segments",
+                  (unsigned)SMS_PDU_MAX_SEGMENTS);
+        return SMS_STATUS_FAILED;
+    }
 
-    /* Send Ctrl+Z to finalize SMS sending */
-    gsmSerialPort.write(26); 
-    delay(GSM_SMS_SEND_TIMEOUT_MS);
+    this->urgent = urgent;
+    if (encoder.fitsTextMode()) {
+        phase = PHASE_TEXT;
+        handle = submit(AT_CMD_SMS_SEND, recipient, body);
+    } else {
+        phase = PHASE_PDU_MODE;
+        handle = submit(AT_CMD_SMS_PDU_MODE);
+    }
+    if (handle == AT_INVALID_HANDLE) {
+        LOG_ERROR("SMS not queued");
+        return SMS_STATUS_FAILED;
+    }
 
-    /* Read and optionally print the response from GSM module */
-    readGsmResponse(GSM_SMS_SEND_TIMEOUT_MS);
+    if (encoder.segmentCount() > 1U) {
+        concatReference++;
+    }
+    state = SMS_STATUS_SENDING;
+    outcome = SMS_STATUS_SENDING;
+    reference = -1;
+    cmsError = -1;
+    segmentIndex = 0U;
+    startedAtMs = millis();
+    durationMs = 0U;
+    return state;
+}
 
-   /* Print confirmation to Serial Monitor */
-    Serial.println("SMS send complete!");
+/*================================================================================================*/
+/**
+* @brief        Drives the AT engine and advances the current message.
+* @details      In PDU mode each segment is submitted as soon as the previous one is accepted.
+*               A failed segment ends the message; text mode is restored in every case.
+*
+* @return       SmsStatus       Current status.
+*/
+/*================================================================================================*/
+SmsStatus SmsSender::poll() {
+    if (state != SMS_STATUS_SENDING) {
+        return state;
+    }
+
+    engine.poll();
+    AtResult result = engine.result(handle);
+    if (result == AT_RESULT_PENDING) {
+        return state;
+    }
+
+    switch (phase) {
+    case PHASE_TEXT:
+        if (result == AT_RESULT_OK) {
+            engine.parse(handle, &reference);
+        }
+        finish(statusFor(result));
+        break;
+
+    case PHASE_PDU_MODE:
+        engine.release(handle);
+        if (result == AT_RESULT_OK) {
+            phase = PHASE_SEGMENT;
+            submitSegment();
+        } else {
+            /* Still in text mode, nothing to restore */
+            finish(statusFor(result));
+        }
+        break;
+
+    case PHASE_SEGMENT:
+        if (result == AT_RESULT_OK) {
+            if (segmentIndex == 0U) {
+                engine.parse(handle, &reference);
+            }
+            engine.release(handle);
+            segmentIndex++;
+            if (segmentIndex < encoder.segmentCount()) {
+                submitSegment();
+            } else {
+                restoreTextMode(SMS_STATUS_SENT);
+            }
+        } else {
+            SmsStatus status = statusFor(result);
+            engine.release(handle);
+            restoreTextMode(status);
+        }
+        break;
+
+    case PHASE_TEXT_MODE:
+        if (result != AT_RESULT_OK) {
+            LOG_WARN("SMS: text mode not restored (%d)", result);
+        }
+        finish(outcome);
+        break;
+    }
+    return state;
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Maps the final result of AT+CMGS to a message status, keeping the +CMS code */
+SmsStatus SmsSender::statusFor(AtResult result) {
+    switch (result) {
+    case AT_RESULT_OK:
+        return SMS_STATUS_SENT;
+    case AT_RESULT_TIMEOUT:
+        return SMS_STATUS_TIMEOUT;
+    case AT_RESULT_ABORTED:
+        return SMS_STATUS_ABORTED;
+    case AT_RESULT_INVALID:
+        /* The command was released behind our back */
+        return SMS_STATUS_FAILED;
+    default:
+        cmsError = engine.errorCode(handle);
+        return SMS_STATUS_REJECTED;
+    }
 }
 
+/* Encodes segment segmentIndex and queues its AT+CMGS */
+void SmsSender::submitSegment() {
+    encoder.encodeSegment(segmentIndex, pdu);
+    snprintf(lengthArgument, sizeof(lengthArgument), "%u", (unsigned)pdu.tpduLength);
+    handle = submit(AT_CMD_SMS_SEND_PDU, lengthArgument, pdu.hex);
+    if (handle == AT_INVALID_HANDLE) {
+        restoreTextMode(SMS_STATUS_FAILED);
+    }
+}
+
+/* Switches the module back to text mode; the message ends with status afterwards */
+void SmsSender::restoreTextMode(SmsStatus status) {
+    outcome = status;
+    phase = PHASE_TEXT_MODE;
+    handle = submit(AT_CMD_SMS_TEXT_MODE);
+    if (handle == AT_INVALID_HANDLE) {
+        LOG_WARN("SMS: text mode not restored (queue full)");
+        finish(outcome);
+    }
+}
+
+/* Queues one command of the message, as urgent for an alert */
+AtHandle SmsSender::submit(const AtCommandDesc& command, const char* argument,
+                           const char* payload) {
+    return urgent ? engine.submitUrgent(command, argument, payload)
+                  : engine.submit(command, argument, payload);
+}
+
+/* Records the outcome and frees the engine slot */
+void SmsSender::finish(SmsStatus status) {
+    state = status;
+    durationMs = millis() - startedAtMs;
+    engine.release(handle);
+    handle = AT_INVALID_HANDLE;
+
+    if (status == SMS_STATUS_SENT) {
+        LOG_INFO("SMS sent: mr=%d, %u segment(s) in %u ms", reference, encoder.segmentCount(),
+                 (unsigned)durationMs);
+    } else {
+        LOG_ERROR("SMS failed: status=%d cms=%d after %u ms", status, cmsError,
+                  (unsigned)durationMs);
+    }
+}
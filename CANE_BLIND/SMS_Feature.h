@@ -5,34 +5,166 @@
  * INCLUDES
  ******************************************************************************/
 #include "Generic_API.h"
+#include "SMS_Pdu.h"
 
 /******************************************************************************
  * MACROS
  ******************************************************************************/
-/* Define default delays for SMS sending (in milliseconds) */
-#define GSM_SMS_COMMAND_DELAY_MS 500
-#define GSM_SMS_TEXT_DELAY_MS 300
-#define GSM_SMS_SEND_TIMEOUT_MS 3000
+/* Longest message body in UTF-8 bytes (a GSM 7-bit text filling every concatenated segment) */
+#define SMS_TEXT_MAX_LEN          (SMS_PDU_MAX_SEGMENTS * SMS_GSM7_SEGMENT_SEPTETS)
 
 /******************************************************************************
- * FUNCTIONS PROTOTYPES
+ * TYPES
+ ******************************************************************************/
+/* State of an SMS submission */
+typedef enum {
+    SMS_STATUS_IDLE = 0,    /* No message started yet */
+    SMS_STATUS_SENDING,     /* Waiting for the "> " prompt or for the network */
+    SMS_STATUS_SENT,        /* "+CMGS: <mr>" and OK received */
+    SMS_STATUS_REJECTED,    /* ERROR or +CMS ERROR: <n> received, code in errorCode() */
+    SMS_STATUS_TIMEOUT,     /* No final result code before AT_TIMEOUT_SMS_SEND_MS */
+    SMS_STATUS_FAILED,      /* Not started (sender busy, body too long, bad number, engine queue
+                               full) or a segment could not be queued */
+    SMS_STATUS_ABORTED      /* Cancelled or detached to make way for an urgent command */
+} SmsStatus;
+
+/******************************************************************************
+ * API
  ******************************************************************************/
 /*================================================================================================*/
 /**
-* @brief        Sends a text message via the GSM module.
-* @details      Configures the GSM module in text mode, sends the recipient's phone number,
-*               writes the message content, and finally sends the SMS by transmitting Ctrl+Z.
-*               Waits appropriate delays between commands and reads the module's response.
-*
-* @param[in]    phoneNumber     The recipient's phone number as a String.
-* @param[in]    messageText     The content of the SMS as a String.
-* @param[out]   None
-*
-* @return       None
+* @class SmsSender
+* @brief Non-blocking SMS submission in text or PDU mode.
+* @details start() queues AT+CMGS on the AT engine with the message body as its payload. The
+* engine writes the body and Ctrl+Z as soon as the module shows the "> " prompt, and the
+* submission completes on "+CMGS: <mr>" + OK or on an error, so nothing waits for fixed delays.
+* Short plain-ASCII messages go out in text mode. Anything else (longer than one SMS, or with
+* characters text mode cannot carry) is encoded by SmsPduEncoder and sent segment by segment in
+* PDU mode, switching back to text mode afterwards so incoming +CMT stay readable. poll()
+* reports the progress; the message reference is available once the status is SENT.
 *
-* @note         Uses gsmSerialPort as the GSM UART port and macros for delay/timeout values.
+* @api
 */
 /*================================================================================================*/
-void sendTextMessage(String phoneNumber, String messageText);
+class SmsSender {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the SmsSender class.
+    *
+    * @param[in]    engine      AT engine of the GSM module.
+    */
+    /*============================================================================================*/
+    SmsSender(AtEngine& engine);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Starts sending a text message. Returns immediately.
+    *
+    * @param[in]    phoneNumber     The recipient's phone number.
+    * @param[in]    messageText     The content in UTF-8, at most SMS_TEXT_MAX_LEN bytes.
+    * @param[in]    urgent          Alert message: its commands are submitted as urgent, so a
+    *                               call never cancels or detaches them.
+    *
+    * @return       SmsStatus       SMS_STATUS_SENDING, or SMS_STATUS_FAILED if not started.
+    */
+    /*============================================================================================*/
+    SmsStatus start(const char* phoneNumber, const char* messageText, bool urgent = false);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Drives the AT engine and updates the status of the current message.
+    *
+    * @return       SmsStatus       Current status.
+    */
+    /*============================================================================================*/
+    SmsStatus poll();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the status of the current (or last) message.
+    */
+    /*============================================================================================*/
+    SmsStatus status() const { return state; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the message reference assigned by the network, or -1.
+    * @details      For a concatenated message this is the reference of the first segment.
+    */
+    /*============================================================================================*/
+    int16_t messageReference() const { return reference; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the +CMS error code of a rejected message, or -1.
+    */
+    /*============================================================================================*/
+    int16_t errorCode() const { return cmsError; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the time from start() to completion of the last message (ms).
+    */
+    /*============================================================================================*/
+    uint32_t elapsedMs() const { return durationMs; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the number of segments of the current (or last) message.
+    */
+    /*============================================================================================*/
+    uint8_t segmentCount() const { return encoder.segmentCount(); }
+
+private:
+    /* Step of the submission waiting on the engine */
+    typedef enum {
+        PHASE_TEXT = 0,     /* AT+CMGS="<number>" with the body */
+        PHASE_PDU_MODE,     /* AT+CMGF=0 */
+        PHASE_SEGMENT,      /* AT+CMGS=<length> with the PDU of segment segmentIndex */
+        PHASE_TEXT_MODE     /* AT+CMGF=1, outcome already known */
+    } Phase;
+
+    SmsStatus statusFor(AtResult result);
+    void submitSegment();
+    void restoreTextMode(SmsStatus status);
+    void finish(SmsStatus status);
+    AtHandle submit(const AtCommandDesc& command, const char* argument = NULL,
+                    const char* payload = NULL);
+
+    /* AT engine of the GSM module */
+    AtEngine& engine;
+    /* Command in flight, or AT_INVALID_HANDLE */
+    AtHandle handle;
+    Phase phase;
+    /* The current message is an alert (submitted with submitUrgent()) */
+    bool urgent;
+    /* Status of the current message */
+    SmsStatus state;
+    /* Message reference from "+CMGS: <mr>" */
+    int16_t reference;
+    /* Code of "+CMS ERROR: <n>" */
+    int16_t cmsError;
+    /* millis() at start() and the total duration */
+    uint32_t startedAtMs;
+    uint32_t durationMs;
+    /* Outcome kept while text mode is restored */
+    SmsStatus outcome;
+    /* Copies of the number and the body; the engine writes the body on the prompt */
+    char recipient[SMS_PDU_MAX_DIGITS + 2];
+    char body[SMS_TEXT_MAX_LEN + 1];
+    /* PDU mode: encoder, current segment and its AT+CMGS length argument */
+    SmsPduEncoder encoder;
+    SmsPdu pdu;
+    uint8_t segmentIndex;
+    uint8_t concatReference;
+    char lengthArgument[4];
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* SMS sender on the GSM module */
+extern SmsSender gsmSmsSender;
 
-#endif /* SMS_FEATURE_H */
\ No newline at end of file
+#endif /* SMS_FEATURE_H */
@@ -0,0 +1,472 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "SMS_Outbox.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Buffer for the NVS key of a slot: "m" and any uint8_t index ("m255") */
+#define OUTBOX_KEY_SIZE           5U
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Outbox draining through gsmSmsSender */
+SmsOutbox smsOutbox(gsmSmsSender, gsmAtEngine);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Builds the NVS key of an outbox slot ("m0".."m7") */
+static void outboxKey(uint8_t index, char* key, size_t size) {
+    snprintf(key, size, "m%u", (unsigned)index);
+}
+
+/* Returns true if text already holds the given message as one of its lines */
+static bool containsLine(const char* text, const char* message, size_t length) {
+    const char* line = text;
+    for (;;) {
+        const char* end = strchr(line, '\n');
+        size_t lineLength = (end != NULL) ? (size_t)(end - line) : strlen(line);
+        if (lineLength == length && memcmp(line, message, length) == 0) {
+            return true;
+        }
+        if (end == NULL) {
+            return false;
+        }
+        line = end + 1;
+    }
+}
+
+/* Delay before the next attempt after the given number of failures */
+static uint32_t backoffMs(uint8_t attempts) {
+    uint32_t delayMs = SMS_OUTBOX_BACKOFF_BASE_MS;
+    for (uint8_t i = 1; i < attempts && delayMs < SMS_OUTBOX_BACKOFF_MAX_MS; i++) {
+        delayMs *= 2U;
+    }
+    return (delayMs < SMS_OUTBOX_BACKOFF_MAX_MS) ? delayMs : SMS_OUTBOX_BACKOFF_MAX_MS;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the SmsOutbox class.
+*
+* @param[in]    sender      Sender used for the submissions.
+* @param[in]    engine      AT engine of the GSM module (checked for idleness).
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+SmsOutbox::SmsOutbox(SmsSender& sender, AtEngine& engine)
+    : sender(sender), engine(engine), activeIndex(-1), nextSequence(0U), nextOutcome(0U) {
+    memset(entries, 0, sizeof(entries));
+    memset(outcomes, 0, sizeof(outcomes));
+    memset(&counters, 0, sizeof(counters));
+    counters.minLatencyMs = UINT32_MAX;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Loads the messages left in NVS by the previous run.
+* @details      Restored messages are due immediately; their attempt counts are kept, so a
+*               message that keeps failing is still given up after SMS_OUTBOX_MAX_ATTEMPTS.
+*
+* @return       uint8_t     Number of messages restored.
+*/
+/*================================================================================================*/
+uint8_t SmsOutbox::begin() {
+    char key[OUTBOX_KEY_SIZE];
+    uint8_t restored = 0U;
+
+    /* Opening a namespace read-only fails until something was written to it */
+    if (!prefs.begin(SMS_OUTBOX_NAMESPACE, true)) {
+        return 0U;
+    }
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        Entry& entry = entries[i];
+        outboxKey(i, key, sizeof(key));
+        if (entry.used || prefs.getBytesLength(key) != sizeof(SmsOutboxRecord)) {
+            continue;
+        }
+        prefs.getBytes(key, &entry.record, sizeof(SmsOutboxRecord));
+        entry.record.recipient[SMS_RECIPIENT_MAX_LEN] = '\0';
+        entry.record.text[SMS_TEXT_MAX_LEN] = '\0';
+        entry.used = true;
+        entry.inFlight = false;
+        entry.sequence = nextSequence++;
+        entry.queuedAtMs = millis();
+        entry.nextAttemptMs = entry.queuedAtMs;
+        restored++;
+    }
+    prefs.end();
+
+    if (restored > 0U) {
+        LOG_INFO("SMS outbox: %u message(s) restored", restored);
+    }
+    touchHighWater();
+    return restored;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Queues a message; returns immediately.
+* @details      A message already waiting for the same recipient (as one of its lines) is not
+*               queued again; a different one is appended to it on a new line while the result
+*               still fits in SMS_PDU_MAX_SEGMENTS segments. The message being submitted right
+*               now is never modified.
+*
+* @param[in]    phoneNumber     The recipient's phone number.
+* @param[in]    messageText     The content of the SMS.
+*
+* @return       bool            True if the message was queued or merged.
+*/
+/*================================================================================================*/
+bool SmsOutbox::enqueue(const char* phoneNumber, const char* messageText) {
+    return add(phoneNumber, messageText, false);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Queues an alert message ahead of the others; returns immediately.
+* @details      The message is submitted before any other due message and is only merged into
+*               another alert. When the outbox is full, the oldest waiting non-urgent message is
+*               dropped to make room; the alert is refused only when every other slot already
+*               holds an alert or the message being submitted.
+*
+* @param[in]    phoneNumber     The recipient's phone number.
+* @param[in]    messageText     The content of the SMS.
+*
+* @return       bool            True if the message was queued or merged.
+*/
+/*================================================================================================*/
+bool SmsOutbox::enqueueUrgent(const char* phoneNumber, const char* messageText) {
+    return add(phoneNumber, messageText, true);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Tracks the submission in flight and starts the next due one; never blocks.
+* @details      A new submission is only started while the AT engine has nothing else queued,
+*               so calls and other commands are not held up behind the outbox.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void SmsOutbox::poll() {
+    if (activeIndex >= 0) {
+        SmsStatus status = sender.poll();
+        if (status == SMS_STATUS_SENDING) {
+            return;
+        }
+        finishAttempt(entries[activeIndex], status);
+        activeIndex = -1;
+    }
+
+    if (!engine.isIdle() || sender.status() == SMS_STATUS_SENDING) {
+        return;
+    }
+
+    /* Oldest urgent message whose backoff has expired, else the oldest due one */
+    uint32_t now = millis();
+    int8_t next = -1;
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        const Entry& entry = entries[i];
+        if (!entry.used || (int32_t)(now - entry.nextAttemptMs) < 0) {
+            continue;
+        }
+        if (next >= 0 && entry.record.urgent != entries[next].record.urgent) {
+            if (entry.record.urgent) {
+                next = (int8_t)i;
+            }
+            continue;
+        }
+        if (next < 0 || (int32_t)(entry.sequence - entries[next].sequence) < 0) {
+            next = (int8_t)i;
+        }
+    }
+    if (next < 0) {
+        return;
+    }
+
+    Entry& entry = entries[next];
+    if (sender.start(entry.record.recipient, entry.record.text, entry.record.urgent) ==
+        SMS_STATUS_SENDING) {
+        entry.inFlight = true;
+        activeIndex = next;
+    } else {
+        /* Could not even be queued on the engine; try again later without counting it */
+        entry.nextAttemptMs = now + SMS_OUTBOX_BACKOFF_BASE_MS;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the number of messages waiting or in flight.
+*/
+/*================================================================================================*/
+uint8_t SmsOutbox::depth() const {
+    uint8_t count = 0U;
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        if (entries[i].used) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns true while a message for the recipient is waiting or in flight.
+*/
+/*================================================================================================*/
+bool SmsOutbox::isPending(const char* phoneNumber) const {
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        if (entries[i].used && strcmp(entries[i].record.recipient, phoneNumber) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns whether the messages for the recipient are pending, sent or dropped.
+* @details      A message still in the outbox wins over the outcome of an earlier one.
+*
+* @param[in]    phoneNumber     The recipient's phone number.
+*
+* @return       SmsDelivery     Outcome of the last message for the recipient.
+*/
+/*================================================================================================*/
+SmsDelivery SmsOutbox::delivery(const char* phoneNumber) const {
+    if (isPending(phoneNumber)) {
+        return SMS_DELIVERY_PENDING;
+    }
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        if (outcomes[i].delivery != SMS_DELIVERY_NONE &&
+            strcmp(outcomes[i].recipient, phoneNumber) == 0) {
+            return outcomes[i].delivery;
+        }
+    }
+    return SMS_DELIVERY_NONE;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the depth, the counters and the delivery latency.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void SmsOutbox::printStats(Print& out) const {
+    out.printf("[SMS] outbox depth %u (max %u), %lu queued, %lu merged, %lu sent, "
+               "%lu failed attempts, %lu dropped\n",
+               depth(), counters.highWater, (unsigned long)counters.queued,
+               (unsigned long)counters.merged, (unsigned long)counters.sent,
+               (unsigned long)counters.failedAttempts, (unsigned long)counters.dropped);
+    if (counters.sent > 0U) {
+        out.printf("[SMS] delivery latency last %lu, min %lu, avg %lu, max %lu ms\n",
+                   (unsigned long)counters.lastLatencyMs, (unsigned long)counters.minLatencyMs,
+                   (unsigned long)(counters.totalLatencyMs / counters.sent),
+                   (unsigned long)counters.maxLatencyMs);
+    }
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Queues or merges a message; an urgent one may evict the oldest non-urgent message */
+bool SmsOutbox::add(const char* phoneNumber, const char* messageText, bool urgent) {
+    size_t recipientLength = strlen(phoneNumber);
+    size_t textLength = strlen(messageText);
+    SmsPduEncoder encoder;
+    if (recipientLength == 0U || recipientLength > SMS_RECIPIENT_MAX_LEN ||
+        textLength > SMS_TEXT_MAX_LEN || !encoder.begin(phoneNumber, messageText, 0U)) {
+        LOG_ERROR("SMS outbox: message rejected (number %u, text %u bytes)",
+                  (unsigned)recipientLength, (unsigned)textLength);
+        counters.dropped++;
+        return false;
+    }
+
+    /* Merge with a message waiting for the same recipient; an alert only with another alert,
+       so it never waits behind a message in backoff */
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        Entry& entry = entries[i];
+        if (!entry.used || entry.inFlight || (urgent && !entry.record.urgent) ||
+            strcmp(entry.record.recipient, phoneNumber) != 0) {
+            continue;
+        }
+        size_t queuedLength = strlen(entry.record.text);
+        if (containsLine(entry.record.text, messageText, textLength)) {
+            counters.queued++;
+            counters.merged++;
+            return true;
+        }
+        if (queuedLength + 1U + textLength <= SMS_TEXT_MAX_LEN) {
+            entry.record.text[queuedLength] = '\n';
+            memcpy(&entry.record.text[queuedLength + 1U], messageText, textLength + 1U);
+            if (encoder.begin(phoneNumber, entry.record.text, 0U)) {
+                store(i);
+                counters.queued++;
+                counters.merged++;
+                return true;
+            }
+            /* Too many segments together: undo and queue separately */
+            entry.record.text[queuedLength] = '\0';
+        }
+    }
+
+    /* Otherwise take a free slot, or the slot of a message an alert goes ahead of */
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH && slot < 0; i++) {
+        if (!entries[i].used) {
+            slot = (int8_t)i;
+        }
+    }
+    if (slot < 0 && urgent) {
+        slot = evictForUrgent();
+    }
+    if (slot < 0) {
+        LOG_ERROR("SMS outbox full, message dropped");
+        counters.dropped++;
+        return false;
+    }
+
+    Entry& entry = entries[slot];
+    entry.used = true;
+    entry.inFlight = false;
+    entry.sequence = nextSequence++;
+    entry.queuedAtMs = millis();
+    entry.nextAttemptMs = entry.queuedAtMs;
+    memset(&entry.record, 0, sizeof(entry.record));
+    entry.record.urgent = urgent;
+    memcpy(entry.record.recipient, phoneNumber, recipientLength + 1U);
+    memcpy(entry.record.text, messageText, textLength + 1U);
+    store((uint8_t)slot);
+    counters.queued++;
+    touchHighWater();
+    return true;
+}
+
+/* Drops the oldest waiting non-urgent message; returns its slot, or -1 if there is none */
+int8_t SmsOutbox::evictForUrgent() {
+    int8_t victim = -1;
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        const Entry& entry = entries[i];
+        if (!entry.used || entry.inFlight || entry.record.urgent) {
+            continue;
+        }
+        if (victim < 0 || (int32_t)(entry.sequence - entries[victim].sequence) < 0) {
+            victim = (int8_t)i;
+        }
+    }
+    if (victim >= 0) {
+        LOG_WARN("SMS outbox full, oldest message dropped for an alert");
+        counters.dropped++;
+        recordOutcome(entries[victim].record.recipient, SMS_DELIVERY_DROPPED);
+        erase((uint8_t)victim);
+    }
+    return victim;
+}
+
+/* Removes a delivered message, or schedules the retry of a failed one */
+void SmsOutbox::finishAttempt(Entry& entry, SmsStatus status) {
+    uint8_t index = (uint8_t)(&entry - entries);
+    entry.inFlight = false;
+
+    if (status == SMS_STATUS_SENT) {
+        uint32_t latencyMs = millis() - entry.queuedAtMs;
+        counters.sent++;
+        counters.lastLatencyMs = latencyMs;
+        counters.totalLatencyMs += latencyMs;
+        if (latencyMs < counters.minLatencyMs) {
+            counters.minLatencyMs = latencyMs;
+        }
+        if (latencyMs > counters.maxLatencyMs) {
+            counters.maxLatencyMs = latencyMs;
+        }
+        recordOutcome(entry.record.recipient, SMS_DELIVERY_SENT);
+        erase(index);
+        return;
+    }
+
+    if (status == SMS_STATUS_ABORTED) {
+        /* Made way for a call: not the message's fault, so no attempt or backoff is counted.
+           A detached submission may still reach the recipient, who then gets it twice. */
+        entry.nextAttemptMs = millis();
+        LOG_INFO("SMS outbox: submission aborted for an urgent command, %u queued",
+                 (unsigned)depth());
+        return;
+    }
+
+    counters.failedAttempts++;
+    entry.record.attempts++;
+    if (entry.record.attempts >= SMS_OUTBOX_MAX_ATTEMPTS) {
+        LOG_ERROR("SMS outbox: giving up after %u attempts", entry.record.attempts);
+        counters.dropped++;
+        recordOutcome(entry.record.recipient, SMS_DELIVERY_DROPPED);
+        erase(index);
+        return;
+    }
+
+    uint32_t delayMs = backoffMs(entry.record.attempts);
+    entry.nextAttemptMs = millis() + delayMs;
+    store(index);
+    LOG_WARN("SMS outbox: attempt %u failed, retry in %u ms", entry.record.attempts,
+             (unsigned)delayMs);
+}
+
+/* Remembers how the last message for a recipient ended, replacing its previous outcome or else
+   the oldest one */
+void SmsOutbox::recordOutcome(const char* phoneNumber, SmsDelivery delivery) {
+    uint8_t slot = 0U;
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        if (outcomes[i].delivery != SMS_DELIVERY_NONE &&
+            strcmp(outcomes[i].recipient, phoneNumber) == 0) {
+            slot = i;
+            break;
+        }
+        if (outcomes[i].delivery == SMS_DELIVERY_NONE ||
+            (int32_t)(outcomes[i].sequence - outcomes[slot].sequence) < 0) {
+            slot = i;
+        }
+    }
+    Outcome& outcome = outcomes[slot];
+    outcome.sequence = nextOutcome++;
+    outcome.delivery = delivery;
+    strncpy(outcome.recipient, phoneNumber, SMS_RECIPIENT_MAX_LEN);
+    outcome.recipient[SMS_RECIPIENT_MAX_LEN] = '\0';
+}
+
+/* Writes one entry to NVS */
+void SmsOutbox::store(uint8_t index) {
+    char key[OUTBOX_KEY_SIZE];
+    outboxKey(index, key, sizeof(key));
+    prefs.begin(SMS_OUTBOX_NAMESPACE, false);
+    prefs.putBytes(key, &entries[index].record, sizeof(SmsOutboxRecord));
+    prefs.end();
+}
+
+/* Frees one entry and deletes it from NVS */
+void SmsOutbox::erase(uint8_t index) {
+    char key[OUTBOX_KEY_SIZE];
+    outboxKey(index, key, sizeof(key));
+    entries[index].used = false;
+    prefs.begin(SMS_OUTBOX_NAMESPACE, false);
+    prefs.remove(key);
+    prefs.end();
+}
+
+/* Updates the depth high-water mark */
+void SmsOutbox::touchHighWater() {
+    uint8_t current = depth();
+    if (current > counters.highWater) {
+        counters.highWater = current;
+    }
+}
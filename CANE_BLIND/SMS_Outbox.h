@@ -0,0 +1,223 @@
+#ifndef SMS_OUTBOX_H
+#define SMS_OUTBOX_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <Preferences.h>
+#include "AT_Engine.h"
+#include "SMS_Feature.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Number of messages the outbox holds (each one is an NVS blob) */
+#define SMS_OUTBOX_DEPTH              8U
+
+/* Longest recipient number stored with a message ('+' and the digits) */
+#define SMS_RECIPIENT_MAX_LEN         (SMS_PDU_MAX_DIGITS + 1U)
+
+/* Retry policy: the delay doubles after every failed attempt, up to the cap */
+#define SMS_OUTBOX_BACKOFF_BASE_MS    5000UL
+#define SMS_OUTBOX_BACKOFF_MAX_MS     300000UL
+#define SMS_OUTBOX_MAX_ATTEMPTS       10U
+
+/* NVS namespace of the outbox */
+#define SMS_OUTBOX_NAMESPACE          "outbox"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Part of a queued message that is kept in NVS */
+typedef struct {
+    uint8_t attempts;                               /* Failed attempts so far */
+    bool    urgent;                                 /* Alert message, sent ahead of the others */
+    char    recipient[SMS_RECIPIENT_MAX_LEN + 1];   /* Phone number */
+    char    text[SMS_TEXT_MAX_LEN + 1];             /* Body, possibly several merged messages */
+} SmsOutboxRecord;
+
+/* Fate of the messages for one recipient */
+typedef enum {
+    SMS_DELIVERY_NONE = 0,    /* Nothing queued for the recipient (or its outcome was forgotten) */
+    SMS_DELIVERY_PENDING,     /* A message is waiting or in flight */
+    SMS_DELIVERY_SENT,        /* The last message was accepted by the network */
+    SMS_DELIVERY_DROPPED      /* The last message was given up after SMS_OUTBOX_MAX_ATTEMPTS */
+} SmsDelivery;
+
+/* Outbox counters */
+typedef struct {
+    uint32_t queued;            /* Messages accepted by enqueue() (including merged ones) */
+    uint32_t merged;            /* Messages folded into one already queued for the recipient */
+    uint32_t sent;              /* Submissions confirmed with +CMGS */
+    uint32_t failedAttempts;    /* Submissions that ended with an error or a timeout */
+    uint32_t dropped;           /* Messages given up (outbox full, evicted or too many attempts) */
+    uint8_t  highWater;         /* Largest depth seen */
+    uint32_t lastLatencyMs;     /* Queue-to-delivery time of the last sent message */
+    uint32_t minLatencyMs;
+    uint32_t maxLatencyMs;
+    uint32_t totalLatencyMs;    /* Sum over all sent messages (for the mean) */
+} SmsOutboxStats;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class SmsOutbox
+* @brief Persistent SMS queue that retries failed submissions in the background.
+* @details Every queued message is stored as its own NVS blob, so messages survive a reboot and
+* only the changed entry is rewritten. poll() submits the oldest due message through the
+* SmsSender whenever the AT engine is idle; failures are retried with exponential backoff. A
+* message for a recipient that already has one waiting is appended to it when the result still
+* fits in one (possibly concatenated) message, so several updates go out as one submission.
+* Urgent (SOS) messages are submitted ahead of every other due message and, when the outbox is
+* full, take the slot of the oldest waiting non-urgent one.
+*
+* @api
+*/
+/*================================================================================================*/
+class SmsOutbox {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the SmsOutbox class.
+    *
+    * @param[in]    sender      Sender used for the submissions.
+    * @param[in]    engine      AT engine of the GSM module (checked for idleness).
+    */
+    /*============================================================================================*/
+    SmsOutbox(SmsSender& sender, AtEngine& engine);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Loads the messages left in NVS by the previous run.
+    *
+    * @return       uint8_t     Number of messages restored.
+    */
+    /*============================================================================================*/
+    uint8_t begin();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Queues a message; returns immediately.
+    *
+    * @param[in]    phoneNumber     The recipient's phone number.
+    * @param[in]    messageText     The content of the SMS.
+    *
+    * @return       bool            True if the message was queued or merged.
+    */
+    /*============================================================================================*/
+    bool enqueue(const char* phoneNumber, const char* messageText);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Queues an alert message ahead of the others; returns immediately.
+    *
+    * @param[in]    phoneNumber     The recipient's phone number.
+    * @param[in]    messageText     The content of the SMS.
+    *
+    * @return       bool            True if the message was queued or merged.
+    */
+    /*============================================================================================*/
+    bool enqueueUrgent(const char* phoneNumber, const char* messageText);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Tracks the submission in flight and starts the next due one; never blocks.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void poll();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the number of messages waiting or in flight.
+    */
+    /*============================================================================================*/
+    uint8_t depth() const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns true while a message for the recipient is waiting or in flight.
+    */
+    /*============================================================================================*/
+    bool isPending(const char* phoneNumber) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns whether the messages for the recipient are pending, sent or dropped.
+    * @details      The outcome of the last message is remembered for the SMS_OUTBOX_DEPTH most
+    *               recent recipients.
+    *
+    * @param[in]    phoneNumber     The recipient's phone number.
+    *
+    * @return       SmsDelivery     Outcome of the last message for the recipient.
+    */
+    /*============================================================================================*/
+    SmsDelivery delivery(const char* phoneNumber) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the outbox counters.
+    */
+    /*============================================================================================*/
+    const SmsOutboxStats& stats() const { return counters; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the depth, the counters and the delivery latency.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+private:
+    /* One outbox slot */
+    typedef struct {
+        bool            used;
+        bool            inFlight;       /* Currently being submitted */
+        uint32_t        sequence;       /* Enqueue order, oldest first */
+        uint32_t        queuedAtMs;     /* millis() when queued (or restored) */
+        uint32_t        nextAttemptMs;  /* millis() before which it is not retried */
+        SmsOutboxRecord record;
+    } Entry;
+
+    /* Outcome of the last message that left the outbox for one recipient */
+    typedef struct {
+        uint32_t    sequence;       /* Order of the outcome, oldest is replaced first */
+        SmsDelivery delivery;       /* SMS_DELIVERY_SENT or SMS_DELIVERY_DROPPED; NONE if free */
+        char        recipient[SMS_RECIPIENT_MAX_LEN + 1];
+    } Outcome;
+
+    bool add(const char* phoneNumber, const char* messageText, bool urgent);
+    int8_t evictForUrgent();
+    void finishAttempt(Entry& entry, SmsStatus status);
+    void recordOutcome(const char* phoneNumber, SmsDelivery delivery);
+    void store(uint8_t index);
+    void erase(uint8_t index);
+    void touchHighWater();
+
+    SmsSender& sender;
+    AtEngine& engine;
+    Preferences prefs;
+    Entry entries[SMS_OUTBOX_DEPTH];
+    Outcome outcomes[SMS_OUTBOX_DEPTH];
+    /* Index of the entry being submitted, or -1 */
+    int8_t activeIndex;
+    uint32_t nextSequence;
+    uint32_t nextOutcome;
+    SmsOutboxStats counters;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Outbox draining through gsmSmsSender */
+extern SmsOutbox smsOutbox;
+
+#endif /* SMS_OUTBOX_H */
@@ -0,0 +1,553 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "SMS_Pdu.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Lookup result for characters outside the GSM alphabet */
+#define GSM7_NONE                 0xFFFFU
+
+/* Lookup results >= GSM7_ESCAPED are sent as ESC (0x1B) followed by the low byte */
+#define GSM7_ESCAPED              0x0100U
+
+/* Replacement for malformed UTF-8 and characters outside the BMP */
+#define UNICODE_REPLACEMENT       0xFFFDU
+
+/* Concatenation user data header: UDHL, IEI 0x00 (8-bit reference), IEDL, ref, total, seq */
+#define SMS_UDH_CONCAT_LEN        6U
+/* The header plus one fill bit occupies exactly 7 septets */
+#define SMS_UDH_CONCAT_SEPTETS    7U
+
+/* Received PDU: SMSC field (12), first octet, address (2 + 11), PID, DCS, SCTS, UDL, user data */
+#define SMS_DELIVER_PDU_MAX_LEN   (12U + 1U + 13U + 10U + 140U)
+
+/* Alphanumeric sender: up to 11 characters in 22 semi-octets */
+#define SMS_ALPHA_SENDER_MAX_LEN  11U
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* GSM 03.38 default alphabet: Unicode code point of each septet (0x1B is the escape) */
+static constexpr uint16_t GSM7_BASIC[128] = {
+    0x0040, 0x00A3, 0x0024, 0x00A5, 0x00E8, 0x00E9, 0x00F9, 0x00EC,
+    0x00F2, 0x00C7, 0x000A, 0x00D8, 0x00F8, 0x000D, 0x00C5, 0x00E5,
+    0x0394, 0x005F, 0x03A6, 0x0393, 0x039B, 0x03A9, 0x03A0, 0x03A8,
+    0x03A3, 0x0398, 0x039E, GSM7_NONE, 0x00C6, 0x00E6, 0x00DF, 0x00C9,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00A4, 0x0025, 0x0026, 0x0027,
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x00A1, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+    0x0058, 0x0059, 0x005A, 0x00C4, 0x00D6, 0x00D1, 0x00DC, 0x00A7,
+    0x00BF, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+    0x0078, 0x0079, 0x007A, 0x00E4, 0x00F6, 0x00F1, 0x00FC, 0x00E0
+};
+
+/* Extension table reached through the escape: { septet, code point } */
+static constexpr uint16_t GSM7_EXTENSION[][2] = {
+    { 0x0A, 0x000C }, { 0x14, 0x005E }, { 0x28, 0x007B }, { 0x29, 0x007D }, { 0x2F, 0x005C },
+    { 0x3C, 0x005B }, { 0x3D, 0x007E }, { 0x3E, 0x005D }, { 0x40, 0x007C }, { 0x65, 0x20AC }
+};
+static constexpr uint8_t GSM7_EXTENSION_COUNT = sizeof(GSM7_EXTENSION) / sizeof(GSM7_EXTENSION[0]);
+
+/******************************************************************************
+ * COMPILE-TIME TABLES
+ ******************************************************************************/
+/* Septet of a code point in the basic table, searching from index */
+constexpr uint16_t gsm7FindBasic(uint16_t codePoint, uint8_t index) {
+    return (index >= 128U) ? GSM7_NONE
+         : (GSM7_BASIC[index] == codePoint) ? index
+         : gsm7FindBasic(codePoint, (uint8_t)(index + 1U));
+}
+
+/* Escaped septet of a code point in the extension table, searching from index */
+constexpr uint16_t gsm7FindExtension(uint16_t codePoint, uint8_t index) {
+    return (index >= GSM7_EXTENSION_COUNT) ? GSM7_NONE
+         : (GSM7_EXTENSION[index][1] == codePoint) ? (uint16_t)(GSM7_ESCAPED | GSM7_EXTENSION[index][0])
+         : gsm7FindExtension(codePoint, (uint8_t)(index + 1U));
+}
+
+/* Full lookup: basic septet, GSM7_ESCAPED | extension septet, or GSM7_NONE */
+constexpr uint16_t gsm7Lookup(uint16_t codePoint) {
+    return (gsm7FindBasic(codePoint, 0U) != GSM7_NONE) ? gsm7FindBasic(codePoint, 0U)
+                                                       : gsm7FindExtension(codePoint, 0U);
+}
+
+/* ASCII to GSM lookup, generated at compile time from the two tables above */
+#define GSM7_ROW(n) gsm7Lookup((n) + 0U), gsm7Lookup((n) + 1U), gsm7Lookup((n) + 2U), \
+                    gsm7Lookup((n) + 3U), gsm7Lookup((n) + 4U), gsm7Lookup((n) + 5U), \
+                    gsm7Lookup((n) + 6U), gsm7Lookup((n) + 7U)
+static constexpr uint16_t GSM7_FROM_ASCII[128] = {
+    GSM7_ROW(0x00), GSM7_ROW(0x08), GSM7_ROW(0x10), GSM7_ROW(0x18),
+    GSM7_ROW(0x20), GSM7_ROW(0x28), GSM7_ROW(0x30), GSM7_ROW(0x38),
+    GSM7_ROW(0x40), GSM7_ROW(0x48), GSM7_ROW(0x50), GSM7_ROW(0x58),
+    GSM7_ROW(0x60), GSM7_ROW(0x68), GSM7_ROW(0x70), GSM7_ROW(0x78)
+};
+#undef GSM7_ROW
+
+static_assert(GSM7_FROM_ASCII['@'] == 0x00U, "'@' is septet 0x00");
+static_assert(GSM7_FROM_ASCII['$'] == 0x02U, "'$' is septet 0x02");
+static_assert(GSM7_FROM_ASCII['A'] == 0x41U, "letters keep their ASCII code");
+static_assert(GSM7_FROM_ASCII['{'] == (GSM7_ESCAPED | 0x28U), "'{' is ESC 0x28");
+static_assert(GSM7_FROM_ASCII['`'] == GSM7_NONE, "'`' is not in the GSM alphabet");
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* GSM lookup of any BMP code point */
+static uint16_t gsm7Encode(uint16_t codePoint) {
+    if (codePoint < 128U) {
+        return GSM7_FROM_ASCII[codePoint];
+    }
+    if (codePoint == GSM7_NONE) {
+        /* Would match the escape placeholder in GSM7_BASIC */
+        return GSM7_NONE;
+    }
+    for (uint8_t i = 0; i < 128U; i++) {
+        if (GSM7_BASIC[i] == codePoint) {
+            return i;
+        }
+    }
+    for (uint8_t i = 0; i < GSM7_EXTENSION_COUNT; i++) {
+        if (GSM7_EXTENSION[i][1] == codePoint) {
+            return (uint16_t)(GSM7_ESCAPED | GSM7_EXTENSION[i][0]);
+        }
+    }
+    return GSM7_NONE;
+}
+
+/* Decodes the UTF-8 character at text[*offset] and advances *offset past it */
+static uint16_t utf8Next(const char* text, uint16_t* offset) {
+    const uint8_t* bytes = (const uint8_t*)&text[*offset];
+    uint32_t codePoint;
+    uint8_t length;
+
+    if (bytes[0] < 0x80U) {
+        codePoint = bytes[0];
+        length = 1U;
+    } else if ((bytes[0] & 0xE0U) == 0xC0U) {
+        codePoint = bytes[0] & 0x1FU;
+        length = 2U;
+    } else if ((bytes[0] & 0xF0U) == 0xE0U) {
+        codePoint = bytes[0] & 0x0FU;
+        length = 3U;
+    } else if ((bytes[0] & 0xF8U) == 0xF0U) {
+        codePoint = bytes[0] & 0x07U;
+        length = 4U;
+    } else {
+        *offset = (uint16_t)(*offset + 1U);
+        return UNICODE_REPLACEMENT;
+    }
+
+    for (uint8_t i = 1; i < length; i++) {
+        if ((bytes[i] & 0xC0U) != 0x80U) {
+            /* Truncated sequence: resume at the offending byte */
+            *offset = (uint16_t)(*offset + i);
+            return UNICODE_REPLACEMENT;
+        }
+        codePoint = (codePoint << 6) | (bytes[i] & 0x3FU);
+    }
+    *offset = (uint16_t)(*offset + length);
+    return (codePoint <= 0xFFFFU) ? (uint16_t)codePoint : UNICODE_REPLACEMENT;
+}
+
+/* Appends a code point to text as UTF-8 if it fits */
+static void utf8Append(SmsDeliver& out, uint16_t codePoint) {
+    char bytes[3];
+    uint8_t length;
+    if (codePoint < 0x80U) {
+        bytes[0] = (char)codePoint;
+        length = 1U;
+    } else if (codePoint < 0x800U) {
+        bytes[0] = (char)(0xC0U | (codePoint >> 6));
+        bytes[1] = (char)(0x80U | (codePoint & 0x3FU));
+        length = 2U;
+    } else {
+        bytes[0] = (char)(0xE0U | (codePoint >> 12));
+        bytes[1] = (char)(0x80U | ((codePoint >> 6) & 0x3FU));
+        bytes[2] = (char)(0x80U | (codePoint & 0x3FU));
+        length = 3U;
+    }
+    if (out.textLength + length <= SMS_DELIVER_TEXT_MAX_LEN) {
+        memcpy(&out.text[out.textLength], bytes, length);
+        out.textLength = (uint16_t)(out.textLength + length);
+    }
+}
+
+/* Value of one hex digit, or -1 */
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/* Septet number index of GSM 7-bit packed data */
+static uint8_t septetAt(const uint8_t* data, uint16_t index) {
+    uint16_t bit = (uint16_t)(index * 7U);
+    uint8_t shift = (uint8_t)(bit % 8U);
+    uint16_t value = data[bit / 8U] >> shift;
+    if (shift > 1U) {
+        value |= (uint16_t)(data[bit / 8U + 1U] << (8U - shift));
+    }
+    return (uint8_t)(value & 0x7FU);
+}
+
+/* Appends one octet as two hex digits */
+static char* appendHex(char* out, uint8_t value) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    out[0] = HEX_DIGITS[value >> 4];
+    out[1] = HEX_DIGITS[value & 0x0FU];
+    return out + 2;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the SmsPduEncoder class.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+SmsPduEncoder::SmsPduEncoder()
+    : number(""), text(""), reference(0U), coding(SMS_ENCODING_GSM7), segments(0U),
+      plainText(false) {
+    memset(segmentStart, 0, sizeof(segmentStart));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Analyses a message. The number and text must outlive the encoder's use.
+* @details      Costs are counted in septets for GSM 7-bit (2 for extension characters) and in
+*               characters for UCS-2. A message that fits the single-message limit is sent
+*               without a header; otherwise it is cut greedily at the segment limit.
+*
+* @param[in]    phoneNumber     Destination, digits with an optional leading '+'.
+* @param[in]    messageText     Message body in UTF-8.
+* @param[in]    concatReference Concatenation reference shared by the segments.
+*
+* @return       bool            False if the number is invalid or the text needs more than
+*                               SMS_PDU_MAX_SEGMENTS segments.
+*/
+/*================================================================================================*/
+bool SmsPduEncoder::begin(const char* phoneNumber, const char* messageText, uint8_t concatReference) {
+    segments = 0U;
+
+    const char* digits = (phoneNumber[0] == '+') ? &phoneNumber[1] : phoneNumber;
+    size_t digitCount = strlen(digits);
+    if (digitCount == 0U || digitCount > SMS_PDU_MAX_DIGITS ||
+        strspn(digits, "0123456789") != digitCount) {
+        return false;
+    }
+    size_t textLength = strlen(messageText);
+    if (textLength > 0xFFFFU) {
+        return false;
+    }
+
+    number = phoneNumber;
+    text = messageText;
+    reference = concatReference;
+
+    /* Pass 1: choose the coding and count the total cost */
+    uint32_t septets = 0U;
+    uint32_t characters = 0U;
+    bool gsm7 = true;
+    plainText = true;
+    for (uint16_t offset = 0U; offset < textLength; ) {
+        uint16_t codePoint = utf8Next(text, &offset);
+        uint16_t code = gsm7Encode(codePoint);
+        characters++;
+        if (code == GSM7_NONE) {
+            gsm7 = false;
+            plainText = false;
+            continue;
+        }
+        septets += (code >= GSM7_ESCAPED) ? 2U : 1U;
+        if (code != codePoint || (codePoint < 0x20U && codePoint != '\n')) {
+            plainText = false;
+        }
+    }
+    coding = gsm7 ? SMS_ENCODING_GSM7 : SMS_ENCODING_UCS2;
+
+    uint32_t total = gsm7 ? septets : characters;
+    uint32_t single = gsm7 ? SMS_GSM7_SINGLE_SEPTETS : SMS_UCS2_SINGLE_CHARS;
+    uint32_t perSegment = gsm7 ? SMS_GSM7_SEGMENT_SEPTETS : SMS_UCS2_SEGMENT_CHARS;
+
+    segmentStart[0] = 0U;
+    if (total <= single) {
+        segments = 1U;
+        segmentStart[1] = (uint16_t)textLength;
+        return true;
+    }
+
+    /* Pass 2: cut at the segment limit; a character (or escape pair) is never split */
+    uint8_t index = 0U;
+    uint32_t used = 0U;
+    for (uint16_t offset = 0U; offset < textLength; ) {
+        uint16_t start = offset;
+        uint16_t code = gsm7Encode(utf8Next(text, &offset));
+        uint32_t cost = (gsm7 && code >= GSM7_ESCAPED) ? 2U : 1U;
+        if (used + cost > perSegment) {
+            index++;
+            if (index >= SMS_PDU_MAX_SEGMENTS) {
+                return false;
+            }
+            segmentStart[index] = start;
+            used = 0U;
+        }
+        used += cost;
+    }
+    segments = (uint8_t)(index + 1U);
+    segmentStart[segments] = (uint16_t)textLength;
+    plainText = false;
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Builds the PDU of one segment.
+* @details      SMS-SUBMIT with the default SMSC, message reference 0 (assigned by the module),
+*               no validity period, PID 0 and DCS 0x00 (GSM 7-bit) or 0x08 (UCS-2).
+*
+* @param[in]    index       Segment index, 0 .. segmentCount() - 1.
+* @param[out]   out         Encoded segment.
+*
+* @return       bool        False if index is out of range.
+*/
+/*================================================================================================*/
+bool SmsPduEncoder::encodeSegment(uint8_t index, SmsPdu& out) const {
+    if (index >= segments) {
+        return false;
+    }
+
+    uint8_t tpdu[SMS_PDU_TPDU_MAX_LEN];
+    uint8_t length = 0U;
+    bool concatenated = (segments > 1U);
+
+    /* First octet: SMS-SUBMIT, UDHI when a header is present; then TP-MR */
+    tpdu[length++] = concatenated ? 0x41U : 0x01U;
+    tpdu[length++] = 0x00U;
+
+    /* Destination address: digit count, type of number, swapped BCD padded with F */
+    bool international = (number[0] == '+');
+    const char* digits = international ? &number[1] : number;
+    uint8_t digitCount = (uint8_t)strlen(digits);
+    tpdu[length++] = digitCount;
+    tpdu[length++] = international ? 0x91U : 0x81U;
+    for (uint8_t i = 0; i < digitCount; i += 2U) {
+        uint8_t low = (uint8_t)(digits[i] - '0');
+        uint8_t high = (i + 1U < digitCount) ? (uint8_t)(digits[i + 1U] - '0') : 0x0FU;
+        tpdu[length++] = (uint8_t)((high << 4) | low);
+    }
+
+    /* Protocol identifier, data coding scheme, user data length (filled in below) */
+    tpdu[length++] = 0x00U;
+    tpdu[length++] = (coding == SMS_ENCODING_GSM7) ? 0x00U : 0x08U;
+    uint8_t udlIndex = length++;
+    uint8_t* userData = &tpdu[length];
+    memset(userData, 0, 140U);
+
+    uint8_t headerLength = 0U;
+    if (concatenated) {
+        userData[0] = SMS_UDH_CONCAT_LEN - 1U;
+        userData[1] = 0x00U;
+        userData[2] = 0x03U;
+        userData[3] = reference;
+        userData[4] = segments;
+        userData[5] = (uint8_t)(index + 1U);
+        headerLength = SMS_UDH_CONCAT_LEN;
+    }
+
+    uint16_t offset = segmentStart[index];
+    uint16_t end = segmentStart[index + 1U];
+    if (coding == SMS_ENCODING_GSM7) {
+        /* Septet s occupies bits 7s .. 7s+6 of the user data, least significant bit first */
+        uint16_t septet = concatenated ? SMS_UDH_CONCAT_SEPTETS : 0U;
+        while (offset < end) {
+            uint16_t code = gsm7Encode(utf8Next(text, &offset));
+            uint8_t values[2] = { 0x1BU, (uint8_t)(code & 0x7FU) };
+            uint8_t first = (code >= GSM7_ESCAPED) ? 0U : 1U;
+            for (uint8_t v = first; v < 2U; v++) {
+                uint16_t bit = (uint16_t)(septet * 7U);
+                uint8_t shift = (uint8_t)(bit % 8U);
+                userData[bit / 8U] |= (uint8_t)(values[v] << shift);
+                if (shift > 1U) {
+                    userData[bit / 8U + 1U] |= (uint8_t)(values[v] >> (8U - shift));
+                }
+                septet++;
+            }
+        }
+        tpdu[udlIndex] = (uint8_t)septet;
+        length = (uint8_t)(length + (septet * 7U + 7U) / 8U);
+    } else {
+        uint8_t octets = headerLength;
+        while (offset < end) {
+            uint16_t codePoint = utf8Next(text, &offset);
+            userData[octets++] = (uint8_t)(codePoint >> 8);
+            userData[octets++] = (uint8_t)(codePoint & 0xFFU);
+        }
+        tpdu[udlIndex] = octets;
+        length = (uint8_t)(length + octets);
+    }
+
+    /* Empty SMSC field (use the SIM's default), then the TPDU as hex */
+    char* hex = out.hex;
+    hex = appendHex(hex, 0x00U);
+    for (uint8_t i = 0; i < length; i++) {
+        hex = appendHex(hex, tpdu[i]);
+    }
+    *hex = '\0';
+    out.tpduLength = length;
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Decodes an SMS-DELIVER PDU as reported by +CMT in PDU mode (AT+CMGF=0).
+* @details      Layout: SMSC field, first octet (UDHI 0x40), originating address (digit count,
+*               type, swapped BCD), PID, DCS, 7-octet time stamp, UDL and the user data. An
+*               alphanumeric sender (type 0x50) is GSM 7-bit text. Septets outside the basic
+*               table decode as '?'.
+*
+* @param[in]    hex         SMSC field followed by the TPDU, as hex digits.
+* @param[in]    length      Number of hex digits.
+* @param[out]   out         Decoded message.
+*
+* @return       bool        False if the PDU is not an SMS-DELIVER or is truncated.
+*/
+/*================================================================================================*/
+bool smsPduDecodeDeliver(const char* hex, size_t length, SmsDeliver& out) {
+    uint8_t pdu[SMS_DELIVER_PDU_MAX_LEN];
+    size_t size = length / 2U;
+    if ((length % 2U) != 0U || size > sizeof(pdu)) {
+        return false;
+    }
+    for (size_t i = 0; i < size; i++) {
+        int high = hexDigit(hex[2U * i]);
+        int low = hexDigit(hex[2U * i + 1U]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        pdu[i] = (uint8_t)((high << 4) | low);
+    }
+
+    out.sender[0] = '\0';
+    out.text[0] = '\0';
+    out.textLength = 0U;
+
+    /* SMSC field, then the first octet: message type indicator 00 = SMS-DELIVER */
+    size_t position = (size_t)pdu[0] + 1U;
+    if (position + 2U > size || (pdu[position] & 0x03U) != 0x00U) {
+        return false;
+    }
+    bool hasHeader = (pdu[position] & 0x40U) != 0U;
+    position++;
+
+    /* Originating address */
+    uint8_t digitCount = pdu[position];
+    uint8_t addressType = pdu[position + 1U];
+    size_t addressOctets = (digitCount + 1U) / 2U;
+    bool alphanumeric = (addressType & 0x70U) == 0x50U;
+    uint8_t maxDigits = alphanumeric ? 2U * SMS_ALPHA_SENDER_MAX_LEN : SMS_PDU_MAX_DIGITS;
+    if (digitCount > maxDigits || position + 2U + addressOctets + 10U > size) {
+        return false;
+    }
+    const uint8_t* address = &pdu[position + 2U];
+    if (alphanumeric) {
+        uint16_t characters = (uint16_t)(digitCount * 4U / 7U);
+        uint16_t i = 0U;
+        for (; i < characters; i++) {
+            uint16_t codePoint = GSM7_BASIC[septetAt(address, i)];
+            out.sender[i] = (codePoint < 0x80U) ? (char)codePoint : '?';
+        }
+        out.sender[i] = '\0';
+    } else {
+        uint8_t next = 0U;
+        if ((addressType & 0x70U) == 0x10U) {
+            out.sender[next++] = '+';
+        }
+        for (uint8_t i = 0; i < digitCount; i++) {
+            uint8_t digit = (uint8_t)((address[i / 2U] >> ((i % 2U) * 4U)) & 0x0FU);
+            out.sender[next++] = (digit < 10U) ? (char)('0' + digit) : '?';
+        }
+        out.sender[next] = '\0';
+    }
+    position += 2U + addressOctets;
+
+    /* PID, DCS, time stamp, UDL */
+    uint8_t dcs = pdu[position + 1U];
+    uint8_t userDataLength = pdu[position + 9U];
+    position += 10U;
+    const uint8_t* userData = &pdu[position];
+    size_t available = size - position;
+
+    SmsEncoding coding = SMS_ENCODING_GSM7;
+    bool eightBit = false;
+    if ((dcs & 0x80U) == 0x00U) {
+        /* General data coding: alphabet in bits 2-3 */
+        coding = (((dcs >> 2) & 0x03U) == 0x02U) ? SMS_ENCODING_UCS2 : SMS_ENCODING_GSM7;
+        eightBit = (((dcs >> 2) & 0x03U) == 0x01U);
+    } else if ((dcs & 0xF0U) == 0xF0U) {
+        eightBit = (dcs & 0x04U) != 0U;
+    } else if ((dcs & 0xF0U) == 0xE0U) {
+        coding = SMS_ENCODING_UCS2;
+    }
+
+    if (coding == SMS_ENCODING_GSM7 && !eightBit) {
+        if (((size_t)userDataLength * 7U + 7U) / 8U > available) {
+            return false;
+        }
+        uint16_t septet = 0U;
+        if (hasHeader && userDataLength > 0U) {
+            septet = (uint16_t)(((userData[0] + 1U) * 8U + 6U) / 7U);
+        }
+        bool escaped = false;
+        for (; septet < userDataLength; septet++) {
+            uint8_t value = septetAt(userData, septet);
+            if (value == 0x1BU && !escaped) {
+                escaped = true;
+                continue;
+            }
+            uint16_t codePoint = escaped ? (uint16_t)'?' : GSM7_BASIC[value];
+            if (escaped) {
+                for (uint8_t i = 0; i < GSM7_EXTENSION_COUNT; i++) {
+                    if (GSM7_EXTENSION[i][0] == value) {
+                        codePoint = GSM7_EXTENSION[i][1];
+                    }
+                }
+                escaped = false;
+            }
+            utf8Append(out, (codePoint == GSM7_NONE) ? (uint16_t)'?' : codePoint);
+        }
+    } else {
+        if (userDataLength > available) {
+            return false;
+        }
+        uint16_t octet = (hasHeader && userDataLength > 0U) ? (uint16_t)(userData[0] + 1U) : 0U;
+        if (coding == SMS_ENCODING_UCS2) {
+            for (; octet + 1U < userDataLength; octet = (uint16_t)(octet + 2U)) {
+                utf8Append(out, (uint16_t)((userData[octet] << 8) | userData[octet + 1U]));
+            }
+        } else {
+            for (; octet < userDataLength; octet++) {
+                utf8Append(out, userData[octet]);
+            }
+        }
+    }
+    out.text[out.textLength] = '\0';
+    return true;
+}
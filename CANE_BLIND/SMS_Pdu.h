@@ -0,0 +1,146 @@
+#ifndef SMS_PDU_H
+#define SMS_PDU_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Maximum number of segments of one concatenated message */
+#define SMS_PDU_MAX_SEGMENTS      4U
+
+/* Payload per segment: single message / segment of a concatenated message */
+#define SMS_GSM7_SINGLE_SEPTETS   160U
+#define SMS_GSM7_SEGMENT_SEPTETS  153U
+#define SMS_UCS2_SINGLE_CHARS     70U
+#define SMS_UCS2_SEGMENT_CHARS    67U
+
+/* Longest destination number in digits */
+#define SMS_PDU_MAX_DIGITS        20U
+
+/* Longest TPDU: header (4) + address (SMS_PDU_MAX_DIGITS / 2) + PID, DCS, UDL (3) + 140 octets */
+#define SMS_PDU_TPDU_MAX_LEN      (7U + SMS_PDU_MAX_DIGITS / 2U + 140U)
+
+/* Hex text of a complete PDU: empty SMSC field ("00") plus the TPDU */
+#define SMS_PDU_HEX_MAX_LEN       (2U + 2U * SMS_PDU_TPDU_MAX_LEN)
+
+/* Longest decoded text of a received message: 160 GSM characters of up to 3 UTF-8 bytes */
+#define SMS_DELIVER_TEXT_MAX_LEN  (3U * SMS_GSM7_SINGLE_SEPTETS)
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Data coding of a message */
+typedef enum {
+    SMS_ENCODING_GSM7 = 0,      /* GSM 03.38 default alphabet, 7 bits per character */
+    SMS_ENCODING_UCS2           /* UCS-2, 16 bits per character */
+} SmsEncoding;
+
+/* A received message decoded from an SMS-DELIVER PDU */
+typedef struct {
+    char     sender[SMS_PDU_MAX_DIGITS + 2];        /* Digits, '+' first if international */
+    char     text[SMS_DELIVER_TEXT_MAX_LEN + 1];    /* Body in UTF-8 */
+    uint16_t textLength;                            /* Bytes in text */
+} SmsDeliver;
+
+/* One encoded segment, ready for AT+CMGS=<tpduLength> in PDU mode */
+typedef struct {
+    uint8_t tpduLength;                     /* Octets after the SMSC field */
+    char    hex[SMS_PDU_HEX_MAX_LEN + 1];   /* SMSC field + TPDU as upper-case hex */
+} SmsPdu;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class SmsPduEncoder
+* @brief SMS-SUBMIT PDU encoder with GSM 7-bit packing, UCS-2 fallback and concatenation.
+* @details begin() decodes the UTF-8 text once, picks GSM 7-bit if every character is in the
+* default alphabet or its extension table and UCS-2 otherwise, and splits the text into as few
+* segments as possible (never splitting an escape sequence). encodeSegment() then builds each
+* PDU; concatenated segments carry an 8-bit reference user data header. Nothing is allocated.
+*
+* @api
+*/
+/*================================================================================================*/
+class SmsPduEncoder {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the SmsPduEncoder class.
+    */
+    /*============================================================================================*/
+    SmsPduEncoder();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Analyses a message. The number and text must outlive the encoder's use.
+    *
+    * @param[in]    phoneNumber     Destination, digits with an optional leading '+'.
+    * @param[in]    messageText     Message body in UTF-8.
+    * @param[in]    concatReference Concatenation reference shared by the segments.
+    *
+    * @return       bool            False if the number is invalid or the text needs more than
+    *                               SMS_PDU_MAX_SEGMENTS segments.
+    */
+    /*============================================================================================*/
+    bool begin(const char* phoneNumber, const char* messageText, uint8_t concatReference);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Builds the PDU of one segment.
+    *
+    * @param[in]    index       Segment index, 0 .. segmentCount() - 1.
+    * @param[out]   out         Encoded segment.
+    *
+    * @return       bool        False if index is out of range.
+    */
+    /*============================================================================================*/
+    bool encodeSegment(uint8_t index, SmsPdu& out) const;
+
+    /* Result of begin() */
+    SmsEncoding encoding() const { return coding; }
+    uint8_t segmentCount() const { return segments; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns true if the text is one segment of characters that are the same in
+    *               ASCII and the GSM alphabet, so text mode (AT+CSCS="GSM") sends it unchanged.
+    */
+    /*============================================================================================*/
+    bool fitsTextMode() const { return plainText && segments == 1U; }
+
+private:
+    const char* number;
+    const char* text;
+    uint8_t reference;
+    SmsEncoding coding;
+    uint8_t segments;
+    bool plainText;
+    /* Byte offset of each segment in text, plus the end offset */
+    uint16_t segmentStart[SMS_PDU_MAX_SEGMENTS + 1];
+};
+
+/*================================================================================================*/
+/**
+* @brief        Decodes an SMS-DELIVER PDU as reported by +CMT in PDU mode (AT+CMGF=0).
+* @details      Reads the sender and converts the user data to UTF-8 from GSM 7-bit (with the
+*               extension table), UCS-2 or 8-bit data. A user data header (concatenation) is
+*               skipped, so each part of a long message decodes on its own.
+*
+* @param[in]    hex         SMSC field followed by the TPDU, as hex digits.
+* @param[in]    length      Number of hex digits.
+* @param[out]   out         Decoded message.
+*
+* @return       bool        False if the PDU is not an SMS-DELIVER or is truncated.
+*
+* @api
+*/
+/*================================================================================================*/
+bool smsPduDecodeDeliver(const char* hex, size_t length, SmsDeliver& out);
+
+#endif /* SMS_PDU_H */
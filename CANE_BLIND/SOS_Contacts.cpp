@@ -0,0 +1,176 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "SOS_Contacts.h"
+#include "Generic_API.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Emergency contacts used by the SOS flow */
+EmergencyContacts sosContacts;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* True for digits with an optional leading '+' */
+static bool isValidNumber(const char* phoneNumber) {
+    const char* digits = (phoneNumber[0] == '+') ? &phoneNumber[1] : phoneNumber;
+    size_t length = strlen(digits);
+    return (length > 0U) && (length <= SMS_PDU_MAX_DIGITS) &&
+           (strspn(digits, "0123456789") == length);
+}
+
+/* True if both numbers end in the same SOS_CONTACT_MATCH_DIGITS digits (or are equal) */
+static bool numbersMatch(const char* a, size_t lengthA, const char* b, size_t lengthB) {
+    if (lengthA < SOS_CONTACT_MATCH_DIGITS || lengthB < SOS_CONTACT_MATCH_DIGITS) {
+        return (lengthA == lengthB) && (memcmp(a, b, lengthA) == 0);
+    }
+    return memcmp(&a[lengthA - SOS_CONTACT_MATCH_DIGITS], &b[lengthB - SOS_CONTACT_MATCH_DIGITS],
+                  SOS_CONTACT_MATCH_DIGITS) == 0;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the EmergencyContacts class.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+EmergencyContacts::EmergencyContacts() : contactCount(0U) {
+    memset(numbers, 0, sizeof(numbers));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Loads the list from NVS, or falls back to SOS_PHONE_NUMBER.
+*
+* @return       uint8_t     Number of contacts.
+*/
+/*================================================================================================*/
+uint8_t EmergencyContacts::begin() {
+    contactCount = 0U;
+    memset(numbers, 0, sizeof(numbers));
+
+    /* Opening a namespace read-only fails until something was written to it */
+    if (prefs.begin(SOS_CONTACTS_NAMESPACE, true)) {
+        if (prefs.getBytesLength("list") == sizeof(numbers)) {
+            prefs.getBytes("list", numbers, sizeof(numbers));
+            contactCount = prefs.getUChar("count", 0U);
+        }
+        prefs.end();
+    }
+
+    /* Drop anything malformed */
+    if (contactCount > SOS_CONTACTS_MAX) {
+        contactCount = 0U;
+    }
+    for (uint8_t i = 0; i < contactCount; i++) {
+        numbers[i][SOS_CONTACT_NUMBER_MAX_LEN] = '\0';
+        if (!isValidNumber(numbers[i])) {
+            contactCount = 0U;
+        }
+    }
+
+    if (contactCount == 0U) {
+        strncpy(numbers[0], SOS_PHONE_NUMBER, SOS_CONTACT_NUMBER_MAX_LEN);
+        contactCount = 1U;
+    }
+    return contactCount;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Appends a contact (lowest priority) and saves the list.
+*
+* @param[in]    phoneNumber     Digits with an optional leading '+'.
+*
+* @return       bool            False if the list is full, the number is invalid or present.
+*/
+/*================================================================================================*/
+bool EmergencyContacts::add(const char* phoneNumber) {
+    if (contactCount >= SOS_CONTACTS_MAX || !isValidNumber(phoneNumber) || contains(phoneNumber)) {
+        return false;
+    }
+    strncpy(numbers[contactCount], phoneNumber, SOS_CONTACT_NUMBER_MAX_LEN);
+    numbers[contactCount][SOS_CONTACT_NUMBER_MAX_LEN] = '\0';
+    contactCount++;
+    save();
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Removes the contact at index and saves the list.
+* @details      The contacts behind it move up one priority. The last contact is never removed,
+*               so an SOS always has someone to call.
+*
+* @param[in]    index       Position in the list.
+*
+* @return       bool        False if index is out of range or it is the only contact.
+*/
+/*================================================================================================*/
+bool EmergencyContacts::remove(uint8_t index) {
+    if (index >= contactCount || contactCount <= 1U) {
+        return false;
+    }
+    for (uint8_t i = index; i + 1U < contactCount; i++) {
+        memcpy(numbers[i], numbers[i + 1U], sizeof(numbers[i]));
+    }
+    contactCount--;
+    memset(numbers[contactCount], 0, sizeof(numbers[contactCount]));
+    save();
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns true if the number is in the list.
+*/
+/*================================================================================================*/
+bool EmergencyContacts::contains(const char* phoneNumber) const {
+    return contains(phoneNumber, strlen(phoneNumber));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Same as contains(), for a number that is not NUL-terminated (e.g. a URC field).
+*/
+/*================================================================================================*/
+bool EmergencyContacts::contains(const char* phoneNumber, size_t length) const {
+    for (uint8_t i = 0; i < contactCount; i++) {
+        if (numbersMatch(numbers[i], strlen(numbers[i]), phoneNumber, length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the list, one contact per line.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void EmergencyContacts::print(Print& out) const {
+    for (uint8_t i = 0; i < contactCount; i++) {
+        out.printf("[SOS] contact %u: %s\n", (unsigned)i, numbers[i]);
+    }
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Writes the whole list to NVS */
+void EmergencyContacts::save() {
+    prefs.begin(SOS_CONTACTS_NAMESPACE, false);
+    prefs.putBytes("list", numbers, sizeof(numbers));
+    prefs.putUChar("count", contactCount);
+    prefs.end();
+}
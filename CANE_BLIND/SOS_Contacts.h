@@ -0,0 +1,125 @@
+#ifndef SOS_CONTACTS_H
+#define SOS_CONTACTS_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <Preferences.h>
+#include "SMS_Pdu.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Maximum number of emergency contacts */
+#define SOS_CONTACTS_MAX              5U
+
+/* Longest contact number ('+' and the digits) */
+#define SOS_CONTACT_NUMBER_MAX_LEN    (SMS_PDU_MAX_DIGITS + 1U)
+
+/* Trailing digits compared when matching numbers (the national significant number) */
+#define SOS_CONTACT_MATCH_DIGITS      9U
+
+/* NVS namespace of the contact list */
+#define SOS_CONTACTS_NAMESPACE        "contacts"
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class EmergencyContacts
+* @brief Ordered list of emergency contacts kept in NVS.
+* @details The list order is the call priority: index 0 is dialled first. The whole list is
+* written as one blob whenever it changes. When nothing has been stored yet the list holds
+* SOS_PHONE_NUMBER, so a fresh device behaves as before.
+*
+* @api
+*/
+/*================================================================================================*/
+class EmergencyContacts {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the EmergencyContacts class.
+    */
+    /*============================================================================================*/
+    EmergencyContacts();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Loads the list from NVS, or falls back to SOS_PHONE_NUMBER.
+    *
+    * @return       uint8_t     Number of contacts.
+    */
+    /*============================================================================================*/
+    uint8_t begin();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Appends a contact (lowest priority) and saves the list.
+    *
+    * @param[in]    phoneNumber     Digits with an optional leading '+'.
+    *
+    * @return       bool            False if the list is full, the number is invalid or present.
+    */
+    /*============================================================================================*/
+    bool add(const char* phoneNumber);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Removes the contact at index and saves the list.
+    *
+    * @param[in]    index       Position in the list.
+    *
+    * @return       bool        False if index is out of range or it is the only contact.
+    */
+    /*============================================================================================*/
+    bool remove(uint8_t index);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns true if the number is in the list.
+    * @details      Numbers are compared on their last SOS_CONTACT_MATCH_DIGITS digits, so the
+    *               international form "+84387..." matches the national form "0387...".
+    */
+    /*============================================================================================*/
+    bool contains(const char* phoneNumber) const;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Same as contains(), for a number that is not NUL-terminated (e.g. a URC field).
+    */
+    /*============================================================================================*/
+    bool contains(const char* phoneNumber, size_t length) const;
+
+    /* Number of contacts and the number at index (by priority) */
+    uint8_t count() const { return contactCount; }
+    const char* number(uint8_t index) const { return (index < contactCount) ? numbers[index] : ""; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the list, one contact per line.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void print(Print& out) const;
+
+private:
+    void save();
+
+    Preferences prefs;
+    uint8_t contactCount;
+    char numbers[SOS_CONTACTS_MAX][SOS_CONTACT_NUMBER_MAX_LEN + 1];
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Emergency contacts used by the SOS flow */
+extern EmergencyContacts sosContacts;
+
+#endif /* SOS_CONTACTS_H */
@@ -0,0 +1,354 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "SOS_Dispatch.h"
+#include "GPS_Feature.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* SOS alert on the GSM module */
+SosDispatcher sosDispatcher(gsmAtEngine, callTracker, smsOutbox, sosContacts, gnssPoller,
+                            locationCache);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the SosDispatcher class.
+*
+* @param[in]    engine      AT engine of the GSM module (position query).
+* @param[in]    calls       Call tracker of the GSM module.
+* @param[in]    outbox      Outbox that delivers the SMS.
+* @param[in]    contacts    Emergency contacts, by priority.
+* @param[in]    gnss        GNSS poller, source of fresh fixes for the follow-up.
+* @param[in]    cache       Last known location.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+SosDispatcher::SosDispatcher(AtEngine& engine, CallTracker& calls, SmsOutbox& outbox,
+                             EmergencyContacts& contacts, GnssPoller& gnss, LocationCache& cache)
+    : engine(engine), calls(calls), outbox(outbox), contacts(contacts), gnss(gnss), cache(cache),
+      active(false), calling(false), dialIndex(0U), locationHandle(AT_INVALID_HANDLE),
+      followUpArmed(false), sentPosition(false), sentFresh(false), messageQueued(false),
+      pendingMask(0U) {
+    memset(&sentCoord, 0, sizeof(sentCoord));
+    memset(&timing, 0, sizeof(timing));
+    timing.callContact = -1;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Starts an alert: dials the first contact and requests the position.
+* @details      Returns immediately. ATD goes first so the network starts setting the call up;
+*               AT+CGPSINFO is queued right behind it and answers while the call rings. The
+*               trigger time is taken here, so every figure in report() is measured from the
+*               moment the caller decided to raise the alert.
+*
+* @return       bool        False if an alert is already running or there is no contact.
+*/
+/*================================================================================================*/
+bool SosDispatcher::start() {
+    if (active || contacts.count() == 0U) {
+        return false;
+    }
+    memset(&timing, 0, sizeof(timing));
+    timing.triggeredAtMs = millis();
+    timing.callContact = -1;
+    active = true;
+    dialIndex = 0U;
+    followUpArmed = false;
+    messageQueued = false;
+    pendingMask = 0U;
+    dialNext();
+    if (locationHandle != AT_INVALID_HANDLE) {
+        engine.release(locationHandle);
+    }
+    locationHandle = engine.submit(AT_CMD_GNSS_INFO);
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Follows the call, the deliveries and the follow-up; never blocks.
+* @details      The alert text is queued for every contact at once with a cached location,
+*               otherwise as soon as the position is known. A call that is rejected, busy or
+*               not answered moves on to the next contact. A contact counts as notified only
+*               once the network accepted its SMS, not when the outbox gave the SMS up. The
+*               alert ends once a contact has answered (or every contact was tried) and every
+*               queued message has left the outbox, or after SOS_NOTIFY_TIMEOUT_MS. The follow-up is watched for until
+*               SOS_FOLLOW_UP_WINDOW_MS, also after the alert ended.
+*
+* @return       bool        True while the alert is running.
+*/
+/*================================================================================================*/
+bool SosDispatcher::poll() {
+    uint32_t elapsedMs = millis() - timing.triggeredAtMs;
+    if (followUpArmed) {
+        checkFollowUp(elapsedMs);
+    }
+    if (!active) {
+        return false;
+    }
+
+    if (!messageQueued && (cache.hasLocation() || locationHandle == AT_INVALID_HANDLE ||
+                           engine.result(locationHandle) != AT_RESULT_PENDING ||
+                           elapsedMs >= SOS_LOCATION_WAIT_MS)) {
+        composeAlert(elapsedMs);
+    }
+
+    if (calling) {
+        CallState state = calls.poll();
+        if (state == CALL_STATE_ACTIVE) {
+            /* Answered: nobody else needs to be called */
+            calling = false;
+            timing.callContact = (int8_t)(dialIndex - 1U);
+            timing.callAnsweredMs = elapsedMs;
+            LOG_INFO("SOS: contact %u answered after %u ms", (unsigned)(dialIndex - 1U),
+                     (unsigned)elapsedMs);
+        } else if (state == CALL_STATE_ENDED) {
+            calling = false;
+            LOG_WARN("SOS: call to contact %u not answered (reason %u)",
+                     (unsigned)(dialIndex - 1U), (unsigned)calls.endReason());
+            dialNext();
+        }
+    }
+
+    for (uint8_t i = 0; i < SOS_CONTACTS_MAX; i++) {
+        uint8_t bit = (uint8_t)(1U << i);
+        if ((pendingMask & bit) == 0U) {
+            continue;
+        }
+        SmsDelivery delivery = outbox.delivery(contacts.number(i));
+        if (delivery == SMS_DELIVERY_PENDING) {
+            continue;
+        }
+        pendingMask &= (uint8_t)~bit;
+        if (delivery != SMS_DELIVERY_SENT) {
+            timing.dropped[i] = true;
+            LOG_WARN("SOS: SMS to contact %u given up after %u ms", (unsigned)i,
+                     (unsigned)elapsedMs);
+        } else {
+            timing.notified[i] = true;
+            timing.notifiedMs[i] = elapsedMs;
+            if (timing.firstSmsMs == 0U) {
+                timing.firstSmsMs = elapsedMs;
+                LOG_INFO("SOS: first SMS submitted %u ms after the trigger",
+                         (unsigned)elapsedMs);
+            }
+        }
+    }
+
+    if (!calling && messageQueued && pendingMask == 0U) {
+        finish(false);
+    } else if (elapsedMs >= SOS_NOTIFY_TIMEOUT_MS) {
+        finish(true);
+    }
+    return active;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints the timing of the current (or last) alert.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void SosDispatcher::printReport(Print& out) const {
+    if (!active && !messageQueued && timing.dialAttempts == 0U) {
+        out.println("[SOS] no alert yet");
+        return;
+    }
+    const char* state = active ? "running" : (timing.timedOut ? "timed out" : "done");
+    out.printf("[SOS] %s, %u dial attempt(s)", state, (unsigned)timing.dialAttempts);
+    if (timing.callContact >= 0) {
+        out.printf(", contact %d answered at %lu ms", (int)timing.callContact,
+                   (unsigned long)timing.callAnsweredMs);
+    }
+    out.println();
+    if (messageQueued) {
+        out.printf("[SOS]   alert text ready at %lu ms (%s)\n", (unsigned long)timing.locationMs,
+                   timing.locationFixed ? "GNSS fix"
+                                        : (timing.locationCached ? "last known location"
+                                                                 : "no location"));
+    }
+    if (timing.followUpMs != 0U) {
+        out.printf("[SOS]   follow-up with a fresh fix at %lu ms\n",
+                   (unsigned long)timing.followUpMs);
+    }
+    for (uint8_t i = 0; i < contacts.count(); i++) {
+        if (timing.notified[i]) {
+            out.printf("[SOS]   %s notified at %lu ms\n", contacts.number(i),
+                       (unsigned long)timing.notifiedMs[i]);
+        } else if (timing.dropped[i]) {
+            out.printf("[SOS]   %s not notified (SMS given up)\n", contacts.number(i));
+        } else {
+            out.printf("[SOS]   %s not notified\n", contacts.number(i));
+        }
+    }
+    if (timing.firstSmsMs != 0U) {
+        out.printf("[SOS] trigger to first SMS submitted: %lu ms\n",
+                   (unsigned long)timing.firstSmsMs);
+    }
+    if (timing.allNotifiedMs != 0U) {
+        out.printf("[SOS] all contacts notified %lu ms after the trigger\n",
+                   (unsigned long)timing.allNotifiedMs);
+    }
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Builds the alert text from the GNSS fix, or else the last known location, and queues it */
+void SosDispatcher::composeAlert(uint32_t elapsedMs) {
+    char message[SMS_TEXT_MAX_LEN + 1U];
+    GnssFix fix;
+    timing.locationFixed = collectLocation(&fix);
+    timing.locationCached = !timing.locationFixed && cache.hasLocation();
+    if (locationHandle != AT_INVALID_HANDLE && elapsedMs >= SOS_LOCATION_WAIT_MS) {
+        /* Too late to be worth holding the SMS up; the follow-up takes the poller's fix */
+        engine.release(locationHandle);
+        locationHandle = AT_INVALID_HANDLE;
+    }
+    timing.locationMs = elapsedMs;
+
+    size_t length = 0U;
+    if (timing.locationFixed) {
+        length = geoFormatMessage("SOS! My location: ", fix.position, message, sizeof(message));
+    } else if (timing.locationCached) {
+        char prefix[LOCATION_DESCRIPTION_MAX_LEN + 32U];
+        char description[LOCATION_DESCRIPTION_MAX_LEN + 1U];
+        cache.describe(description, sizeof(description));
+        snprintf(prefix, sizeof(prefix), "SOS! Last known location (%s): ", description);
+        length = geoFormatMessage(prefix, cache.location().position, message, sizeof(message));
+    }
+    if (length == 0U) {
+        snprintf(message, sizeof(message), "SOS! Unable to get GPS location.");
+    }
+
+    /* Anything short of a fresh fix is followed up once one arrives */
+    followUpArmed = !timing.locationFixed;
+    sentPosition = timing.locationCached;
+    sentFresh = timing.locationCached && cache.ageSeconds() <= SOS_CACHE_FRESH_S;
+    sentCoord = cache.location().position;
+
+    LOG_INFO("SOS: alert text ready after %u ms (GNSS fix %u, cached %u)",
+             (unsigned)elapsedMs, (unsigned)timing.locationFixed,
+             (unsigned)timing.locationCached);
+    broadcast(message);
+}
+
+/* Takes the answer of the alert's position query once it is there; true with a fix */
+bool SosDispatcher::collectLocation(GnssFix* fix) {
+    if (locationHandle == AT_INVALID_HANDLE ||
+        engine.result(locationHandle) == AT_RESULT_PENDING) {
+        return false;
+    }
+    bool fixed = engine.parse(locationHandle, fix);
+    engine.release(locationHandle);
+    locationHandle = AT_INVALID_HANDLE;
+    if (fixed) {
+        cache.update(*fix);
+    }
+    return fixed;
+}
+
+/* Sends the follow-up with the first fresh fix after the trigger, unless it confirms a recent
+   cached location */
+void SosDispatcher::checkFollowUp(uint32_t elapsedMs) {
+    if (elapsedMs >= SOS_FOLLOW_UP_WINDOW_MS) {
+        followUpArmed = false;
+        LOG_WARN("SOS: no fresh fix within %u ms, no follow-up",
+                 (unsigned)SOS_FOLLOW_UP_WINDOW_MS);
+        return;
+    }
+
+    GnssFix fix;
+    if (!collectLocation(&fix)) {
+        const GnssFix& latest = gnss.fix();
+        if (!latest.valid || (int32_t)(latest.updatedMs - timing.triggeredAtMs) < 0) {
+            return;
+        }
+        fix = latest;
+    }
+    followUpArmed = false;
+
+    if (sentPosition && sentFresh &&
+        geoDistanceM(sentCoord, fix.position) < SOS_FOLLOW_UP_DISTANCE_M) {
+        LOG_INFO("SOS: fresh fix after %u ms confirms the cached location",
+                 (unsigned)elapsedMs);
+        return;
+    }
+
+    char message[SMS_TEXT_MAX_LEN + 1U];
+    if (geoFormatMessage("SOS update, my location now: ", fix.position, message,
+                         sizeof(message)) == 0U) {
+        return;
+    }
+    timing.followUpMs = elapsedMs;
+    LOG_INFO("SOS: follow-up with a fresh fix after %u ms", (unsigned)elapsedMs);
+    broadcast(message);
+}
+
+/* Queues the alert text for every contact ahead of other messages; a contact the outbox
+   cannot take now stays not notified */
+uint8_t SosDispatcher::broadcast(const char* messageText) {
+    uint8_t queued = 0U;
+    for (uint8_t i = 0; i < contacts.count(); i++) {
+        if (outbox.enqueueUrgent(contacts.number(i), messageText)) {
+            pendingMask |= (uint8_t)(1U << i);
+            queued++;
+        }
+    }
+    messageQueued = true;
+    return queued;
+}
+
+/* Calls the next contact; false when every contact has been tried */
+bool SosDispatcher::dialNext() {
+    /* The alert takes over the line from any other call */
+    calls.hangUp();
+    while (dialIndex < contacts.count()) {
+        const char* number = contacts.number(dialIndex++);
+        if (calls.dial(number)) {
+            calling = true;
+            timing.dialAttempts++;
+            return true;
+        }
+        LOG_WARN("SOS: could not queue the call to contact %u", (unsigned)(dialIndex - 1U));
+    }
+    return false;
+}
+
+/* Ends the alert and logs the outcome */
+void SosDispatcher::finish(bool timedOut) {
+    /* The position query stays in flight while the follow-up waits for it */
+    if (locationHandle != AT_INVALID_HANDLE && !followUpArmed) {
+        engine.release(locationHandle);
+        locationHandle = AT_INVALID_HANDLE;
+    }
+    active = false;
+    calling = false;
+    timing.timedOut = timedOut;
+
+    bool allNotified = messageQueued;
+    uint32_t lastMs = 0U;
+    for (uint8_t i = 0; i < contacts.count(); i++) {
+        if (!timing.notified[i]) {
+            allNotified = false;
+        } else if (timing.notifiedMs[i] > lastMs) {
+            lastMs = timing.notifiedMs[i];
+        }
+    }
+    if (allNotified) {
+        timing.allNotifiedMs = lastMs;
+        LOG_INFO("SOS: all %u contacts notified after %u ms", (unsigned)contacts.count(),
+                 (unsigned)lastMs);
+    } else {
+        LOG_WARN("SOS: alert ended with contacts not notified (timeout %u)", (unsigned)timedOut);
+    }
+}
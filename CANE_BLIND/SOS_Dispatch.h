@@ -0,0 +1,189 @@
+#ifndef SOS_DISPATCH_H
+#define SOS_DISPATCH_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "CALL_Tracker.h"
+#include "SMS_Outbox.h"
+#include "SOS_Contacts.h"
+#include "GPS_Poller.h"
+#include "GPS_Cache.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Longest time an alert is tracked; the outbox keeps retrying undelivered messages afterwards */
+#define SOS_NOTIFY_TIMEOUT_MS     120000UL
+
+/* Longest wait for the GNSS position before the alert text goes out without a fix; with a
+   cached location the text goes out at once */
+#define SOS_LOCATION_WAIT_MS      3000UL
+
+/* How long after the trigger a fresh fix still produces the follow-up SMS */
+#define SOS_FOLLOW_UP_WINDOW_MS   600000UL
+
+/* A cached location at most this old (s) that the fresh fix confirms within
+   SOS_FOLLOW_UP_DISTANCE_M (m) is not followed up */
+#define SOS_CACHE_FRESH_S         120U
+#define SOS_FOLLOW_UP_DISTANCE_M  25U
+
+/* Longest time from the SOS trigger (start()) until ATD is written to the modem, excluding
+   the loop period. ATD is urgent: in the worst case it waits for ATH of a call still in
+   progress, which itself waits AT_ENGINE_URGENT_WAIT_MS for the command on the wire (a query
+   runs to its deadline, an SMS at its prompt is cancelled, one sent to the network is
+   detached). Only an alert SMS of an earlier alert still on the wire, or ATD of its call that
+   has not answered yet (ATH waits for it), can hold ATD longer. */
+#define SOS_DIAL_BOUND_MS         3000UL
+
+static_assert(AT_ENGINE_URGENT_WAIT_MS + AT_CMD_HANG_UP.timeoutMs <= SOS_DIAL_BOUND_MS,
+              "worst-case time to ATD exceeds SOS_DIAL_BOUND_MS");
+
+/* Alert messages evict other queued messages, so every contact fits as long as they do */
+static_assert(SOS_CONTACTS_MAX <= SMS_OUTBOX_DEPTH, "the outbox cannot hold an alert per contact");
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Timing of the last alert, relative to the trigger (0 while not reached) */
+typedef struct {
+    uint32_t triggeredAtMs;                   /* millis() at start() */
+    int8_t   callContact;                     /* Contact who answered, or -1 */
+    uint8_t  dialAttempts;                    /* Calls placed */
+    uint32_t callAnsweredMs;                  /* Call answered */
+    uint32_t locationMs;                      /* Alert text composed (with or without a fix) */
+    bool     locationFixed;                   /* The text carries a GNSS fix */
+    bool     locationCached;                  /* The text carries the last known location */
+    uint32_t followUpMs;                      /* Follow-up with a fresh fix queued */
+    uint32_t firstSmsMs;                      /* First SMS accepted by the network */
+    bool     notified[SOS_CONTACTS_MAX];      /* The network accepted the SMS to the contact */
+    bool     dropped[SOS_CONTACTS_MAX];       /* The outbox gave the SMS to the contact up */
+    uint32_t notifiedMs[SOS_CONTACTS_MAX];    /* SMS to each contact delivered */
+    uint32_t allNotifiedMs;                   /* Every contact notified */
+    bool     timedOut;                        /* SOS_NOTIFY_TIMEOUT_MS expired first */
+} SosReport;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class SosDispatcher
+* @brief Non-blocking SOS alert: calls the contacts in priority order and texts all of them.
+* @details start() returns at once after queuing ATD for the first contact and AT+CGPSINFO
+* behind it on the modem's command channel, so the position is read while the call is being
+* set up. When a location is cached the first poll() composes the alert text with it, its age
+* and accuracy; otherwise poll() waits for the position (at most SOS_LOCATION_WAIT_MS). The
+* text goes into the SMS outbox for every contact as an urgent message; the outbox sends them
+* back to back, ahead of any other queued message, whenever the engine is free, i.e. while the
+* call rings. An alert sent without a fresh fix
+* is followed by one more SMS with the first fresh fix (from the query or the GNSS poller)
+* within SOS_FOLLOW_UP_WINDOW_MS, unless that fix confirms a recent cached location.
+* poll() also follows the call
+* through the CallTracker, calls the next contact when it is rejected, busy or not answered
+* within the ring timeout, and records when each stage was reached.
+*
+* @api
+*/
+/*================================================================================================*/
+class SosDispatcher {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the SosDispatcher class.
+    *
+    * @param[in]    engine      AT engine of the GSM module (position query).
+    * @param[in]    calls       Call tracker of the GSM module.
+    * @param[in]    outbox      Outbox that delivers the SMS.
+    * @param[in]    contacts    Emergency contacts, by priority.
+    * @param[in]    gnss        GNSS poller, source of fresh fixes for the follow-up.
+    * @param[in]    cache       Last known location.
+    */
+    /*============================================================================================*/
+    SosDispatcher(AtEngine& engine, CallTracker& calls, SmsOutbox& outbox,
+                  EmergencyContacts& contacts, GnssPoller& gnss, LocationCache& cache);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Starts an alert: dials the first contact and requests the position.
+    *
+    * @return       bool        False if an alert is already running or there is no contact.
+    */
+    /*============================================================================================*/
+    bool start();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Follows the call, the deliveries and the follow-up; never blocks.
+    * @details      Keep calling it after the alert ended: the follow-up may still be due.
+    *
+    * @return       bool        True while the alert is running.
+    */
+    /*============================================================================================*/
+    bool poll();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns true while the alert is running.
+    */
+    /*============================================================================================*/
+    bool isActive() const { return active; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns the timing of the current (or last) alert.
+    */
+    /*============================================================================================*/
+    const SosReport& report() const { return timing; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints the timing of the current (or last) alert.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printReport(Print& out) const;
+
+private:
+    void composeAlert(uint32_t elapsedMs);
+    bool collectLocation(GnssFix* fix);
+    void checkFollowUp(uint32_t elapsedMs);
+    uint8_t broadcast(const char* messageText);
+    bool dialNext();
+    void finish(bool timedOut);
+
+    AtEngine& engine;
+    CallTracker& calls;
+    SmsOutbox& outbox;
+    EmergencyContacts& contacts;
+    GnssPoller& gnss;
+    LocationCache& cache;
+    bool active;
+    /* A call placed by the alert is in progress */
+    bool calling;
+    /* Next contact to dial */
+    uint8_t dialIndex;
+    /* AT+CGPSINFO in flight, or AT_INVALID_HANDLE */
+    AtHandle locationHandle;
+    /* Waiting for a fresh fix to follow the alert up; what the alert text carried */
+    bool followUpArmed;
+    bool sentPosition;
+    bool sentFresh;
+    GeoCoord sentCoord;
+    /* Alert text queued; contacts whose message is still in the outbox (bit per index) */
+    bool messageQueued;
+    uint8_t pendingMask;
+    SosReport timing;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* SOS alert on the GSM module */
+extern SosDispatcher sosDispatcher;
+
+#endif /* SOS_DISPATCH_H */
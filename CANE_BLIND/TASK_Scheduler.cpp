@@ -0,0 +1,279 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TASK_Scheduler.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Scheduler of the loop task */
+TaskletScheduler loopScheduler;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the TaskletScheduler class.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+TaskletScheduler::TaskletScheduler()
+    : count(0U), owner(NULL), triggered(0U), busyUs(0U), sleeps(0U), statsStartMs(0U) {
+    memset(tasklets, 0, sizeof(tasklets));
+    for (uint8_t i = 0; i < TASKLET_MAX_COUNT; i++) {
+        triggerMs[i] = 0U;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Binds the scheduler to the calling task, the one that will call runOnce().
+* @details      Until then runOnce() sleeps with delay() and triggers only take effect at the
+*               next wake-up.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void TaskletScheduler::begin() {
+    owner = xTaskGetCurrentTaskHandle();
+    statsStartMs = millis();
+}
+
+/*================================================================================================*/
+/**
+* @brief        Adds a tasklet.
+*
+* @param[in]    name        Name shown in the statistics (string literal).
+* @param[in]    function    Tasklet body.
+* @param[in]    context     Passed to function.
+* @param[in]    periodMs    Interval between runs, 0 for a tasklet that only runs when
+*                           triggered or rescheduled with runIn(). The first run is due now.
+* @param[in]    deadlineMs  Lateness above which a run counts as a deadline miss.
+*
+* @return       TaskletId   Id of the tasklet, or TASKLET_INVALID_ID if the table is full.
+*/
+/*================================================================================================*/
+TaskletId TaskletScheduler::add(const char* name, TaskletFunction function, void* context,
+                                uint32_t periodMs, uint32_t deadlineMs) {
+    if (count >= TASKLET_MAX_COUNT || function == NULL) {
+        return TASKLET_INVALID_ID;
+    }
+    Tasklet& tasklet = tasklets[count];
+    memset(&tasklet, 0, sizeof(tasklet));
+    tasklet.name = name;
+    tasklet.function = function;
+    tasklet.context = context;
+    tasklet.periodMs = periodMs;
+    tasklet.deadlineMs = deadlineMs;
+    tasklet.dueMs = millis();
+    tasklet.armed = (periodMs > 0U);
+    return count++;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Makes a tasklet due now and wakes the scheduler.
+* @details      The trigger time is kept from the first trigger until the run, so the lateness
+*               covers the whole wait. Safe from interrupts and from other tasks.
+*
+* @param[in]    id          Tasklet to run.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void IRAM_ATTR TaskletScheduler::trigger(TaskletId id) {
+    if (id >= TASKLET_MAX_COUNT) {
+        return;
+    }
+    uint32_t bit = 1UL << id;
+    if ((triggered.load(std::memory_order_relaxed) & bit) == 0U) {
+        triggerMs[id] = millis();
+    }
+    triggered.fetch_or(bit, std::memory_order_release);
+
+    if (owner == NULL) {
+        return;
+    }
+    if (xPortInIsrContext()) {
+        BaseType_t higherPriorityWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(owner, &higherPriorityWoken);
+        portYIELD_FROM_ISR(higherPriorityWoken);
+    } else {
+        xTaskNotifyGive(owner);
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Makes a tasklet due in delayMs unless it is due earlier already.
+*
+* @param[in]    id          Tasklet to run.
+* @param[in]    delayMs     Time from now.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void TaskletScheduler::runIn(TaskletId id, uint32_t delayMs) {
+    if (id >= count) {
+        return;
+    }
+    Tasklet& tasklet = tasklets[id];
+    uint32_t dueMs = millis() + delayMs;
+    if (!tasklet.armed || (int32_t)(dueMs - tasklet.dueMs) < 0) {
+        tasklet.dueMs = dueMs;
+        tasklet.armed = true;
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Runs the due tasklets, then sleeps until the next one is due or triggered.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void TaskletScheduler::runOnce() {
+    uint32_t waitMs = runDue();
+    if (waitMs > 0U) {
+        sleep(waitMs);
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Runs every due tasklet once, in registration order.
+* @details      A triggered tasklet is timed from its trigger, any other from its due time.
+*               Triggers that arrive while the tasklets run are left for the next call.
+*
+* @return       uint32_t    Time until the next tasklet is due (ms), 0 if one is due now.
+*/
+/*================================================================================================*/
+uint32_t TaskletScheduler::runDue() {
+    uint32_t pending = triggered.exchange(0U, std::memory_order_acquire);
+
+    for (uint8_t i = 0; i < count; i++) {
+        Tasklet& tasklet = tasklets[i];
+        if ((pending & (1UL << i)) != 0U) {
+            run(tasklet, triggerMs[i]);
+        } else if (tasklet.armed && (int32_t)(millis() - tasklet.dueMs) >= 0) {
+            run(tasklet, tasklet.dueMs);
+        }
+    }
+
+    if (triggered.load(std::memory_order_relaxed) != 0U) {
+        return 0U;
+    }
+    uint32_t nowMs = millis();
+    uint32_t waitMs = TASKLET_MAX_SLEEP_MS;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!tasklets[i].armed) {
+            continue;
+        }
+        int32_t remaining = (int32_t)(tasklets[i].dueMs - nowMs);
+        if (remaining <= 0) {
+            return 0U;
+        }
+        if ((uint32_t)remaining < waitMs) {
+            waitMs = (uint32_t)remaining;
+        }
+    }
+    return waitMs;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Prints run time, lateness and deadline misses per tasklet, and the busy share.
+*
+* @param[in]    out         Destination (typically Serial).
+*
+* @return       void
+*/
+/*================================================================================================*/
+void TaskletScheduler::printStats(Print& out) const {
+    for (uint8_t i = 0; i < count; i++) {
+        const TaskletStats& stats = tasklets[i].stats;
+        uint32_t runs = (stats.runs > 0U) ? stats.runs : 1U;
+        out.printf("[TASK] %-8s %6lu runs, run avg %5lu max %6lu us, "
+                   "late avg %4lu max %5lu ms, %lu over %lu ms\n",
+                   tasklets[i].name, (unsigned long)stats.runs,
+                   (unsigned long)(stats.totalRunUs / runs), (unsigned long)stats.maxRunUs,
+                   (unsigned long)(stats.totalLateMs / runs), (unsigned long)stats.maxLateMs,
+                   (unsigned long)stats.deadlineMisses, (unsigned long)tasklets[i].deadlineMs);
+    }
+
+    uint32_t elapsedMs = millis() - statsStartMs;
+    uint32_t busyPermille = (elapsedMs > 0U) ? (uint32_t)(busyUs / elapsedMs) : 0U;
+    out.printf("[TASK] loop busy %lu.%lu%% of %lu ms, %lu sleeps\n",
+               (unsigned long)(busyPermille / 10U), (unsigned long)(busyPermille % 10U),
+               (unsigned long)elapsedMs, (unsigned long)sleeps);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Clears the statistics of every tasklet.
+*
+* @return       void
+*/
+/*================================================================================================*/
+void TaskletScheduler::resetStats() {
+    for (uint8_t i = 0; i < count; i++) {
+        memset(&tasklets[i].stats, 0, sizeof(tasklets[i].stats));
+    }
+    busyUs = 0U;
+    sleeps = 0U;
+    statsStartMs = millis();
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Sets the next due time, runs the body and records run time and lateness */
+void TaskletScheduler::run(Tasklet& tasklet, uint32_t dueMs) {
+    uint32_t startMs = millis();
+
+    /* Periodic tasklets keep a fixed rate; one that fell a whole period behind restarts from
+       now instead of running several times in a row. The body may still move it with runIn(). */
+    if (tasklet.periodMs == 0U) {
+        tasklet.armed = false;
+    } else if ((int32_t)(startMs - tasklet.dueMs) >= 0) {
+        tasklet.dueMs += tasklet.periodMs;
+        if ((int32_t)(startMs - tasklet.dueMs) >= 0) {
+            tasklet.dueMs = startMs + tasklet.periodMs;
+        }
+    }
+
+    uint32_t startUs = micros();
+    tasklet.function(tasklet.context);
+    uint32_t runUs = micros() - startUs;
+
+    int32_t lateMs = (int32_t)(startMs - dueMs);
+    uint32_t late = (lateMs > 0) ? (uint32_t)lateMs : 0U;
+    TaskletStats& stats = tasklet.stats;
+    stats.runs++;
+    stats.totalRunUs += runUs;
+    stats.totalLateMs += late;
+    if (runUs > stats.maxRunUs) {
+        stats.maxRunUs = runUs;
+    }
+    if (late > stats.maxLateMs) {
+        stats.maxLateMs = late;
+    }
+    if (late > tasklet.deadlineMs) {
+        stats.deadlineMisses++;
+    }
+    busyUs += runUs;
+}
+
+/* Blocks the loop task until timeoutMs has passed or a tasklet is triggered */
+void TaskletScheduler::sleep(uint32_t timeoutMs) {
+    sleeps++;
+    if (owner == NULL) {
+        delay(timeoutMs);
+        return;
+    }
+    /* Round up so a short wait never turns into zero ticks and a busy spin */
+    TickType_t ticks = (TickType_t)((timeoutMs + portTICK_PERIOD_MS - 1U) / portTICK_PERIOD_MS);
+    ulTaskNotifyTake(pdTRUE, ticks);
+}
@@ -0,0 +1,196 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Number of tasklets the scheduler holds (at most 32, one trigger bit each) */
+#define TASKLET_MAX_COUNT         12U
+
+/* Longest sleep when no tasklet is due; bounds the time spent blind to a missed wake-up (ms) */
+#define TASKLET_MAX_SLEEP_MS      1000U
+
+/* Id returned when a tasklet cannot be added */
+#define TASKLET_INVALID_ID        0xFFU
+
+static_assert(TASKLET_MAX_COUNT <= 32U, "one trigger bit per tasklet");
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Body of a tasklet; runs on the loop task and must return without blocking */
+typedef void (*TaskletFunction)(void* context);
+
+/* Index of a tasklet in the scheduler */
+typedef uint8_t TaskletId;
+
+/* Run time and lateness of one tasklet */
+typedef struct {
+    uint32_t runs;            /* Number of runs */
+    uint64_t totalRunUs;      /* Time spent in the body (32 bits wrap after 71 min) */
+    uint32_t maxRunUs;        /* Longest run */
+    uint32_t totalLateMs;     /* Sum of (start - due time) */
+    uint32_t maxLateMs;       /* Largest (start - due time) */
+    uint32_t deadlineMisses;  /* Runs started later than the deadline */
+} TaskletStats;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class TaskletScheduler
+* @brief Cooperative run-to-completion scheduler for the work of loop().
+* @details Every piece of loop() work is a tasklet: a non-blocking function that is due every
+* periodMs, when it is triggered (from an interrupt, another task or another tasklet), or at
+* the time it asked for with runIn(). runOnce() runs the due tasklets in registration order,
+* then blocks the loop task on its FreeRTOS notification until the earliest due time; a
+* trigger ends the sleep at once. Each tasklet records its run time and its lateness, i.e. how
+* long after its due time it started, against a deadline. The table is fixed, nothing is
+* allocated.
+*
+* @api
+*/
+/*================================================================================================*/
+class TaskletScheduler {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the TaskletScheduler class.
+    */
+    /*============================================================================================*/
+    TaskletScheduler();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Binds the scheduler to the calling task, the one that will call runOnce().
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void begin();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Adds a tasklet.
+    *
+    * @param[in]    name        Name shown in the statistics (string literal).
+    * @param[in]    function    Tasklet body.
+    * @param[in]    context     Passed to function.
+    * @param[in]    periodMs    Interval between runs, 0 for a tasklet that only runs when
+    *                           triggered or rescheduled with runIn(). The first run is due now.
+    * @param[in]    deadlineMs  Lateness above which a run counts as a deadline miss.
+    *
+    * @return       TaskletId   Id of the tasklet, or TASKLET_INVALID_ID if the table is full.
+    */
+    /*============================================================================================*/
+    TaskletId add(const char* name, TaskletFunction function, void* context, uint32_t periodMs,
+                  uint32_t deadlineMs);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Makes a tasklet due now and wakes the scheduler.
+    * @details      Safe from interrupts and from other tasks.
+    *
+    * @param[in]    id          Tasklet to run.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void IRAM_ATTR trigger(TaskletId id);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Makes a tasklet due in delayMs unless it is due earlier already.
+    * @details      Loop task only; typically called by a tasklet about itself.
+    *
+    * @param[in]    id          Tasklet to run.
+    * @param[in]    delayMs     Time from now.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void runIn(TaskletId id, uint32_t delayMs);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Runs the due tasklets, then sleeps until the next one is due or triggered.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void runOnce();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Runs every due tasklet once, in registration order.
+    *
+    * @return       uint32_t    Time until the next tasklet is due (ms), 0 if one is due now.
+    */
+    /*============================================================================================*/
+    uint32_t runDue();
+
+    /* Statistics of one tasklet, or NULL */
+    const TaskletStats* stats(TaskletId id) const {
+        return (id < count) ? &tasklets[id].stats : NULL;
+    }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Prints run time, lateness and deadline misses per tasklet, and the busy share.
+    *
+    * @param[in]    out         Destination (typically Serial).
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void printStats(Print& out) const;
+
+    /* Clears the statistics of every tasklet */
+    void resetStats();
+
+private:
+    /* One table entry */
+    typedef struct {
+        const char*     name;
+        TaskletFunction function;
+        void*           context;
+        uint32_t        periodMs;
+        uint32_t        deadlineMs;
+        uint32_t        dueMs;          /* Next due time, valid while armed */
+        bool            armed;          /* True if a due time is set */
+        TaskletStats    stats;
+    } Tasklet;
+
+    void run(Tasklet& tasklet, uint32_t dueMs);
+    void sleep(uint32_t timeoutMs);
+
+    Tasklet tasklets[TASKLET_MAX_COUNT];
+    uint8_t count;
+    TaskHandle_t owner;
+
+    /* One bit per triggered tasklet, and the time of each trigger; set from any context */
+    std::atomic<uint32_t> triggered;
+    volatile uint32_t triggerMs[TASKLET_MAX_COUNT];
+
+    /* Loop task time: in tasklets (64 bits, 32 wrap after 71 min), sleeping, and since the
+       statistics were cleared */
+    uint64_t busyUs;
+    uint32_t sleeps;
+    uint32_t statsStartMs;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+extern TaskletScheduler loopScheduler;     /* Runs the work of loop() */
+
+#endif /* TASK_SCHEDULER_H */
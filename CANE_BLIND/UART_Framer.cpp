@@ -0,0 +1,145 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "UART_Framer.h"
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor for the LineFramer class.
+* @details      Starts with an empty ring buffer and no partial line.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+LineFramer::LineFramer()
+    : lineLength(0U), lineOverflow(false), receivedCount(0U), lineCount(0U), truncatedCount(0U) {
+    lineBuffer[0] = '\0';
+}
+
+/*================================================================================================*/
+/**
+* @brief        Moves all currently available bytes from the port into the ring buffer.
+* @details      Reads in small stack chunks so the UART driver can copy in bulk instead of one
+*               byte per call. Only bytes reported by available() are requested, so the read
+*               never waits for the stream timeout.
+*
+* @param[in]    port        Serial stream connected to the modem.
+*
+* @return       uint16_t    Number of bytes moved.
+*/
+/*================================================================================================*/
+uint16_t LineFramer::pump(Stream& port) {
+    uint8_t chunk[UART_PUMP_CHUNK_SIZE];
+    uint16_t moved = 0U;
+
+    int available = port.available();
+    while (available > 0 && ring.freeSpace() > 0U) {
+        uint16_t wanted = (uint16_t)available;
+        if (wanted > UART_PUMP_CHUNK_SIZE) {
+            wanted = UART_PUMP_CHUNK_SIZE;
+        }
+        if (wanted > ring.freeSpace()) {
+            wanted = ring.freeSpace();
+        }
+
+        uint16_t received = (uint16_t)port.readBytes(chunk, wanted);
+        if (received == 0U) {
+            break;
+        }
+        moved = (uint16_t)(moved + feed(chunk, received));
+        available = port.available();
+    }
+    return moved;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Appends raw bytes to the ring buffer (for producers other than pump()).
+*
+* @param[in]    data        Bytes to append.
+* @param[in]    count       Number of bytes.
+*
+* @return       uint16_t    Number of bytes accepted.
+*/
+/*================================================================================================*/
+uint16_t LineFramer::feed(const uint8_t* data, uint16_t count) {
+    uint16_t accepted = ring.write(data, count);
+    receivedCount += accepted;
+    return accepted;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Extracts the next complete line from the buffered bytes.
+* @details      A line is complete when CR or LF is seen. A '>' at the start of a line is the
+*               SMS/data prompt, which the modem sends as "> " without a terminator, so it is
+*               reported immediately. Lines longer than UART_LINE_MAX_LEN are truncated.
+*
+* @param[out]   line        View of the line; valid until the next call.
+*
+* @return       bool        True if a line was produced, false if more bytes are needed.
+*/
+/*================================================================================================*/
+bool LineFramer::nextLine(LineView& line) {
+    uint8_t receivedByte;
+
+    while (ring.pop(receivedByte)) {
+        char receivedChar = (char)receivedByte;
+
+        if (receivedChar == '\r' || receivedChar == '\n') {
+            if (lineLength == 0U) {
+                /* Empty line or second half of CR/LF */
+                continue;
+            }
+            if (lineOverflow) {
+                truncatedCount++;
+            }
+            lineBuffer[lineLength] = '\0';
+            line.data = lineBuffer;
+            line.length = lineLength;
+            line.isPrompt = false;
+            lineLength = 0U;
+            lineOverflow = false;
+            lineCount++;
+            return true;
+        }
+
+        if (lineLength == 0U) {
+            if (receivedChar == '>') {
+                lineBuffer[0] = '>';
+                lineBuffer[1] = '\0';
+                line.data = lineBuffer;
+                line.length = 1U;
+                line.isPrompt = true;
+                lineCount++;
+                return true;
+            }
+            if (receivedChar == ' ') {
+                /* Leading blanks, including the space after the prompt */
+                continue;
+            }
+        }
+
+        if (lineLength < UART_LINE_MAX_LEN) {
+            lineBuffer[lineLength++] = receivedChar;
+        } else {
+            lineOverflow = true;
+        }
+    }
+
+    return false;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Discards buffered bytes and any partially assembled line.
+*/
+/*================================================================================================*/
+void LineFramer::reset() {
+    ring.clear();
+    lineLength = 0U;
+    lineOverflow = false;
+}
@@ -0,0 +1,196 @@
+#ifndef UART_FRAMER_H
+#define UART_FRAMER_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Capacity of the modem receive ring buffer in bytes (must be a power of two) */
+#define UART_RX_RING_SIZE         1024U
+
+/* Maximum length of a single framed line; longer lines are truncated */
+#define UART_LINE_MAX_LEN         192U
+
+/* Size of the stack chunk used to move bytes from the UART into the ring */
+#define UART_PUMP_CHUNK_SIZE      64U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* View of one complete line held by a LineFramer (valid until the next nextLine() call) */
+typedef struct {
+    const char* data;       /* NUL-terminated line text without CR/LF */
+    uint16_t    length;     /* Number of characters in data */
+    bool        isPrompt;   /* True for the unterminated "> " data prompt */
+} LineView;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class RingBuffer
+* @brief Fixed-capacity byte ring buffer with free-running indices.
+* @details Capacity must be a power of two no larger than 32768 so that the 16-bit head and tail
+* counters can wrap freely. Bytes that do not fit are counted and discarded; nothing is allocated.
+*
+* @api
+*/
+/*================================================================================================*/
+template <uint16_t CAPACITY>
+class RingBuffer {
+    static_assert(CAPACITY > 0U && (CAPACITY & (CAPACITY - 1U)) == 0U,
+                  "RingBuffer capacity must be a power of two");
+    static_assert(CAPACITY <= 32768U, "RingBuffer capacity must fit the 16-bit indices");
+
+public:
+    RingBuffer() : head(0U), tail(0U), dropped(0U) {}
+
+    /* Number of bytes waiting to be read */
+    uint16_t size() const { return (uint16_t)(head - tail); }
+
+    /* Number of bytes that can still be written */
+    uint16_t freeSpace() const { return (uint16_t)(CAPACITY - size()); }
+
+    /* Appends up to count bytes; the rest is counted as dropped */
+    uint16_t write(const uint8_t* data, uint16_t count) {
+        uint16_t room = freeSpace();
+        uint16_t accepted = (count < room) ? count : room;
+        for (uint16_t i = 0; i < accepted; i++) {
+            storage[(uint16_t)(head + i) & (CAPACITY - 1U)] = data[i];
+        }
+        head = (uint16_t)(head + accepted);
+        dropped += (uint32_t)(count - accepted);
+        return accepted;
+    }
+
+    /* Removes the oldest byte; returns false when empty */
+    bool pop(uint8_t& value) {
+        if (head == tail) {
+            return false;
+        }
+        value = storage[tail & (CAPACITY - 1U)];
+        tail++;
+        return true;
+    }
+
+    /* Discards all buffered bytes */
+    void clear() { tail = head; }
+
+    /* Total number of bytes rejected because the buffer was full */
+    uint32_t droppedBytes() const { return dropped; }
+
+private:
+    uint8_t  storage[CAPACITY];
+    uint16_t head;
+    uint16_t tail;
+    uint32_t dropped;
+};
+
+/*================================================================================================*/
+/**
+* @class LineSource
+* @brief Producer of already framed modem lines (e.g. a receive task) that AtEngine can consume
+* instead of reading the port itself.
+*
+* @api
+*/
+/*================================================================================================*/
+class LineSource {
+public:
+    /* Takes the next framed line; the view stays valid until the next call */
+    virtual bool nextLine(LineView& line) = 0;
+
+    /* Sleeps until a line is available or timeoutMs expires; true if a line is available */
+    virtual bool waitForLine(uint32_t timeoutMs) = 0;
+
+    /* Discards buffered lines and any partially received input */
+    virtual void reset() = 0;
+
+    /* Total number of bytes read from the port */
+    virtual uint32_t bytesReceived() const = 0;
+
+protected:
+    ~LineSource() {}
+};
+
+/*================================================================================================*/
+/**
+* @class LineFramer
+* @brief Splits the modem byte stream into CR/LF terminated lines without heap use.
+* @details Bytes are moved from the UART into a RingBuffer by pump() and framed by nextLine(),
+* which hands out a LineView into an internal fixed line buffer. Empty lines and leading blanks
+* are skipped, and the "> " data prompt (which has no terminator) is reported as its own line.
+*
+* @api
+*/
+/*================================================================================================*/
+class LineFramer {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor for the LineFramer class.
+    */
+    /*============================================================================================*/
+    LineFramer();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Moves all currently available bytes from the port into the ring buffer.
+    * @details      Stops early when the ring is full; the remaining bytes stay in the UART driver.
+    *
+    * @param[in]    port        Serial stream connected to the modem.
+    *
+    * @return       uint16_t    Number of bytes moved.
+    */
+    /*============================================================================================*/
+    uint16_t pump(Stream& port);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Appends raw bytes to the ring buffer (for producers other than pump()).
+    *
+    * @return       uint16_t    Number of bytes accepted.
+    */
+    /*============================================================================================*/
+    uint16_t feed(const uint8_t* data, uint16_t count);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Extracts the next complete line from the buffered bytes.
+    *
+    * @param[out]   line        View of the line; valid until the next call.
+    *
+    * @return       bool        True if a line was produced, false if more bytes are needed.
+    */
+    /*============================================================================================*/
+    bool nextLine(LineView& line);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Discards buffered bytes and any partially assembled line.
+    */
+    /*============================================================================================*/
+    void reset();
+
+    /* Statistics */
+    uint32_t bytesReceived() const { return receivedCount; }
+    uint32_t linesFramed() const { return lineCount; }
+    uint32_t truncatedLines() const { return truncatedCount; }
+    uint32_t droppedBytes() const { return ring.droppedBytes(); }
+
+private:
+    RingBuffer<UART_RX_RING_SIZE> ring;
+    char     lineBuffer[UART_LINE_MAX_LEN + 1U];
+    uint16_t lineLength;
+    bool     lineOverflow;
+    uint32_t receivedCount;
+    uint32_t lineCount;
+    uint32_t truncatedCount;
+};
+
+#endif /* UART_FRAMER_H */
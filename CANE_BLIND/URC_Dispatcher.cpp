@@ -0,0 +1,297 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "URC_Dispatcher.h"
+
+/******************************************************************************
+ * PRIVATE TYPES AND CONSTANTS
+ ******************************************************************************/
+/* Longest tag considered when hashing a line */
+#define URC_TAG_MAX_LEN           16U
+
+/* Static description of one known URC */
+typedef struct {
+    const char* tag;        /* "+CLIP" for "+CLIP: ..." lines, or the whole line ("RING") */
+    UrcType     type;
+    bool        hasBody;    /* True if the next line is part of the URC */
+} UrcDescriptor;
+
+/* Known URCs; the bucket table is built from this list */
+static const UrcDescriptor URC_DESCRIPTORS[] = {
+    { "RING",       URC_RING,       false },
+    { "+CLIP",      URC_CLIP,       false },
+    { "+CMT",       URC_CMT,        true  },
+    { "+CMTI",      URC_CMTI,       false },
+    { "+CSQ",       URC_CSQ,        false },
+    { "+CLCC",      URC_CLCC,       false },
+    { "NO CARRIER", URC_NO_CARRIER, false },
+    { "BUSY",       URC_BUSY,       false },
+    { "NO ANSWER",  URC_NO_ANSWER,  false },
+    { "+CPIN",      URC_CPIN,       false },
+    { "+CGPSINFO",  URC_CGPSINFO,   false },
+    { "+CGNSINF",   URC_CGNSINF,    false },
+};
+
+static const uint8_t URC_DESCRIPTOR_COUNT = sizeof(URC_DESCRIPTORS) / sizeof(URC_DESCRIPTORS[0]);
+
+static_assert(sizeof(URC_DESCRIPTORS) / sizeof(URC_DESCRIPTORS[0]) == URC_COUNT,
+              "Every UrcType needs exactly one descriptor");
+static_assert(URC_COUNT < URC_BUCKET_COUNT, "URC bucket table is too small");
+static_assert((URC_BUCKET_COUNT & (URC_BUCKET_COUNT - 1)) == 0, "URC_BUCKET_COUNT must be a power of two");
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Length of the tag of a line: up to ':' for "+XXX:" lines, the whole line otherwise */
+static size_t tagLength(const char* line, size_t length) {
+    if (length > 0U && line[0] == '+') {
+        for (size_t i = 1; i < length && i <= URC_TAG_MAX_LEN; i++) {
+            if (line[i] == ':') {
+                return i;
+            }
+        }
+        return 0U;
+    }
+    return (length <= URC_TAG_MAX_LEN) ? length : 0U;
+}
+
+/* FNV-1a hash of a tag */
+static uint32_t tagHash(const char* tag, size_t length) {
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)tag[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Constructor; builds the bucket table from the URC descriptor list.
+* @details      Each descriptor is placed in the bucket selected by its tag hash, using linear
+*               probing on collision. No handlers are registered initially.
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+UrcDispatcher::UrcDispatcher()
+    : pendingType(URC_COUNT), pendingLength(0U), dispatched(0U), ignored(0U) {
+    memset(buckets, 0, sizeof(buckets));
+    memset(handlers, 0, sizeof(handlers));
+    memset(contexts, 0, sizeof(contexts));
+    pendingHeader[0] = '\0';
+
+    for (uint8_t i = 0; i < URC_DESCRIPTOR_COUNT; i++) {
+        const char* tag = URC_DESCRIPTORS[i].tag;
+        uint32_t bucket = tagHash(tag, strlen(tag)) & (URC_BUCKET_COUNT - 1U);
+        while (buckets[bucket] != 0U) {
+            bucket = (bucket + 1U) & (URC_BUCKET_COUNT - 1U);
+        }
+        buckets[bucket] = (uint8_t)(i + 1U);
+    }
+}
+
+/*================================================================================================*/
+/**
+* @brief        Registers (or replaces) the handler for one URC type.
+*
+* @param[in]    type        URC type to handle.
+* @param[in]    handler     Callback, or NULL to remove the handler.
+* @param[in]    context     Opaque pointer passed back to the callback.
+*
+* @return       bool        False if type is out of range.
+*/
+/*================================================================================================*/
+bool UrcDispatcher::registerHandler(UrcType type, UrcHandler handler, void* context) {
+    if (type >= URC_COUNT) {
+        return false;
+    }
+    handlers[type] = handler;
+    contexts[type] = context;
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Matches one received line and invokes the registered handler.
+* @details      If a two-line URC is pending, the line is taken as its body. Otherwise the
+*               line's tag is hashed and looked up in the bucket table; a hit is confirmed with
+*               a single comparison before the fields are decoded and the handler is called.
+*
+* @param[in]    line        Received line without CR/LF.
+* @param[in]    length      Number of characters in line.
+*
+* @return       bool        True if the line was a recognised URC (or a pending URC body).
+*/
+/*================================================================================================*/
+bool UrcDispatcher::dispatch(const char* line, size_t length) {
+    UrcEvent event;
+
+    /* Body line of a pending two-line URC */
+    if (pendingType != URC_COUNT) {
+        event.type = pendingType;
+        event.line = pendingHeader;
+        event.length = pendingLength;
+        event.fieldCount = decodeFields(pendingHeader, pendingLength, event.fields, URC_MAX_FIELDS);
+        event.body = line;
+        event.bodyLength = (uint16_t)length;
+        pendingType = URC_COUNT;
+        invoke(event);
+        return true;
+    }
+
+    size_t tagLen = tagLength(line, length);
+    if (tagLen == 0U) {
+        ignored++;
+        return false;
+    }
+
+    /* Probe the bucket table */
+    uint32_t bucket = tagHash(line, tagLen) & (URC_BUCKET_COUNT - 1U);
+    const UrcDescriptor* descriptor = NULL;
+    for (uint8_t probe = 0; probe < URC_BUCKET_COUNT && buckets[bucket] != 0U; probe++) {
+        const UrcDescriptor& candidate = URC_DESCRIPTORS[buckets[bucket] - 1U];
+        if (strlen(candidate.tag) == tagLen && memcmp(candidate.tag, line, tagLen) == 0) {
+            descriptor = &candidate;
+            break;
+        }
+        bucket = (bucket + 1U) & (URC_BUCKET_COUNT - 1U);
+    }
+    if (descriptor == NULL) {
+        ignored++;
+        return false;
+    }
+
+    /* Two-line URC: keep the header until the body arrives */
+    if (descriptor->hasBody) {
+        size_t keep = (length < URC_HEADER_MAX_LEN) ? length : URC_HEADER_MAX_LEN;
+        memcpy(pendingHeader, line, keep);
+        pendingHeader[keep] = '\0';
+        pendingLength = (uint16_t)keep;
+        pendingType = descriptor->type;
+        return true;
+    }
+
+    event.type = descriptor->type;
+    event.line = line;
+    event.length = (uint16_t)length;
+    event.fieldCount = decodeFields(line, length, event.fields, URC_MAX_FIELDS);
+    event.body = NULL;
+    event.bodyLength = 0U;
+    invoke(event);
+    return true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Splits the part after ':' into fields, stripping blanks and quotes.
+* @details      Commas inside double quotes do not split fields. Lines without ':' have no fields.
+*
+* @param[in]    line        Line to decode.
+* @param[in]    length      Number of characters in line.
+* @param[out]   fields      Field array to fill.
+* @param[in]    maxFields   Capacity of fields.
+*
+* @return       uint8_t     Number of fields decoded.
+*/
+/*================================================================================================*/
+uint8_t UrcDispatcher::decodeFields(const char* line, size_t length, UrcField* fields, uint8_t maxFields) {
+    const char* colon = (const char*)memchr(line, ':', length);
+    if (colon == NULL || maxFields == 0U) {
+        return 0U;
+    }
+
+    const char* cursor = colon + 1;
+    const char* end = line + length;
+    uint8_t count = 0U;
+
+    while (count < maxFields) {
+        /* Skip blanks before the field */
+        while (cursor < end && *cursor == ' ') {
+            cursor++;
+        }
+
+        /* Find the end of the field, honouring quotes */
+        const char* fieldStart = cursor;
+        bool quoted = false;
+        while (cursor < end && (quoted || *cursor != ',')) {
+            if (*cursor == '"') {
+                quoted = !quoted;
+            }
+            cursor++;
+        }
+        const char* fieldEnd = cursor;
+
+        /* Strip surrounding quotes */
+        if ((fieldEnd - fieldStart) >= 2 && fieldStart[0] == '"' && fieldEnd[-1] == '"') {
+            fieldStart++;
+            fieldEnd--;
+        }
+
+        size_t fieldLength = (size_t)(fieldEnd - fieldStart);
+        fields[count].data = fieldStart;
+        fields[count].length = (uint8_t)((fieldLength > 255U) ? 255U : fieldLength);
+        count++;
+
+        if (cursor >= end) {
+            break;
+        }
+        cursor++; /* Skip ',' */
+    }
+    return count;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Converts a decimal field to an integer, or returns fallback if it is empty.
+*/
+/*================================================================================================*/
+int32_t UrcDispatcher::fieldToInt(const UrcField& field, int32_t fallback) {
+    int32_t value = 0;
+    bool negative = false;
+    uint8_t i = 0U;
+
+    if (field.length > 0U && field.data[0] == '-') {
+        negative = true;
+        i = 1U;
+    }
+    if (i >= field.length) {
+        return fallback;
+    }
+    for (; i < field.length; i++) {
+        char digit = field.data[i];
+        if (digit < '0' || digit > '9') {
+            return fallback;
+        }
+        value = value * 10 + (digit - '0');
+    }
+    return negative ? -value : value;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Copies a field into a NUL-terminated buffer (truncating if needed).
+*/
+/*================================================================================================*/
+void UrcDispatcher::fieldToString(const UrcField& field, char* buffer, size_t bufferSize) {
+    if (bufferSize == 0U) {
+        return;
+    }
+    size_t copyLength = (field.length < bufferSize - 1U) ? field.length : bufferSize - 1U;
+    memcpy(buffer, field.data, copyLength);
+    buffer[copyLength] = '\0';
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Calls the handler registered for the event's type */
+void UrcDispatcher::invoke(UrcEvent& event) {
+    dispatched++;
+    if (handlers[event.type] != NULL) {
+        handlers[event.type](event, contexts[event.type]);
+    }
+}
@@ -0,0 +1,162 @@
+#ifndef URC_DISPATCHER_H
+#define URC_DISPATCHER_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Maximum number of comma separated fields decoded from one URC */
+#define URC_MAX_FIELDS            8
+
+/* Number of hash buckets used for prefix matching (must be a power of two) */
+#define URC_BUCKET_COUNT          32
+
+/* Maximum length of a URC header kept while waiting for its body line (+CMT) */
+#define URC_HEADER_MAX_LEN        96
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Unsolicited result codes recognised by the dispatcher */
+typedef enum {
+    URC_RING = 0,       /* "RING" - incoming call alert */
+    URC_CLIP,           /* "+CLIP: <number>,<type>,..." - caller identification */
+    URC_CMT,            /* "+CMT: <oa>,<alpha>,<scts>" followed by the message text */
+    URC_CMTI,           /* "+CMTI: <mem>,<index>" - SMS stored in memory */
+    URC_CSQ,            /* "+CSQ: <rssi>,<ber>" - signal quality report (AT+AUTOCSQ) */
+    URC_CLCC,           /* "+CLCC: <id>,<dir>,<stat>,..." - call status (AT+CLCC=1) */
+    URC_NO_CARRIER,     /* "NO CARRIER" - call ended or failed */
+    URC_BUSY,           /* "BUSY" - called party busy */
+    URC_NO_ANSWER,      /* "NO ANSWER" - called party did not answer */
+    URC_CPIN,           /* "+CPIN: <code>" - SIM state */
+    URC_CGPSINFO,       /* "+CGPSINFO: <lat>,<N/S>,<lon>,..." - periodic GNSS report (AT+CGPSINFO=<n>) */
+    URC_CGNSINF,        /* "+CGNSINF: <run>,<fix>,<utc>,..." - periodic GNSS report (AT+CGNSURC=<n>) */
+    URC_COUNT
+} UrcType;
+
+/* One field of a URC, pointing into the received line (not NUL-terminated) */
+typedef struct {
+    const char* data;
+    uint8_t     length;
+} UrcField;
+
+/* A decoded URC handed to handlers; all pointers are valid only during the callback */
+typedef struct {
+    UrcType     type;
+    const char* line;                       /* Complete header line */
+    uint16_t    length;
+    uint8_t     fieldCount;
+    UrcField    fields[URC_MAX_FIELDS];     /* Fields after ':' with quotes removed */
+    const char* body;                       /* Second line for two-line URCs (+CMT), else NULL */
+    uint16_t    bodyLength;
+} UrcEvent;
+
+/* Handler invoked for a recognised URC */
+typedef void (*UrcHandler)(const UrcEvent& event, void* context);
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class UrcDispatcher
+* @brief Table-driven dispatcher for unsolicited result codes from the GSM/GNSS module.
+* @details The tag of each line ("+CLIP", "RING", ...) is hashed once and looked up in a fixed
+* bucket table built from a constant descriptor list, so matching costs the same whatever the
+* number of known URCs. Fields are decoded in place and handed to the handler registered for the
+* URC type. Two-line URCs (+CMT) are held until their body line arrives.
+*
+* @api
+*/
+/*================================================================================================*/
+class UrcDispatcher {
+public:
+    /*============================================================================================*/
+    /**
+    * @brief        Constructor; builds the bucket table from the URC descriptor list.
+    */
+    /*============================================================================================*/
+    UrcDispatcher();
+
+    /*============================================================================================*/
+    /**
+    * @brief        Registers (or replaces) the handler for one URC type.
+    *
+    * @param[in]    type        URC type to handle.
+    * @param[in]    handler     Callback, or NULL to remove the handler.
+    * @param[in]    context     Opaque pointer passed back to the callback.
+    *
+    * @return       bool        False if type is out of range.
+    */
+    /*============================================================================================*/
+    bool registerHandler(UrcType type, UrcHandler handler, void* context);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Matches one received line and invokes the registered handler.
+    *
+    * @param[in]    line        Received line without CR/LF.
+    * @param[in]    length      Number of characters in line.
+    *
+    * @return       bool        True if the line was a recognised URC (or a pending URC body).
+    */
+    /*============================================================================================*/
+    bool dispatch(const char* line, size_t length);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Returns true while a two-line URC is waiting for its body line.
+    */
+    /*============================================================================================*/
+    bool expectsBody() const { return pendingType != URC_COUNT; }
+
+    /*============================================================================================*/
+    /**
+    * @brief        Splits the part after ':' into fields, stripping blanks and quotes.
+    * @details      Usable for solicited responses with the same syntax (e.g. "+CSQ: 20,99").
+    *
+    * @return       uint8_t     Number of fields decoded.
+    */
+    /*============================================================================================*/
+    static uint8_t decodeFields(const char* line, size_t length, UrcField* fields, uint8_t maxFields);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Converts a decimal field to an integer, or returns fallback if it is empty.
+    */
+    /*============================================================================================*/
+    static int32_t fieldToInt(const UrcField& field, int32_t fallback);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Copies a field into a NUL-terminated buffer (truncating if needed).
+    */
+    /*============================================================================================*/
+    static void fieldToString(const UrcField& field, char* buffer, size_t bufferSize);
+
+    /* Number of lines recognised and of lines ignored */
+    uint32_t dispatchedCount() const { return dispatched; }
+    uint32_t ignoredCount() const { return ignored; }
+
+private:
+    void invoke(UrcEvent& event);
+
+    /* Bucket table: index into the descriptor list + 1, 0 = empty */
+    uint8_t buckets[URC_BUCKET_COUNT];
+    /* Registered handlers per URC type */
+    UrcHandler handlers[URC_COUNT];
+    void* contexts[URC_COUNT];
+    /* Header of a two-line URC waiting for its body */
+    UrcType pendingType;
+    char pendingHeader[URC_HEADER_MAX_LEN + 1];
+    uint16_t pendingLength;
+    /* Statistics */
+    uint32_t dispatched;
+    uint32_t ignored;
+};
+
+#endif /* URC_DISPATCHER_H */
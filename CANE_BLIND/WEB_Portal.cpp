@@ -10,6 +10,9 @@
 IPAddress apIP(192,168,4,1);
 IPAddress nm(255,255,255,0);
 
+/* Response buffer for '/stats' (static so the handler never allocates) */
+static char statsJson[AT_STATS_JSON_MAX_LEN];
+
 /******************************************************************************
  * API
  ******************************************************************************/
@@ -28,7 +31,7 @@ IPAddress nm(255,255,255,0);
 * @api
 */
 /*================================================================================================*/
-WebPortal::WebPortal(WifiManagerCustom* wm) : server(80) {
+WebPortal::WebPortal(WifiManagerCustom* wm) : server(80), captive(false) {
     wifi = wm;
 }
 
@@ -37,7 +40,8 @@ WebPortal::WebPortal(WifiManagerCustom* wm) : server(80) {
 * @brief        Sets up the device as a Wi-Fi Access Point and starts the Web Configuration Server.
 * @details      This function enters the Captive Portal mode by setting the device to WIFI_AP, 
 *               configuring its IP, starting the SoftAP, and launching the DNS server to redirect 
-*               all traffic. It then defines the necessary routes ('/', '/save', '/style.css') 
+*               all traffic. It then defines the necessary routes ('/', '/save', '/style.css',
+*               '/stats')
 *               before commencing the HTTP server.
 *
 * @param[in]    None
@@ -71,16 +75,43 @@ void WebPortal::startPortal() {
     /* Handle HTTP GET requests for external style sheets. */
     server.on("/style.css", HTTP_GET, std::bind(&WebPortal::handleCSS, this)); 
 
+    /* Handle HTTP GET requests for the AT command latency statistics (JSON). */
+    server.on("/stats", HTTP_GET, std::bind(&WebPortal::handleStats, this));
+
     /* Start the web server, making it listen for client connections on port 80. */
     server.begin();                                             
+    captive = true;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Serves the modem statistics on the network the device joined.
+* @details      Used instead of startPortal() once the station is connected: only '/stats' is
+*               routed, so the credentials can still be changed from the access point alone.
+*               No DNS server is started.
+*
+* @param[in]    None
+* @param[out]   None
+*
+* @return       void
+*
+* @api
+*/
+/*================================================================================================*/
+void WebPortal::startStatsServer() {
+    /* Handle HTTP GET requests for the AT command latency statistics (JSON). */
+    server.on("/stats", HTTP_GET, std::bind(&WebPortal::handleStats, this));
+
+    /* Start the web server on port 80 of the station interface. */
+    server.begin();
 }
 
 /*================================================================================================*/
 /**
 * @brief        Handles all incoming client requests for the Captive Portal.
 * @details      This function must be called repeatedly inside the main application loop (e.g., Arduino loop()).
-*               It processes DNS requests first to maintain the Captive Portal behavior, and then 
-*               processes any pending HTTP requests for the web server.
+*               It processes DNS requests first to maintain the Captive Portal behavior (AP mode
+*               only), and then processes any pending HTTP requests for the web server.
 *
 * @param[in]    None
 * @param[out]   None
@@ -93,7 +124,9 @@ void WebPortal::startPortal() {
 void WebPortal::handleClient() {
     /* Processes the next incoming DNS query. This is crucial for the Captive Portal 
        to redirect web requests to the configuration page. */
-    dns.processNextRequest();
+    if (captive) {
+        dns.processNextRequest();
+    }
 
     /* Handles any pending incoming HTTP requests on the web server (e.g., loading the page or submitting the form). */
     server.handleClient();
@@ -472,4 +505,27 @@ void WebPortal::handleSave() {
     
     /* Initiate a hardware reset/reboot. The device will restart and attempt to connect to the new Wi-Fi network. */
     ESP.restart();
-}
\ No newline at end of file
+}
+
+/*================================================================================================*/
+/**
+* @brief        Handles HTTP GET requests for the modem statistics ('/stats').
+* @details      Serves the per-class AT command latency histograms as JSON. The document is
+*               written into a static buffer and sent with send_P(), so no String is built.
+*
+* @param[in]    None
+* @param[out]   None
+*
+* @return       void
+*
+* @api
+*/
+/*================================================================================================*/
+void WebPortal::handleStats() {
+    size_t length = gsmAtEngine.latencyStats().formatJson(statsJson, sizeof(statsJson));
+    if (length == 0U) {
+        server.send(500, "text/plain", "statistics buffer too small");
+        return;
+    }
+    server.send_P(200, "application/json", statsJson, length);
+}
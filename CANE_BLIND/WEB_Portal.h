@@ -50,6 +50,17 @@ public:
     /*============================================================================================*/
     void startPortal();
 
+    /*============================================================================================*/
+    /**
+    * @brief        Serves '/stats' on the joined Wi-Fi network (station mode).
+    * @details      Call instead of startPortal() once connected; the configuration routes stay
+    *               reachable from the access point only.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void startStatsServer();
+
     /*============================================================================================*/
     /**
     * @brief        Handles all incoming client requests (DNS and HTTP).
@@ -68,6 +79,8 @@ private:
     WebServer server;
     /* The DNS server instance used for the Captive Portal mechanism (runs on port 53). */
     DNSServer dns;
+    /* The access point and the DNS server were started (startPortal()). */
+    bool captive;
 
     /*============================================================================================*/
     /**
@@ -98,6 +111,16 @@ private:
     */
     /*============================================================================================*/
     void handleCSS(); 
+
+    /*============================================================================================*/
+    /**
+    * @brief        Handler for HTTP GET requests to '/stats'.
+    * @details      Sends the AT command latency histograms as JSON.
+    *
+    * @return       void
+    */
+    /*============================================================================================*/
+    void handleStats();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include <new>
+#include <stdlib.h>
+#include <time.h>
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Heap allocations through operator new (std::string, String, containers) */
+static uint64_t allocationCount = 0U;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+uint64_t benchCpuNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+uint64_t benchAllocations() {
+    return allocationCount;
+}
+
+void benchPrint(const char* label, double value, const char* unit) {
+    printf("[BENCH] %-44s %14.1f %s\n", label, value, unit);
+}
+
+/******************************************************************************
+ * ALLOCATION COUNTING
+ ******************************************************************************/
+void* operator new(size_t size) {
+    allocationCount++;
+    void* block = malloc((size > 0U) ? size : 1U);
+    if (block == NULL) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    free(block);
+}
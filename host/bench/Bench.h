@@ -0,0 +1,40 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Returns the CPU time used by the process (ns).
+* @details      Virtual time does not move while code runs, so host benchmarks of computation
+*               measure CPU time; protocol latencies are read from millis() instead.
+*
+* @return       uint64_t    Process CPU time (ns).
+*
+* @api
+*/
+/*================================================================================================*/
+uint64_t benchCpuNs();
+
+/*================================================================================================*/
+/**
+* @brief        Returns the number of heap allocations (operator new) made so far.
+*
+* @return       uint64_t    Allocations since the start of the program.
+*
+* @api
+*/
+/*================================================================================================*/
+uint64_t benchAllocations();
+
+/* Prints one figure of a benchmark, aligned with the others */
+void benchPrint(const char* label, double value, const char* unit);
+
+#endif /* BENCH_H */
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the benchmark runs on (UART 1 belongs to gsmSerialPort) */
+#define BENCH_UART                2
+
+/* The blocking sendGsmCommand() this engine replaced: a fixed wait after writing the
+   command, then reading until a fixed timeout expired */
+#define BLOCKING_COMMAND_WAIT_MS  800U
+#define BLOCKING_READ_TIMEOUT_MS  1000U
+
+/* Engine round trips timed for the CPU cost per command */
+#define BENCH_CPU_COMMANDS        2000U
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* The bring-up sequence of the original setup() */
+static const AtCommandDesc* const BENCH_COMMANDS[] = {
+    &AT_CMD_ATTENTION, &AT_CMD_ECHO_OFF, &AT_CMD_CHARSET_GSM, &AT_CMD_SMS_TEXT_MODE,
+    &AT_CMD_SMS_INDICATION, &AT_CMD_CLIP_ON, &AT_CMD_SIGNAL_QUALITY
+};
+static const size_t BENCH_COMMAND_COUNT = sizeof(BENCH_COMMANDS) / sizeof(BENCH_COMMANDS[0]);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* One command the old way; returns the time the caller was blocked (ms) */
+static uint32_t blockingCommand(HardwareSerial& port, const char* command) {
+    uint32_t startMs = millis();
+    port.print(command);
+    port.print("\r");
+    delay(BLOCKING_COMMAND_WAIT_MS);
+    uint32_t readStartMs = millis();
+    while ((uint32_t)(millis() - readStartMs) < BLOCKING_READ_TIMEOUT_MS) {
+        while (port.available() > 0) {
+            port.read();
+        }
+        delay(1);
+    }
+    return millis() - startMs;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Per-command latency of the AT engine against the blocking fixed-delay path.
+* @details      Both run the original bring-up commands against the fake modem with its default
+*               latencies; the figures are virtual milliseconds from the command being issued to
+*               the caller getting the result. The CPU time of one engine round trip is measured
+*               separately.
+*
+* @return       int         0 if every command completes sooner through the engine.
+*/
+/*================================================================================================*/
+int main() {
+    bool faster = true;
+    uint32_t blockingTotalMs = 0U;
+    uint32_t engineTotalMs = 0U;
+    {
+        HardwareSerial port(BENCH_UART);
+        port.begin(115200);
+        FakeModem modem(port);
+        for (size_t i = 0; i < BENCH_COMMAND_COUNT; i++) {
+            blockingTotalMs += blockingCommand(port, BENCH_COMMANDS[i]->prefix);
+        }
+    }
+
+    HardwareSerial port(BENCH_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    printf("[BENCH] AT command latency (ms): blocking path %u + %u per command\n",
+           BLOCKING_COMMAND_WAIT_MS, BLOCKING_READ_TIMEOUT_MS);
+    for (size_t i = 0; i < BENCH_COMMAND_COUNT; i++) {
+        AtHandle handle = engine.submit(*BENCH_COMMANDS[i]);
+        AtResult result = engine.waitFor(handle);
+        uint32_t latencyMs = engine.latencyMs(handle);
+        engine.release(handle);
+        engineTotalMs += latencyMs;
+        faster = faster && (result == AT_RESULT_OK) &&
+                 (latencyMs < BLOCKING_COMMAND_WAIT_MS + BLOCKING_READ_TIMEOUT_MS);
+        benchPrint(BENCH_COMMANDS[i]->prefix, (double)latencyMs, "ms");
+    }
+    benchPrint("bring-up total, blocking", (double)blockingTotalMs, "ms");
+    benchPrint("bring-up total, engine", (double)engineTotalMs, "ms");
+
+    uint64_t startNs = benchCpuNs();
+    for (uint32_t i = 0; i < BENCH_CPU_COMMANDS; i++) {
+        AtHandle handle = engine.submit(AT_CMD_ATTENTION);
+        engine.waitFor(handle);
+        engine.release(handle);
+    }
+    uint64_t cpuNs = benchCpuNs() - startNs;
+    benchPrint("CPU per command (engine, modem and UART model)",
+               (double)cpuNs / 1000.0 / BENCH_CPU_COMMANDS, "us");
+
+    return (faster && engineTotalMs < blockingTotalMs) ? 0 : 1;
+}
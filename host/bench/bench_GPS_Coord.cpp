@@ -0,0 +1,143 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "GPS_Coord.h"
+#include <math.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Calls timed per figure */
+#define BENCH_CALLS               200000U
+
+/* Text of the SOS message the link is appended to */
+#define BENCH_SOS_TEXT            "SOS! I need help. My location: "
+
+/* Mean Earth radius of the floating-point distance (m) */
+#define BENCH_EARTH_RADIUS_M      6371008.8
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Cost of one way of doing something, per call */
+typedef struct {
+    double ns;
+    double allocations;
+} CallCost;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Results are summed here so the compiler cannot drop the calls */
+static volatile uint32_t benchSink = 0U;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Position of call i: a walk around Hanoi, a different one every call */
+static GeoCoord positionOf(uint32_t i) {
+    GeoCoord position = { 21028511 + (int32_t)(i % 997U), 105804817 - (int32_t)(i % 991U) };
+    return position;
+}
+
+/* The map link as the former parseGpsToMapLink() built it */
+static String stringMapLink(double latitude, double longitude) {
+    String link = "https://www.google.com/maps?q=";
+    link += String(latitude, 6);
+    link += ",";
+    link += String(longitude, 6);
+    return link;
+}
+
+/* Great-circle distance in double precision (m) */
+static double haversineM(double lat1, double lon1, double lat2, double lon2) {
+    double toRadians = M_PI / 180.0;
+    double dLat = (lat2 - lat1) * toRadians;
+    double dLon = (lon2 - lon1) * toRadians;
+    double a = sin(dLat / 2.0) * sin(dLat / 2.0) +
+               cos(lat1 * toRadians) * cos(lat2 * toRadians) * sin(dLon / 2.0) * sin(dLon / 2.0);
+    return 2.0 * BENCH_EARTH_RADIUS_M * asin(sqrt(a));
+}
+
+/* Runs body(i) BENCH_CALLS times; returns its cost per call */
+template <typename Body>
+static CallCost timeCalls(Body body) {
+    uint64_t startAllocations = benchAllocations();
+    uint64_t startNs = benchCpuNs();
+    for (uint32_t i = 0; i < BENCH_CALLS; i++) {
+        body(i);
+    }
+    CallCost cost;
+    cost.ns = (double)(benchCpuNs() - startNs) / BENCH_CALLS;
+    cost.allocations = (double)(benchAllocations() - startAllocations) / BENCH_CALLS;
+    return cost;
+}
+
+/* Prints the two ways of one operation */
+static void printPair(const char* name, const char* oldName, const CallCost& oldCost,
+                      const char* newName, const CallCost& newCost) {
+    char label[64];
+    printf("[BENCH] %s\n", name);
+    snprintf(label, sizeof(label), "  %s", oldName);
+    benchPrint(label, oldCost.ns, "ns/call");
+    benchPrint("    heap allocations", oldCost.allocations, "allocs/call");
+    snprintf(label, sizeof(label), "  %s", newName);
+    benchPrint(label, newCost.ns, "ns/call");
+    benchPrint("    heap allocations", newCost.allocations, "allocs/call");
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Map link, SOS text and distance: the String/double path against GeoCoord.
+* @details      The host has a double-precision FPU; the ESP32 does double math in software,
+*               so the distance figures understate the gain on the device.
+*
+* @return       int         0 if both formatters beat the String path without heap use.
+*/
+/*================================================================================================*/
+int main() {
+    CallCost stringLink = timeCalls([](uint32_t i) {
+        GeoCoord position = positionOf(i);
+        String link = stringMapLink(position.latitudeE6 / 1e6, position.longitudeE6 / 1e6);
+        benchSink += link.length();
+    });
+    CallCost bufferLink = timeCalls([](uint32_t i) {
+        char link[GEO_MAP_LINK_MAX_LEN + 1U];
+        benchSink += geoFormatMapLink(positionOf(i), link, sizeof(link));
+    });
+
+    CallCost stringMessage = timeCalls([](uint32_t i) {
+        GeoCoord position = positionOf(i);
+        String message = BENCH_SOS_TEXT;
+        message += stringMapLink(position.latitudeE6 / 1e6, position.longitudeE6 / 1e6);
+        benchSink += message.length();
+    });
+    CallCost bufferMessage = timeCalls([](uint32_t i) {
+        char message[sizeof(BENCH_SOS_TEXT) + GEO_MAP_LINK_MAX_LEN];
+        benchSink += geoFormatMessage(BENCH_SOS_TEXT, positionOf(i), message, sizeof(message));
+    });
+
+    GeoCoord origin = positionOf(0U);
+    CallCost doubleDistance = timeCalls([origin](uint32_t i) {
+        GeoCoord position = positionOf(i);
+        benchSink += (uint32_t)haversineM(origin.latitudeE6 / 1e6, origin.longitudeE6 / 1e6,
+                                          position.latitudeE6 / 1e6, position.longitudeE6 / 1e6);
+    });
+    CallCost integerDistance = timeCalls([origin](uint32_t i) {
+        benchSink += geoDistanceM(origin, positionOf(i));
+    });
+
+    printPair("map link", "String(lat, 6) concatenation", stringLink, "geoFormatMapLink()",
+              bufferLink);
+    printPair("SOS text with map link", "String concatenation", stringMessage,
+              "geoFormatMessage()", bufferMessage);
+    printPair("distance", "double haversine", doubleDistance, "geoDistanceM()", integerDistance);
+
+    bool linkFaster = bufferLink.ns < stringLink.ns && bufferLink.allocations == 0.0;
+    bool messageFaster = bufferMessage.ns < stringMessage.ns && bufferMessage.allocations == 0.0;
+    return (linkFaster && messageFaster) ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "GPS_Nmea.h"
+#include <string>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Length of the log: one epoch per second of a walk */
+#define BENCH_EPOCHS              3600U
+
+/* Times the log is parsed per figure */
+#define BENCH_PASSES              20U
+
+/* UART rate the receiver output arrives at (bits per byte with start and stop bits) */
+#define BENCH_UART_BAUD           115200U
+#define BENCH_UART_BITS_PER_BYTE  10U
+
+/* Start of the walk (millionths of a degree) and its step per epoch, about 1.3 m/s */
+#define BENCH_START_LAT_E6        21028511
+#define BENCH_START_LON_E6        105804817
+#define BENCH_STEP_LAT_E6         9
+#define BENCH_STEP_LON_E6         7
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Appends "$<body>*hh\r\n" to the log */
+static void appendSentence(std::string& log, const char* body) {
+    uint8_t checksum = 0U;
+    for (const char* c = body; *c != '\0'; c++) {
+        checksum ^= (uint8_t)*c;
+    }
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+    log += "$";
+    log += body;
+    log += tail;
+}
+
+/* Writes a coordinate as NMEA degrees and minutes ("ddmm.mmmmmm" / "dddmm.mmmmmm") */
+static void formatDegreesMinutes(char* out, size_t size, int32_t valueE6, uint8_t degreeDigits) {
+    uint32_t magnitude = (uint32_t)(valueE6 < 0 ? -valueE6 : valueE6);
+    uint32_t minutesE6 = (magnitude % 1000000U) * 60U;
+    snprintf(out, size, "%0*u%02u.%06u", degreeDigits, (unsigned)(magnitude / 1000000U),
+             (unsigned)(minutesE6 / 1000000U), (unsigned)(minutesE6 % 1000000U));
+}
+
+/* An hour of receiver output as a SIM7600 streams it: GGA, RMC, GSA and three GSV per second */
+static std::string recordLog(uint32_t* sentences) {
+    std::string log;
+    char body[GNSS_SENTENCE_MAX_LEN];
+    char latitude[16];
+    char longitude[16];
+    for (uint32_t epoch = 0; epoch < BENCH_EPOCHS; epoch++) {
+        uint32_t second = 36000U + epoch;
+        unsigned hh = (unsigned)(second / 3600U);
+        unsigned mm = (unsigned)(second / 60U % 60U);
+        unsigned ss = (unsigned)(second % 60U);
+        formatDegreesMinutes(latitude, sizeof(latitude),
+                             BENCH_START_LAT_E6 + (int32_t)epoch * BENCH_STEP_LAT_E6, 2U);
+        formatDegreesMinutes(longitude, sizeof(longitude),
+                             BENCH_START_LON_E6 + (int32_t)epoch * BENCH_STEP_LON_E6, 3U);
+
+        snprintf(body, sizeof(body),
+                 "GPGGA,%02u%02u%02u.00,%s,N,%s,E,1,%02u,0.%u,%u.%u,M,-28.0,M,,", hh, mm, ss,
+                 latitude, longitude, 7U + epoch % 5U, 7U + epoch % 3U, 10U + epoch % 7U,
+                 epoch % 10U);
+        appendSentence(log, body);
+        snprintf(body, sizeof(body), "GNRMC,%02u%02u%02u.00,A,%s,N,%s,E,2.5,%u.0,161026,,,A",
+                 hh, mm, ss, latitude, longitude, (unsigned)(epoch % 360U));
+        appendSentence(log, body);
+        appendSentence(log, "GNGSA,A,3,05,12,15,18,24,25,29,,,,,,1.6,0.9,1.3");
+        appendSentence(log, "GPGSV,3,1,11,05,45,120,38,12,30,210,35,15,60,300,40,18,20,045,33");
+        appendSentence(log, "GPGSV,3,2,11,24,55,090,41,25,15,330,29,29,35,180,36,31,05,260,");
+        appendSentence(log, "GPGSV,3,3,11,10,10,020,,20,08,140,,26,03,350,");
+        *sentences += 6U;
+    }
+    return log;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Parsing throughput of GnssParser on an hour of receiver output.
+* @details      The log is fed byte by byte, as the modem line handlers do; the GSV sentences
+*               are skipped by the parser, which costs their bytes but publishes nothing.
+*
+* @return       int         0 if every position sentence is accepted without heap use, faster
+*                           than the UART can deliver the log.
+*/
+/*================================================================================================*/
+int main() {
+    uint32_t sentences = 0U;
+    std::string log = recordLog(&sentences);
+    GnssParser parser;
+
+    uint32_t published = 0U;
+    uint64_t startAllocations = benchAllocations();
+    uint64_t startNs = benchCpuNs();
+    for (uint32_t pass = 0; pass < BENCH_PASSES; pass++) {
+        for (char c : log) {
+            if (parser.feed(c)) {
+                published++;
+            }
+        }
+    }
+    uint64_t cpuNs = benchCpuNs() - startNs;
+    uint64_t allocations = benchAllocations() - startAllocations;
+
+    double parsedPerSecond = (double)sentences * BENCH_PASSES * 1e9 / (double)cpuNs;
+    double wirePerSecond = (double)sentences * BENCH_UART_BAUD / BENCH_UART_BITS_PER_BYTE /
+                           (double)log.size();
+    printf("[BENCH] NMEA log: %u sentences, %u bytes\n", (unsigned)sentences,
+           (unsigned)log.size());
+    benchPrint("parse throughput", parsedPerSecond, "sentences/s");
+    benchPrint("parse throughput (bytes)", (double)log.size() * BENCH_PASSES * 1000.0 / cpuNs,
+               "MB/s");
+    benchPrint("CPU per sentence", (double)cpuNs / sentences / BENCH_PASSES, "ns");
+    benchPrint("UART delivery at 115200 baud", wirePerSecond, "sentences/s");
+    benchPrint("heap allocations", (double)allocations, "allocs");
+    printf("[BENCH]   %lu published, %lu checksum errors\n", (unsigned long)published,
+           (unsigned long)parser.checksumErrors());
+
+    int32_t endLatitudeE6 = BENCH_START_LAT_E6 + (int32_t)(BENCH_EPOCHS - 1U) * BENCH_STEP_LAT_E6;
+    bool complete = published == BENCH_PASSES * BENCH_EPOCHS * 3U &&
+                    parser.checksumErrors() == 0U &&
+                    parser.fix().position.latitudeE6 == endLatitudeE6;
+    return (complete && allocations == 0U && parsedPerSecond > wirePerSecond) ? 0 : 1;
+}
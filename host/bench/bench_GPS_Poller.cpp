@@ -0,0 +1,173 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+#include "GPS_Poller.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the benchmark runs on (UART 1 belongs to gsmSerialPort) */
+#define BENCH_UART                2
+
+/* The walk: no fix for the first 45 s, standing still, then about 110 m further at 5 min */
+#define BENCH_RUN_MS              600000U
+#define BENCH_FIX_AT_MS           45000U
+#define BENCH_MOVE_AT_MS          300000U
+#define BENCH_LATITUDE            21.028511
+#define BENCH_MOVED_LATITUDE      21.029511
+#define BENCH_LONGITUDE           105.804817
+
+/* Stable query interval of the sketch (GNSS_STABLE_INTERVAL_MS in CANE_BLIND.ino) */
+#define BENCH_STABLE_INTERVAL_MS  30000U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* What one way of getting the location cost over the walk */
+typedef struct {
+    uint64_t cpuNs;           /* CPU time of the location code alone */
+    uint64_t allocations;
+    uint32_t queries;
+    uint32_t bytes;           /* Modem traffic, both directions */
+    uint32_t links;           /* Map links built */
+} LocationCost;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Moves the fake receiver along the walk, relative to now */
+static void scheduleWalk(FakeModem& modem) {
+    modem.clearFix();
+    hostAfterMs(BENCH_FIX_AT_MS, [&modem]() { modem.setFix(BENCH_LATITUDE, BENCH_LONGITUDE); });
+    hostAfterMs(BENCH_MOVE_AT_MS, [&modem]() {
+        modem.setFix(BENCH_MOVED_LATITUDE, BENCH_LONGITUDE);
+    });
+}
+
+/* The map link of the former parseGpsToMapLink(), without its debug output */
+static String legacyMapLink(double latitude, double longitude) {
+    String link = "https://www.google.com/maps?q=";
+    link += String(latitude, 6);
+    link += ",";
+    link += String(longitude, 6);
+    return link;
+}
+
+/* The superloop: a map link rebuilt on every pass, no receiver query at all */
+static void runLegacy(LocationCost& cost) {
+    String mapLink;
+    uint32_t startMs = millis();
+    uint64_t startAllocations = benchAllocations();
+    while ((uint32_t)(millis() - startMs) < BENCH_RUN_MS) {
+        uint64_t startNs = benchCpuNs();
+        mapLink = legacyMapLink(BENCH_LATITUDE, BENCH_LONGITUDE);
+        cost.cpuNs += benchCpuNs() - startNs;
+        cost.links++;
+        delay(GNSS_LEGACY_LOOP_MS);
+    }
+    cost.allocations = benchAllocations() - startAllocations;
+}
+
+/* A query every GNSS_POLL_ACQUIRE_MS whatever the fix state */
+static void runFixedRate(LocationCost& cost) {
+    HardwareSerial port(BENCH_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    GnssParser parser;
+    scheduleWalk(modem);
+
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < BENCH_RUN_MS) {
+        AtHandle handle = engine.submit(AT_CMD_GNSS_INFO);
+        engine.waitFor(handle);
+        const char* response = engine.response(handle);
+        parser.feedLine(response, strlen(response));
+        cost.bytes += strlen(AT_CMD_GNSS_INFO.prefix) + 1U + strlen(response);
+        cost.queries++;
+        engine.release(handle);
+        delay(GNSS_POLL_ACQUIRE_MS);
+    }
+}
+
+/* GnssPoller called when it asks to be, as the GNSS tasklet does */
+static void runPoller(LocationCost& cost) {
+    HardwareSerial port(BENCH_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    GnssParser parser;
+    GnssPoller poller(engine, parser);
+    poller.setStableInterval(BENCH_STABLE_INTERVAL_MS);
+    scheduleWalk(modem);
+
+    uint32_t startMs = millis();
+    uint32_t nextPollMs = startMs;
+    uint64_t allocations = 0U;
+    while ((uint32_t)(millis() - startMs) < BENCH_RUN_MS) {
+        engine.poll();
+        if ((int32_t)(millis() - nextPollMs) >= 0) {
+            uint64_t startAllocations = benchAllocations();
+            uint64_t startNs = benchCpuNs();
+            uint32_t waitMs = poller.poll();
+            cost.cpuNs += benchCpuNs() - startNs;
+            allocations += benchAllocations() - startAllocations;
+            nextPollMs = millis() + waitMs;
+        }
+        delay(1);
+    }
+    cost.allocations = allocations;
+    cost.queries = poller.stats().queries;
+    cost.bytes = poller.stats().txBytes + poller.stats().rxBytes;
+    cost.links = poller.stats().publishes;
+}
+
+/* Prints the figures of one way */
+static void printCost(const char* name, const LocationCost& cost) {
+    printf("[BENCH] %s\n", name);
+    benchPrint("  CPU time", (double)cost.cpuNs / 1000.0, "us");
+    benchPrint("  heap allocations", (double)cost.allocations, "allocs");
+    benchPrint("  map links built", (double)cost.links, "links");
+    benchPrint("  receiver queries", (double)cost.queries, "queries");
+    benchPrint("  modem traffic", (double)cost.bytes, "B");
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Cost of keeping the location current over a ten-minute walk.
+* @details      The superloop rebuilt a String map link every GNSS_LEGACY_LOOP_MS and never
+*               asked the receiver; querying at the acquisition rate throughout is the naive
+*               way to get real fixes. GnssPoller's CPU time covers poll() alone: the AT engine
+*               is polled by the modem tasklet either way.
+*
+* @return       int         0 if the poller spends less CPU than the superloop and sends less
+*                           modem traffic than fixed-rate polling.
+*/
+/*================================================================================================*/
+int main() {
+    LocationCost legacy = {};
+    LocationCost fixedRate = {};
+    LocationCost adaptive = {};
+    runLegacy(legacy);
+    runFixedRate(fixedRate);
+    runPoller(adaptive);
+
+    printf("[BENCH] %u s walk, fix after %u s, moves at %u s\n", BENCH_RUN_MS / 1000U,
+           BENCH_FIX_AT_MS / 1000U, BENCH_MOVE_AT_MS / 1000U);
+    printCost("superloop link rebuild", legacy);
+    printCost("query every 2 s", fixedRate);
+    printCost("GnssPoller", adaptive);
+    printf("[BENCH]   its allocations are the fake modem's, made as the query is written\n");
+    benchPrint("CPU time saved against the superloop",
+               (double)(int64_t)(legacy.cpuNs - adaptive.cpuNs) / 1000.0, "us");
+    benchPrint("traffic saved against a query every 2 s",
+               (double)((int64_t)fixedRate.bytes - (int64_t)adaptive.bytes), "B");
+
+    return (adaptive.cpuNs < legacy.cpuNs && adaptive.bytes < fixedRate.bytes) ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "FakeModem.h"
+#include "MODEM_Init.h"
+#include "MODEM_Link.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the benchmark runs on (UART 1 belongs to gsmSerialPort) */
+#define BENCH_UART                2
+
+/* Power-on to the module answering "AT" (ms) */
+#define BENCH_MODEM_BOOT_MS       4000U
+
+/* The blocking bring-up this replaced: a fixed wait and read window per command */
+#define BLOCKING_COMMAND_WAIT_MS  800U
+#define BLOCKING_READ_TIMEOUT_MS  1000U
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* The sketch's boot script (CANE_BLIND.ino) */
+static const ModemInitStep BOOT_SCRIPT[] = {
+    { &AT_CMD_ATTENTION,       NULL,                         NULL,               20, true  },
+    { &AT_CMD_ECHO_OFF,        NULL,                         NULL,               2,  true  },
+    { &AT_CMD_CHARSET_GSM,     &AT_CMD_CHARSET_QUERY,        "\"GSM\"",          2,  true  },
+    { &AT_CMD_SMS_TEXT_MODE,   &AT_CMD_SMS_MODE_QUERY,       "+CMGF: 1",         2,  true  },
+    { &AT_CMD_SMS_INDICATION,  &AT_CMD_SMS_INDICATION_QUERY, "+CNMI: 2,2,0,0,0", 2,  true  },
+    { &AT_CMD_CLIP_ON,         &AT_CMD_CLIP_QUERY,           "+CLIP: 1",         2,  false },
+    { &AT_CMD_CALL_REPORT_ON,  &AT_CMD_CALL_REPORT_QUERY,    "+CLCC: 1",         2,  false },
+    { &AT_CMD_SIGNAL_QUALITY,  NULL,                         NULL,               0,  false },
+    { &AT_CMD_AUTO_CSQ_ON,     &AT_CMD_AUTO_CSQ_QUERY,       "+AUTOCSQ: 1,1",    1,  false },
+    { &AT_CMD_GNSS_POWER_ON,   &AT_CMD_GNSS_POWER_QUERY,     "+CGPS: 1",         1,  false }
+};
+static const uint8_t BOOT_STEPS = sizeof(BOOT_SCRIPT) / sizeof(BOOT_SCRIPT[0]);
+
+/* Commands of the original setup() */
+static const char* const BLOCKING_COMMANDS[] = {
+    "AT", "ATE0", "AT+CSCS=\"GSM\"", "AT+CMGF=1", "AT+CNMI=2,2,0,0,0", "AT+CLIP=1", "AT+CSQ"
+};
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* The original bring-up from power-on; returns its duration (ms) */
+static uint32_t blockingBringUp(HardwareSerial& port) {
+    uint32_t startMs = millis();
+    for (const char* command : BLOCKING_COMMANDS) {
+        port.print(command);
+        port.print("\r");
+        delay(BLOCKING_COMMAND_WAIT_MS);
+        uint32_t readStartMs = millis();
+        while ((uint32_t)(millis() - readStartMs) < BLOCKING_READ_TIMEOUT_MS) {
+            while (port.available() > 0) {
+                port.read();
+            }
+            delay(1);
+        }
+    }
+    return millis() - startMs;
+}
+
+/* Link negotiation and the boot script from now; returns the time to ready (ms) */
+static uint32_t pipelinedBringUp(HardwareSerial& port, AtEngine& engine, bool& ready) {
+    uint32_t startMs = millis();
+    ModemLink link(port, engine);
+    ModemInitRunner runner(engine);
+    bool linked = link.begin(33, 25, 18, 19);
+    runner.begin(BOOT_SCRIPT, BOOT_STEPS);
+    while (!runner.poll()) {
+        delay(1);
+    }
+    ready = linked && runner.isReady();
+    return millis() - startMs;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Boot-to-ready latency of the modem bring-up.
+* @details      Power-on to a configured module (virtual ms) for the original fixed-delay
+*               sequence, for the link negotiation plus init script after a cold power-on, and
+*               for an ESP32 reset with the module already configured.
+*
+* @return       int         0 if the pipelined bring-up is ready sooner after a cold boot.
+*/
+/*================================================================================================*/
+int main() {
+    uint32_t blockingMs;
+    size_t blockingHeard;
+    std::string blockingEcho;
+    {
+        HardwareSerial port(BENCH_UART);
+        port.begin(115200);
+        FakeModem modem(port, BENCH_MODEM_BOOT_MS);
+        blockingMs = blockingBringUp(port);
+        blockingHeard = modem.commands().size();
+        blockingEcho = modem.setting("+CMGF");
+    }
+
+    HardwareSerial port(BENCH_UART);
+    port.begin(115200);
+    FakeModem modem(port, BENCH_MODEM_BOOT_MS);
+    AtEngine engine(port);
+    bool coldReady = false;
+    uint32_t coldMs = pipelinedBringUp(port, engine, coldReady);
+    bool warmReady = false;
+    uint32_t warmMs = pipelinedBringUp(port, engine, warmReady);
+
+    printf("[BENCH] Power-on to modem ready, module boot %u ms\n", BENCH_MODEM_BOOT_MS);
+    benchPrint("blocking setup() sequence", (double)blockingMs, "ms");
+    printf("[BENCH]   module heard %lu of %lu commands, AT+CMGF now \"%s\"\n",
+           (unsigned long)blockingHeard,
+           (unsigned long)(sizeof(BLOCKING_COMMANDS) / sizeof(BLOCKING_COMMANDS[0])),
+           blockingEcho.c_str());
+    benchPrint("link negotiation + init script, cold boot", (double)coldMs, "ms");
+    benchPrint("link negotiation + init script, ESP32 reset", (double)warmMs, "ms");
+    printf("[BENCH]   link at %lu baud, %lu commands in total\n", (unsigned long)modem.baud(),
+           (unsigned long)modem.commands().size());
+
+    return (coldReady && warmReady && coldMs < blockingMs) ? 0 : 1;
+}
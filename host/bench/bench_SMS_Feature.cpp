@@ -0,0 +1,135 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+#include "SMS_Feature.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the benchmark runs on (UART 1 belongs to gsmSerialPort) */
+#define BENCH_UART                2
+
+/* The blocking send with fixed waits that this sender replaced */
+#define BLOCKING_COMMAND_WAIT_MS  800U
+#define BLOCKING_READ_TIMEOUT_MS  1000U
+#define BLOCKING_SMS_COMMAND_MS   500U
+#define BLOCKING_SMS_TEXT_MS      300U
+#define BLOCKING_SMS_SEND_MS      3000U
+
+/* Messages timed for the CPU cost per message */
+#define BENCH_CPU_MESSAGES        500U
+
+/* Recipient and body of the benchmark messages */
+#define BENCH_CONTACT             "+84900000001"
+#define BENCH_TEXT                "SOS! I need help. My location: https://maps.google.com/?q=" \
+                                  "21.028511,105.804817"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Reads the port for ms, appending what arrived */
+static void readFor(HardwareSerial& port, uint32_t ms, std::string& received) {
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < ms) {
+        while (port.available() > 0) {
+            received += (char)port.read();
+        }
+        delay(1);
+    }
+}
+
+/* One message the old way; returns the time the caller was blocked (ms) */
+static uint32_t blockingSend(HardwareSerial& port, bool& confirmed) {
+    std::string received;
+    uint32_t startMs = millis();
+    port.print("AT+CMGF=1\r");
+    delay(BLOCKING_COMMAND_WAIT_MS);
+    readFor(port, BLOCKING_READ_TIMEOUT_MS, received);
+    port.print("AT+CMGS=\"" BENCH_CONTACT "\"\r\n");
+    delay(BLOCKING_SMS_COMMAND_MS);
+    port.print(BENCH_TEXT);
+    delay(BLOCKING_SMS_TEXT_MS);
+    port.write((uint8_t)0x1A);
+    delay(BLOCKING_SMS_SEND_MS);
+    readFor(port, BLOCKING_SMS_SEND_MS, received);
+    confirmed = (received.find("+CMGS:") != std::string::npos);
+    return millis() - startMs;
+}
+
+/* Runs the sender to completion */
+static SmsStatus finish(SmsSender& sender, AtEngine& engine) {
+    SmsStatus status = sender.status();
+    while (status == SMS_STATUS_SENDING) {
+        status = sender.poll();
+        if (status == SMS_STATUS_SENDING) {
+            engine.idle(AT_ENGINE_WAIT_SLICE_MS);
+        }
+    }
+    return status;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        SMS send latency of the prompt-driven sender against the fixed-delay path.
+* @details      Both send the SOS text against the fake modem with its default latencies
+*               (prompt, then a network round trip of smsNetworkMs); the figures are virtual
+*               milliseconds until the caller knows the outcome. The CPU time of one message
+*               through the sender is measured separately.
+*
+* @return       int         0 if the sender gets a confirmed result sooner.
+*/
+/*================================================================================================*/
+int main() {
+    bool blockingConfirmed = false;
+    uint32_t blockingMs;
+    {
+        HardwareSerial port(BENCH_UART);
+        port.begin(115200);
+        FakeModem modem(port);
+        blockingMs = blockingSend(port, blockingConfirmed);
+    }
+
+    HardwareSerial port(BENCH_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+
+    sender.start(BENCH_CONTACT, BENCH_TEXT);
+    bool sent = (finish(sender, engine) == SMS_STATUS_SENT);
+    uint32_t senderMs = sender.elapsedMs();
+
+    modem.setSmsError(331);
+    sender.start(BENCH_CONTACT, BENCH_TEXT);
+    bool rejected = (finish(sender, engine) == SMS_STATUS_REJECTED);
+    uint32_t rejectedMs = sender.elapsedMs();
+    modem.setSmsError(0);
+
+    printf("[BENCH] SMS send latency, network round trip %u ms\n",
+           modem.timing().smsNetworkMs);
+    benchPrint(blockingConfirmed ? "blocking send with fixed waits, +CMGS seen"
+                                 : "blocking send with fixed waits, +CMGS missed",
+               (double)blockingMs, "ms");
+    benchPrint("SmsSender to +CMGS: <mr>", (double)senderMs, "ms");
+    benchPrint("SmsSender to +CMS ERROR", (double)rejectedMs, "ms");
+
+    uint64_t startNs = benchCpuNs();
+    uint64_t startAllocations = benchAllocations();
+    for (uint32_t i = 0; i < BENCH_CPU_MESSAGES; i++) {
+        sender.start(BENCH_CONTACT, BENCH_TEXT);
+        finish(sender, engine);
+    }
+    uint64_t cpuNs = benchCpuNs() - startNs;
+    benchPrint("CPU per message (modem model included)",
+               (double)cpuNs / 1000.0 / BENCH_CPU_MESSAGES, "us");
+    benchPrint("heap allocations per message (modem included)",
+               (double)(benchAllocations() - startAllocations) / BENCH_CPU_MESSAGES, "allocs");
+
+    return (sent && rejected && senderMs < blockingMs) ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "SMS_Pdu.h"
+#include <string>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Messages encoded per figure */
+#define BENCH_MESSAGES            20000U
+
+/* UART rate the PDUs are written at (bits per byte with start and stop bits) */
+#define BENCH_UART_BAUD           115200U
+#define BENCH_UART_BITS_PER_BYTE  10U
+
+/* Recipient of the benchmark messages */
+#define BENCH_CONTACT             "+84900000001"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Encodes text BENCH_MESSAGES times; prints the figures and returns true if encoding a message
+   costs less CPU than writing its PDUs to the module */
+static bool benchEncode(const char* label, const std::string& text) {
+    SmsPduEncoder encoder;
+    SmsPdu pdu;
+    size_t hexBytes = 0U;
+    uint8_t segments = 0U;
+    bool encoded = true;
+
+    uint64_t startAllocations = benchAllocations();
+    uint64_t startNs = benchCpuNs();
+    for (uint32_t i = 0; i < BENCH_MESSAGES; i++) {
+        encoded = encoder.begin(BENCH_CONTACT, text.c_str(), (uint8_t)i) && encoded;
+        segments = encoder.segmentCount();
+        hexBytes = 0U;
+        for (uint8_t s = 0; s < segments; s++) {
+            encoded = encoder.encodeSegment(s, pdu) && encoded;
+            hexBytes += strlen(pdu.hex);
+        }
+    }
+    uint64_t cpuNs = benchCpuNs() - startNs;
+    uint64_t allocations = benchAllocations() - startAllocations;
+
+    double messageUs = (double)cpuNs / 1000.0 / BENCH_MESSAGES;
+    double wireUs = (double)hexBytes * BENCH_UART_BITS_PER_BYTE * 1000000.0 / BENCH_UART_BAUD;
+    printf("[BENCH] %s: %u bytes, %u segment(s)\n", label, (unsigned)text.size(),
+           (unsigned)segments);
+    benchPrint("  encode per message", messageUs, "us");
+    benchPrint("  encode throughput (UTF-8 in)",
+               (double)text.size() * BENCH_MESSAGES * 1000.0 / (double)cpuNs, "MB/s");
+    benchPrint("  PDU wire time at 115200 baud", wireUs, "us");
+    benchPrint("  heap allocations", (double)allocations, "allocs");
+    return encoded && allocations == 0U && messageUs < wireUs;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Encoding throughput of SmsPduEncoder.
+* @details      Encodes a single GSM 7-bit SOS text, a four-segment GSM 7-bit report and a
+*               Vietnamese (UCS-2) message, every segment included.
+*
+* @return       int         0 if every message encodes without heap use, faster than its PDUs
+*                           can be written to the module.
+*/
+/*================================================================================================*/
+int main() {
+    std::string sos = "SOS! I need help. My location: https://maps.google.com/?q=21.028511,"
+                      "105.804817";
+    std::string report;
+    while (report.size() + sos.size() + 1U <= SMS_PDU_MAX_SEGMENTS * SMS_GSM7_SEGMENT_SEPTETS) {
+        report += sos + "\n";
+    }
+    std::string vietnamese;
+    for (uint8_t i = 0; i < 10U; i++) {
+        vietnamese += "C\xE1\xBA\xA7n gi\xC3\xBA" "p \xC4\x91\xE1\xBB\xA1! ";
+    }
+
+    bool passed = benchEncode("single GSM 7-bit SMS", sos);
+    passed = benchEncode("concatenated GSM 7-bit report", report) && passed;
+    passed = benchEncode("UCS-2 message", vietnamese) && passed;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "FakeModem.h"
+#include "SOS_Dispatch.h"
+#include <HostSim.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the benchmark runs on (UART 1 belongs to gsmSerialPort) */
+#define BENCH_UART                2
+
+/* The blocking SOS flow this dispatcher replaced: ATD then a fixed read, and an SMS send with
+   fixed waits */
+#define BLOCKING_DIAL_READ_MS     5000U
+#define BLOCKING_COMMAND_WAIT_MS  800U
+#define BLOCKING_READ_TIMEOUT_MS  1000U
+#define BLOCKING_SMS_COMMAND_MS   500U
+#define BLOCKING_SMS_TEXT_MS      300U
+#define BLOCKING_SMS_SEND_MS      3000U
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Emergency contacts, by priority */
+static const char* const BENCH_CONTACTS[] = {
+    "+84900000001", "+84900000002", "+84900000003", "+84900000004", "+84900000005"
+};
+
+/* Dispatcher fed by the engine, as dispatchGsmLine() does on the device */
+static UrcDispatcher benchDispatcher;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+static void dispatchLine(const char* line, size_t length, void*) {
+    benchDispatcher.dispatch(line, length);
+}
+
+/* Reads the port for ms */
+static void readFor(HardwareSerial& port, uint32_t ms) {
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < ms) {
+        while (port.available() > 0) {
+            port.read();
+        }
+        delay(1);
+    }
+}
+
+/* The original flow, repeated for every contact; returns trigger to the last SMS done (ms) */
+static uint32_t blockingAlert(uint8_t contactCount) {
+    HardwareSerial port(BENCH_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    uint32_t startMs = millis();
+
+    port.print("ATD");
+    port.print(BENCH_CONTACTS[0]);
+    port.print(";\r\n");
+    readFor(port, BLOCKING_DIAL_READ_MS);
+    for (uint8_t i = 0; i < contactCount; i++) {
+        port.print("AT+CMGF=1\r\n");
+        delay(BLOCKING_COMMAND_WAIT_MS);
+        readFor(port, BLOCKING_READ_TIMEOUT_MS);
+        port.print("AT+CMGS=\"");
+        port.print(BENCH_CONTACTS[i]);
+        port.print("\"\r\n");
+        delay(BLOCKING_SMS_COMMAND_MS);
+        port.print("SOS! My location: https://www.google.com/maps?q=21.028511,105.804817");
+        delay(BLOCKING_SMS_TEXT_MS);
+        port.write((uint8_t)0x1A);
+        delay(BLOCKING_SMS_SEND_MS);
+        readFor(port, BLOCKING_SMS_SEND_MS);
+    }
+    return millis() - startMs;
+}
+
+/* The dispatcher; returns the report of the alert */
+static SosReport dispatchedAlert(uint8_t contactCount) {
+    Preferences store;
+    store.begin(SOS_CONTACTS_NAMESPACE);
+    store.clear();
+    store.end();
+    store.begin(SMS_OUTBOX_NAMESPACE);
+    store.clear();
+    store.end();
+
+    HardwareSerial port(BENCH_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setFix(21.028511, 105.804817);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    for (uint8_t i = 0; i < contactCount; i++) {
+        contacts.add(BENCH_CONTACTS[i]);
+    }
+    contacts.remove(0);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+    CallTracker calls(engine);
+    calls.begin(benchDispatcher);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    dispatcher.start();
+    while (dispatcher.isActive()) {
+        engine.poll();
+        outbox.poll();
+        dispatcher.poll();
+        delay(1);
+    }
+    return dispatcher.report();
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Trigger-to-all-notified time of an SOS alert.
+* @details      The original flow dialled one contact and then texted with fixed waits; repeated
+*               for every contact, the last one hears about the alert after the sum of those
+*               waits. The dispatcher dials and texts all contacts in one pipelined sequence
+*               against the fake modem; its figure is the time until the network accepted the
+*               last SMS.
+*
+* @return       int         0 if every contact is notified sooner by the dispatcher.
+*/
+/*================================================================================================*/
+int main() {
+    bool faster = true;
+    printf("[BENCH] SOS trigger to every contact notified (ms)\n");
+    for (uint8_t count = 1U; count <= SOS_CONTACTS_MAX; count += 2U) {
+        uint32_t blockingMs = blockingAlert(count);
+        SosReport report = dispatchedAlert(count);
+        char label[64];
+        snprintf(label, sizeof(label), "%u contact(s), blocking flow", (unsigned)count);
+        benchPrint(label, (double)blockingMs, "ms");
+        snprintf(label, sizeof(label), "%u contact(s), dispatcher", (unsigned)count);
+        benchPrint(label, (double)report.allNotifiedMs, "ms");
+        faster = faster && !report.timedOut && report.allNotifiedMs != 0U &&
+                 report.allNotifiedMs < blockingMs;
+    }
+    return faster ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "TASK_Scheduler.h"
+#include <HostSim.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Virtual time each loop runs for (ms) */
+#define BENCH_RUN_MS              60000U
+
+/* Button presses and portal requests over the run, at pseudo-random times */
+#define BENCH_EVENT_COUNT         400U
+
+/* The superloop this replaced: three handlers, then a fixed delay */
+#define SUPERLOOP_DELAY_MS        175U
+
+/* Tasklet periods of the sketch (CANE_BLIND.ino) */
+#define PORTAL_PERIOD_MS          10U
+#define MODEM_PERIOD_MS           50U
+#define BUTTON_DEADLINE_MS        10U
+#define PORTAL_DEADLINE_MS        20U
+#define MODEM_DEADLINE_MS         20U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Latency of one kind of event (ms) */
+typedef struct {
+    volatile uint32_t pendingSinceMs;  /* Time the oldest unserved event arrived */
+    volatile bool pending;
+    uint32_t served;
+    uint64_t totalMs;
+    uint32_t maxMs;
+} EventLatency;
+
+/* What one loop did over the run */
+typedef struct {
+    EventLatency button;
+    EventLatency portal;
+    uint32_t handlerCalls;             /* Calls of any handler, with or without work */
+    uint32_t wakeUps;                  /* Loop passes (superloop) or runOnce() calls */
+} LoopRun;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static LoopRun* activeRun = NULL;
+static TaskletScheduler* activeScheduler = NULL;
+static TaskletId buttonTasklet = TASKLET_INVALID_ID;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Marks an event as arrived (interrupt context) */
+static void raiseEvent(EventLatency& event) {
+    if (!event.pending) {
+        event.pendingSinceMs = millis();
+        event.pending = true;
+    }
+}
+
+/* Serves a pending event, if any */
+static void serveEvent(EventLatency& event) {
+    activeRun->handlerCalls++;
+    if (event.pending) {
+        uint32_t latencyMs = millis() - event.pendingSinceMs;
+        event.pending = false;
+        event.served++;
+        event.totalMs += latencyMs;
+        if (latencyMs > event.maxMs) {
+            event.maxMs = latencyMs;
+        }
+    }
+}
+
+static void serveButton(void*) {
+    serveEvent(activeRun->button);
+}
+
+static void servePortal(void*) {
+    serveEvent(activeRun->portal);
+}
+
+static void serveModem(void*) {
+    activeRun->handlerCalls++;
+}
+
+/* Schedules the same presses and requests for every run; a press also triggers the scheduler's
+   button tasklet when one is set */
+static void scheduleEvents(LoopRun& run) {
+    uint32_t seed = 12345U;
+    uint64_t startUs = hostNowUs();
+    for (uint32_t i = 0U; i < BENCH_EVENT_COUNT; i++) {
+        seed = seed * 1103515245U + 12345U;
+        uint64_t atUs = startUs + (uint64_t)(seed % (BENCH_RUN_MS * 1000U));
+        if ((i & 1U) == 0U) {
+            hostAt(atUs, [&run]() {
+                raiseEvent(run.button);
+                if (activeScheduler != NULL) {
+                    activeScheduler->trigger(buttonTasklet);
+                }
+            });
+        } else {
+            hostAt(atUs, [&run]() { raiseEvent(run.portal); });
+        }
+    }
+}
+
+/* The original loop(): every handler on each pass, then delay(175) */
+static void runSuperloop(LoopRun& run) {
+    activeRun = &run;
+    activeScheduler = NULL;
+    scheduleEvents(run);
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < BENCH_RUN_MS) {
+        servePortal(NULL);
+        serveModem(NULL);
+        serveButton(NULL);
+        run.wakeUps++;
+        delay(SUPERLOOP_DELAY_MS);
+    }
+}
+
+/* The tasklet loop of the sketch: button on trigger, portal and modem periodic */
+static void runTasklets(LoopRun& run) {
+    TaskletScheduler scheduler;
+    scheduler.begin();
+    activeRun = &run;
+    activeScheduler = &scheduler;
+    buttonTasklet = scheduler.add("button", serveButton, NULL, 0U, BUTTON_DEADLINE_MS);
+    scheduler.add("modem", serveModem, NULL, MODEM_PERIOD_MS, MODEM_DEADLINE_MS);
+    scheduler.add("portal", servePortal, NULL, PORTAL_PERIOD_MS, PORTAL_DEADLINE_MS);
+    scheduleEvents(run);
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < BENCH_RUN_MS) {
+        scheduler.runOnce();
+        run.wakeUps++;
+    }
+    activeScheduler = NULL;
+}
+
+/* Prints the figures of one run */
+static void printRun(const char* name, const LoopRun& run) {
+    char label[64];
+    snprintf(label, sizeof(label), "%s button latency, mean", name);
+    benchPrint(label, (double)run.button.totalMs / run.button.served, "ms");
+    snprintf(label, sizeof(label), "%s button latency, max", name);
+    benchPrint(label, (double)run.button.maxMs, "ms");
+    snprintf(label, sizeof(label), "%s portal latency, mean", name);
+    benchPrint(label, (double)run.portal.totalMs / run.portal.served, "ms");
+    snprintf(label, sizeof(label), "%s portal latency, max", name);
+    benchPrint(label, (double)run.portal.maxMs, "ms");
+    snprintf(label, sizeof(label), "%s wake-ups", name);
+    benchPrint(label, run.wakeUps * 1000.0 / BENCH_RUN_MS, "/s");
+    snprintf(label, sizeof(label), "%s handler calls", name);
+    benchPrint(label, run.handlerCalls * 1000.0 / BENCH_RUN_MS, "/s");
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Event latency of the delay(175) superloop and of the tasklet scheduler.
+* @details      The same button presses and portal requests arrive at pseudo-random times while
+*               each loop runs for a minute of virtual time; the handlers take no time, so the
+*               figures are what the loop structure alone costs.
+*
+* @return       int         0 if the scheduler serves both buttons and portal requests sooner.
+*/
+/*================================================================================================*/
+int main() {
+    static LoopRun superloop = {};
+    static LoopRun tasklets = {};
+    runSuperloop(superloop);
+    runTasklets(tasklets);
+
+    printf("[BENCH] %u presses and requests over %u ms\n", BENCH_EVENT_COUNT, BENCH_RUN_MS);
+    printRun("superloop", superloop);
+    printRun("scheduler", tasklets);
+
+    bool buttonSooner = tasklets.button.maxMs < superloop.button.totalMs / superloop.button.served;
+    bool portalSooner = tasklets.portal.totalMs < superloop.portal.totalMs;
+    return (buttonSooner && portalSooner) ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "Bench.h"
+#include "UART_Framer.h"
+#include <string>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Passes over the recorded traffic */
+#define BENCH_PASSES              20000U
+
+/* Bytes handed to the framer at a time, as pump() moves them from the UART */
+#define BENCH_CHUNK_SIZE          UART_PUMP_CHUNK_SIZE
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Modem traffic captured on the UART: bring-up, signal reports, a position query with NMEA
+   output enabled, an incoming SMS and an outgoing call */
+static const char RECORDED_TRAFFIC[] =
+    "\r\nRDY\r\n\r\n+CPIN: READY\r\n\r\nSMS DONE\r\n\r\nPB DONE\r\n"
+    "ATE0\r\r\nOK\r\n\r\nOK\r\n\r\nOK\r\n\r\n+CSQ: 21,99\r\n\r\nOK\r\n"
+    "\r\n+CGPSINFO: 2101.710660,N,10548.289020,E,161026,101500.0,12.3,0.0,0.0\r\n\r\nOK\r\n"
+    "$GPRMC,101500.00,A,2101.710660,N,10548.289020,E,0.0,0.0,161026,,,A*6B\r\n"
+    "$GPGGA,101500.00,2101.710660,N,10548.289020,E,1,08,0.9,12.3,M,-21.4,M,,*7A\r\n"
+    "$GPGSA,A,3,01,03,06,09,17,19,22,28,,,,,1.6,0.9,1.3*3D\r\n"
+    "\r\n+CSQ: 20,99\r\n"
+    "\r\n+CMT: \"+84900000001\",\"\",\"26/10/16,10:15:00+28\"\r\nWHERE\r\n"
+    "\r\n> \r\n+CMGS: 17\r\n\r\nOK\r\n"
+    "\r\nOK\r\n\r\n+CLCC: 1,0,2,0,0,\"+84900000001\",145\r\n"
+    "\r\n+CLCC: 1,0,3,0,0,\"+84900000001\",145\r\n"
+    "\r\n+CLCC: 1,0,0,0,0,\"+84900000001\",145\r\n"
+    "\r\n+CLCC: 1,0,6,0,0,\"+84900000001\",145\r\n\r\nNO CARRIER\r\n";
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* The String path the framer replaced: characters appended to a String, split at LF */
+static uint32_t stringPathLines(const char* data, size_t size, size_t& checksum) {
+    uint32_t lines = 0U;
+    String pending;
+    for (size_t i = 0; i < size; i++) {
+        pending += data[i];
+        if (data[i] == '\n') {
+            pending.trim();
+            if (pending.length() > 0U) {
+                checksum += pending.length();
+                lines++;
+            }
+            pending = "";
+        }
+    }
+    return lines;
+}
+
+/* The framer fed in UART-sized chunks */
+static uint32_t framerLines(LineFramer& framer, const char* data, size_t size, size_t& checksum) {
+    uint32_t lines = 0U;
+    LineView line;
+    for (size_t offset = 0; offset < size; offset += BENCH_CHUNK_SIZE) {
+        size_t count = (size - offset < BENCH_CHUNK_SIZE) ? size - offset : BENCH_CHUNK_SIZE;
+        framer.feed((const uint8_t*)&data[offset], (uint16_t)count);
+        while (framer.nextLine(line)) {
+            checksum += line.length;
+            lines++;
+        }
+    }
+    return lines;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Throughput and heap use of the line framer against the String path.
+* @details      Both split the same recorded modem traffic into lines; the figures are CPU
+*               throughput and operator new calls per framed line.
+*
+* @return       int         0 if the framer allocates nothing and is the faster of the two.
+*/
+/*================================================================================================*/
+int main() {
+    const size_t size = sizeof(RECORDED_TRAFFIC) - 1U;
+    size_t checksum = 0U;
+
+    uint64_t allocations = benchAllocations();
+    uint64_t startNs = benchCpuNs();
+    uint32_t stringLines = 0U;
+    for (uint32_t pass = 0; pass < BENCH_PASSES; pass++) {
+        stringLines += stringPathLines(RECORDED_TRAFFIC, size, checksum);
+    }
+    uint64_t stringNs = benchCpuNs() - startNs;
+    uint64_t stringAllocations = benchAllocations() - allocations;
+
+    LineFramer framer;
+    allocations = benchAllocations();
+    startNs = benchCpuNs();
+    uint32_t framedLines = 0U;
+    for (uint32_t pass = 0; pass < BENCH_PASSES; pass++) {
+        framedLines += framerLines(framer, RECORDED_TRAFFIC, size, checksum);
+    }
+    uint64_t framerNs = benchCpuNs() - startNs;
+    uint64_t framerAllocations = benchAllocations() - allocations;
+
+    double megabytes = (double)size * BENCH_PASSES / 1e6;
+    printf("[BENCH] %lu bytes of recorded traffic x %u passes (checksum %lu)\n",
+           (unsigned long)size, BENCH_PASSES, (unsigned long)checksum);
+    benchPrint("String path throughput", megabytes / ((double)stringNs / 1e9), "MB/s");
+    benchPrint("String path allocations per line",
+               (double)stringAllocations / stringLines, "");
+    benchPrint("LineFramer throughput", megabytes / ((double)framerNs / 1e9), "MB/s");
+    benchPrint("LineFramer allocations per line", (double)framerAllocations / framedLines, "");
+    benchPrint("LineFramer lines per pass", (double)framedLines / BENCH_PASSES, "");
+
+    return (framerAllocations == 0U && framerNs < stringNs) ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "HostSim.h"
+#include "FakeModem.h"
+#include "Generic_API.h"
+#include "CALL_SOS_Feature.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Power-on to the module answering "AT" (ms); the SIM7600 takes several seconds */
+#define HOST_MODEM_BOOT_MS        4000U
+
+/* After setup(): the SOS button is pressed, then released as a long press (ms) */
+#define HOST_PRESS_AT_MS          1000U
+#define HOST_PRESS_LENGTH_MS      1000U
+
+/* Virtual time the scenario runs after the release (ms) */
+#define HOST_RUN_AFTER_PRESS_MS   20000U
+
+/******************************************************************************
+ * FUNCTIONS PROTOTYPES
+ ******************************************************************************/
+void setup();
+void loop();
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Runs the sketch against the fake modem: boot, a long press on the SOS button and
+*               the alert it raises.
+* @details      Prints the firmware console, then the alert timings measured on the modem side
+*               from the release of the button: ATD written, each AT+CMGS body handed over and
+*               the network acknowledging it.
+*
+* @return       int         0 if the call was placed and the alert SMS was sent.
+*/
+/*================================================================================================*/
+int main() {
+    /* The button is wired to GPIO35 with an external pull-up */
+    hostSetPin(BUTTON_PIN, HIGH);
+
+    FakeModem modem(gsmSerialPort, HOST_MODEM_BOOT_MS);
+    modem.setFix(21.028511, 105.804817);
+
+    setup();
+
+    uint32_t releaseMs = (uint32_t)millis() + HOST_PRESS_AT_MS + HOST_PRESS_LENGTH_MS;
+    hostAfterMs(HOST_PRESS_AT_MS, []() { hostSetPin(BUTTON_PIN, LOW); });
+    hostAfterMs(HOST_PRESS_AT_MS + HOST_PRESS_LENGTH_MS, []() { hostSetPin(BUTTON_PIN, HIGH); });
+
+    uint64_t endUs = hostNowUs() +
+                     (uint64_t)(HOST_PRESS_AT_MS + HOST_PRESS_LENGTH_MS + HOST_RUN_AFTER_PRESS_MS) * 1000U;
+    while (hostNowUs() < endUs) {
+        loop();
+    }
+
+    printf("\n[HOST] SOS timings from the button release at %lu ms\n", (unsigned long)releaseMs);
+    const FakeModemCommand* dial = modem.last("ATD");
+    if (dial != NULL) {
+        printf("[HOST]   %-40s +%lu ms\n", dial->text.c_str(), (unsigned long)(dial->atMs - releaseMs));
+    }
+    size_t smsSent = 0U;
+    for (const FakeModemCommand& command : modem.commands()) {
+        if (command.text.compare(0, 8, "AT+CMGS=") != 0 || command.atMs < releaseMs) {
+            continue;
+        }
+        printf("[HOST]   %-40s +%lu ms%s\n", command.text.c_str(),
+               (unsigned long)(command.atMs - releaseMs), command.cancelled ? " (cancelled)" : "");
+        if (!command.cancelled && !command.body.empty()) {
+            printf("[HOST]     body: %s\n", command.body.c_str());
+            smsSent++;
+        }
+    }
+    printf("[HOST] %lu commands, %lu SMS\n", (unsigned long)modem.commands().size(),
+           (unsigned long)smsSent);
+
+    return (dial != NULL && dial->atMs >= releaseMs && smsSent > 0U) ? 0 : 1;
+}
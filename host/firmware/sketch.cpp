@@ -0,0 +1,3 @@
+/* The Arduino builder compiles the sketch as C++ after including Arduino.h; so does this file */
+#include <Arduino.h>
+#include "../../CANE_BLIND/CANE_BLIND.ino"
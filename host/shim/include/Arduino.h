@@ -0,0 +1,323 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <deque>
+#include <functional>
+#include <string>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Pin levels and modes */
+#define LOW                       0x0
+#define HIGH                      0x1
+#define INPUT                     0x01
+#define OUTPUT                    0x03
+#define INPUT_PULLUP              0x05
+
+/* Interrupt edges */
+#define RISING                    0x01
+#define FALLING                   0x02
+#define CHANGE                    0x03
+
+/* UART frame format and flow control modes of the ESP32 core */
+#define SERIAL_8N1                0x800001cUL
+#define UART_HW_FLOWCTRL_DISABLE  0x0U
+#define UART_HW_FLOWCTRL_CTS_RTS  0x3U
+
+/* Number of GPIOs the shim keeps a level for */
+#define HOST_PIN_COUNT            64U
+
+/* Flash and IRAM placement are meaningless on the host */
+#define IRAM_ATTR
+#define PROGMEM
+#define F(text)                   (text)
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Receive error reported through HardwareSerial::onReceiveError() */
+typedef enum {
+    UART_NO_ERROR = 0,
+    UART_BREAK_ERROR,
+    UART_BUFFER_FULL_ERROR,
+    UART_FIFO_OVF_ERROR,
+    UART_FRAME_ERROR,
+    UART_PARITY_ERROR
+} hardwareSerial_error_t;
+
+typedef std::function<void(void)> OnReceiveCb;
+typedef std::function<void(hardwareSerial_error_t)> OnReceiveErrorCb;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class String
+* @brief Heap string with the subset of the Arduino String API the sketch uses.
+*
+* @api
+*/
+/*================================================================================================*/
+class String {
+public:
+    String(const char* text = "") : text((text != NULL) ? text : "") {}
+    String(const std::string& text) : text(text) {}
+    String(char c) : text(1, c) {}
+    String(int value) : text(std::to_string(value)) {}
+    String(unsigned int value) : text(std::to_string(value)) {}
+    String(long value) : text(std::to_string(value)) {}
+    String(unsigned long value) : text(std::to_string(value)) {}
+    String(double value, unsigned int decimals = 2U) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+        text = buffer;
+    }
+
+    const char* c_str() const { return text.c_str(); }
+    unsigned int length() const { return (unsigned int)text.size(); }
+    bool reserve(unsigned int size) { text.reserve(size); return true; }
+    bool isEmpty() const { return text.empty(); }
+    char charAt(unsigned int index) const { return (index < text.size()) ? text[index] : '\0'; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    int indexOf(const char* needle, unsigned int from = 0U) const {
+        size_t position = text.find(needle, from);
+        return (position == std::string::npos) ? -1 : (int)position;
+    }
+    int indexOf(char needle, unsigned int from = 0U) const {
+        size_t position = text.find(needle, from);
+        return (position == std::string::npos) ? -1 : (int)position;
+    }
+    String substring(unsigned int from, unsigned int to = 0xFFFFFFFFU) const {
+        if (from >= text.size()) {
+            return String();
+        }
+        return String(text.substr(from, (to > text.size() ? text.size() : to) - from));
+    }
+    bool startsWith(const char* prefix) const { return text.compare(0, strlen(prefix), prefix) == 0; }
+    void trim() {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        size_t last = text.find_last_not_of(" \t\r\n");
+        text = (first == std::string::npos) ? std::string() : text.substr(first, last - first + 1U);
+    }
+    long toInt() const { return strtol(text.c_str(), NULL, 10); }
+
+    String& operator+=(const String& other) { text += other.text; return *this; }
+    String& operator+=(const char* other) { text += other; return *this; }
+    String& operator+=(char other) { text += other; return *this; }
+    friend String operator+(const String& left, const String& right) { return String(left.text + right.text); }
+    friend String operator+(const String& left, const char* right) { return String(left.text + right); }
+    friend String operator+(const char* left, const String& right) { return String(left + right.text); }
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator==(const char* other) const { return text == other; }
+    bool operator!=(const String& other) const { return text != other.text; }
+    bool operator!=(const char* other) const { return text != other; }
+
+private:
+    std::string text;
+};
+
+/*================================================================================================*/
+/**
+* @class Print
+* @brief Byte sink with the Arduino print helpers.
+*
+* @api
+*/
+/*================================================================================================*/
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            write(data[i]);
+        }
+        return size;
+    }
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    size_t write(const char* data, size_t size) { return write((const uint8_t*)data, size); }
+    virtual void flush() {}
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char value) { return write((uint8_t)value); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned int value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(double value, int decimals = 2) { return printf("%.*f", decimals, value); }
+    template <typename T> size_t println(const T& value) { return print(value) + println(); }
+    size_t println() { return write("\r\n"); }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+/*================================================================================================*/
+/**
+* @class Stream
+* @brief Readable byte stream.
+*
+* @api
+*/
+/*================================================================================================*/
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    size_t readBytes(uint8_t* buffer, size_t size) {
+        size_t count = 0U;
+        while (count < size && available() > 0) {
+            buffer[count++] = (uint8_t)read();
+        }
+        return count;
+    }
+    size_t readBytes(char* buffer, size_t size) { return readBytes((uint8_t*)buffer, size); }
+};
+
+class HostSerialDevice;
+
+/*================================================================================================*/
+/**
+* @class HardwareSerial
+* @brief UART of the ESP32 core, backed by a simulated device or by the host console.
+* @details UART 0 writes to stdout (or a capture buffer) and reads the text queued with
+* hostConsoleInput(). Other UARTs exchange bytes with the HostSerialDevice attached to them;
+* received bytes land in a driver buffer of setRxBufferSize() bytes, overflowing into
+* UART_BUFFER_FULL_ERROR like the real driver, and fire the onReceive() callback.
+*
+* @api
+*/
+/*================================================================================================*/
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial(int uartNumber);
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1,
+               int8_t txPin = -1, bool invert = false, unsigned long timeoutMs = 20000UL,
+               uint8_t rxFifoFull = 112U);
+    void end(bool turnOffDebug = true);
+    void updateBaudRate(unsigned long baud);
+    uint32_t baudRate() const { return baud; }
+    size_t setRxBufferSize(size_t size);
+    bool setPins(int8_t rxPin, int8_t txPin, int8_t ctsPin = -1, int8_t rtsPin = -1);
+    bool setHwFlowCtrlMode(uint8_t mode = UART_HW_FLOWCTRL_CTS_RTS, uint8_t threshold = 64U);
+    bool setRxTimeout(uint8_t symbols) { (void)symbols; return true; }
+    void onReceive(OnReceiveCb function, bool onlyOnTimeout = false);
+    void onReceiveError(OnReceiveErrorCb function);
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t* data, size_t size) override;
+    using Print::write;
+    void flush() override {}
+    operator bool() const { return true; }
+
+    /* Host side: device connected to the TX/RX lines (NULL for none) */
+    void hostAttach(HostSerialDevice* device);
+    /* Host side: bytes arriving from the device; returns how many fit the driver buffer */
+    size_t hostReceive(const uint8_t* data, size_t size);
+    /* Host side: reports a receive error as the driver would */
+    void hostReceiveError(hardwareSerial_error_t error);
+    /* Host side: true while RTS/CTS is enabled */
+    bool hostFlowControl() const { return flowControl; }
+
+private:
+    int uartNumber;
+    uint32_t baud;
+    size_t rxBufferSize;
+    bool flowControl;
+    std::deque<uint8_t> rxBuffer;
+    HostSerialDevice* device;
+    OnReceiveCb receiveCallback;
+    OnReceiveErrorCb errorCallback;
+};
+
+/*================================================================================================*/
+/**
+* @class HostSerialDevice
+* @brief Peer of a simulated UART (e.g. the fake modem).
+*
+* @api
+*/
+/*================================================================================================*/
+class HostSerialDevice {
+public:
+    virtual ~HostSerialDevice() {}
+    /* A byte written by the firmware, at the firmware's current baud rate */
+    virtual void hostWrite(uint8_t value, uint32_t baud) = 0;
+};
+
+/*================================================================================================*/
+/**
+* @class EspClass
+* @brief Chip services used by the sketch.
+*
+* @api
+*/
+/*================================================================================================*/
+class EspClass {
+public:
+    /* Host CPU time scaled to 240 MHz cycles, for cost measurements */
+    uint32_t getCycleCount();
+    uint32_t getFreeHeap() { return 320U * 1024U; }
+    void restart();
+};
+
+/******************************************************************************
+ * FUNCTIONS PROTOTYPES
+ ******************************************************************************/
+/* Virtual time: advances only while every task sleeps (see HostSim.h) */
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+/* GPIO */
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(uint8_t interrupt, void (*function)(void), int mode);
+void attachInterruptArg(uint8_t interrupt, void (*function)(void*), void* argument, int mode);
+void detachInterrupt(uint8_t interrupt);
+void interrupts();
+void noInterrupts();
+
+/* Deterministic pseudo-random numbers */
+long random(long maximum);
+long random(long minimum, long maximum);
+void randomSeed(unsigned long seed);
+
+uint32_t getCpuFreqMhz();
+
+template <typename T> T min(T left, T right) { return (left < right) ? left : right; }
+template <typename T> T max(T left, T right) { return (left > right) ? left : right; }
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+extern HardwareSerial Serial;     /* Debug console (UART 0) */
+extern EspClass ESP;              /* Chip services */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#endif /* HOST_ARDUINO_H */
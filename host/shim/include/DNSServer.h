@@ -0,0 +1,26 @@
+#ifndef HOST_DNSSERVER_H
+#define HOST_DNSSERVER_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "IPAddress.h"
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/* Captive portal DNS; no client ever asks on the host */
+class DNSServer {
+public:
+    bool start(uint16_t port, const char* domain, const IPAddress& address) {
+        (void)port;
+        (void)domain;
+        (void)address;
+        return true;
+    }
+    void processNextRequest() {}
+    void stop() {}
+};
+
+#endif /* HOST_DNSSERVER_H */
@@ -0,0 +1,119 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <functional>
+#include <string>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Stack given to every simulated FreeRTOS task; host code needs far more than the ESP32 */
+#define HOST_TASK_STACK_SIZE      (256U * 1024U)
+
+/* Virtual time that never comes */
+#define HOST_TIME_NEVER           UINT64_MAX
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Returns the virtual time in microseconds since the start of the program.
+* @details      Time only moves while every task sleeps (delay(), vTaskDelay(), a notification or
+*               queue wait): it then jumps to the next wake-up or scheduled event. Code between
+*               two sleeps therefore runs in zero virtual time, so timings measured with millis()
+*               are modem and protocol latencies, never host CPU speed.
+*
+* @return       uint64_t    Virtual time (us).
+*
+* @api
+*/
+/*================================================================================================*/
+uint64_t hostNowUs();
+
+/*================================================================================================*/
+/**
+* @brief        Schedules an action at a virtual time.
+* @details      The action runs in interrupt context (xPortInIsrContext() is true) when the
+*               clock reaches atUs; actions due at the same time run in the order scheduled.
+*               Used by simulated devices to deliver bytes and by tests to script inputs.
+*
+* @param[in]    atUs        Virtual time (us); a time in the past runs at the next sleep.
+* @param[in]    action      Work to do.
+*
+* @return       void
+*
+* @api
+*/
+/*================================================================================================*/
+void hostAt(uint64_t atUs, std::function<void()> action);
+
+/* Same as hostAt(), relative to now (ms) */
+void hostAfterMs(uint32_t delayMs, std::function<void()> action);
+
+/*================================================================================================*/
+/**
+* @brief        Drives an input pin, running its interrupt handler on a matching edge.
+*
+* @param[in]    pin         GPIO number.
+* @param[in]    level       LOW or HIGH.
+*
+* @return       void
+*
+* @api
+*/
+/*================================================================================================*/
+void hostSetPin(uint8_t pin, uint8_t level);
+
+/* Level of a pin, as last written by the firmware or driven by hostSetPin() */
+uint8_t hostPinLevel(uint8_t pin);
+
+/* Number of level changes the firmware wrote to a pin */
+uint32_t hostPinToggles(uint8_t pin);
+
+/*================================================================================================*/
+/**
+* @brief        Queues text typed on the debug console (read through Serial).
+*
+* @param[in]    text        Characters, e.g. "!stats\n".
+*
+* @return       void
+*
+* @api
+*/
+/*================================================================================================*/
+void hostConsoleInput(const char* text);
+
+/*================================================================================================*/
+/**
+* @brief        Keeps console output in memory instead of printing it.
+*
+* @param[in]    capture     True to capture, false to print to stdout again.
+*
+* @return       void
+*
+* @api
+*/
+/*================================================================================================*/
+void hostCaptureConsole(bool capture);
+
+/* Returns the captured console output and clears it */
+std::string hostTakeConsole();
+
+/* Erases every Preferences namespace (a factory-fresh NVS partition) */
+void hostNvsClear();
+
+/* Number of Preferences put calls so far (flash writes) */
+uint32_t hostNvsWrites();
+
+/* Number of simulated FreeRTOS tasks, the loop task included */
+uint8_t hostTaskCount();
+
+/* Replaces what ESP.restart() does (default: print and exit) */
+void hostOnRestart(std::function<void()> handler);
+
+#endif /* HOST_SIM_H */
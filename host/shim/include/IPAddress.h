@@ -0,0 +1,29 @@
+#ifndef HOST_IPADDRESS_H
+#define HOST_IPADDRESS_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/* IPv4 address */
+class IPAddress {
+public:
+    IPAddress() : value(0U) {}
+    IPAddress(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth)
+        : value(((uint32_t)first << 24) | ((uint32_t)second << 16) | ((uint32_t)third << 8) | fourth) {}
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", (unsigned)(value >> 24), (unsigned)((value >> 16) & 0xFFU),
+                 (unsigned)((value >> 8) & 0xFFU), (unsigned)(value & 0xFFU));
+        return String(text);
+    }
+
+private:
+    uint32_t value;
+};
+
+#endif /* HOST_IPADDRESS_H */
@@ -0,0 +1,54 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class Preferences
+* @brief NVS key-value store of the ESP32 core, kept in host memory.
+* @details Behaves like the real partition where the sketch depends on it: a namespace opened
+* read-only that was never written does not exist and begin() fails, writes through a
+* read-only handle are refused, and the contents survive end()/begin() (but not the process).
+*
+* @api
+*/
+/*================================================================================================*/
+class Preferences {
+public:
+    Preferences() : opened(false), readOnly(false) {}
+
+    bool begin(const char* name, bool readOnly = false, const char* partition = NULL);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value);
+    size_t putUInt(const char* key, uint32_t value);
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value);
+    size_t putBytes(const char* key, const void* value, size_t length);
+
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0U);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0U);
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t length);
+
+private:
+    size_t put(const char* key, const void* value, size_t length);
+    const std::string* find(const char* key);
+
+    std::string space;
+    bool opened;
+    bool readOnly;
+};
+
+#endif /* HOST_PREFERENCES_H */
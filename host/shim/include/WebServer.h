@@ -0,0 +1,89 @@
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include <map>
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+typedef enum {
+    HTTP_ANY = 0,
+    HTTP_GET,
+    HTTP_POST
+} HTTPMethod;
+
+/* Response to a request made with WebServer::hostRequest() */
+typedef struct {
+    int code;
+    std::string contentType;
+    std::string body;
+} HostHttpResponse;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class WebServer
+* @brief HTTP server of the ESP32 core without sockets: requests come from hostRequest().
+*
+* @api
+*/
+/*================================================================================================*/
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    WebServer(int port = 80) { (void)port; }
+    void on(const char* uri, HTTPMethod method, THandlerFunction handler) {
+        routes[std::make_pair(std::string(uri), method)] = handler;
+    }
+    void begin() { started = true; }
+    void handleClient() {}
+    String arg(const char* name) const {
+        std::map<std::string, std::string>::const_iterator entry = arguments.find(name);
+        return (entry != arguments.end()) ? String(entry->second) : String();
+    }
+    bool hasArg(const char* name) const { return arguments.find(name) != arguments.end(); }
+    void send(int code, const char* contentType, const String& content) {
+        last.code = code;
+        last.contentType = contentType;
+        last.body = content.c_str();
+    }
+    void send(int code, const char* contentType, const char* content) {
+        send(code, contentType, String(content));
+    }
+    void send_P(int code, const char* contentType, const char* content, size_t length) {
+        last.code = code;
+        last.contentType = contentType;
+        last.body.assign(content, length);
+    }
+
+    /* Host side: runs the handler of a route as if a client had requested it */
+    HostHttpResponse hostRequest(HTTPMethod method, const char* uri,
+                                 const std::map<std::string, std::string>& requestArguments =
+                                     std::map<std::string, std::string>()) {
+        last.code = 404;
+        last.contentType = "text/plain";
+        last.body = "not found";
+        std::map<std::pair<std::string, HTTPMethod>, THandlerFunction>::iterator route =
+            routes.find(std::make_pair(std::string(uri), method));
+        if (started && route != routes.end()) {
+            arguments = requestArguments;
+            route->second();
+        }
+        return last;
+    }
+
+private:
+    std::map<std::pair<std::string, HTTPMethod>, THandlerFunction> routes;
+    std::map<std::string, std::string> arguments;
+    HostHttpResponse last;
+    bool started = false;
+};
+
+#endif /* HOST_WEBSERVER_H */
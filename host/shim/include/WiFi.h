@@ -0,0 +1,58 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+#include "IPAddress.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+#define WIFI_STA                  1
+#define WIFI_AP                   2
+#define WL_IDLE_STATUS            0
+#define WL_CONNECTED              3
+#define WL_DISCONNECTED           6
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/* Wi-Fi radio; a station connects only when the host made a network available */
+class WiFiClass {
+public:
+    WiFiClass() : connected(false), available(false) {}
+    bool mode(int mode) { (void)mode; return true; }
+    bool softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet) {
+        (void)local;
+        (void)gateway;
+        (void)subnet;
+        return true;
+    }
+    bool softAP(const char* ssid, const char* password) { (void)ssid; (void)password; return true; }
+    int begin(const char* ssid, const char* password) {
+        (void)ssid;
+        (void)password;
+        connected = available;
+        return status();
+    }
+    int status() const { return connected ? WL_CONNECTED : WL_DISCONNECTED; }
+    bool disconnect(bool wifiOff = false) { (void)wifiOff; connected = false; return true; }
+    IPAddress localIP() const { return connected ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+    int8_t RSSI() const { return connected ? -60 : 0; }
+
+    /* Host side: whether begin() finds the network */
+    void hostSetAvailable(bool isAvailable) { available = isAvailable; }
+
+private:
+    bool connected;
+    bool available;
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+extern WiFiClass WiFi;
+
+#endif /* HOST_WIFI_H */
@@ -0,0 +1,28 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/* I2C master; nothing is attached to the bus on the host */
+class TwoWire {
+public:
+    bool begin(int sdaPin = -1, int sclPin = -1, uint32_t frequency = 0U) {
+        (void)sdaPin;
+        (void)sclPin;
+        (void)frequency;
+        return true;
+    }
+};
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+extern TwoWire Wire;
+
+#endif /* HOST_WIRE_H */
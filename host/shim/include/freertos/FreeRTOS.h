@@ -0,0 +1,48 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+#define pdFALSE                   0
+#define pdTRUE                    1
+#define pdFAIL                    0
+#define pdPASS                    1
+#define portMAX_DELAY             0xFFFFFFFFUL
+
+/* One tick per millisecond, as configured for the Arduino core */
+#define portTICK_PERIOD_MS        1U
+#define pdMS_TO_TICKS(ms)         ((TickType_t)(ms))
+#define tskIDLE_PRIORITY          0U
+#define configMAX_PRIORITIES      25U
+
+/* Tasks are cooperative on the host, so critical sections need no lock */
+#define portMUX_INITIALIZER_UNLOCKED  { 0 }
+#define portENTER_CRITICAL(mux)       ((void)(mux))
+#define portEXIT_CRITICAL(mux)        ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)   ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)    ((void)(mux))
+#define portYIELD_FROM_ISR(woken)     ((void)(woken))
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef struct HostTask* TaskHandle_t;
+typedef struct HostQueue* QueueHandle_t;
+typedef struct { int owner; } portMUX_TYPE;
+
+/******************************************************************************
+ * FUNCTIONS PROTOTYPES
+ ******************************************************************************/
+/* True while a simulated interrupt handler runs */
+BaseType_t xPortInIsrContext();
+
+#endif /* HOST_FREERTOS_H */
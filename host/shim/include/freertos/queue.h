@@ -0,0 +1,27 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "FreeRTOS.h"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Control block storage of a static queue; the host keeps the queue itself on the heap */
+typedef struct { uint8_t reserved[80]; } StaticQueue_t;
+
+/******************************************************************************
+ * FUNCTIONS PROTOTYPES
+ ******************************************************************************/
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t* storage,
+                                 StaticQueue_t* control);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks);
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+#endif /* HOST_FREERTOS_QUEUE_H */
@@ -0,0 +1,29 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "FreeRTOS.h"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+typedef void (*TaskFunction_t)(void* parameter);
+
+/******************************************************************************
+ * FUNCTIONS PROTOTYPES
+ ******************************************************************************/
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackSize,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackSize,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityWoken);
+
+#endif /* HOST_FREERTOS_TASK_H */
@@ -0,0 +1,174 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "HostSim.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Receive buffer of the ESP32 UART driver unless setRxBufferSize() says otherwise */
+#define HOST_UART_RX_BUFFER_DEFAULT   256U
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Debug console input and captured output */
+static std::deque<uint8_t> consoleInput;
+static bool consoleCaptured = false;
+static std::string consoleOutput;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+size_t Print::printf(const char* format, ...) {
+    char buffer[512];
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, arguments);
+    va_end(arguments);
+    if (length < 0) {
+        return 0U;
+    }
+    size_t size = ((size_t)length < sizeof(buffer)) ? (size_t)length : sizeof(buffer) - 1U;
+    return write((const uint8_t*)buffer, size);
+}
+
+HardwareSerial::HardwareSerial(int uartNumber)
+    : uartNumber(uartNumber), baud(0U), rxBufferSize(HOST_UART_RX_BUFFER_DEFAULT),
+      flowControl(false), device(NULL) {
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin,
+                           bool invert, unsigned long timeoutMs, uint8_t rxFifoFull) {
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    (void)invert;
+    (void)timeoutMs;
+    (void)rxFifoFull;
+    this->baud = (uint32_t)baud;
+    rxBuffer.clear();
+}
+
+void HardwareSerial::end(bool turnOffDebug) {
+    (void)turnOffDebug;
+    baud = 0U;
+    flowControl = false;
+    rxBuffer.clear();
+}
+
+void HardwareSerial::updateBaudRate(unsigned long baud) {
+    this->baud = (uint32_t)baud;
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t size) {
+    rxBufferSize = size;
+    return size;
+}
+
+bool HardwareSerial::setPins(int8_t rxPin, int8_t txPin, int8_t ctsPin, int8_t rtsPin) {
+    (void)rxPin;
+    (void)txPin;
+    (void)ctsPin;
+    (void)rtsPin;
+    return true;
+}
+
+bool HardwareSerial::setHwFlowCtrlMode(uint8_t mode, uint8_t threshold) {
+    (void)threshold;
+    flowControl = (mode != UART_HW_FLOWCTRL_DISABLE);
+    return true;
+}
+
+void HardwareSerial::onReceive(OnReceiveCb function, bool onlyOnTimeout) {
+    (void)onlyOnTimeout;
+    receiveCallback = function;
+}
+
+void HardwareSerial::onReceiveError(OnReceiveErrorCb function) {
+    errorCallback = function;
+}
+
+int HardwareSerial::available() {
+    return (int)((uartNumber == 0) ? consoleInput.size() : rxBuffer.size());
+}
+
+int HardwareSerial::read() {
+    std::deque<uint8_t>& source = (uartNumber == 0) ? consoleInput : rxBuffer;
+    if (source.empty()) {
+        return -1;
+    }
+    uint8_t value = source.front();
+    source.pop_front();
+    return value;
+}
+
+int HardwareSerial::peek() {
+    std::deque<uint8_t>& source = (uartNumber == 0) ? consoleInput : rxBuffer;
+    return source.empty() ? -1 : source.front();
+}
+
+size_t HardwareSerial::write(uint8_t value) {
+    return write(&value, 1U);
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t size) {
+    if (uartNumber == 0) {
+        if (consoleCaptured) {
+            consoleOutput.append((const char*)data, size);
+        } else {
+            fwrite(data, 1U, size, stdout);
+        }
+        return size;
+    }
+    if (device != NULL && baud != 0U) {
+        for (size_t i = 0; i < size; i++) {
+            device->hostWrite(data[i], baud);
+        }
+    }
+    return size;
+}
+
+void HardwareSerial::hostAttach(HostSerialDevice* device) {
+    this->device = device;
+}
+
+size_t HardwareSerial::hostReceive(const uint8_t* data, size_t size) {
+    if (baud == 0U) {
+        return size;   /* Port closed: the bytes are lost on the wire */
+    }
+    size_t room = (rxBuffer.size() < rxBufferSize) ? rxBufferSize - rxBuffer.size() : 0U;
+    size_t accepted = (size < room) ? size : room;
+    rxBuffer.insert(rxBuffer.end(), data, data + accepted);
+    if (accepted > 0U && receiveCallback) {
+        receiveCallback();
+    }
+    if (accepted < size) {
+        if (flowControl) {
+            return accepted;   /* RTS deasserted: the sender holds the rest */
+        }
+        hostReceiveError(UART_BUFFER_FULL_ERROR);
+    }
+    return size;
+}
+
+void HardwareSerial::hostReceiveError(hardwareSerial_error_t error) {
+    if (errorCallback) {
+        errorCallback(error);
+    }
+}
+
+void hostConsoleInput(const char* text) {
+    consoleInput.insert(consoleInput.end(), text, text + strlen(text));
+}
+
+void hostCaptureConsole(bool capture) {
+    fflush(stdout);
+    consoleCaptured = capture;
+}
+
+std::string hostTakeConsole() {
+    std::string text;
+    text.swap(consoleOutput);
+    return text;
+}
@@ -0,0 +1,488 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "HostSim.h"
+#include <time.h>
+#include <ucontext.h>
+#include <map>
+#include <vector>
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* Simulated FreeRTOS task: a ucontext coroutine that runs until it blocks */
+struct HostTask {
+    ucontext_t context;
+    std::vector<uint8_t> stack;
+    TaskFunction_t function;
+    void* parameter;
+    UBaseType_t priority;
+    const char* name;
+    uint32_t notifyCount;
+    std::function<bool()> condition;   /* Wakes the task when true; empty = deadline only */
+    uint64_t wakeUs;                    /* Deadline of the wait, HOST_TIME_NEVER for none */
+    uint64_t blockSequence;             /* Orders equal-priority tasks by wait start */
+};
+
+/* FreeRTOS queue of fixed-size items */
+struct HostQueue {
+    size_t itemSize;
+    size_t length;
+    std::deque<std::vector<uint8_t> > items;
+};
+
+/* GPIO state and its interrupt handler */
+typedef struct {
+    uint8_t level;
+    uint32_t toggles;
+    int interruptMode;
+    void (*handler)(void);
+    void (*handlerArg)(void*);
+    void* argument;
+} HostPin;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+HardwareSerial Serial(0);
+EspClass ESP;
+
+/* Virtual clock and the actions scheduled on it */
+static uint64_t nowUs = 0U;
+static std::multimap<uint64_t, std::function<void()> >& eventQueue() {
+    static std::multimap<uint64_t, std::function<void()> > events;
+    return events;
+}
+
+/* Tasks; the first one is the Arduino loop task running main() */
+static std::vector<HostTask*>& taskList() {
+    static std::vector<HostTask*> tasks;
+    if (tasks.empty()) {
+        HostTask* loopTask = new HostTask();
+        loopTask->function = NULL;
+        loopTask->parameter = NULL;
+        loopTask->priority = 1U;
+        loopTask->name = "loopTask";
+        loopTask->notifyCount = 0U;
+        loopTask->wakeUs = HOST_TIME_NEVER;
+        loopTask->blockSequence = 0U;
+        tasks.push_back(loopTask);
+    }
+    return tasks;
+}
+static HostTask* currentTask = NULL;
+static uint64_t blockCounter = 0U;
+static bool inInterrupt = false;
+
+static HostPin pins[HOST_PIN_COUNT];
+static uint32_t randomState = 1U;
+static std::function<void()> restartHandler;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+static HostTask* runningTask() {
+    if (currentTask == NULL) {
+        currentTask = taskList()[0];
+    }
+    return currentTask;
+}
+
+/* Runs every action due at the current virtual time */
+static void runDueEvents() {
+    std::multimap<uint64_t, std::function<void()> >& events = eventQueue();
+    while (!events.empty() && events.begin()->first <= nowUs) {
+        std::function<void()> action = events.begin()->second;
+        events.erase(events.begin());
+        bool wasInInterrupt = inInterrupt;
+        inInterrupt = true;
+        action();
+        inInterrupt = wasInInterrupt;
+    }
+}
+
+static bool isReady(const HostTask* task) {
+    return (task->condition && task->condition()) || nowUs >= task->wakeUs;
+}
+
+/* Blocks the running task until condition() holds or the deadline passes, running the
+   other tasks and advancing the clock meanwhile */
+static void blockUntil(std::function<bool()> condition, uint64_t wakeUs) {
+    HostTask* self = runningTask();
+    if (inInterrupt) {
+        fprintf(stderr, "[HOST] blocking call from interrupt context\n");
+        abort();
+    }
+    self->condition = condition;
+    self->wakeUs = wakeUs;
+    self->blockSequence = ++blockCounter;
+
+    for (;;) {
+        runDueEvents();
+
+        HostTask* best = NULL;
+        for (HostTask* task : taskList()) {
+            if (task->function == NULL && task != taskList()[0]) {
+                continue;   /* Returned from its body */
+            }
+            if (!isReady(task)) {
+                continue;
+            }
+            if (best == NULL || task->priority > best->priority ||
+                (task->priority == best->priority && task->blockSequence < best->blockSequence)) {
+                best = task;
+            }
+        }
+
+        if (best != NULL) {
+            best->condition = std::function<bool()>();
+            best->wakeUs = HOST_TIME_NEVER;
+            if (best != self) {
+                currentTask = best;
+                swapcontext(&self->context, &best->context);
+                currentTask = self;
+            }
+            return;
+        }
+
+        /* Nothing can run: jump to the next deadline or event */
+        uint64_t nextUs = HOST_TIME_NEVER;
+        for (HostTask* task : taskList()) {
+            if (task->wakeUs < nextUs) {
+                nextUs = task->wakeUs;
+            }
+        }
+        if (!eventQueue().empty() && eventQueue().begin()->first < nextUs) {
+            nextUs = eventQueue().begin()->first;
+        }
+        if (nextUs == HOST_TIME_NEVER) {
+            fprintf(stderr, "[HOST] every task waits forever at %llu us\n",
+                    (unsigned long long)nowUs);
+            abort();
+        }
+        if (nextUs > nowUs) {
+            nowUs = nextUs;
+        }
+    }
+}
+
+/* Entry of a task coroutine; a body that returns is parked for good */
+static void taskTrampoline() {
+    HostTask* self = runningTask();
+    self->function(self->parameter);
+    self->function = NULL;
+    blockUntil(std::function<bool()>(), HOST_TIME_NEVER);
+}
+
+static uint64_t deadlineAfterTicks(TickType_t ticks) {
+    return (ticks == portMAX_DELAY) ? HOST_TIME_NEVER : nowUs + (uint64_t)ticks * 1000U;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+uint64_t hostNowUs() {
+    return nowUs;
+}
+
+void hostAt(uint64_t atUs, std::function<void()> action) {
+    eventQueue().insert(std::make_pair(atUs, action));
+}
+
+void hostAfterMs(uint32_t delayMs, std::function<void()> action) {
+    hostAt(nowUs + (uint64_t)delayMs * 1000U, action);
+}
+
+void hostSetPin(uint8_t pin, uint8_t level) {
+    if (pin >= HOST_PIN_COUNT || pins[pin].level == level) {
+        return;
+    }
+    HostPin& state = pins[pin];
+    state.level = level;
+    bool fires = (state.interruptMode == CHANGE) ||
+                 (state.interruptMode == RISING && level == HIGH) ||
+                 (state.interruptMode == FALLING && level == LOW);
+    if (!fires) {
+        return;
+    }
+    bool wasInInterrupt = inInterrupt;
+    inInterrupt = true;
+    if (state.handlerArg != NULL) {
+        state.handlerArg(state.argument);
+    } else if (state.handler != NULL) {
+        state.handler();
+    }
+    inInterrupt = wasInInterrupt;
+}
+
+uint8_t hostPinLevel(uint8_t pin) {
+    return (pin < HOST_PIN_COUNT) ? pins[pin].level : (uint8_t)LOW;
+}
+
+uint32_t hostPinToggles(uint8_t pin) {
+    return (pin < HOST_PIN_COUNT) ? pins[pin].toggles : 0U;
+}
+
+uint8_t hostTaskCount() {
+    return (uint8_t)taskList().size();
+}
+
+void hostOnRestart(std::function<void()> handler) {
+    restartHandler = handler;
+}
+
+/* Time */
+unsigned long millis() {
+    return (uint32_t)(nowUs / 1000U);
+}
+
+unsigned long micros() {
+    return (uint32_t)nowUs;
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay((TickType_t)ms);
+}
+
+void delayMicroseconds(uint32_t us) {
+    blockUntil(std::function<bool()>(), nowUs + us);
+}
+
+void yield() {
+    blockUntil([]() { return true; }, HOST_TIME_NEVER);
+}
+
+/* GPIO */
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < HOST_PIN_COUNT && mode == INPUT_PULLUP && pins[pin].toggles == 0U) {
+        pins[pin].level = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin >= HOST_PIN_COUNT) {
+        return;
+    }
+    uint8_t value = (level != LOW) ? (uint8_t)HIGH : (uint8_t)LOW;
+    if (pins[pin].level != value) {
+        pins[pin].level = value;
+        pins[pin].toggles++;
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return hostPinLevel(pin);
+}
+
+int analogRead(uint8_t pin) {
+    return (hostPinLevel(pin) == HIGH) ? 4095 : 0;
+}
+
+int digitalPinToInterrupt(int pin) {
+    return pin;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*function)(void), int mode) {
+    if (interrupt < HOST_PIN_COUNT) {
+        pins[interrupt].handler = function;
+        pins[interrupt].handlerArg = NULL;
+        pins[interrupt].interruptMode = mode;
+    }
+}
+
+void attachInterruptArg(uint8_t interrupt, void (*function)(void*), void* argument, int mode) {
+    if (interrupt < HOST_PIN_COUNT) {
+        pins[interrupt].handler = NULL;
+        pins[interrupt].handlerArg = function;
+        pins[interrupt].argument = argument;
+        pins[interrupt].interruptMode = mode;
+    }
+}
+
+void detachInterrupt(uint8_t interrupt) {
+    if (interrupt < HOST_PIN_COUNT) {
+        pins[interrupt].handler = NULL;
+        pins[interrupt].handlerArg = NULL;
+        pins[interrupt].interruptMode = 0;
+    }
+}
+
+void interrupts() {
+}
+
+void noInterrupts() {
+}
+
+/* Pseudo-random numbers (same sequence on every run) */
+long random(long maximum) {
+    return random(0, maximum);
+}
+
+long random(long minimum, long maximum) {
+    if (maximum <= minimum) {
+        return minimum;
+    }
+    randomState = randomState * 1103515245U + 12345U;
+    return minimum + (long)((randomState >> 8) % (uint32_t)(maximum - minimum));
+}
+
+void randomSeed(unsigned long seed) {
+    randomState = (uint32_t)seed;
+}
+
+uint32_t getCpuFreqMhz() {
+    return 240U;
+}
+
+/* FreeRTOS tasks */
+BaseType_t xPortInIsrContext() {
+    return inInterrupt ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackSize,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    (void)stackSize;
+    (void)core;
+    HostTask* task = new HostTask();
+    task->stack.resize(HOST_TASK_STACK_SIZE);
+    task->function = function;
+    task->parameter = parameter;
+    task->priority = priority;
+    task->name = name;
+    task->notifyCount = 0U;
+    task->condition = []() { return true; };
+    task->wakeUs = HOST_TIME_NEVER;
+    task->blockSequence = ++blockCounter;
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->stack.data();
+    task->context.uc_stack.ss_size = task->stack.size();
+    task->context.uc_link = NULL;
+    makecontext(&task->context, taskTrampoline, 0);
+    taskList().push_back(task);
+    if (handle != NULL) {
+        *handle = task;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackSize,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(function, name, stackSize, parameter, priority, handle, 0);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return runningTask();
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(nowUs / 1000U);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (ticks == 0U) {
+        yield();
+        return;
+    }
+    blockUntil(std::function<bool()>(), deadlineAfterTicks(ticks));
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask* self = runningTask();
+    if (self->notifyCount == 0U && ticks > 0U) {
+        blockUntil([self]() { return self->notifyCount > 0U; }, deadlineAfterTicks(ticks));
+    }
+    uint32_t value = self->notifyCount;
+    if (value > 0U) {
+        self->notifyCount = (clearOnExit != pdFALSE) ? 0U : value - 1U;
+    }
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (task != NULL) {
+        task->notifyCount++;
+    }
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityWoken != NULL) {
+        *higherPriorityWoken = pdFALSE;
+    }
+}
+
+/* FreeRTOS queues */
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue* queue = new HostQueue();
+    queue->itemSize = itemSize;
+    queue->length = length;
+    return queue;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t* storage,
+                                 StaticQueue_t* control) {
+    (void)storage;
+    (void)control;
+    return xQueueCreate(length, itemSize);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    if (queue->items.size() >= queue->length && ticks > 0U && !inInterrupt) {
+        blockUntil([queue]() { return queue->items.size() < queue->length; },
+                   deadlineAfterTicks(ticks));
+    }
+    if (queue->items.size() >= queue->length) {
+        return pdFAIL;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(item);
+    queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->itemSize));
+    return pdPASS;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks) {
+    if (queue->items.empty() && ticks > 0U && !inInterrupt) {
+        blockUntil([queue]() { return !queue->items.empty(); }, deadlineAfterTicks(ticks));
+    }
+    if (queue->items.empty()) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    if (xQueuePeek(queue, item, ticks) != pdTRUE) {
+        return pdFALSE;
+    }
+    queue->items.pop_front();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    return (UBaseType_t)queue->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    queue->items.clear();
+    return pdPASS;
+}
+
+/* Chip services */
+uint32_t EspClass::getCycleCount() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    return (uint32_t)(ns * 240U / 1000U);
+}
+
+void EspClass::restart() {
+    if (restartHandler) {
+        restartHandler();
+        return;
+    }
+    printf("[HOST] ESP.restart()\n");
+    fflush(stdout);
+    exit(0);
+}
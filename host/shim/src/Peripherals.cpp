@@ -0,0 +1,11 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Wire.h>
+#include <WiFi.h>
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+TwoWire Wire;
+WiFiClass WiFi;
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Preferences.h>
+#include "HostSim.h"
+#include <map>
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Namespace -> key -> value bytes */
+static std::map<std::string, std::map<std::string, std::string> > storage;
+static uint32_t writeCount = 0U;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+    (void)partition;
+    if (readOnly && storage.find(name) == storage.end()) {
+        return false;
+    }
+    storage[name];
+    space = name;
+    opened = true;
+    this->readOnly = readOnly;
+    return true;
+}
+
+void Preferences::end() {
+    opened = false;
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) {
+        return false;
+    }
+    storage[space].clear();
+    writeCount++;
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly) {
+        return false;
+    }
+    writeCount++;
+    return storage[space].erase(key) > 0U;
+}
+
+bool Preferences::isKey(const char* key) {
+    return find(key) != NULL;
+}
+
+size_t Preferences::putUChar(const char* key, uint8_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    return put(key, value, strlen(value));
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+    return putString(key, value.c_str());
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    return put(key, value, length);
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) {
+    const std::string* value = find(key);
+    return (value != NULL && value->size() == sizeof(uint8_t)) ? (uint8_t)(*value)[0] : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    const std::string* value = find(key);
+    uint32_t result = defaultValue;
+    if (value != NULL && value->size() == sizeof(result)) {
+        memcpy(&result, value->data(), sizeof(result));
+    }
+    return result;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    const std::string* value = find(key);
+    return (value != NULL) ? String(*value) : defaultValue;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    const std::string* value = find(key);
+    return (value != NULL) ? value->size() : 0U;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t length) {
+    const std::string* value = find(key);
+    if (value == NULL || value->size() > length) {
+        return 0U;
+    }
+    memcpy(buffer, value->data(), value->size());
+    return value->size();
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+size_t Preferences::put(const char* key, const void* value, size_t length) {
+    if (!opened || readOnly) {
+        return 0U;
+    }
+    storage[space][key] = std::string(static_cast<const char*>(value), length);
+    writeCount++;
+    return length;
+}
+
+const std::string* Preferences::find(const char* key) {
+    if (!opened) {
+        return NULL;
+    }
+    std::map<std::string, std::string>& keys = storage[space];
+    std::map<std::string, std::string>::const_iterator entry = keys.find(key);
+    return (entry != keys.end()) ? &entry->second : NULL;
+}
+
+void hostNvsClear() {
+    storage.clear();
+}
+
+uint32_t hostNvsWrites() {
+    return writeCount;
+}
@@ -0,0 +1,552 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "FakeModem.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Service centre the module prefixes to received PDUs */
+#define FAKE_MODEM_SMSC_PDU       "07914400000000F0"
+
+/* Service centre time stamp of injected messages (2026-10-16 10:15:00 +02:00) */
+#define FAKE_MODEM_SCTS_TEXT      "26/10/16,10:15:00+08"
+#define FAKE_MODEM_SCTS_PDU       "62016101510080"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* True if text starts with prefix */
+static bool startsWith(const std::string& text, const char* prefix) {
+    return text.compare(0, strlen(prefix), prefix) == 0;
+}
+
+/* Appends one octet as two upper-case hex digits */
+static void appendHex(std::string& out, uint8_t value) {
+    static const char DIGITS[] = "0123456789ABCDEF";
+    out += DIGITS[value >> 4];
+    out += DIGITS[value & 0x0FU];
+}
+
+/* Maps an ASCII character to the GSM 7-bit default alphabet; 0xFF if it has no basic code */
+static uint8_t asciiToGsm7(char c) {
+    switch (c) {
+    case '@': return 0x00U;
+    case '$': return 0x02U;
+    case '_': return 0x11U;
+    case '\n': return 0x0AU;
+    case '\r': return 0x0DU;
+    default: break;
+    }
+    if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+        strchr(" !\"#%&'()*+,-./:;<=>?", c) != NULL) {
+        return (uint8_t)c;
+    }
+    return 0xFFU;
+}
+
+/* Decodes UTF-8 into UTF-16 code units (BMP only) */
+static std::vector<uint16_t> utf8ToUcs2(const std::string& text) {
+    std::vector<uint16_t> units;
+    for (size_t i = 0; i < text.size();) {
+        uint8_t lead = (uint8_t)text[i];
+        if (lead < 0x80U) {
+            units.push_back(lead);
+            i += 1U;
+        } else if ((lead & 0xE0U) == 0xC0U && i + 1U < text.size()) {
+            units.push_back((uint16_t)(((lead & 0x1FU) << 6) | (text[i + 1U] & 0x3FU)));
+            i += 2U;
+        } else if ((lead & 0xF0U) == 0xE0U && i + 2U < text.size()) {
+            units.push_back((uint16_t)(((lead & 0x0FU) << 12) | ((text[i + 1U] & 0x3FU) << 6) |
+                                       (text[i + 2U] & 0x3FU)));
+            i += 3U;
+        } else {
+            units.push_back(0xFFFDU);
+            i += 1U;
+        }
+    }
+    return units;
+}
+
+/* Builds the hex SMS-DELIVER TPDU (without service centre) of a single-part message: GSM 7-bit
+   when every character has a basic code, UCS-2 otherwise */
+static std::string encodeDeliverPdu(const std::string& sender, const std::string& text) {
+    std::string pdu = "04";   /* SMS-DELIVER, no more messages to send */
+
+    std::string digits = (sender[0] == '+') ? sender.substr(1) : sender;
+    appendHex(pdu, (uint8_t)digits.size());
+    appendHex(pdu, (sender[0] == '+') ? 0x91U : 0x81U);
+    std::string padded = (digits.size() % 2U != 0U) ? digits + "F" : digits;
+    for (size_t i = 0; i < padded.size(); i += 2U) {
+        pdu += padded[i + 1U];
+        pdu += padded[i];
+    }
+    pdu += "00";   /* TP-PID */
+
+    std::vector<uint8_t> septets;
+    bool gsm7 = true;
+    for (char c : text) {
+        uint8_t code = asciiToGsm7(c);
+        if (code == 0xFFU) {
+            gsm7 = false;
+            break;
+        }
+        septets.push_back(code);
+    }
+
+    if (gsm7) {
+        pdu += "00";
+        pdu += FAKE_MODEM_SCTS_PDU;
+        appendHex(pdu, (uint8_t)septets.size());
+        uint32_t accumulator = 0U;
+        uint8_t bits = 0U;
+        for (uint8_t septet : septets) {
+            accumulator |= (uint32_t)septet << bits;
+            bits = (uint8_t)(bits + 7U);
+            while (bits >= 8U) {
+                appendHex(pdu, (uint8_t)(accumulator & 0xFFU));
+                accumulator >>= 8;
+                bits = (uint8_t)(bits - 8U);
+            }
+        }
+        if (bits > 0U) {
+            appendHex(pdu, (uint8_t)(accumulator & 0xFFU));
+        }
+    } else {
+        std::vector<uint16_t> units = utf8ToUcs2(text);
+        pdu += "08";
+        pdu += FAKE_MODEM_SCTS_PDU;
+        appendHex(pdu, (uint8_t)(units.size() * 2U));
+        for (uint16_t unit : units) {
+            appendHex(pdu, (uint8_t)(unit >> 8));
+            appendHex(pdu, (uint8_t)(unit & 0xFFU));
+        }
+    }
+    return pdu;
+}
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @brief        Attaches the module to a UART.
+* @details      The settings start at the factory values (text mode off, no URCs, echo on); the
+*               module announces itself with RDY once booted.
+*
+* @param[in]    port        UART of the firmware the module is wired to.
+* @param[in]    bootMs      Time from now until the module answers commands (ms).
+*
+* @return       N/A
+*/
+/*================================================================================================*/
+FakeModem::FakeModem(HardwareSerial& port, uint32_t bootMs)
+    : port(port), readyAtUs(hostNowUs() + (uint64_t)bootMs * 1000U),
+      baudRate(FAKE_MODEM_FACTORY_BAUD), maxReliableBaud(0U), commandCounter(0U), echo(true),
+      inData(false), dataIndex(0U), lineFreeAtUs(0U),
+      retryScheduled(false), hasFix(false), fixLatitude(0.0), fixLongitude(0.0),
+      callOutcome(FAKE_CALL_ANSWERED), callState(CALL_IDLE), callGeneration(0U), smsError(0),
+      messageReference(0U), randomState(7U), alive(std::make_shared<bool>(true)) {
+    latencies.commandMs = 20U;
+    latencies.jitterMs = 10U;
+    latencies.gnssMs = 40U;
+    latencies.promptMs = 30U;
+    latencies.smsNetworkMs = 2500U;
+    latencies.dialMs = 300U;
+    latencies.alertingMs = 2000U;
+    latencies.ringMs = 6000U;
+
+    settings["+CMGF"] = "0";
+    settings["+CSCS"] = "\"IRA\"";
+    settings["+CNMI"] = "2,1,0,0,0";
+    settings["+CLIP"] = "0,1";
+    settings["+CLCC"] = "0";
+    settings["+AUTOCSQ"] = "0,0";
+    settings["+CGPS"] = "0,1";
+    settings["+IFC"] = "0,0";
+
+    port.hostAttach(this);
+    if (bootMs > 0U) {
+        reply("RDY", bootMs);
+    }
+}
+
+FakeModem::~FakeModem() {
+    *alive = false;
+    port.hostAttach(NULL);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sets the position reported by AT+CGPSINFO.
+*/
+/*================================================================================================*/
+void FakeModem::setFix(double latitude, double longitude) {
+    hasFix = true;
+    fixLatitude = latitude;
+    fixLongitude = longitude;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Replaces the built-in answer to commands starting with prefix.
+* @details      Handlers registered later win; a handler returning false falls back.
+*/
+/*================================================================================================*/
+void FakeModem::on(const char* prefix, Handler handler) {
+    handlers.insert(handlers.begin(), std::make_pair(std::string(prefix), handler));
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sends response lines, each framed by CR LF as the module does.
+*/
+/*================================================================================================*/
+void FakeModem::reply(const std::string& lines, uint32_t delayMs) {
+    std::string bytes;
+    size_t start = 0U;
+    for (;;) {
+        size_t end = lines.find('\n', start);
+        bytes += "\r\n" + lines.substr(start, end - start) + "\r\n";
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1U;
+    }
+    send(bytes, delayMs);
+}
+
+/*================================================================================================*/
+/**
+* @brief        Sends raw bytes after delayMs, once the line is free, taking their wire time.
+*/
+/*================================================================================================*/
+void FakeModem::send(const std::string& bytes, uint32_t delayMs) {
+    transmit(bytes, delayMs, std::function<void()>());
+}
+
+/*================================================================================================*/
+/**
+* @brief        Delivers a received SMS as +CMT in the current message format.
+* @details      Text mode: +CMT: "<oa>","","<scts>" followed by the text. PDU mode: +CMT: ,<length>
+*               followed by the hex SMS-DELIVER (service centre included).
+*/
+/*================================================================================================*/
+void FakeModem::injectSms(const std::string& sender, const std::string& text, uint32_t delayMs) {
+    std::shared_ptr<bool> guard = alive;
+    hostAfterMs(delayMs, [this, guard, sender, text]() {
+        if (!*guard) {
+            return;
+        }
+        if (setting("+CMGF") == "1") {
+            reply("+CMT: \"" + sender + "\",\"\",\"" FAKE_MODEM_SCTS_TEXT "\"\n" + text);
+        } else {
+            std::string tpdu = encodeDeliverPdu(sender, text);
+            reply("+CMT: ," + std::to_string(tpdu.size() / 2U) + "\n" FAKE_MODEM_SMSC_PDU + tpdu);
+        }
+    });
+}
+
+/*================================================================================================*/
+/**
+* @brief        Counts the received commands starting with prefix.
+*/
+/*================================================================================================*/
+size_t FakeModem::count(const char* prefix) const {
+    size_t total = 0U;
+    for (const FakeModemCommand& command : received) {
+        if (startsWith(command.text, prefix)) {
+            total++;
+        }
+    }
+    return total;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the last received command starting with prefix, or NULL.
+*/
+/*================================================================================================*/
+const FakeModemCommand* FakeModem::last(const char* prefix) const {
+    for (size_t i = received.size(); i > 0U; i--) {
+        if (startsWith(received[i - 1U].text, prefix)) {
+            return &received[i - 1U];
+        }
+    }
+    return NULL;
+}
+
+/*================================================================================================*/
+/**
+* @brief        Returns the current value of a setting, e.g. setting("+CMGF") -> "1".
+*/
+/*================================================================================================*/
+std::string FakeModem::setting(const char* name) const {
+    std::map<std::string, std::string>::const_iterator entry = settings.find(name);
+    return (entry != settings.end()) ? entry->second : std::string();
+}
+
+/*================================================================================================*/
+/**
+* @brief        Receives one byte written by the firmware.
+* @details      Bytes sent before the module booted, or at a rate it is not listening on, are
+*               lost. A command runs on its CR from the last "AT" on the line, so garbage left
+*               by a rate mismatch does not hide the next command. While AT+CMGS waits for its
+*               data, Ctrl+Z sends the message and ESC cancels it.
+*/
+/*================================================================================================*/
+void FakeModem::hostWrite(uint8_t value, uint32_t baud) {
+    if (hostNowUs() < readyAtUs || baud != baudRate) {
+        return;
+    }
+
+    if (inData) {
+        if (value == 0x1AU || value == 0x1BU) {
+            finishData(value == 0x1BU);
+        } else {
+            data += (char)value;
+        }
+        return;
+    }
+
+    if (value == '\n') {
+        return;
+    }
+    if (value != '\r') {
+        input += (char)value;
+        return;
+    }
+
+    std::string line;
+    line.swap(input);
+    size_t start = line.rfind("AT");
+    size_t lower = line.rfind("at");
+    if (start == std::string::npos || (lower != std::string::npos && lower > start)) {
+        start = lower;
+    }
+    if (start == std::string::npos) {
+        return;
+    }
+    line = line.substr(start);
+
+    /* Above the reliable rate the line corrupts every other command */
+    commandCounter++;
+    if (maxReliableBaud != 0U && baudRate > maxReliableBaud && (commandCounter % 2U) == 0U) {
+        return;
+    }
+
+    FakeModemCommand command = { (uint32_t)millis(), line, std::string(), false };
+    received.push_back(command);
+    if (echo) {
+        send(line + "\r");
+    }
+    for (const std::pair<std::string, Handler>& handler : handlers) {
+        if (startsWith(line, handler.first.c_str()) && handler.second(*this, line)) {
+            return;
+        }
+    }
+    answerBuiltIn(line);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+/* Answers a command the way the SIM7600 does */
+void FakeModem::answerBuiltIn(const std::string& command) {
+    uint32_t delayMs = commandDelayMs();
+
+    if (command == "AT" || command == "at") {
+        reply("OK", delayMs);
+    } else if (command == "ATE0" || command == "ATE1") {
+        echo = (command == "ATE1");
+        reply("OK", delayMs);
+    } else if (startsWith(command, "AT+IPR=")) {
+        /* OK goes out at the old rate; the module listens on the new one right after */
+        uint32_t newBaud = (uint32_t)strtoul(command.c_str() + 7, NULL, 10);
+        std::shared_ptr<bool> guard = alive;
+        transmit("\r\nOK\r\n", delayMs, [this, guard, newBaud]() {
+            if (*guard) {
+                baudRate = newBaud;
+            }
+        });
+    } else if (command == "AT+CSQ") {
+        reply("+CSQ: 21,99\n\nOK", delayMs);
+    } else if (command == "AT+CGPSINFO") {
+        char text[96];
+        if (hasFix) {
+            double latitude = fabs(fixLatitude);
+            double longitude = fabs(fixLongitude);
+            double latitudeField = floor(latitude) * 100.0 + (latitude - floor(latitude)) * 60.0;
+            double longitudeField = floor(longitude) * 100.0 + (longitude - floor(longitude)) * 60.0;
+            snprintf(text, sizeof(text), "+CGPSINFO: %.6f,%c,%.6f,%c,161026,101500.0,44.1,0.0,",
+                     latitudeField, (fixLatitude < 0.0) ? 'S' : 'N', longitudeField,
+                     (fixLongitude < 0.0) ? 'W' : 'E');
+        } else {
+            snprintf(text, sizeof(text), "+CGPSINFO: ,,,,,,,,");
+        }
+        reply(std::string(text) + "\n\nOK", latencies.gnssMs + delayMs - latencies.commandMs);
+    } else if (startsWith(command, "ATD")) {
+        if (callState != CALL_IDLE) {
+            reply("ERROR", delayMs);
+            return;
+        }
+        std::string number = command.substr(3, command.find(';') - 3U);
+        startCall(number);
+    } else if (command == "ATH") {
+        reply("OK", delayMs);
+        if (callState != CALL_IDLE) {
+            callGeneration++;
+            callState = CALL_IDLE;
+            reply(clccLine(6), delayMs);
+        }
+    } else if (startsWith(command, "AT+CMGS=")) {
+        /* The prompt follows; everything until Ctrl+Z or ESC is the message */
+        inData = true;
+        data.clear();
+        dataIndex = received.size() - 1U;
+        send("\r\n> ", latencies.promptMs);
+    } else if (command.size() > 3U && command[2] == '+') {
+        size_t separator = command.find_first_of("=?", 3);
+        std::string name = command.substr(2, separator - 2U);
+        if (separator == std::string::npos) {
+            reply("OK", delayMs);
+        } else if (command.compare(separator, 2, "=?") == 0) {
+            reply("OK", delayMs);
+        } else if (command[separator] == '?') {
+            std::string value = setting(name.c_str());
+            reply(value.empty() ? std::string("OK") : name + ": " + value + "\n\nOK", delayMs);
+        } else {
+            settings[name] = command.substr(separator + 1U);
+            reply("OK", delayMs);
+        }
+    } else {
+        reply("OK", delayMs);
+    }
+}
+
+/* Ends the data of AT+CMGS: ESC cancels the message, Ctrl+Z hands it to the network */
+void FakeModem::finishData(bool cancelled) {
+    inData = false;
+    FakeModemCommand& command = received[dataIndex];
+    command.body = data;
+    command.cancelled = cancelled;
+    if (cancelled) {
+        reply("OK", commandDelayMs());
+        return;
+    }
+    if (smsError != 0) {
+        reply("+CMS ERROR: " + std::to_string(smsError), latencies.smsNetworkMs);
+        return;
+    }
+    messageReference = (uint16_t)((messageReference + 1U) & 0xFFU);
+    reply("+CMGS: " + std::to_string(messageReference) + "\n\nOK", latencies.smsNetworkMs);
+}
+
+/* Dials: OK, then +CLCC dialing, alerting and the outcome of the call */
+void FakeModem::startCall(const std::string& number) {
+    callNumber = number;
+    callState = CALL_DIALING;
+    uint32_t generation = ++callGeneration;
+    reply("OK", latencies.dialMs);
+    reply(clccLine(2), latencies.dialMs);
+
+    std::shared_ptr<bool> guard = alive;
+    uint32_t alertingMs = latencies.alertingMs;
+    uint32_t outcomeMs = latencies.alertingMs + latencies.ringMs;
+    FakeCallOutcome outcome = callOutcome;
+    hostAfterMs(alertingMs, [this, guard, generation, outcome]() {
+        if (!*guard || generation != callGeneration) {
+            return;
+        }
+        if (outcome == FAKE_CALL_REJECTED) {
+            callState = CALL_IDLE;
+            reply(clccLine(6) + "\nNO CARRIER");
+        } else if (outcome == FAKE_CALL_BUSY) {
+            callState = CALL_IDLE;
+            reply(clccLine(6) + "\nBUSY");
+        } else {
+            callState = CALL_ALERTING;
+            reply(clccLine(3));
+        }
+    });
+    hostAfterMs(outcomeMs, [this, guard, generation, outcome]() {
+        if (!*guard || generation != callGeneration || callState != CALL_ALERTING) {
+            return;
+        }
+        if (outcome == FAKE_CALL_ANSWERED) {
+            callState = CALL_ACTIVE;
+            reply(clccLine(0));
+        } else {
+            callState = CALL_IDLE;
+            reply(clccLine(6) + "\nNO ANSWER");
+        }
+    });
+}
+
+/* +CLCC report of the outgoing voice call in the given state */
+std::string FakeModem::clccLine(int state) const {
+    return "+CLCC: 1,0," + std::to_string(state) + ",0,0,\"" + callNumber + "\",129";
+}
+
+/* Result code latency of a plain command, with jitter */
+uint32_t FakeModem::commandDelayMs() {
+    randomState = randomState * 1103515245U + 12345U;
+    uint32_t jitter = (latencies.jitterMs > 0U) ? (randomState >> 8) % (latencies.jitterMs + 1U) : 0U;
+    return latencies.commandMs + jitter;
+}
+
+/* Puts bytes on the line after delayMs and behind anything already on it; sent runs once the
+   last byte is on the wire */
+void FakeModem::transmit(const std::string& bytes, uint32_t delayMs, std::function<void()> sent) {
+    std::shared_ptr<bool> guard = alive;
+    hostAfterMs(delayMs, [this, guard, bytes, sent]() {
+        if (!*guard) {
+            return;
+        }
+        uint64_t startUs = (lineFreeAtUs > hostNowUs()) ? lineFreeAtUs : hostNowUs();
+        uint32_t baud = baudRate;
+        uint64_t wireUs = (uint64_t)bytes.size() * FAKE_MODEM_BITS_PER_BYTE * 1000000U / baud;
+        lineFreeAtUs = startUs + wireUs;
+        hostAt(lineFreeAtUs, [this, guard, bytes, baud, sent]() {
+            if (!*guard) {
+                return;
+            }
+            deliver(bytes, baud);
+            if (sent) {
+                sent();
+            }
+        });
+    });
+}
+
+/* Hands bytes to the UART; at a different rate they arrive as framing errors */
+void FakeModem::deliver(const std::string& bytes, uint32_t baud) {
+    if (port.baudRate() != baud) {
+        port.hostReceiveError(UART_FRAME_ERROR);
+        return;
+    }
+    held.insert(held.end(), bytes.begin(), bytes.end());
+    flushHeld();
+}
+
+/* Sends the bytes held back while RTS was deasserted */
+void FakeModem::flushHeld() {
+    while (!held.empty()) {
+        std::vector<uint8_t> chunk(held.begin(), held.end());
+        size_t accepted = port.hostReceive(chunk.data(), chunk.size());
+        held.erase(held.begin(), held.begin() + accepted);
+        if (accepted < chunk.size()) {
+            break;
+        }
+    }
+    if (!held.empty() && !retryScheduled) {
+        retryScheduled = true;
+        std::shared_ptr<bool> guard = alive;
+        hostAt(hostNowUs() + FAKE_MODEM_RTS_RETRY_US, [this, guard]() {
+            if (*guard) {
+                retryScheduled = false;
+                flushHeld();
+            }
+        });
+    }
+}
@@ -0,0 +1,202 @@
+#ifndef FAKE_MODEM_H
+#define FAKE_MODEM_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "HostSim.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Rate the module listens on out of the factory */
+#define FAKE_MODEM_FACTORY_BAUD   115200UL
+
+/* UART bits per byte on the wire (start + 8 data + stop) */
+#define FAKE_MODEM_BITS_PER_BYTE  10U
+
+/* Retry interval while the host UART holds RTS deasserted (us) */
+#define FAKE_MODEM_RTS_RETRY_US   500U
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* How an outgoing voice call ends */
+typedef enum {
+    FAKE_CALL_ANSWERED = 0,   /* Dialing, alerting, then active until ATH */
+    FAKE_CALL_BUSY,           /* Dialing, then BUSY */
+    FAKE_CALL_NO_ANSWER,      /* Dialing, alerting, then NO ANSWER */
+    FAKE_CALL_REJECTED        /* Dialing, then NO CARRIER without alerting */
+} FakeCallOutcome;
+
+/* A command received from the firmware */
+typedef struct {
+    uint32_t    atMs;         /* millis() when its CR arrived */
+    std::string text;         /* Command line without CR */
+    std::string body;         /* Data sent on the "> " prompt (AT+CMGS), without Ctrl+Z */
+    bool        cancelled;    /* The data was cancelled with ESC */
+} FakeModemCommand;
+
+/* Latencies of the simulated module (ms) */
+typedef struct {
+    uint32_t commandMs;       /* Plain command to its result code */
+    uint32_t jitterMs;        /* Random extra delay added to commandMs */
+    uint32_t gnssMs;          /* AT+CGPSINFO to its response */
+    uint32_t promptMs;        /* AT+CMGS to the "> " prompt */
+    uint32_t smsNetworkMs;    /* Ctrl+Z to +CMGS (network round trip) */
+    uint32_t dialMs;          /* ATD to its OK */
+    uint32_t alertingMs;      /* ATD to the callee's phone ringing */
+    uint32_t ringMs;          /* Ringing to the outcome of the call */
+} FakeModemTiming;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+/*================================================================================================*/
+/**
+* @class FakeModem
+* @brief Scriptable SIM7600-style GSM/GNSS module attached to a simulated UART.
+* @details Answers the commands the firmware sends with the result codes, URCs and latencies of
+* the real module: boot delay (no answer, then RDY), echo until ATE0, AT+IPR switching after
+* its OK, garbled bytes when the two sides disagree on the baud rate, the "> " prompt and
+* network round trip of AT+CMGS, +CLCC progress of outgoing calls and AT+CGPSINFO for a
+* configurable fix. Responses take their UART wire time at the current rate and wait while the
+* host holds RTS. Tests override any command with on() and inject URCs or received SMS.
+*
+* @api
+*/
+/*================================================================================================*/
+class FakeModem : public HostSerialDevice {
+public:
+    /* Custom answer to a command; return false to fall back to the built-in answer */
+    typedef std::function<bool(FakeModem& modem, const std::string& command)> Handler;
+
+    /*============================================================================================*/
+    /**
+    * @brief        Attaches the module to a UART.
+    *
+    * @param[in]    port        UART of the firmware the module is wired to.
+    * @param[in]    bootMs      Time from now until the module answers commands (ms).
+    */
+    /*============================================================================================*/
+    FakeModem(HardwareSerial& port, uint32_t bootMs = 0U);
+    ~FakeModem();
+
+    /* Latencies in use; change them before the commands they apply to */
+    FakeModemTiming& timing() { return latencies; }
+
+    /* Rate the module listens on (as stored by an earlier AT+IPR) */
+    void setBaud(uint32_t baud) { baudRate = baud; }
+    uint32_t baud() const { return baudRate; }
+
+    /* Above this rate every other command is lost on the line (0 = any rate works) */
+    void setMaxReliableBaud(uint32_t baud) { maxReliableBaud = baud; }
+
+    /* Position reported by AT+CGPSINFO; clearFix() reports an empty response */
+    void setFix(double latitude, double longitude);
+    void clearFix() { hasFix = false; }
+
+    /* Outcome of the next outgoing calls */
+    void setCallOutcome(FakeCallOutcome outcome) { callOutcome = outcome; }
+
+    /* Result of the next AT+CMGS: 0 sends, otherwise "+CMS ERROR: <code>" */
+    void setSmsError(int code) { smsError = code; }
+
+    /* Replaces the built-in answer to commands starting with prefix */
+    void on(const char* prefix, Handler handler);
+
+    /*============================================================================================*/
+    /**
+    * @brief        Sends response lines, each framed by CR LF as the module does.
+    *
+    * @param[in]    lines       Lines separated by '\n'.
+    * @param[in]    delayMs     Delay before the first byte goes on the wire.
+    */
+    /*============================================================================================*/
+    void reply(const std::string& lines, uint32_t delayMs = 0U);
+
+    /* Sends raw bytes (e.g. "\r\n> ") */
+    void send(const std::string& bytes, uint32_t delayMs = 0U);
+
+    /* Sends an unsolicited result code; same as reply() */
+    void urc(const std::string& lines, uint32_t delayMs = 0U) { reply(lines, delayMs); }
+
+    /* Delivers a received SMS as +CMT in the current message format (AT+CMGF) */
+    void injectSms(const std::string& sender, const std::string& text, uint32_t delayMs = 0U);
+
+    /* Commands received so far */
+    const std::vector<FakeModemCommand>& commands() const { return received; }
+
+    /* Number of received commands starting with prefix */
+    size_t count(const char* prefix) const;
+
+    /* Last received command starting with prefix, or NULL */
+    const FakeModemCommand* last(const char* prefix) const;
+
+    /* Current value of a setting, e.g. setting("+CMGF") */
+    std::string setting(const char* name) const;
+
+    /* True while an outgoing call is dialing, ringing or active */
+    bool callInProgress() const { return callState != CALL_IDLE; }
+
+    void hostWrite(uint8_t value, uint32_t baud) override;
+
+private:
+    typedef enum {
+        CALL_IDLE = 0,
+        CALL_DIALING,
+        CALL_ALERTING,
+        CALL_ACTIVE
+    } CallState;
+
+    void answerBuiltIn(const std::string& command);
+    void finishData(bool cancelled);
+    void startCall(const std::string& number);
+    std::string clccLine(int state) const;
+    uint32_t commandDelayMs();
+    void transmit(const std::string& bytes, uint32_t delayMs, std::function<void()> sent);
+    void deliver(const std::string& bytes, uint32_t baud);
+    void flushHeld();
+
+    /* UART of the firmware */
+    HardwareSerial& port;
+    FakeModemTiming latencies;
+    /* Boot: nothing is understood before this virtual time */
+    uint64_t readyAtUs;
+    /* Line state */
+    uint32_t baudRate;
+    uint32_t maxReliableBaud;
+    uint32_t commandCounter;
+    bool echo;
+    std::string input;
+    /* AT+CMGS data: collected until Ctrl+Z or ESC, stored with received[dataIndex] */
+    bool inData;
+    std::string data;
+    size_t dataIndex;
+    /* Transmit side: end of the last scheduled byte and bytes refused while RTS is deasserted */
+    uint64_t lineFreeAtUs;
+    std::deque<uint8_t> held;
+    bool retryScheduled;
+    std::vector<FakeModemCommand> received;
+    std::vector<std::pair<std::string, Handler> > handlers;
+    std::map<std::string, std::string> settings;
+    /* GNSS, call and SMS behaviour */
+    bool hasFix;
+    double fixLatitude;
+    double fixLongitude;
+    FakeCallOutcome callOutcome;
+    CallState callState;
+    uint32_t callGeneration;
+    std::string callNumber;
+    int smsError;
+    uint16_t messageReference;
+    uint32_t randomState;
+    /* Cleared on destruction so scheduled answers of a destroyed module are dropped */
+    std::shared_ptr<bool> alive;
+};
+
+#endif /* FAKE_MODEM_H */
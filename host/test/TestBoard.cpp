@@ -0,0 +1,10 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <Arduino.h>
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* UART of the GSM/GNSS module; defined by the sketch on the device */
+HardwareSerial gsmSerialPort(1);
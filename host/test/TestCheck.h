@@ -0,0 +1,77 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Defines a test case; every case of the executable runs in definition order */
+#define TEST_CASE(name)                                                                          \
+    static void name();                                                                          \
+    static TestRegistration name##Registration(#name, name);                                     \
+    static void name()
+
+/* Records a failure and carries on with the case */
+#define CHECK(condition)                                                                         \
+    testCheck((condition), #condition, __FILE__, __LINE__)
+
+/* Same, printing both values on failure */
+#define CHECK_EQ(actual, expected)                                                               \
+    testCheckEqual((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+typedef void (*TestFunction)();
+
+/* Adds a case to the list run by main() (TestMain.cpp) */
+struct TestRegistration {
+    TestRegistration(const char* name, TestFunction function);
+};
+
+/******************************************************************************
+ * FUNCTIONS PROTOTYPES
+ ******************************************************************************/
+void testCheck(bool passed, const char* expression, const char* file, int line);
+void testReportValues(const std::string& actual, const std::string& expected);
+
+/* Printable form of a checked value */
+inline std::string testToString(const std::string& value) { return "\"" + value + "\""; }
+inline std::string testToString(const char* value) {
+    return (value != NULL) ? testToString(std::string(value)) : std::string("NULL");
+}
+inline std::string testToString(bool value) { return value ? "true" : "false"; }
+inline std::string testToString(double value) { return std::to_string(value); }
+template <typename T> std::string testToString(T value) { return std::to_string((long long)value); }
+
+template <typename A, typename E>
+void testCheckEqual(const A& actual, const E& expected, const char* expression, const char* file,
+                    int line) {
+    bool passed = (actual == expected);
+    testCheck(passed, expression, file, line);
+    if (!passed) {
+        testReportValues(testToString(actual), testToString(expected));
+    }
+}
+
+/* const char* compares as text */
+inline void testCheckEqual(const char* actual, const char* expected, const char* expression,
+                           const char* file, int line) {
+    testCheckEqual(std::string((actual != NULL) ? actual : "(null)"),
+                   std::string((expected != NULL) ? expected : "(null)"), expression, file, line);
+}
+
+/* Character buffers and literals compare as text too */
+template <size_t N, size_t M>
+void testCheckEqual(const char (&actual)[N], const char (&expected)[M], const char* expression,
+                    const char* file, int line) {
+    testCheckEqual((const char*)actual, (const char*)expected, expression, file, line);
+}
+
+#endif /* TEST_CHECK_H */
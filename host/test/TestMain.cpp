@@ -0,0 +1,60 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+typedef struct {
+    const char* name;
+    TestFunction function;
+} TestEntry;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static std::vector<TestEntry>& testList() {
+    static std::vector<TestEntry> tests;
+    return tests;
+}
+static const char* currentTest = "";
+static unsigned failedChecks = 0U;
+
+/******************************************************************************
+ * API
+ ******************************************************************************/
+TestRegistration::TestRegistration(const char* name, TestFunction function) {
+    TestEntry entry = { name, function };
+    testList().push_back(entry);
+}
+
+void testCheck(bool passed, const char* expression, const char* file, int line) {
+    if (!passed) {
+        failedChecks++;
+        printf("FAIL %s: %s:%d: %s\n", currentTest, file, line, expression);
+    }
+}
+
+void testReportValues(const std::string& actual, const std::string& expected) {
+    printf("     actual:   %s\n     expected: %s\n", actual.c_str(), expected.c_str());
+}
+
+/* Runs every registered case; the exit code is the number of failed cases */
+int main() {
+    unsigned failedTests = 0U;
+    for (const TestEntry& test : testList()) {
+        unsigned before = failedChecks;
+        currentTest = test.name;
+        test.function();
+        bool passed = (failedChecks == before);
+        printf("%s %s\n", passed ? "ok  " : "FAIL", test.name);
+        fflush(stdout);
+        if (!passed) {
+            failedTests++;
+        }
+    }
+    printf("%u of %u cases passed\n", (unsigned)(testList().size() - failedTests),
+           (unsigned)testList().size());
+    return (int)failedTests;
+}
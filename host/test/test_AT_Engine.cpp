@@ -0,0 +1,329 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Polls the engine for ms of virtual time */
+static void runFor(AtEngine& engine, uint32_t ms) {
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < ms) {
+        engine.poll();
+        delay(1);
+    }
+    engine.poll();
+}
+
+/* Polls the engine until the command has completed */
+static AtResult finish(AtEngine& engine, AtHandle handle) {
+    return engine.waitFor(handle);
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* A command completes as soon as its final result code arrives, without a fixed wait */
+TEST_CASE(completesOnFinalResultCode) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().jitterMs = 0U;
+    AtEngine engine(port);
+
+    AtHandle handle = engine.submit(AT_CMD_SIGNAL_QUALITY);
+    CHECK_EQ(finish(engine, handle), AT_RESULT_OK);
+    CHECK(engine.latencyMs(handle) >= modem.timing().commandMs);
+    CHECK(engine.latencyMs(handle) < modem.timing().commandMs + 10U);
+    int8_t rssi = -1;
+    CHECK(engine.parse(handle, &rssi));
+    CHECK_EQ(rssi, 21);
+    engine.release(handle);
+    CHECK_EQ(engine.result(handle), AT_RESULT_INVALID);
+}
+
+/* Echoed command lines are not part of the response; error codes are reported */
+TEST_CASE(separatesEchoAndErrors) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.on("AT+CGMR", [](FakeModem& fake, const std::string&) {
+        fake.reply("+CGMR: LE20B04SIM7600\n\nOK", 20U);
+        return true;
+    });
+    modem.on("AT+CPIN?", [](FakeModem& fake, const std::string&) {
+        fake.reply("+CME ERROR: 10", 20U);
+        return true;
+    });
+    AtEngine engine(port);
+
+    AtHandle version = engine.submit("AT+CGMR", AT_TIMEOUT_CONFIG_MS);
+    AtHandle sim = engine.submit("AT+CPIN?", AT_TIMEOUT_CONFIG_MS);
+    CHECK_EQ(finish(engine, version), AT_RESULT_OK);
+    CHECK_EQ(engine.response(version), "+CGMR: LE20B04SIM7600");
+    CHECK_EQ(finish(engine, sim), AT_RESULT_CME_ERROR);
+    CHECK_EQ(engine.errorCode(sim), 10);
+    engine.release(version);
+    engine.release(sim);
+}
+
+/* Queued commands go out one at a time, in order, each after the previous result code */
+TEST_CASE(runsQueuedCommandsInOrder) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+
+    AtHandle first = engine.submit(AT_CMD_ECHO_OFF);
+    AtHandle second = engine.submit(AT_CMD_SMS_TEXT_MODE);
+    AtHandle third = engine.submit(AT_CMD_CLIP_ON);
+    CHECK(!engine.isIdle());
+    CHECK_EQ(finish(engine, third), AT_RESULT_OK);
+    CHECK_EQ(engine.result(first), AT_RESULT_OK);
+    CHECK_EQ(engine.result(second), AT_RESULT_OK);
+    CHECK(engine.isIdle());
+
+    const std::vector<FakeModemCommand>& commands = modem.commands();
+    CHECK_EQ(commands.size(), 3U);
+    CHECK_EQ(commands[0].text, "ATE0");
+    CHECK_EQ(commands[1].text, "AT+CMGF=1");
+    CHECK_EQ(commands[2].text, "AT+CLIP=1");
+    CHECK(commands[1].atMs >= commands[0].atMs + modem.timing().commandMs);
+    engine.release(first);
+    engine.release(second);
+    engine.release(third);
+}
+
+/* A module that never answers: the command times out at its catalog deadline */
+TEST_CASE(timesOutAtCatalogDeadline) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port, 3600000U);
+    AtEngine engine(port);
+
+    AtHandle handle = engine.submit(AT_CMD_ATTENTION);
+    CHECK_EQ(finish(engine, handle), AT_RESULT_TIMEOUT);
+    CHECK_EQ(engine.latencyMs(handle), AT_CMD_ATTENTION.timeoutMs);
+    engine.release(handle);
+}
+
+/* An urgent command behind an AT+CMGS whose body is on its way to the network detaches it and
+   is written at once; the late +CMGS/OK pair is dropped instead of completing another command */
+TEST_CASE(urgentDetachesSmsHandedToNetwork) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().smsNetworkMs = 4000U;
+    modem.timing().jitterMs = 0U;
+    AtEngine engine(port);
+
+    AtHandle sms = engine.submit(AT_CMD_SMS_SEND, "+84900000001", "Battery low");
+    AtHandle query = engine.submit(AT_CMD_GNSS_INFO);
+    runFor(engine, 500);
+    CHECK(modem.last("AT+CMGS=") != NULL && modem.last("AT+CMGS=")->body == "Battery low");
+
+    uint32_t urgentAtMs = millis();
+    AtHandle dial = engine.submitUrgent(AT_CMD_DIAL, "+84900000002");
+    CHECK(dial != AT_INVALID_HANDLE);
+    CHECK_EQ(engine.result(sms), AT_RESULT_ABORTED);
+    CHECK_EQ(finish(engine, dial), AT_RESULT_OK);
+    CHECK(modem.last("ATD")->atMs - urgentAtMs < 10U);
+
+    /* The query goes out before the message is accepted; the +CMGS/OK arriving while a
+       command the module never answers is on the wire does not complete that command */
+    CHECK_EQ(finish(engine, query), AT_RESULT_OK);
+    CHECK(strstr(engine.response(query), "+CGPSINFO:") != NULL);
+    modem.on("AT+SILENT", [](FakeModem&, const std::string&) { return true; });
+    AtHandle probe = engine.submit("AT+SILENT", 6000U);
+    CHECK_EQ(finish(engine, probe), AT_RESULT_TIMEOUT);
+    AtHandle next = engine.submit(AT_CMD_ATTENTION);
+    CHECK_EQ(finish(engine, next), AT_RESULT_OK);
+    CHECK_EQ(modem.count("AT+CMGS="), 1U);
+
+    engine.release(sms);
+    engine.release(query);
+    engine.release(dial);
+    engine.release(probe);
+    engine.release(next);
+}
+
+/* An urgent AT+CMGS (an alert message) is never detached: the urgent command behind it waits */
+TEST_CASE(urgentWaitsForUrgentSms) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().smsNetworkMs = 4000U;
+    AtEngine engine(port);
+
+    AtHandle sms = engine.submitUrgent(AT_CMD_SMS_SEND, "+84900000001", "SOS test");
+    runFor(engine, 500);
+    AtHandle dial = engine.submitUrgent(AT_CMD_DIAL, "+84900000002");
+
+    CHECK_EQ(finish(engine, sms), AT_RESULT_OK);
+    int16_t reference = -1;
+    CHECK(engine.parse(sms, &reference));
+    CHECK_EQ(reference, 1);
+    CHECK(modem.last("ATD")->atMs >= modem.last("AT+CMGS=")->atMs + 4000U);
+    CHECK_EQ(finish(engine, dial), AT_RESULT_OK);
+
+    engine.release(sms);
+    engine.release(dial);
+}
+
+/* The network deadline of AT+CMGS starts with the body, the prompt has its own shorter one */
+TEST_CASE(smsDeadlineStartsWithBody) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().promptMs = AT_TIMEOUT_SMS_PROMPT_MS - 500U;
+    modem.timing().smsNetworkMs = AT_TIMEOUT_SMS_SEND_MS - 1000U;
+    AtEngine engine(port);
+
+    AtHandle sms = engine.submit(AT_CMD_SMS_SEND, "+84900000001", "slow network");
+    CHECK_EQ(finish(engine, sms), AT_RESULT_OK);
+    CHECK(engine.latencyMs(sms) > AT_TIMEOUT_SMS_SEND_MS);
+    engine.release(sms);
+}
+
+/* Worst cases of the command on the wire: an urgent command is written within
+   AT_ENGINE_URGENT_WAIT_MS of its submission in each of them */
+TEST_CASE(urgentWaitIsBounded) {
+    for (uint8_t scenario = 0U; scenario < 4U; scenario++) {
+        HardwareSerial port(TEST_UART);
+        port.begin(115200);
+        FakeModem modem(port);
+        modem.timing().jitterMs = 0U;
+        AtEngine engine(port);
+        AtHandle busy = AT_INVALID_HANDLE;
+        uint32_t leadMs = 10U;
+
+        if (scenario == 0U) {
+            /* A query the module never answers */
+            modem.on("AT+CGPSINFO", [](FakeModem&, const std::string&) { return true; });
+            busy = engine.submit(AT_CMD_GNSS_INFO);
+        } else if (scenario == 1U) {
+            /* AT+CMGS whose prompt never comes and whose ESC is never confirmed */
+            modem.on("AT+CMGS=", [](FakeModem&, const std::string&) { return true; });
+            busy = engine.submit(AT_CMD_SMS_SEND, "+84900000001", "lost");
+        } else if (scenario == 2U) {
+            /* AT+CMGS waiting for a slow prompt */
+            modem.timing().promptMs = AT_TIMEOUT_SMS_PROMPT_MS - 100U;
+            busy = engine.submit(AT_CMD_SMS_SEND, "+84900000001", "slow prompt");
+        } else {
+            /* AT+CMGS waiting for a network that takes the whole deadline */
+            modem.timing().smsNetworkMs = AT_TIMEOUT_SMS_SEND_MS;
+            busy = engine.submit(AT_CMD_SMS_SEND, "+84900000001", "slow network");
+            leadMs = 500U;
+        }
+        runFor(engine, leadMs);
+
+        uint32_t urgentAtMs = millis();
+        AtHandle dial = engine.submitUrgent(AT_CMD_DIAL, "+84900000002");
+        while (modem.count("ATD") == 0U) {
+            engine.poll();
+            delay(1);
+        }
+        CHECK(modem.last("ATD")->atMs - urgentAtMs <= AT_ENGINE_URGENT_WAIT_MS);
+        CHECK(engine.result(busy) != AT_RESULT_OK);
+
+        engine.release(busy);
+        engine.release(dial);
+    }
+}
+
+/* An AT+CMGS still waiting for its prompt is cancelled with ESC; however late the modem
+   confirms, that result code ends the message and the urgent command gets its own */
+TEST_CASE(urgentCancelsSmsAtPromptAndWaitsForConfirmation) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().promptMs = 300U;
+    modem.timing().commandMs = 900U;
+    modem.timing().jitterMs = 0U;
+    modem.timing().dialMs = 2000U;
+    AtEngine engine(port);
+
+    AtHandle sms = engine.submit(AT_CMD_SMS_SEND, "+84900000001", "never sent");
+    runFor(engine, 100);
+    AtHandle dial = engine.submitUrgent(AT_CMD_DIAL, "+84900000002");
+
+    CHECK_EQ(finish(engine, sms), AT_RESULT_ABORTED);
+    CHECK(modem.last("AT+CMGS=")->cancelled);
+    CHECK(modem.last("AT+CMGS=")->body.empty());
+    CHECK_EQ(modem.count("ATD"), 1U);
+
+    CHECK_EQ(finish(engine, dial), AT_RESULT_OK);
+    CHECK(engine.latencyMs(dial) >= modem.timing().dialMs);
+
+    engine.release(sms);
+    engine.release(dial);
+}
+
+/* A query on the wire is never timed out early for an urgent command */
+TEST_CASE(urgentWaitsForSlowQuery) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().gnssMs = 700U;
+    modem.timing().jitterMs = 0U;
+    AtEngine engine(port);
+
+    AtHandle query = engine.submit(AT_CMD_GNSS_INFO);
+    runFor(engine, 10);
+    AtHandle hangUp = engine.submitUrgent(AT_CMD_HANG_UP);
+
+    CHECK_EQ(finish(engine, query), AT_RESULT_OK);
+    CHECK(strstr(engine.response(query), "+CGPSINFO:") != NULL);
+    CHECK_EQ(finish(engine, hangUp), AT_RESULT_OK);
+
+    engine.release(query);
+    engine.release(hangUp);
+}
+
+/* Deadlines longer than AT_ENGINE_MAX_TIMEOUT_MS are clamped */
+TEST_CASE(timeoutIsClamped) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.on("AT+SILENT", [](FakeModem&, const std::string&) { return true; });
+    AtEngine engine(port);
+
+    AtHandle handle = engine.submit("AT+SILENT", 600000U);
+    CHECK_EQ(finish(engine, handle), AT_RESULT_TIMEOUT);
+    CHECK_EQ(engine.latencyMs(handle), AT_ENGINE_MAX_TIMEOUT_MS);
+    engine.release(handle);
+}
+
+/* NMEA sentences arriving while a command waits for its response go to the unsolicited
+   handler, never into the response */
+TEST_CASE(nmeaSentencesAreUnsolicited) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.on("AT+CGSN", [](FakeModem& fake, const std::string&) {
+        fake.reply("$GPRMC,101500.00,A,2101.710660,N,10548.289020,E,0.0,0.0,161026,,,A*6B\n"
+                   "861234567890123\n\nOK", 20U);
+        return true;
+    });
+    AtEngine engine(port);
+    static std::string unsolicited;
+    unsolicited.clear();
+    engine.setUnsolicitedHandler([](const char* line, size_t length, void*) {
+        unsolicited.append(line, length);
+    }, NULL);
+
+    AtHandle handle = engine.submit("AT+CGSN", AT_TIMEOUT_CONFIG_MS);
+    CHECK_EQ(engine.waitFor(handle), AT_RESULT_OK);
+    CHECK_EQ(engine.response(handle), "861234567890123");
+    CHECK_EQ(unsolicited.compare(0, 7, "$GPRMC,"), 0);
+    engine.release(handle);
+}
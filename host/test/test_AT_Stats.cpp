@@ -0,0 +1,119 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "AT_Stats.h"
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Bucket 0 holds < 4 ms, bucket i holds [2^(i+1), 2^(i+2)) ms and the last one is open */
+TEST_CASE(placesLatencyInLog2Buckets) {
+    AtLatencyStats stats;
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 0U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 3U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 4U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 7U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 8U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 1000U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 65535U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, 65536U, -1);
+    stats.record(AT_CLASS_STATUS, AT_OUTCOME_OK, UINT32_MAX, -1);
+
+    const AtClassStats& status = stats.forClass(AT_CLASS_STATUS);
+    CHECK_EQ(status.buckets[0], 2U);
+    CHECK_EQ(status.buckets[1], 2U);
+    CHECK_EQ(status.buckets[2], 1U);
+    CHECK_EQ(status.buckets[8], 1U);
+    CHECK_EQ(status.buckets[14], 1U);
+    CHECK_EQ(status.buckets[AT_STATS_BUCKET_COUNT - 1U], 2U);
+
+    CHECK_EQ(AtLatencyStats::bucketFloorMs(0U), 0U);
+    CHECK_EQ(AtLatencyStats::bucketFloorMs(1U), 4U);
+    CHECK_EQ(AtLatencyStats::bucketFloorMs(8U), 512U);
+    CHECK_EQ(AtLatencyStats::bucketFloorMs(AT_STATS_BUCKET_COUNT - 1U), 65536U);
+}
+
+/* Each outcome has its own counter; min, max and the last error code are kept per class */
+TEST_CASE(countsOutcomesPerClass) {
+    AtLatencyStats stats;
+    stats.record(AT_CLASS_SMS, AT_OUTCOME_OK, 2500U, -1);
+    stats.record(AT_CLASS_SMS, AT_OUTCOME_CMS_ERROR, 300U, 331);
+    stats.record(AT_CLASS_SMS, AT_OUTCOME_TIMEOUT, 60000U, -1);
+    stats.record(AT_CLASS_CALL, AT_OUTCOME_ERROR, 20U, -1);
+    stats.record(AT_CLASS_CALL, AT_OUTCOME_CME_ERROR, 40U, 30);
+    stats.record(AT_CLASS_COUNT, AT_OUTCOME_OK, 10U, -1);
+
+    const AtClassStats& sms = stats.forClass(AT_CLASS_SMS);
+    CHECK_EQ(sms.count, 3U);
+    CHECK_EQ(sms.okCount, 1U);
+    CHECK_EQ(sms.cmsCount, 1U);
+    CHECK_EQ(sms.timeoutCount, 1U);
+    CHECK_EQ(sms.errorCount, 0U);
+    CHECK_EQ(sms.lastErrorCode, 331);
+    CHECK_EQ(sms.minMs, 300U);
+    CHECK_EQ(sms.maxMs, 60000U);
+    CHECK_EQ(sms.totalMs, 62800U);
+
+    const AtClassStats& call = stats.forClass(AT_CLASS_CALL);
+    CHECK_EQ(call.count, 2U);
+    CHECK_EQ(call.errorCount, 1U);
+    CHECK_EQ(call.cmeCount, 1U);
+    CHECK_EQ(call.lastErrorCode, 30);
+
+    CHECK_EQ(stats.forClass(AT_CLASS_BASIC).count, 0U);
+    CHECK_EQ(stats.forClass(AT_CLASS_BASIC).lastErrorCode, -1);
+}
+
+/* reset() returns every class to its initial state */
+TEST_CASE(resetClearsEveryClass) {
+    AtLatencyStats stats;
+    stats.record(AT_CLASS_GNSS, AT_OUTCOME_CME_ERROR, 150U, 3);
+    stats.reset();
+
+    const AtClassStats& gnss = stats.forClass(AT_CLASS_GNSS);
+    CHECK_EQ(gnss.count, 0U);
+    CHECK_EQ(gnss.cmeCount, 0U);
+    CHECK_EQ(gnss.lastErrorCode, -1);
+    CHECK_EQ(gnss.minMs, UINT32_MAX);
+    CHECK_EQ(gnss.maxMs, 0U);
+    CHECK_EQ(gnss.buckets[6], 0U);
+}
+
+/* The JSON lists the bucket floors and every class, used or not */
+TEST_CASE(formatsJson) {
+    AtLatencyStats stats;
+    stats.record(AT_CLASS_CALL, AT_OUTCOME_OK, 5U, -1);
+    stats.record(AT_CLASS_CALL, AT_OUTCOME_CME_ERROR, 9U, 30);
+
+    char json[AT_STATS_JSON_MAX_LEN];
+    size_t length = stats.formatJson(json, sizeof(json));
+    CHECK_EQ(length, strlen(json));
+    std::string text(json);
+    CHECK(text.compare(0, 40, "{\"bucketFloorsMs\":[0,4,8,16,32,64,128,25") == 0);
+    CHECK(text.find(",65536],\"classes\":{\"basic\":{\"count\":0,") != std::string::npos);
+    CHECK(text.find("\"call\":{\"count\":2,\"ok\":1,\"error\":0,\"cme\":1,\"cms\":0,\"timeout\":0,"
+                    "\"lastErrorCode\":30,\"minMs\":5,\"avgMs\":7,\"maxMs\":9,"
+                    "\"histogram\":[0,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0]}") != std::string::npos);
+    CHECK(text.find("\"raw\":{") != std::string::npos);
+    CHECK(text.compare(text.size() - 4U, 4U, "]}}}") == 0);
+}
+
+/* Large figures still fit AT_STATS_JSON_MAX_LEN; a buffer too small yields 0 and an empty
+   string instead of a truncated document */
+TEST_CASE(refusesTruncatedJson) {
+    AtLatencyStats stats;
+    for (uint8_t i = 0; i < AT_CLASS_COUNT; i++) {
+        stats.record((AtCommandClass)i, AT_OUTCOME_TIMEOUT, UINT32_MAX, 32767);
+    }
+    char json[AT_STATS_JSON_MAX_LEN];
+    size_t length = stats.formatJson(json, sizeof(json));
+    CHECK(length > 0U);
+
+    char exact[AT_STATS_JSON_MAX_LEN];
+    CHECK_EQ(stats.formatJson(exact, length + 1U), length);
+    CHECK_EQ(std::string(exact), std::string(json));
+    CHECK_EQ(stats.formatJson(exact, length), 0U);
+    CHECK_EQ(exact[0], '\0');
+    CHECK_EQ(stats.formatJson(exact, 0U), 0U);
+}
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "BTN_Capture.h"
+#include <HostSim.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Each case uses its own pin: a capture stays attached to its pin after the case */
+#define TEST_PIN_PRESS            13
+#define TEST_PIN_BOUNCE           14
+#define TEST_PIN_GLITCH           15
+#define TEST_PIN_BLOCKED          16
+#define TEST_PIN_OVERFLOW         17
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Drives the pin at atMs from now, as a hand on the button would */
+static void edgeAt(uint8_t pin, uint32_t atMs, uint8_t level) {
+    hostAfterMs(atMs, [pin, level]() { hostSetPin(pin, level); });
+}
+
+/* Same, in microseconds (contact bounce) */
+static void edgeAtUs(uint8_t pin, uint32_t atUs, uint8_t level) {
+    hostAt(hostNowUs() + atUs, [pin, level]() { hostSetPin(pin, level); });
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Press and release carry the time of their first edge; the release carries the hold time */
+TEST_CASE(timestampsPressAndRelease) {
+    hostSetPin(TEST_PIN_PRESS, HIGH);
+    ButtonCapture button(TEST_PIN_PRESS);
+    button.begin();
+    ButtonEvent event;
+    CHECK(!button.nextEvent(event));
+
+    uint32_t startUs = micros();
+    edgeAt(TEST_PIN_PRESS, 100U, LOW);
+    edgeAt(TEST_PIN_PRESS, 800U, HIGH);
+    delay(50);
+    CHECK(!button.nextEvent(event));
+    delay(100);
+    CHECK(button.isSettling());
+    delay(10);
+    CHECK(button.nextEvent(event));
+    CHECK_EQ(event.type, BUTTON_EVENT_PRESS);
+    CHECK_EQ(event.timestampUs - startUs, 100000U);
+    CHECK(button.isPressed());
+
+    delay(1000);
+    CHECK(button.nextEvent(event));
+    CHECK_EQ(event.type, BUTTON_EVENT_RELEASE);
+    CHECK_EQ(event.timestampUs - startUs, 800000U);
+    CHECK_EQ(event.durationUs, 700000U);
+    CHECK(!button.isPressed());
+    CHECK(!button.nextEvent(event));
+    CHECK(!button.isSettling());
+}
+
+/* Contact bounce collapses into one transition at the first edge */
+TEST_CASE(filtersBounces) {
+    hostSetPin(TEST_PIN_BOUNCE, HIGH);
+    ButtonCapture button(TEST_PIN_BOUNCE);
+    button.begin();
+
+    uint32_t startUs = micros();
+    edgeAtUs(TEST_PIN_BOUNCE, 1000U, LOW);
+    edgeAtUs(TEST_PIN_BOUNCE, 1400U, HIGH);
+    edgeAtUs(TEST_PIN_BOUNCE, 1900U, LOW);
+    edgeAtUs(TEST_PIN_BOUNCE, 2300U, HIGH);
+    edgeAtUs(TEST_PIN_BOUNCE, 3000U, LOW);
+    delay(200);
+
+    ButtonEvent event;
+    CHECK(button.nextEvent(event));
+    CHECK_EQ(event.type, BUTTON_EVENT_PRESS);
+    CHECK_EQ(event.timestampUs - startUs, 1000U);
+    CHECK(!button.nextEvent(event));
+    CHECK_EQ(button.bouncesFiltered(), 4U);
+}
+
+/* A pulse that returns to the released level within the debounce time is no press */
+TEST_CASE(ignoresGlitch) {
+    hostSetPin(TEST_PIN_GLITCH, HIGH);
+    ButtonCapture button(TEST_PIN_GLITCH);
+    button.begin();
+
+    edgeAtUs(TEST_PIN_GLITCH, 1000U, LOW);
+    edgeAtUs(TEST_PIN_GLITCH, 3000U, HIGH);
+    delay(200);
+
+    ButtonEvent event;
+    CHECK(!button.nextEvent(event));
+    CHECK(!button.isPressed());
+    CHECK(!button.isSettling());
+}
+
+/* Presses made while the loop is blocked are all there afterwards, with their exact durations */
+TEST_CASE(capturesWhileLoopBlocked) {
+    hostSetPin(TEST_PIN_BLOCKED, HIGH);
+    ButtonCapture button(TEST_PIN_BLOCKED);
+    button.begin();
+
+    static const uint32_t HOLD_MS[] = { 120U, 300U, 900U };
+    uint32_t atMs = 100U;
+    for (uint32_t holdMs : HOLD_MS) {
+        edgeAt(TEST_PIN_BLOCKED, atMs, LOW);
+        edgeAt(TEST_PIN_BLOCKED, atMs + holdMs, HIGH);
+        atMs += holdMs + 250U;
+    }
+    delay(5000);
+
+    ButtonEvent event;
+    for (uint32_t holdMs : HOLD_MS) {
+        CHECK(button.nextEvent(event));
+        CHECK_EQ(event.type, BUTTON_EVENT_PRESS);
+        CHECK(button.nextEvent(event));
+        CHECK_EQ(event.type, BUTTON_EVENT_RELEASE);
+        CHECK_EQ(event.durationUs, holdMs * 1000U);
+    }
+    CHECK(!button.nextEvent(event));
+    CHECK_EQ(button.edgesDropped(), 0U);
+}
+
+/* Edges beyond the queue size are dropped and counted, never overwriting queued ones */
+TEST_CASE(countsDroppedEdges) {
+    hostSetPin(TEST_PIN_OVERFLOW, HIGH);
+    ButtonCapture button(TEST_PIN_OVERFLOW);
+    button.begin();
+
+    for (uint32_t i = 0; i < BUTTON_EDGE_QUEUE_SIZE + 8U; i++) {
+        edgeAt(TEST_PIN_OVERFLOW, 100U * (i + 1U), (i % 2U == 0U) ? LOW : HIGH);
+    }
+    delay(100U * (BUTTON_EDGE_QUEUE_SIZE + 8U) + 200U);
+    CHECK_EQ(button.edgesDropped(), 8U);
+
+    ButtonEvent event;
+    uint32_t events = 0U;
+    while (button.nextEvent(event)) {
+        events++;
+    }
+    CHECK_EQ(events, BUTTON_EDGE_QUEUE_SIZE);
+}
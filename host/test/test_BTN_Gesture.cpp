@@ -0,0 +1,151 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "BTN_Gesture.h"
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* One press of a synthetic trace (ms from the start of the trace) */
+typedef struct {
+    uint32_t pressMs;
+    uint32_t releaseMs;     /* 0: still pressed at the end of the trace */
+} TracePress;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Feeds the debounced events of a trace and then polls at endMs; returns every gesture
+   recognized, in order */
+static std::vector<Gesture> run(GestureRecognizer& recognizer, const TracePress* presses,
+                                size_t count, uint32_t endMs) {
+    std::vector<Gesture> gestures;
+    uint32_t lastUs = 0U;
+    for (size_t i = 0; i < count; i++) {
+        ButtonEvent event;
+        event.type = BUTTON_EVENT_PRESS;
+        event.timestampUs = presses[i].pressMs * 1000U;
+        event.durationUs = event.timestampUs - lastUs;
+        Gesture gesture = recognizer.feed(event);
+        if (gesture != GESTURE_NONE) {
+            gestures.push_back(gesture);
+        }
+        if (presses[i].releaseMs == 0U) {
+            break;
+        }
+        event.type = BUTTON_EVENT_RELEASE;
+        event.timestampUs = presses[i].releaseMs * 1000U;
+        event.durationUs = (presses[i].releaseMs - presses[i].pressMs) * 1000U;
+        lastUs = event.timestampUs;
+        gesture = recognizer.feed(event);
+        if (gesture != GESTURE_NONE) {
+            gestures.push_back(gesture);
+        }
+    }
+    Gesture gesture = recognizer.poll(endMs * 1000U);
+    if (gesture != GESTURE_NONE) {
+        gestures.push_back(gesture);
+    }
+    return gestures;
+}
+
+/* Single gesture expected from a trace */
+static Gesture recognize(const TracePress* presses, size_t count, uint32_t endMs) {
+    GestureRecognizer recognizer;
+    std::vector<Gesture> gestures = run(recognizer, presses, count, endMs);
+    return (gestures.size() == 1U) ? gestures[0] : GESTURE_NONE;
+}
+
+static void countAction(Gesture gesture, void* context) {
+    static_cast<std::vector<Gesture>*>(context)->push_back(gesture);
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* A click is reported once the click gap has passed without another press */
+TEST_CASE(recognizesSingleClick) {
+    static const TracePress TRACE[] = { { 100U, 220U } };
+    GestureRecognizer recognizer;
+    CHECK(run(recognizer, TRACE, 1U, 220U + GESTURE_CLICK_GAP_MS - 1U).empty());
+    CHECK(recognizer.waitsForTimeout());
+    CHECK_EQ(recognizer.poll((220U + GESTURE_CLICK_GAP_MS) * 1000U), GESTURE_SINGLE_CLICK);
+    CHECK(!recognizer.waitsForTimeout());
+    CHECK_EQ(recognizer.count(GESTURE_SINGLE_CLICK), 1U);
+}
+
+/* Two and three clicks within the gap; the third click needs no timeout */
+TEST_CASE(recognizesMultiClicks) {
+    static const TracePress DOUBLE[] = { { 0U, 100U }, { 300U, 400U } };
+    CHECK_EQ(recognize(DOUBLE, 2U, 1000U), GESTURE_DOUBLE_CLICK);
+
+    static const TracePress TRIPLE[] = { { 0U, 100U }, { 300U, 400U }, { 600U, 700U } };
+    GestureRecognizer recognizer;
+    std::vector<Gesture> gestures = run(recognizer, TRIPLE, 3U, 700U);
+    CHECK_EQ(gestures.size(), 1U);
+    CHECK(!gestures.empty() && gestures[0] == GESTURE_TRIPLE_CLICK);
+
+    static const TracePress APART[] = { { 0U, 100U }, { 100U + GESTURE_CLICK_GAP_MS + 50U,
+                                                        200U + GESTURE_CLICK_GAP_MS + 50U } };
+    GestureRecognizer slow;
+    gestures = run(slow, APART, 2U, 2000U);
+    CHECK_EQ(gestures.size(), 2U);
+    CHECK_EQ(slow.count(GESTURE_SINGLE_CLICK), 2U);
+}
+
+/* Released after the long-press time: a long press, also as the last press of a multi-click */
+TEST_CASE(recognizesLongPress) {
+    static const TracePress LONG[] = { { 0U, GESTURE_LONG_PRESS_MS } };
+    CHECK_EQ(recognize(LONG, 1U, 5000U), GESTURE_LONG_PRESS);
+
+    static const TracePress SHORT[] = { { 0U, GESTURE_LONG_PRESS_MS - 1U } };
+    CHECK_EQ(recognize(SHORT, 1U, 5000U), GESTURE_SINGLE_CLICK);
+
+    static const TracePress CLICK_THEN_LONG[] = { { 0U, 100U }, { 300U, 1200U } };
+    CHECK_EQ(recognize(CLICK_THEN_LONG, 2U, 5000U), GESTURE_LONG_PRESS);
+}
+
+/* Still pressed after the hold time: reported while down, and the release adds nothing */
+TEST_CASE(recognizesHold) {
+    static const TracePress HOLD[] = { { 0U, 0U } };
+    GestureRecognizer recognizer;
+    CHECK(run(recognizer, HOLD, 1U, GESTURE_HOLD_MS - 1U).empty());
+    CHECK_EQ(recognizer.poll(GESTURE_HOLD_MS * 1000U), GESTURE_HOLD);
+    CHECK(!recognizer.waitsForTimeout());
+
+    ButtonEvent release = { BUTTON_EVENT_RELEASE, 5000000U, 5000000U };
+    CHECK_EQ(recognizer.feed(release), GESTURE_NONE);
+    CHECK_EQ(recognizer.poll(10000000U), GESTURE_NONE);
+    CHECK_EQ(recognizer.count(GESTURE_HOLD), 1U);
+    CHECK_EQ(recognizer.count(GESTURE_LONG_PRESS), 0U);
+}
+
+/* Timeouts follow the event timestamps, so a trace fed late gives the same gestures */
+TEST_CASE(usesEventTimestamps) {
+    static const TracePress TRACE[] = { { 0U, 100U }, { 300U, 400U }, { 2000U, 2100U } };
+    GestureRecognizer recognizer;
+    std::vector<Gesture> gestures = run(recognizer, TRACE, 3U, 10000U);
+    CHECK_EQ(gestures.size(), 2U);
+    CHECK(gestures.size() == 2U && gestures[0] == GESTURE_DOUBLE_CLICK);
+    CHECK(gestures.size() == 2U && gestures[1] == GESTURE_SINGLE_CLICK);
+}
+
+/* Timing is configurable; every gesture goes to its own action */
+TEST_CASE(dispatchesActionsWithCustomTiming) {
+    GestureTiming timing = { 200U, 1500U, 5000U };
+    GestureRecognizer recognizer(timing);
+    std::vector<Gesture> dispatched;
+    for (uint8_t gesture = GESTURE_SINGLE_CLICK; gesture < GESTURE_COUNT; gesture++) {
+        recognizer.setAction((Gesture)gesture, countAction, &dispatched);
+    }
+
+    static const TracePress TRACE[] = { { 0U, 1000U }, { 1300U, 1400U }, { 1500U, 3100U },
+                                        { 4000U, 0U } };
+    run(recognizer, TRACE, 4U, 9000U);
+    CHECK_EQ(dispatched.size(), 3U);
+    CHECK(dispatched.size() == 3U && dispatched[0] == GESTURE_SINGLE_CLICK);
+    CHECK(dispatched.size() == 3U && dispatched[1] == GESTURE_LONG_PRESS);
+    CHECK(dispatched.size() == 3U && dispatched[2] == GESTURE_HOLD);
+    CHECK_EQ(gestureName(GESTURE_TRIPLE_CLICK), "triple click");
+}
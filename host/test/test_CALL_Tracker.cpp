@@ -0,0 +1,248 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "CALL_Tracker.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/* Number the test calls go to */
+#define TEST_CONTACT              "+84900000001"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Dispatcher fed by the engine, as dispatchGsmLine() does on the device */
+static UrcDispatcher testDispatcher;
+
+/* States reported to the state handler, in order */
+static std::vector<CallState> transitions;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Unsolicited handler: every line to testDispatcher */
+static void dispatchLine(const char* line, size_t length, void*) {
+    testDispatcher.dispatch(line, length);
+}
+
+static void recordTransition(CallState state, CallEndReason, void*) {
+    transitions.push_back(state);
+}
+
+/* Polls the tracker until the call has ended or ms of virtual time have passed */
+static CallState runFor(CallTracker& calls, AtEngine& engine, uint32_t ms) {
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < ms && calls.state() != CALL_STATE_ENDED) {
+        engine.poll();
+        calls.poll();
+        delay(1);
+    }
+    return calls.state();
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* dial() returns at once; +CLCC reports drive dialing, alerting and active; latencies are kept */
+TEST_CASE(tracksAnsweredCall) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().jitterMs = 0U;
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    transitions.clear();
+    calls.setStateHandler(recordTransition, NULL);
+
+    uint32_t startMs = millis();
+    CHECK(calls.dial(TEST_CONTACT));
+    CHECK_EQ(millis(), startMs);
+    CHECK(calls.inProgress());
+    CHECK(!calls.dial(TEST_CONTACT));
+    runFor(calls, engine, 20000U);
+    CHECK_EQ(calls.state(), CALL_STATE_ACTIVE);
+    CHECK_EQ(modem.last("ATD")->text, "ATD" TEST_CONTACT ";");
+
+    CHECK_EQ(transitions.size(), 3U);
+    CHECK_EQ(transitions[0], CALL_STATE_DIALING);
+    CHECK_EQ(transitions[1], CALL_STATE_ALERTING);
+    CHECK_EQ(transitions[2], CALL_STATE_ACTIVE);
+
+    const CallStats& stats = calls.stats();
+    CHECK_EQ(stats.dialled, 1U);
+    CHECK_EQ(stats.answered, 1U);
+    CHECK_EQ(stats.toAlerting.count, 1U);
+    CHECK(stats.toAlerting.lastMs >= modem.timing().alertingMs);
+    CHECK(stats.toAlerting.lastMs < modem.timing().alertingMs + 50U);
+    CHECK(stats.toAnswer.lastMs >= modem.timing().alertingMs + modem.timing().ringMs);
+    CHECK(stats.toAnswer.lastMs < modem.timing().alertingMs + modem.timing().ringMs + 50U);
+
+    calls.hangUp();
+    runFor(calls, engine, 2000U);
+    CHECK_EQ(calls.state(), CALL_STATE_ENDED);
+    CHECK_EQ(calls.endReason(), CALL_END_HUNG_UP);
+    CHECK_EQ(modem.count("ATH"), 1U);
+    CHECK(!modem.callInProgress());
+    calls.setStateHandler(NULL, NULL);
+}
+
+/* BUSY, NO ANSWER and NO CARRIER end the call with their own reason */
+TEST_CASE(reportsBusyNoAnswerAndNoCarrier) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+
+    modem.setCallOutcome(FAKE_CALL_BUSY);
+    CHECK(calls.dial(TEST_CONTACT));
+    CHECK_EQ(runFor(calls, engine, 20000U), CALL_STATE_ENDED);
+    CHECK_EQ(calls.endReason(), CALL_END_BUSY);
+    CHECK(millis() - modem.last("ATD")->atMs < modem.timing().alertingMs + 50U);
+
+    modem.setCallOutcome(FAKE_CALL_NO_ANSWER);
+    CHECK(calls.dial(TEST_CONTACT));
+    CHECK_EQ(runFor(calls, engine, 20000U), CALL_STATE_ENDED);
+    CHECK_EQ(calls.endReason(), CALL_END_NO_ANSWER);
+
+    modem.setCallOutcome(FAKE_CALL_REJECTED);
+    CHECK(calls.dial(TEST_CONTACT));
+    CHECK_EQ(runFor(calls, engine, 20000U), CALL_STATE_ENDED);
+    CHECK_EQ(calls.endReason(), CALL_END_NO_CARRIER);
+
+    const CallStats& stats = calls.stats();
+    CHECK_EQ(stats.dialled, 3U);
+    CHECK_EQ(stats.busy, 1U);
+    CHECK_EQ(stats.noAnswer, 2U);
+    CHECK_EQ(stats.answered, 0U);
+    CHECK_EQ(stats.toAnswer.count, 0U);
+    CHECK_EQ(stats.toAlerting.count, 1U);
+}
+
+/* A call still ringing at the ring timeout is hung up so the caller can try someone else */
+TEST_CASE(hangsUpAtRingTimeout) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setCallOutcome(FAKE_CALL_NO_ANSWER);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    calls.setRingTimeout(4000U);
+
+    uint32_t startMs = millis();
+    CHECK(calls.dial(TEST_CONTACT));
+    CHECK_EQ(runFor(calls, engine, 20000U), CALL_STATE_ENDED);
+    CHECK_EQ(calls.endReason(), CALL_END_RING_TIMEOUT);
+    CHECK(millis() - startMs >= 4000U);
+    CHECK(millis() - startMs <= 4001U);
+    CHECK_EQ(calls.stats().noAnswer, 1U);
+
+    for (uint32_t i = 0; i < 500U; i++) {
+        engine.poll();
+        calls.poll();
+        delay(1);
+    }
+    CHECK_EQ(modem.count("ATH"), 1U);
+    CHECK(!modem.callInProgress());
+}
+
+/* ATD refused by the module ends the call as rejected */
+TEST_CASE(reportsRejectedDial) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.on("ATD", [](FakeModem& fake, const std::string&) {
+        fake.reply("ERROR", 200U);
+        return true;
+    });
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+
+    CHECK(calls.dial(TEST_CONTACT));
+    CHECK_EQ(runFor(calls, engine, 20000U), CALL_STATE_ENDED);
+    CHECK_EQ(calls.endReason(), CALL_END_REJECTED);
+    CHECK_EQ(calls.stats().rejected, 1U);
+}
+
+/* Hanging up while ATD has not answered writes ATH only after ATD's late OK */
+TEST_CASE(hangUpWaitsForLateDial) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().jitterMs = 0U;
+    modem.timing().dialMs = 3000U;
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+
+    CHECK(calls.dial(TEST_CONTACT));
+    for (uint32_t i = 0; i < 100U; i++) {
+        engine.poll();
+        calls.poll();
+        delay(1);
+    }
+    CHECK_EQ(modem.count("ATD"), 1U);
+    calls.hangUp();
+    CHECK_EQ(calls.state(), CALL_STATE_ENDED);
+    CHECK_EQ(calls.endReason(), CALL_END_NO_CARRIER);
+
+    for (uint32_t i = 0; i < 4000U; i++) {
+        engine.poll();
+        calls.poll();
+        delay(1);
+    }
+    CHECK_EQ(modem.count("ATH"), 1U);
+    CHECK(modem.last("ATH")->atMs >= modem.last("ATD")->atMs + modem.timing().dialMs);
+    CHECK(!modem.callInProgress());
+    CHECK(engine.isIdle());
+    CHECK_EQ(calls.stats().rejected, 0U);
+}
+
+/* A call placed while the ATD of the previous one has not answered goes out after its ATH */
+TEST_CASE(redialWaitsForLateDialAndHangUp) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().jitterMs = 0U;
+    modem.timing().dialMs = 3000U;
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+
+    CHECK(calls.dial(TEST_CONTACT));
+    for (uint32_t i = 0; i < 100U; i++) {
+        engine.poll();
+        calls.poll();
+        delay(1);
+    }
+    calls.hangUp();
+    modem.timing().dialMs = 300U;
+    CHECK(calls.dial(TEST_CONTACT));
+    runFor(calls, engine, 20000U);
+    CHECK_EQ(calls.state(), CALL_STATE_ACTIVE);
+
+    const std::vector<FakeModemCommand>& commands = modem.commands();
+    CHECK_EQ(commands.size(), 3U);
+    CHECK_EQ(commands[0].text, "ATD" TEST_CONTACT ";");
+    CHECK_EQ(commands[1].text, "ATH");
+    CHECK_EQ(commands[2].text, "ATD" TEST_CONTACT ";");
+    CHECK(commands[1].atMs >= commands[0].atMs + 3000U);
+    CHECK(commands[2].atMs > commands[1].atMs);
+    CHECK_EQ(calls.stats().answered, 1U);
+}
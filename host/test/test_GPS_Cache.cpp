@@ -0,0 +1,124 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "GPS_Cache.h"
+#include <HostSim.h>
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* A fix as the parser publishes it, taken now */
+static GnssFix fixAt(int32_t latitudeE6, int32_t longitudeE6, uint16_t hdopX100) {
+    GnssFix fix;
+    memset(&fix, 0, sizeof(fix));
+    fix.valid = true;
+    fix.quality = 1U;
+    fix.hdopX100 = hdopX100;
+    fix.position.latitudeE6 = latitudeE6;
+    fix.position.longitudeE6 = longitudeE6;
+    fix.utcDate = 161026U;
+    fix.utcTimeMs = 36900000U;
+    fix.updatedMs = millis();
+    return fix;
+}
+
+/* Describes the cached location as a string */
+static std::string describe(const LocationCache& cache) {
+    char description[LOCATION_DESCRIPTION_MAX_LEN + 1U];
+    cache.describe(description, sizeof(description));
+    return description;
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Only valid fixes are kept; accuracy comes from the HDOP and the age from the fix time */
+TEST_CASE(keepsLastValidFix) {
+    hostNvsClear();
+    LocationCache cache;
+    CHECK(!cache.begin());
+    CHECK(!cache.hasLocation());
+    CHECK_EQ(cache.ageSeconds(), LOCATION_AGE_UNKNOWN);
+
+    GnssFix lost = fixAt(21028511, 105804817, 120U);
+    lost.valid = false;
+    CHECK(!cache.update(lost));
+    CHECK(!cache.update(fixAt(91000000, 105804817, 120U)));
+    CHECK(!cache.hasLocation());
+
+    CHECK(cache.update(fixAt(21028511, 105804817, 150U)));
+    CHECK(cache.hasLocation());
+    CHECK(cache.isFromThisBoot());
+    CHECK_EQ(cache.location().position.latitudeE6, 21028511);
+    CHECK_EQ(cache.location().accuracyM, 8U);
+    CHECK(!cache.update(lost));
+    CHECK_EQ(cache.location().position.longitudeE6, 105804817);
+
+    delay(42000);
+    CHECK_EQ(cache.ageSeconds(), 42U);
+}
+
+/* The description gives the age in the unit that reads best, and the accuracy when known */
+TEST_CASE(describesAgeAndAccuracy) {
+    hostNvsClear();
+    LocationCache cache;
+    CHECK(cache.update(fixAt(21028511, 105804817, 150U)));
+    delay(5000);
+    CHECK_EQ(describe(cache), "5 s old, accuracy 8 m");
+    delay(175000);
+    CHECK_EQ(describe(cache), "3 min old, accuracy 8 m");
+    delay(7200000);
+    CHECK_EQ(describe(cache), "2 h old, accuracy 8 m");
+
+    CHECK(cache.update(fixAt(21028511, 105804817, 0U)));
+    CHECK_EQ(describe(cache), "0 s old");
+    CHECK(cache.update(fixAt(21028511, 105804817, 10U)));
+    CHECK_EQ(cache.location().accuracyM, 1U);
+}
+
+/* After a restart the stored location is known at once, described by its UTC time */
+TEST_CASE(survivesRestart) {
+    hostNvsClear();
+    {
+        LocationCache cache;
+        cache.begin();
+        CHECK(cache.update(fixAt(-33850000, 151200000, 150U)));
+    }
+
+    LocationCache cache;
+    CHECK(cache.begin());
+    CHECK(cache.hasLocation());
+    CHECK(!cache.isFromThisBoot());
+    CHECK_EQ(cache.location().position.latitudeE6, -33850000);
+    CHECK_EQ(cache.location().position.longitudeE6, 151200000);
+    CHECK_EQ(cache.ageSeconds(), LOCATION_AGE_UNKNOWN);
+    CHECK_EQ(describe(cache), "16/10 10:15 UTC, accuracy 8 m");
+
+    CHECK(cache.update(fixAt(-33850000, 151200000, 150U)));
+    CHECK(cache.isFromThisBoot());
+    CHECK_EQ(cache.ageSeconds(), 0U);
+}
+
+/* NVS is written on the first fix, after a real move and at most every save interval at rest */
+TEST_CASE(limitsFlashWrites) {
+    hostNvsClear();
+    LocationCache cache;
+    cache.begin();
+    uint32_t writesBefore = hostNvsWrites();
+
+    CHECK(cache.update(fixAt(21028511, 105804817, 150U)));
+    CHECK_EQ(hostNvsWrites() - writesBefore, 1U);
+    for (uint32_t i = 0; i < 100U; i++) {
+        delay(1000);
+        CHECK(cache.update(fixAt(21028511 + (int32_t)(i % 50U), 105804817, 150U)));
+    }
+    CHECK_EQ(hostNvsWrites() - writesBefore, 1U);
+
+    CHECK(cache.update(fixAt(21029511, 105804817, 150U)));
+    CHECK_EQ(hostNvsWrites() - writesBefore, 2U);
+
+    delay(LOCATION_SAVE_INTERVAL_MS);
+    CHECK(cache.update(fixAt(21029511, 105804817, 150U)));
+    CHECK_EQ(hostNvsWrites() - writesBefore, 3U);
+}
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "GPS_Coord.h"
+#include <math.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Mean Earth radius of the reference distances (m) */
+#define TEST_EARTH_RADIUS_M       6371008.8
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+static GeoCoord coord(int32_t latitudeE6, int32_t longitudeE6) {
+    GeoCoord result = { latitudeE6, longitudeE6 };
+    return result;
+}
+
+/* Great-circle distance in floating point (m) */
+static double haversineM(const GeoCoord& from, const GeoCoord& to) {
+    double lat1 = from.latitudeE6 * 1e-6 * M_PI / 180.0;
+    double lat2 = to.latitudeE6 * 1e-6 * M_PI / 180.0;
+    double dLat = lat2 - lat1;
+    double dLon = (to.longitudeE6 - (double)from.longitudeE6) * 1e-6 * M_PI / 180.0;
+    double a = sin(dLat / 2.0) * sin(dLat / 2.0) +
+               cos(lat1) * cos(lat2) * sin(dLon / 2.0) * sin(dLon / 2.0);
+    return 2.0 * TEST_EARTH_RADIUS_M * asin(sqrt(a));
+}
+
+/* Initial great-circle bearing in floating point (degrees, 0..360) */
+static double bearingDeg(const GeoCoord& from, const GeoCoord& to) {
+    double lat1 = from.latitudeE6 * 1e-6 * M_PI / 180.0;
+    double lat2 = to.latitudeE6 * 1e-6 * M_PI / 180.0;
+    double dLon = (to.longitudeE6 - (double)from.longitudeE6) * 1e-6 * M_PI / 180.0;
+    double y = sin(dLon) * cos(lat2);
+    double x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dLon);
+    double degrees = atan2(y, x) * 180.0 / M_PI;
+    return (degrees < 0.0) ? degrees + 360.0 : degrees;
+}
+
+/* Difference between two bearings, across north (degrees) */
+static double bearingError(double a, double b) {
+    double difference = fabs(a - b);
+    return (difference > 180.0) ? 360.0 - difference : difference;
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Latitude within +-90 degrees and longitude within +-180 degrees */
+TEST_CASE(checksRange) {
+    CHECK(geoIsValid(coord(21028511, 105804817)));
+    CHECK(geoIsValid(coord(-90000000, 180000000)));
+    CHECK(geoIsValid(coord(90000000, -180000000)));
+    CHECK(!geoIsValid(coord(90000001, 0)));
+    CHECK(!geoIsValid(coord(0, -180000001)));
+}
+
+/* Distances from a few metres to 50 km stay within 1 % (plus a metre) of the great circle */
+TEST_CASE(measuresDistance) {
+    GeoCoord hanoi = coord(21028511, 105804817);
+    CHECK_EQ(geoDistanceM(hanoi, hanoi), 0U);
+    CHECK_EQ(geoDistanceM(hanoi, coord(21029511, 105804817)), 111U);
+
+    const GeoCoord starts[] = { hanoi, coord(-33850000, 151200000), coord(64128000, -21827000),
+                                coord(0, 179990000) };
+    const int32_t offsetsE6[][2] = { { 45, 0 }, { 0, 90 }, { -300, 700 }, { 4500, -4500 },
+                                     { -120000, 80000 }, { 300000, 300000 }, { 0, 20000 } };
+    for (const GeoCoord& start : starts) {
+        for (const int32_t* offset : offsetsE6) {
+            GeoCoord end = coord(start.latitudeE6 + offset[0], start.longitudeE6 + offset[1]);
+            if (end.longitudeE6 > 180000000) {
+                end.longitudeE6 -= 360000000;
+            }
+            double reference = haversineM(start, end);
+            double measured = geoDistanceM(start, end);
+            CHECK(fabs(measured - reference) <= reference * 0.01 + 1.0);
+            CHECK_EQ(geoDistanceM(end, start), geoDistanceM(start, end));
+        }
+    }
+}
+
+/* Bearings round to the degree and stay within a degree of the great-circle bearing */
+TEST_CASE(measuresBearing) {
+    GeoCoord hanoi = coord(21028511, 105804817);
+    CHECK_EQ(geoBearingDeg(hanoi, hanoi), 0U);
+    CHECK_EQ(geoBearingDeg(hanoi, coord(21038511, 105804817)), 0U);
+    CHECK_EQ(geoBearingDeg(hanoi, coord(21028511, 105814817)), 90U);
+    CHECK_EQ(geoBearingDeg(hanoi, coord(21018511, 105804817)), 180U);
+    CHECK_EQ(geoBearingDeg(hanoi, coord(21028511, 105794817)), 270U);
+
+    for (int32_t angle = 0; angle < 360; angle += 7) {
+        double radians = angle * M_PI / 180.0;
+        GeoCoord end = coord(hanoi.latitudeE6 + (int32_t)lround(cos(radians) * 20000.0),
+                             hanoi.longitudeE6 + (int32_t)lround(sin(radians) * 20000.0 /
+                                                                 cos(21.03 * M_PI / 180.0)));
+        uint16_t bearing = geoBearingDeg(hanoi, end);
+        CHECK(bearing < 360U);
+        CHECK(bearingError(bearing, bearingDeg(hanoi, end)) <= 1.0);
+    }
+
+    /* Across the antimeridian the short way round is taken */
+    CHECK_EQ(geoBearingDeg(coord(0, 179990000), coord(0, -179990000)), 90U);
+    CHECK_EQ(geoDistanceM(coord(0, 179990000), coord(0, -179990000)), 2224U);
+}
+
+/* Six decimals with the sign, for any position, straight into the caller's buffer */
+TEST_CASE(formatsMapLink) {
+    char link[GEO_MAP_LINK_MAX_LEN + 1U];
+    CHECK_EQ(geoFormatMapLink(coord(21028511, 105804817), link, sizeof(link)),
+             strlen("https://www.google.com/maps?q=21.028511,105.804817"));
+    CHECK_EQ(link, "https://www.google.com/maps?q=21.028511,105.804817");
+    geoFormatMapLink(coord(-500000, -7), link, sizeof(link));
+    CHECK_EQ(link, "https://www.google.com/maps?q=-0.500000,-0.000007");
+    geoFormatMapLink(coord(0, 0), link, sizeof(link));
+    CHECK_EQ(link, "https://www.google.com/maps?q=0.000000,0.000000");
+    CHECK_EQ(geoFormatMapLink(coord(-90000000, -180000000), link, sizeof(link)),
+             GEO_MAP_LINK_MAX_LEN);
+    CHECK_EQ(link, "https://www.google.com/maps?q=-90.000000,-180.000000");
+}
+
+/* A link that does not fit leaves an empty string, never a truncated link */
+TEST_CASE(refusesShortBuffers) {
+    char link[GEO_MAP_LINK_MAX_LEN + 1U];
+    CHECK_EQ(geoFormatMapLink(coord(-90000000, -180000000), link, GEO_MAP_LINK_MAX_LEN), 0U);
+    CHECK_EQ(link, "");
+    CHECK_EQ(geoFormatMapLink(coord(0, 0), link, 0U), 0U);
+
+    char message[64];
+    CHECK_EQ(geoFormatMessage("SOS! ", coord(21028511, 105804817), message, sizeof(message)),
+             strlen("SOS! https://www.google.com/maps?q=21.028511,105.804817"));
+    CHECK_EQ(message, "SOS! https://www.google.com/maps?q=21.028511,105.804817");
+    CHECK_EQ(geoFormatMessage("SOS! I need help, my location is ", coord(21028511, 105804817),
+                              message, sizeof(message)), 0U);
+    CHECK_EQ(message, "");
+}
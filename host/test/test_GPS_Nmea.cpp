@@ -0,0 +1,167 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "GPS_Nmea.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* Recorded sentences, checksums included */
+#define GGA_DUBLIN      "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76"
+#define GGA_SYDNEY      "$GPGGA,235959.5,3351.000000,S,15112.000000,E,2,12,0.8,-5.3,M,0,M,,*4A"
+#define GGA_NO_FIX      "$GPGGA,101501.00,,,,,0,00,99.99,,,,,,*62"
+#define RMC_HANOI       "$GNRMC,101500.00,A,2101.710660,N,10548.289020,E,0.0,0.0,161026,,,A*4A"
+#define RMC_VOID        "$GNRMC,101502.00,V,,,,,,,161026,,,N*66"
+#define GSA_3D          "$GNGSA,A,3,05,12,15,18,24,25,,,,,,,1.8,0.9,1.5*22"
+#define GSV_VIEW        "$GPGSV,3,1,11,05,45,120,38,12,30,210,35,15,60,300,40,18,20,045,33*7D"
+
+/* Modem responses, which carry no checksum */
+#define CGPSINFO_HANOI  "+CGPSINFO: 2101.710660,N,10548.289020,E,161026,101500.0,15.2,0.0,0.0"
+#define CGPSINFO_EMPTY  "+CGPSINFO: ,,,,,,,,"
+#define CGNSINF_HANOI   "+CGNSINF: 1,1,20261016101500.000,21.028511,105.804817,15.200," \
+                        "0.00,0.0,1,,1.2,1.5,0.9,,12,8,,,42,,"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Feeds a line without its line ending */
+static uint8_t feedLine(GnssParser& parser, const char* line) {
+    return parser.feedLine(line, strlen(line));
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* GGA: position in millionths of a degree, time, quality, satellites, HDOP and altitude */
+TEST_CASE(parsesGga) {
+    GnssParser parser;
+    delay(5);
+    CHECK_EQ(feedLine(parser, GGA_DUBLIN), 1U);
+    const GnssFix& fix = parser.fix();
+    CHECK(fix.valid);
+    CHECK_EQ(fix.position.latitudeE6, 53361336);
+    CHECK_EQ(fix.position.longitudeE6, -6505620);
+    CHECK_EQ(fix.utcTimeMs, 34070000U);
+    CHECK_EQ(fix.quality, 1U);
+    CHECK_EQ(fix.satellites, 8U);
+    CHECK_EQ(fix.hdopX100, 103U);
+    CHECK_EQ(fix.altitudeDm, 617);
+    CHECK_EQ(fix.updatedMs, millis());
+
+    CHECK_EQ(feedLine(parser, GGA_SYDNEY), 1U);
+    CHECK_EQ(fix.position.latitudeE6, -33850000);
+    CHECK_EQ(fix.position.longitudeE6, 151200000);
+    CHECK_EQ(fix.utcTimeMs, 86399500U);
+    CHECK_EQ(fix.quality, 2U);
+    CHECK_EQ(fix.hdopX100, 80U);
+    CHECK_EQ(fix.altitudeDm, -53);
+    CHECK_EQ(parser.sentencesAccepted(), 2U);
+}
+
+/* RMC brings the date, GSA the fix type and HDOP; each keeps what the others reported */
+TEST_CASE(combinesRmcAndGsa) {
+    GnssParser parser;
+    CHECK_EQ(feedLine(parser, GGA_DUBLIN), 1U);
+    CHECK_EQ(feedLine(parser, RMC_HANOI), 1U);
+    CHECK_EQ(feedLine(parser, GSA_3D), 1U);
+    const GnssFix& fix = parser.fix();
+    CHECK(fix.valid);
+    CHECK_EQ(fix.position.latitudeE6, 21028511);
+    CHECK_EQ(fix.position.longitudeE6, 105804817);
+    CHECK_EQ(fix.utcDate, 161026U);
+    CHECK_EQ(fix.utcTimeMs, 36900000U);
+    CHECK_EQ(fix.fixType, 3U);
+    CHECK_EQ(fix.hdopX100, 90U);
+    CHECK_EQ(fix.satellites, 8U);
+}
+
+/* A receiver that loses the fix clears valid but keeps the last position */
+TEST_CASE(reportsLostFix) {
+    GnssParser parser;
+    CHECK_EQ(feedLine(parser, RMC_HANOI), 1U);
+    CHECK_EQ(feedLine(parser, RMC_VOID), 1U);
+    CHECK(!parser.fix().valid);
+    CHECK_EQ(parser.fix().position.latitudeE6, 21028511);
+
+    CHECK_EQ(feedLine(parser, RMC_HANOI), 1U);
+    CHECK(parser.fix().valid);
+    CHECK_EQ(feedLine(parser, GGA_NO_FIX), 1U);
+    CHECK(!parser.fix().valid);
+    CHECK_EQ(parser.fix().quality, 0U);
+    CHECK_EQ(parser.fix().hdopX100, 9999U);
+}
+
+/* A sentence with a wrong or missing checksum never changes the fix */
+TEST_CASE(rejectsBadChecksums) {
+    GnssParser parser;
+    CHECK_EQ(feedLine(parser, RMC_HANOI), 1U);
+    std::string sentence(GGA_DUBLIN);
+    std::string wrong = sentence.substr(0, sentence.size() - 1U) + "7";
+    std::string missing = sentence.substr(0, sentence.size() - 3U);
+    std::string truncated = sentence.substr(0, sentence.size() - 1U);
+    CHECK_EQ(feedLine(parser, wrong.c_str()), 0U);
+    CHECK_EQ(feedLine(parser, missing.c_str()), 0U);
+    CHECK_EQ(feedLine(parser, truncated.c_str()), 0U);
+    CHECK_EQ(parser.checksumErrors(), 1U);
+    CHECK_EQ(parser.fix().position.latitudeE6, 21028511);
+    CHECK_EQ(parser.sentencesAccepted(), 1U);
+
+    CHECK_EQ(feedLine(parser, GSA_3D), 1U);
+    CHECK_EQ(feedLine(parser, RMC_VOID), 1U);
+    CHECK_EQ(parser.sentencesAccepted(), 3U);
+}
+
+/* Byte by byte: '$' restarts after a lost line ending, unknown sentences and overlong fields
+   are skipped to the end of their line */
+TEST_CASE(resynchronisesAndSkips) {
+    GnssParser parser;
+    const char stream[] = "$GPGGA,0927" RMC_HANOI "\r\n" GSV_VIEW "\r\n"
+                          "$GPGGA,092750.000000000000000000001,5321.6802,N*00\r\n"
+                          "noise\r\n" GSA_3D "\r\n";
+    uint8_t published = 0U;
+    for (size_t i = 0; i + 1U < sizeof(stream); i++) {
+        if (parser.feed(stream[i])) {
+            published++;
+        }
+    }
+    CHECK_EQ(published, 2U);
+    CHECK(parser.fix().valid);
+    CHECK_EQ(parser.fix().position.longitudeE6, 105804817);
+    CHECK_EQ(parser.fix().fixType, 3U);
+    CHECK_EQ(parser.sentencesAccepted(), 2U);
+    CHECK_EQ(parser.checksumErrors(), 0U);
+}
+
+/* +CGPSINFO and +CGNSINF: an empty +CGPSINFO means no fix */
+TEST_CASE(parsesModemResponses) {
+    GnssParser parser;
+    CHECK_EQ(feedLine(parser, CGPSINFO_HANOI), 1U);
+    const GnssFix& fix = parser.fix();
+    CHECK(fix.valid);
+    CHECK_EQ(fix.position.latitudeE6, 21028511);
+    CHECK_EQ(fix.position.longitudeE6, 105804817);
+    CHECK_EQ(fix.utcDate, 161026U);
+    CHECK_EQ(fix.utcTimeMs, 36900000U);
+    CHECK_EQ(fix.altitudeDm, 152);
+
+    CHECK_EQ(feedLine(parser, CGPSINFO_EMPTY), 1U);
+    CHECK(!fix.valid);
+    CHECK_EQ(fix.quality, 0U);
+
+    CHECK_EQ(feedLine(parser, CGNSINF_HANOI), 1U);
+    CHECK(fix.valid);
+    CHECK_EQ(fix.position.latitudeE6, 21028511);
+    CHECK_EQ(fix.position.longitudeE6, 105804817);
+    CHECK_EQ(fix.utcDate, 161026U);
+    CHECK_EQ(fix.utcTimeMs, 36900000U);
+    CHECK_EQ(fix.hdopX100, 120U);
+    CHECK_EQ(fix.satellites, 8U);
+
+    CHECK_EQ(feedLine(parser, "+CSQ: 21,99"), 0U);
+    CHECK_EQ(parser.sentencesAccepted(), 3U);
+
+    parser.reset();
+    CHECK(!parser.fix().valid);
+    CHECK_EQ(parser.fix().position.latitudeE6, 0);
+}
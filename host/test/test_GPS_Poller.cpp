@@ -0,0 +1,193 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+#include "GPS_Poller.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/* Position the fake receiver reports, and one about 110 m north of it */
+#define TEST_LATITUDE             21.028511
+#define TEST_LONGITUDE            105.804817
+#define TEST_MOVED_LATITUDE       21.029511
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Polls the engine and the poller every millisecond for ms of virtual time */
+static void runFor(AtEngine& engine, GnssPoller& poller, uint32_t ms) {
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < ms) {
+        engine.poll();
+        poller.poll();
+        delay(1);
+    }
+}
+
+/* Gap between the last two AT+CGPSINFO the module received (ms), 0 if fewer than two */
+static uint32_t lastQueryGapMs(const FakeModem& modem) {
+    const std::vector<FakeModemCommand>& commands = modem.commands();
+    uint32_t lastMs = 0U;
+    uint32_t previousMs = 0U;
+    uint32_t seen = 0U;
+    for (const FakeModemCommand& command : commands) {
+        if (command.text == "AT+CGPSINFO") {
+            previousMs = lastMs;
+            lastMs = command.atMs;
+            seen++;
+        }
+    }
+    return (seen >= 2U) ? lastMs - previousMs : 0U;
+}
+
+/* True if gapMs is the interval after an answer that took gnssMs, plus its wire time */
+static bool isQueryGap(uint32_t gapMs, uint32_t intervalMs, FakeModem& modem) {
+    uint32_t expectedMs = intervalMs + modem.timing().gnssMs;
+    return gapMs >= expectedMs && gapMs < expectedMs + 10U;
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Fast queries without a fix, slower while tracking, the stable interval once in place */
+TEST_CASE(adaptsRateToFixState) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().jitterMs = 0U;
+    AtEngine engine(port);
+    GnssParser parser;
+    GnssPoller poller(engine, parser);
+    poller.setStableInterval(20000U);
+
+    runFor(engine, poller, 6500U);
+    CHECK_EQ(poller.mode(), GNSS_POLL_ACQUIRING);
+    CHECK_EQ(modem.count("AT+CGPSINFO"), 4U);
+    CHECK(isQueryGap(lastQueryGapMs(modem), GNSS_POLL_ACQUIRE_MS, modem));
+    CHECK_EQ(poller.stats().withoutFix, 4U);
+    CHECK(!poller.fix().valid);
+    CHECK_EQ(poller.mapLink(), "");
+
+    modem.setFix(TEST_LATITUDE, TEST_LONGITUDE);
+    runFor(engine, poller, 2000U);
+    CHECK_EQ(poller.mode(), GNSS_POLL_TRACKING);
+    CHECK(poller.fix().valid);
+    CHECK_EQ(poller.mapLink(), "https://www.google.com/maps?q=21.028511,105.804817");
+
+    runFor(engine, poller, 2U * (GNSS_POLL_TRACK_MS + 100U));
+    CHECK_EQ(poller.mode(), GNSS_POLL_STABLE);
+    CHECK(isQueryGap(lastQueryGapMs(modem), GNSS_POLL_TRACK_MS, modem));
+    uint32_t queries = modem.count("AT+CGPSINFO");
+    runFor(engine, poller, 19000U);
+    CHECK_EQ(modem.count("AT+CGPSINFO"), queries);
+    runFor(engine, poller, 1200U);
+    CHECK_EQ(modem.count("AT+CGPSINFO"), queries + 1U);
+    CHECK(isQueryGap(lastQueryGapMs(modem), 20000U, modem));
+    CHECK_EQ(poller.stats().failures, 0U);
+}
+
+/* The fix is published once per change: repeated answers at the same place leave it alone */
+TEST_CASE(publishesOnlyChangedFixes) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    GnssParser parser;
+    GnssPoller poller(engine, parser);
+    modem.setFix(TEST_LATITUDE, TEST_LONGITUDE);
+
+    runFor(engine, poller, 100U);
+    uint32_t version = poller.fixVersion();
+    CHECK_EQ(version, 1U);
+    runFor(engine, poller, 3U * GNSS_POLL_TRACK_MS);
+    CHECK(poller.stats().withFix >= 3U);
+    CHECK_EQ(poller.fixVersion(), version);
+    CHECK_EQ(poller.stats().publishes, 1U);
+
+    modem.setFix(TEST_MOVED_LATITUDE, TEST_LONGITUDE);
+    runFor(engine, poller, GNSS_POLL_STABLE_MS + 100U);
+    CHECK_EQ(poller.fixVersion(), version + 1U);
+    CHECK_EQ(poller.mode(), GNSS_POLL_TRACKING);
+    CHECK_EQ(poller.mapLink(), "https://www.google.com/maps?q=21.029511,105.804817");
+
+    modem.clearFix();
+    runFor(engine, poller, GNSS_POLL_TRACK_MS + 100U);
+    CHECK_EQ(poller.fixVersion(), version + 2U);
+    CHECK_EQ(poller.mode(), GNSS_POLL_ACQUIRING);
+    CHECK(!poller.fix().valid);
+    CHECK_EQ(poller.mapLink(), "");
+}
+
+/* NMEA lines fed to the parser outside the queries publish as well */
+TEST_CASE(publishesFixFromOtherLines) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    GnssParser parser;
+    GnssPoller poller(engine, parser);
+
+    runFor(engine, poller, 100U);
+    CHECK_EQ(poller.fixVersion(), 0U);
+    const char* rmc = "$GNRMC,101500.00,A,2101.710660,N,10548.289020,E,0.0,0.0,161026,,,A*4A";
+    CHECK_EQ(parser.feedLine(rmc, strlen(rmc)), 1U);
+    poller.poll();
+    CHECK_EQ(poller.fixVersion(), 1U);
+    CHECK_EQ(poller.fix().position.latitudeE6, 21028511);
+    CHECK_EQ(poller.mapLink(), "https://www.google.com/maps?q=21.028511,105.804817");
+}
+
+/* A query never queues behind other commands: it retries once the engine is idle */
+TEST_CASE(waitsWhileEngineBusy) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().smsNetworkMs = 1800U;
+    AtEngine engine(port);
+    GnssParser parser;
+    GnssPoller poller(engine, parser);
+
+    AtHandle sms = engine.submit(AT_CMD_SMS_SEND, "+84900000001", "SOS test");
+    runFor(engine, poller, 1000U);
+    CHECK_EQ(modem.count("AT+CGPSINFO"), 0U);
+    CHECK_EQ(poller.stats().queries, 0U);
+    CHECK_EQ(engine.waitFor(sms), AT_RESULT_OK);
+    engine.release(sms);
+
+    runFor(engine, poller, GNSS_BUSY_RETRY_MS + 100U);
+    CHECK_EQ(modem.count("AT+CGPSINFO"), 1U);
+    CHECK(modem.last("AT+CGPSINFO")->atMs >= modem.last("AT+CMGS=")->atMs + 1800U);
+    CHECK_EQ(poller.stats().failures, 0U);
+}
+
+/* poll() returns how long nothing is due; traffic is counted per query */
+TEST_CASE(reportsWaitAndTraffic) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.timing().jitterMs = 0U;
+    AtEngine engine(port);
+    GnssParser parser;
+    GnssPoller poller(engine, parser);
+    poller.setStableInterval(1000U);
+
+    CHECK_EQ(poller.poll(), GNSS_RESULT_CHECK_MS);
+    CHECK_EQ(poller.lastQueryMs(), millis());
+    runFor(engine, poller, 100U);
+    uint32_t waitMs = poller.poll();
+    CHECK(waitMs > GNSS_POLL_ACQUIRE_MS - 100U);
+    CHECK(waitMs <= GNSS_POLL_ACQUIRE_MS);
+
+    const GnssPollStats& stats = poller.stats();
+    CHECK_EQ(stats.queries, 1U);
+    CHECK_EQ(stats.txBytes, 12U);
+    CHECK_EQ(stats.rxBytes, strlen("+CGPSINFO: ,,,,,,,,"));
+    poller.resetStats();
+    CHECK_EQ(poller.stats().queries, 0U);
+}
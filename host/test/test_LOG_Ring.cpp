@@ -0,0 +1,109 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "LOG_Ring.h"
+#include <HostSim.h>
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Prints every queued record of systemLog and returns the console output */
+static std::string drainLog() {
+    static bool started = false;
+    if (!started) {
+        /* The drain task only runs while a test sleeps; the cases drain by hand */
+        started = systemLog.begin(Serial);
+    }
+    hostCaptureConsole(true);
+    systemLog.drain();
+    std::string output = hostTakeConsole();
+    hostCaptureConsole(false);
+    return output;
+}
+
+/* Number of lines in console output */
+static size_t countLines(const std::string& output) {
+    size_t lines = 0U;
+    for (char c : output) {
+        lines += (c == '\n') ? 1U : 0U;
+    }
+    return lines;
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Arguments come back as written, whatever their type, and each line carries its level tag */
+TEST_CASE(printsArgumentsAndLevel) {
+    drainLog();
+    int16_t negative = -331;
+    uint32_t large = 4000000000UL;
+    uint8_t small = 7U;
+    LOG_ERROR("err %d %u %x %u", negative, large, 0xBEEFU, small);
+    LOG_WARN("warn %u", false);
+    LOG_INFO("info");
+
+    std::string output = drainLog();
+    CHECK_EQ(countLines(output), 3U);
+    CHECK(output.find(" E err -331 4000000000 beef 7\r\n") != std::string::npos);
+    CHECK(output.find(" W warn 0\r\n") != std::string::npos);
+    CHECK(output.find(" I info\r\n") != std::string::npos);
+}
+
+/* Levels above LOG_LEVEL compile to nothing: no record is written */
+TEST_CASE(stripsLevelsAboveLogLevel) {
+    drainLog();
+    uint32_t written = systemLog.recordsWritten();
+    LOG_DEBUG("debug %u", 1U);
+    LOG_DEBUG_TEXT("debug %s", "text", 4U);
+    CHECK_EQ(systemLog.recordsWritten(), written);
+    LOG_INFO("info %u", 1U);
+    CHECK_EQ(systemLog.recordsWritten(), written + 1U);
+    CHECK_EQ(drainLog().find("debug"), std::string::npos);
+}
+
+/* A full ring drops new records, counts them and reports the gap once on the next drain */
+TEST_CASE(countsDroppedRecords) {
+    drainLog();
+    uint32_t dropped = systemLog.recordsDropped();
+    for (uint32_t i = 0; i < LOG_RING_SIZE + 3U; i++) {
+        LOG_INFO("record %u", (unsigned)i);
+    }
+    CHECK_EQ(systemLog.recordsDropped(), dropped + 3U);
+
+    std::string output = drainLog();
+    CHECK_EQ(countLines(output), LOG_RING_SIZE + 1U);
+    CHECK(output.find(" I record 0\r\n") != std::string::npos);
+    CHECK(output.find(" I record 31\r\n") != std::string::npos);
+    CHECK_EQ(output.find(" I record 32\r\n"), std::string::npos);
+    CHECK(output.find("[LOG] 3 record(s) dropped\n") != std::string::npos);
+
+    /* Room again, and the drops are not reported twice */
+    LOG_INFO("after");
+    output = drainLog();
+    CHECK_EQ(countLines(output), 1U);
+    CHECK_EQ(systemLog.recordsDropped(), dropped + 3U);
+}
+
+/* Copied text is cut at LOG_TEXT_MAX_LEN - 1 characters, the line at LOG_LINE_MAX_LEN - 1 */
+TEST_CASE(truncatesTextAndLine) {
+    drainLog();
+    std::string text(200U, 'x');
+    LOG_INFO_TEXT("<%s>", text.c_str(), text.size());
+    LOG_INFO_TEXT("%s", "short\0hidden", 12U);
+
+    std::string output = drainLog();
+    std::string expected = "<" + std::string(LOG_TEXT_MAX_LEN - 1U, 'x') + ">\r\n";
+    CHECK(output.find(expected) != std::string::npos);
+    CHECK(output.find(" I short\r\n") != std::string::npos);
+
+    /* A format alone longer than the line */
+    LOG_INFO("yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy"
+             "yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy"
+             "yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy"
+             "yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy %u", 1234U);
+    output = drainLog();
+    CHECK_EQ(output.size(), LOG_LINE_MAX_LEN - 1U + 2U);
+    CHECK(output.compare(output.size() - 3U, 3U, "y\r\n") == 0);
+}
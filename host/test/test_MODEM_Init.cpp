@@ -0,0 +1,130 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "MODEM_Init.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* The shape of the sketch's boot script: a retried probe, required and optional settings */
+static const ModemInitStep TEST_SCRIPT[] = {
+    { &AT_CMD_ATTENTION,       NULL,                         NULL,               20, true  },
+    { &AT_CMD_ECHO_OFF,        NULL,                         NULL,               2,  true  },
+    { &AT_CMD_CHARSET_GSM,     &AT_CMD_CHARSET_QUERY,        "\"GSM\"",          2,  true  },
+    { &AT_CMD_SMS_TEXT_MODE,   &AT_CMD_SMS_MODE_QUERY,       "+CMGF: 1",         2,  true  },
+    { &AT_CMD_CLIP_ON,         &AT_CMD_CLIP_QUERY,           "+CLIP: 1",         2,  false },
+    { &AT_CMD_SIGNAL_QUALITY,  NULL,                         NULL,               0,  false }
+};
+static const uint8_t TEST_STEPS = sizeof(TEST_SCRIPT) / sizeof(TEST_SCRIPT[0]);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Runs the script to the end */
+static void runScript(ModemInitRunner& runner) {
+    runner.begin(TEST_SCRIPT, TEST_STEPS);
+    while (!runner.poll()) {
+        delay(1);
+    }
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* A factory-fresh module gets every setting, each step right after the previous answer */
+TEST_CASE(appliesEveryStep) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    ModemInitRunner runner(engine);
+
+    runScript(runner);
+    CHECK(runner.isReady());
+    for (uint8_t i = 0; i < TEST_STEPS; i++) {
+        CHECK_EQ(runner.stepStatus(i), MODEM_STEP_APPLIED);
+        CHECK_EQ(runner.stepAttempts(i), 1U);
+    }
+    CHECK_EQ(modem.setting("+CMGF"), "1");
+    CHECK_EQ(modem.setting("+CLIP"), "1");
+    CHECK(runner.totalMs() < 1000U);
+}
+
+/* After an ESP32 reset the module kept its settings: the probes skip the commands */
+TEST_CASE(skipsSettingsInEffect) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    ModemInitRunner first(engine);
+    runScript(first);
+
+    ModemInitRunner second(engine);
+    runScript(second);
+    CHECK(second.isReady());
+    CHECK_EQ(second.stepStatus(2), MODEM_STEP_SKIPPED);
+    CHECK_EQ(second.stepStatus(3), MODEM_STEP_SKIPPED);
+    CHECK_EQ(second.stepStatus(4), MODEM_STEP_SKIPPED);
+    CHECK_EQ(modem.count("AT+CMGF=1"), 1U);
+    CHECK_EQ(modem.count("AT+CMGF?"), 2U);
+}
+
+/* The first probe is retried until the module has booted */
+TEST_CASE(retriesUntilModuleBoots) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port, 2000U);
+    AtEngine engine(port);
+    ModemInitRunner runner(engine);
+
+    runScript(runner);
+    CHECK(runner.isReady());
+    CHECK(runner.stepAttempts(0) > 1U);
+    CHECK(runner.stepMs(0) >= 2000U);
+    CHECK(runner.stepMs(0) < 2000U + 2U * AT_CMD_ATTENTION.timeoutMs);
+}
+
+/* A failed optional step is retried and then given up; a failed required step is not ready */
+TEST_CASE(reportsFailedSteps) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    int clipFailures = 1;
+    modem.on("AT+CLIP=1", [&clipFailures](FakeModem& fake, const std::string&) {
+        if (clipFailures-- > 0) {
+            fake.reply("ERROR", 20U);
+            return true;
+        }
+        return false;
+    });
+    AtEngine engine(port);
+    ModemInitRunner runner(engine);
+
+    runScript(runner);
+    CHECK(runner.isReady());
+    CHECK_EQ(runner.stepStatus(4), MODEM_STEP_APPLIED);
+    CHECK_EQ(runner.stepAttempts(4), 2U);
+
+    modem.on("AT+CMGF=", [](FakeModem& fake, const std::string&) {
+        fake.reply("+CMS ERROR: 500", 20U);
+        return true;
+    });
+    modem.on("AT+CMGF?", [](FakeModem& fake, const std::string&) {
+        fake.reply("+CMGF: 0\n\nOK", 20U);
+        return true;
+    });
+    ModemInitRunner failing(engine);
+    runScript(failing);
+    CHECK(!failing.isReady());
+    CHECK_EQ(failing.stepStatus(3), MODEM_STEP_FAILED);
+    CHECK_EQ(failing.stepAttempts(3), 3U);
+    CHECK(failing.stepStatus(5) != MODEM_STEP_PENDING);
+}
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "MODEM_Link.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the link on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Cold power-on: nothing answers for seconds, then the link still reaches the top rate */
+TEST_CASE(negotiatesAfterColdBoot) {
+    HardwareSerial port(TEST_UART);
+    FakeModem modem(port, 4000U);
+    AtEngine engine(port);
+    ModemLink link(port, engine);
+
+    CHECK(link.begin(33, 25, -1, -1));
+    CHECK_EQ(link.stats().baudRate, MODEM_BAUD_MAX);
+    CHECK_EQ(modem.baud(), MODEM_BAUD_MAX);
+    CHECK_EQ(port.baudRate(), MODEM_BAUD_MAX);
+    CHECK(link.stats().negotiationMs >= 4000U);
+    CHECK(link.stats().negotiationMs < MODEM_LINK_READY_TIMEOUT_MS + 2000U);
+
+    AtHandle handle = engine.submit(AT_CMD_ATTENTION);
+    CHECK_EQ(engine.waitFor(handle), AT_RESULT_OK);
+    engine.release(handle);
+}
+
+/* ESP32 reset alone: the module kept the rate of an earlier AT+IPR */
+TEST_CASE(findsStoredRate) {
+    HardwareSerial port(TEST_UART);
+    FakeModem modem(port);
+    modem.setBaud(460800UL);
+    AtEngine engine(port);
+    ModemLink link(port, engine);
+
+    CHECK(link.begin(33, 25, -1, -1));
+    CHECK_EQ(link.stats().baudRate, MODEM_BAUD_MAX);
+    CHECK_EQ(modem.baud(), MODEM_BAUD_MAX);
+}
+
+/* Rates the wiring cannot carry are rejected and both sides fall back */
+TEST_CASE(fallsBackBelowUnreliableRate) {
+    HardwareSerial port(TEST_UART);
+    FakeModem modem(port);
+    modem.setMaxReliableBaud(230400UL);
+    AtEngine engine(port);
+    ModemLink link(port, engine);
+
+    CHECK(link.begin(33, 25, -1, -1));
+    CHECK_EQ(link.stats().baudRate, 230400UL);
+    CHECK_EQ(modem.baud(), 230400UL);
+    CHECK_EQ(port.baudRate(), 230400UL);
+}
+
+/* Flow control is enabled on both sides before the rate goes up */
+TEST_CASE(enablesFlowControl) {
+    HardwareSerial port(TEST_UART);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    ModemLink link(port, engine);
+
+    CHECK(link.begin(33, 25, 18, 19));
+    CHECK(link.stats().flowControl);
+    CHECK(port.hostFlowControl());
+    CHECK_EQ(modem.setting("+IFC"), "2,2");
+    CHECK(modem.last("AT+IFC=")->atMs < modem.last("AT+IPR=")->atMs);
+}
+
+/* A module that never answers: begin() gives up after the ready timeout at the default rate */
+TEST_CASE(givesUpWithoutModule) {
+    HardwareSerial port(TEST_UART);
+    FakeModem modem(port, 3600000U);
+    AtEngine engine(port);
+    ModemLink link(port, engine);
+
+    CHECK(!link.begin(33, 25, -1, -1));
+    CHECK_EQ(link.stats().baudRate, MODEM_BAUD_DEFAULT);
+    CHECK_EQ(port.baudRate(), MODEM_BAUD_DEFAULT);
+    CHECK(link.stats().negotiationMs >= MODEM_LINK_READY_TIMEOUT_MS);
+    CHECK(!link.stats().flowControl);
+}
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+#include "MODEM_RxTask.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the task on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* A task never ends, so the port and the task outlive every case */
+static HardwareSerial port(TEST_UART);
+static ModemRxTask rxTask(port);
+static volatile uint32_t listenerCalls = 0U;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+static void countListenerCall(void*) {
+    listenerCalls++;
+}
+
+/* Starts the task on first use and empties it for the case */
+static ModemRxTask& startedTask() {
+    static bool started = false;
+    if (!started) {
+        port.begin(115200);
+        rxTask.setLineListener(countListenerCall, NULL);
+        started = rxTask.start();
+    }
+    rxTask.reset();
+    delay(1);
+    return rxTask;
+}
+
+/* Takes the next queued line as a string ("" when the queue is empty) */
+static std::string takeLine(ModemRxTask& task) {
+    LineView line;
+    return task.nextLine(line) ? std::string(line.data, line.length) : std::string();
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* A URC is queued as soon as its bytes arrive, without anyone polling the port */
+TEST_CASE(queuesLinesAsTheyArrive) {
+    ModemRxTask& task = startedTask();
+    CHECK(hostTaskCount() >= 2U);
+    FakeModem modem(port);
+    uint32_t queuedBefore = task.linesQueued();
+    uint32_t callsBefore = listenerCalls;
+
+    uint32_t startMs = millis();
+    modem.urc("+CSQ: 10,99", 100U);
+    CHECK(task.waitForLine(1000U));
+    uint32_t latencyMs = millis() - startMs;
+    CHECK(latencyMs >= 100U);
+    CHECK(latencyMs <= 102U);
+    CHECK_EQ(takeLine(task), "+CSQ: 10,99");
+    CHECK_EQ(task.linesQueued() - queuedBefore, 1U);
+    CHECK_EQ(listenerCalls - callsBefore, 1U);
+    CHECK(!task.waitForLine(50U));
+}
+
+/* URCs arriving while the consumer is blocked are all kept, in order */
+TEST_CASE(capturesUrcsWhileConsumerBlocks) {
+    ModemRxTask& task = startedTask();
+    FakeModem modem(port);
+    uint32_t droppedBefore = task.linesDropped();
+
+    modem.urc("RING", 100U);
+    modem.urc("+CLIP: \"+84900000001\",145,,,,0", 110U);
+    modem.urc("+CMTI: \"SM\",3", 900U);
+    modem.urc("NO CARRIER", 1500U);
+    delay(2000);
+
+    CHECK_EQ(takeLine(task), "RING");
+    CHECK_EQ(takeLine(task), "+CLIP: \"+84900000001\",145,,,,0");
+    CHECK_EQ(takeLine(task), "+CMTI: \"SM\",3");
+    CHECK_EQ(takeLine(task), "NO CARRIER");
+    CHECK_EQ(takeLine(task), "");
+    CHECK_EQ(task.linesDropped(), droppedBefore);
+}
+
+/* The data prompt is delivered as its own line */
+TEST_CASE(reportsPrompt) {
+    ModemRxTask& task = startedTask();
+    FakeModem modem(port);
+
+    modem.send("\r\n> ", 10U);
+    CHECK(task.waitForLine(100U));
+    LineView line;
+    CHECK(task.nextLine(line));
+    CHECK(line.isPrompt);
+}
+
+/* A full queue drops the newest lines and counts them */
+TEST_CASE(countsLinesDroppedOnFullQueue) {
+    ModemRxTask& task = startedTask();
+    FakeModem modem(port);
+    uint32_t droppedBefore = task.linesDropped();
+
+    std::string burst;
+    for (uint32_t i = 0U; i < MODEM_RX_QUEUE_DEPTH + 4U; i++) {
+        burst += (i == 0U ? "" : "\n") + std::string("+CREG: ") + std::to_string(i);
+    }
+    modem.urc(burst, 10U);
+    delay(200);
+
+    CHECK_EQ(task.queueHighWater(), MODEM_RX_QUEUE_DEPTH);
+    CHECK_EQ(task.linesDropped() - droppedBefore, 4U);
+    CHECK_EQ(takeLine(task), "+CREG: 0");
+    for (uint32_t i = 1U; i < MODEM_RX_QUEUE_DEPTH; i++) {
+        takeLine(task);
+    }
+    CHECK_EQ(takeLine(task), "");
+}
+
+/* reset() throws away queued lines and the partial line the task holds; the rest of that line
+   then arrives as a line of its own */
+TEST_CASE(resetDiscardsQueuedAndPartialInput) {
+    ModemRxTask& task = startedTask();
+    FakeModem modem(port);
+
+    modem.urc("OK", 10U);
+    modem.send("\r\n+CSQ: 1", 20U);
+    delay(50);
+    task.reset();
+    modem.send("5,99\r\n\r\nRING\r\n", 10U);
+    delay(50);
+
+    CHECK_EQ(takeLine(task), "5,99");
+    CHECK_EQ(takeLine(task), "RING");
+    CHECK_EQ(takeLine(task), "");
+}
+
+/* The engine runs commands on lines from the task instead of reading the port itself */
+TEST_CASE(feedsEngine) {
+    ModemRxTask& task = startedTask();
+    FakeModem modem(port);
+    modem.timing().jitterMs = 0U;
+    AtEngine engine(port);
+    engine.setLineSource(&task);
+
+    AtHandle handle = engine.submit(AT_CMD_SIGNAL_QUALITY);
+    CHECK_EQ(engine.waitFor(handle), AT_RESULT_OK);
+    CHECK(engine.latencyMs(handle) < modem.timing().commandMs + 5U);
+    int8_t rssi = -1;
+    CHECK(engine.parse(handle, &rssi));
+    CHECK_EQ(rssi, 21);
+    engine.release(handle);
+    CHECK_EQ(takeLine(task), "");
+}
@@ -0,0 +1,142 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+#include "SMS_Feature.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/* Recipient of the test messages */
+#define TEST_CONTACT              "+84900000001"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Polls the sender until the message has an outcome */
+static SmsStatus finish(SmsSender& sender, AtEngine& engine) {
+    SmsStatus status = sender.status();
+    while (status == SMS_STATUS_SENDING) {
+        status = sender.poll();
+        if (status == SMS_STATUS_SENDING) {
+            engine.idle(AT_ENGINE_WAIT_SLICE_MS);
+        }
+    }
+    return status;
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* The body is written on the prompt and the message completes on +CMGS with its reference */
+TEST_CASE(sendsOnPromptAndReturnsReference) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+
+    CHECK_EQ(sender.start(TEST_CONTACT, "SOS test"), SMS_STATUS_SENDING);
+    CHECK_EQ(finish(sender, engine), SMS_STATUS_SENT);
+    CHECK_EQ(sender.messageReference(), 1);
+    CHECK_EQ(sender.segmentCount(), 1U);
+    CHECK(sender.elapsedMs() >= modem.timing().promptMs + modem.timing().smsNetworkMs);
+    CHECK(sender.elapsedMs() < modem.timing().promptMs + modem.timing().smsNetworkMs + 50U);
+
+    const FakeModemCommand* command = modem.last("AT+CMGS=");
+    CHECK(command != NULL && command->text == "AT+CMGS=\"" TEST_CONTACT "\"");
+    CHECK(command != NULL && command->body == "SOS test");
+    CHECK_EQ(modem.commands().size(), 1U);
+
+    CHECK_EQ(sender.start(TEST_CONTACT, "second"), SMS_STATUS_SENDING);
+    CHECK_EQ(finish(sender, engine), SMS_STATUS_SENT);
+    CHECK_EQ(sender.messageReference(), 2);
+}
+
+/* A network error ends the message at once with its +CMS code */
+TEST_CASE(reportsCmsError) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setSmsError(331);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+
+    sender.start(TEST_CONTACT, "no network");
+    CHECK_EQ(finish(sender, engine), SMS_STATUS_REJECTED);
+    CHECK_EQ(sender.errorCode(), 331);
+    CHECK_EQ(sender.messageReference(), -1);
+}
+
+/* A module that never shows the prompt: the message times out at the prompt deadline */
+TEST_CASE(timesOutWithoutPrompt) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.on("AT+CMGS=", [](FakeModem&, const std::string&) { return true; });
+    AtEngine engine(port);
+    SmsSender sender(engine);
+
+    sender.start(TEST_CONTACT, "lost");
+    CHECK_EQ(finish(sender, engine), SMS_STATUS_TIMEOUT);
+    CHECK_EQ(sender.elapsedMs(), AT_TIMEOUT_SMS_PROMPT_MS);
+}
+
+/* One message at a time; bodies that cannot fit are refused before anything is sent */
+TEST_CASE(refusesWhileBusyAndOversizedBodies) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+
+    std::string oversized(SMS_TEXT_MAX_LEN + 1U, 'x');
+    CHECK_EQ(sender.start(TEST_CONTACT, oversized.c_str()), SMS_STATUS_FAILED);
+    CHECK_EQ(sender.start(TEST_CONTACT, "first"), SMS_STATUS_SENDING);
+    CHECK_EQ(sender.start(TEST_CONTACT, "second"), SMS_STATUS_FAILED);
+    CHECK_EQ(finish(sender, engine), SMS_STATUS_SENT);
+    CHECK_EQ(modem.count("AT+CMGS="), 1U);
+    CHECK_EQ(modem.last("AT+CMGS=")->body, "first");
+}
+
+/* Ctrl+Z or ESC in the body would end the submission early; they go out as spaces */
+TEST_CASE(replacesControlCharacters) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+
+    sender.start(TEST_CONTACT, "a\x1A" "b\x1B" "c");
+    CHECK_EQ(finish(sender, engine), SMS_STATUS_SENT);
+    CHECK_EQ(modem.last("AT+CMGS=")->body, "a b c");
+}
+
+/* A long or Unicode message goes out segment by segment in PDU mode, then text mode returns */
+TEST_CASE(sendsLongMessageInPduMode) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+
+    std::string text = "V\xE1\xBB\x8B tr\xC3\xAD: " + std::string(80U, 'x');
+    CHECK_EQ(sender.start(TEST_CONTACT, text.c_str()), SMS_STATUS_SENDING);
+    CHECK_EQ(sender.segmentCount(), 2U);
+    CHECK_EQ(finish(sender, engine), SMS_STATUS_SENT);
+    CHECK_EQ(sender.messageReference(), 1);
+
+    const std::vector<FakeModemCommand>& commands = modem.commands();
+    CHECK_EQ(commands.size(), 4U);
+    CHECK_EQ(commands[0].text, "AT+CMGF=0");
+    CHECK_EQ(commands[1].text.compare(0, 8, "AT+CMGS="), 0);
+    CHECK_EQ(commands[1].body.compare(0, 4, "0041"), 0);
+    CHECK_EQ(commands[2].body.compare(0, 4, "0041"), 0);
+    CHECK_EQ(commands[3].text, "AT+CMGF=1");
+    CHECK_EQ(modem.setting("+CMGF"), "1");
+}
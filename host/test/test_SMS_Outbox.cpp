@@ -0,0 +1,275 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "SMS_Outbox.h"
+#include <HostSim.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/* Recipients of the test messages */
+#define TEST_CONTACT_FIRST        "+84900000001"
+#define TEST_CONTACT_SECOND       "+84900000002"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Polls the outbox for ms of virtual time, sleeping stepMs between polls */
+static void runFor(SmsOutbox& outbox, uint32_t ms, uint32_t stepMs = 1U) {
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < ms) {
+        outbox.poll();
+        delay(stepMs);
+    }
+    outbox.poll();
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* enqueue() returns at once; the message goes out in the background and its latency is kept */
+TEST_CASE(sendsInBackground) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    CHECK_EQ(outbox.begin(), 0U);
+
+    uint32_t startMs = millis();
+    CHECK(outbox.enqueue(TEST_CONTACT_FIRST, "SOS test"));
+    CHECK_EQ(millis(), startMs);
+    CHECK_EQ(outbox.depth(), 1U);
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_FIRST), SMS_DELIVERY_PENDING);
+
+    runFor(outbox, 5000U);
+    CHECK_EQ(outbox.depth(), 0U);
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_FIRST), SMS_DELIVERY_SENT);
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_SECOND), SMS_DELIVERY_NONE);
+    CHECK_EQ(modem.last("AT+CMGS=")->body, "SOS test");
+
+    const SmsOutboxStats& stats = outbox.stats();
+    CHECK_EQ(stats.sent, 1U);
+    CHECK_EQ(stats.failedAttempts, 0U);
+    CHECK(stats.lastLatencyMs >= modem.timing().smsNetworkMs);
+    CHECK(stats.lastLatencyMs < modem.timing().smsNetworkMs + 100U);
+    CHECK_EQ(stats.maxLatencyMs, stats.lastLatencyMs);
+}
+
+/* Messages for a recipient that already has one waiting go out in the same submission */
+TEST_CASE(mergesMessagesForSameRecipient) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+
+    CHECK(outbox.enqueue(TEST_CONTACT_FIRST, "Fall detected"));
+    CHECK(outbox.enqueue(TEST_CONTACT_SECOND, "Fall detected"));
+    CHECK(outbox.enqueue(TEST_CONTACT_FIRST, "Location: 21.028511,105.804817"));
+    CHECK(outbox.enqueue(TEST_CONTACT_FIRST, "Fall detected"));
+    CHECK_EQ(outbox.depth(), 2U);
+    CHECK_EQ(outbox.stats().queued, 4U);
+    CHECK_EQ(outbox.stats().merged, 2U);
+
+    runFor(outbox, 10000U);
+    CHECK_EQ(outbox.depth(), 0U);
+    CHECK_EQ(modem.count("AT+CMGS="), 2U);
+    CHECK_EQ(modem.commands()[0].body, "Fall detected\nLocation: 21.028511,105.804817");
+    CHECK_EQ(modem.commands()[1].body, "Fall detected");
+}
+
+/* A failed submission is retried after a backoff that doubles with every attempt */
+TEST_CASE(retriesWithExponentialBackoff) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setSmsError(331);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+
+    outbox.enqueue(TEST_CONTACT_FIRST, "no network yet");
+    runFor(outbox, 3U * SMS_OUTBOX_BACKOFF_BASE_MS + 4U * modem.timing().smsNetworkMs, 10U);
+    CHECK_EQ(outbox.stats().failedAttempts, 3U);
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_FIRST), SMS_DELIVERY_PENDING);
+
+    std::vector<uint32_t> attemptsMs;
+    for (const FakeModemCommand& command : modem.commands()) {
+        attemptsMs.push_back(command.atMs);
+    }
+    CHECK_EQ(attemptsMs.size(), 3U);
+    uint32_t firstGapMs = attemptsMs[1] - attemptsMs[0];
+    uint32_t secondGapMs = attemptsMs[2] - attemptsMs[1];
+    CHECK(firstGapMs >= SMS_OUTBOX_BACKOFF_BASE_MS);
+    CHECK(firstGapMs < SMS_OUTBOX_BACKOFF_BASE_MS + modem.timing().smsNetworkMs + 100U);
+    CHECK(secondGapMs >= 2U * SMS_OUTBOX_BACKOFF_BASE_MS);
+    CHECK(secondGapMs < 2U * SMS_OUTBOX_BACKOFF_BASE_MS + modem.timing().smsNetworkMs + 100U);
+
+    modem.setSmsError(0);
+    runFor(outbox, 4U * SMS_OUTBOX_BACKOFF_BASE_MS + modem.timing().smsNetworkMs, 10U);
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_FIRST), SMS_DELIVERY_SENT);
+    CHECK_EQ(outbox.stats().sent, 1U);
+    CHECK(outbox.stats().lastLatencyMs >= 7U * SMS_OUTBOX_BACKOFF_BASE_MS);
+}
+
+/* After SMS_OUTBOX_MAX_ATTEMPTS failures the message is dropped and reported as such */
+TEST_CASE(dropsAfterMaxAttempts) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setSmsError(500);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+
+    outbox.enqueue(TEST_CONTACT_FIRST, "never accepted");
+    runFor(outbox, 30U * 60U * 1000U, 50U);
+    CHECK_EQ(modem.count("AT+CMGS="), SMS_OUTBOX_MAX_ATTEMPTS);
+    CHECK_EQ(outbox.depth(), 0U);
+    CHECK_EQ(outbox.stats().dropped, 1U);
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_FIRST), SMS_DELIVERY_DROPPED);
+    const std::vector<FakeModemCommand>& commands = modem.commands();
+    uint32_t lastGapMs = commands[commands.size() - 1U].atMs - commands[commands.size() - 2U].atMs;
+    CHECK(lastGapMs >= SMS_OUTBOX_BACKOFF_MAX_MS);
+    CHECK(lastGapMs < SMS_OUTBOX_BACKOFF_MAX_MS + modem.timing().smsNetworkMs + 200U);
+}
+
+/* Queued messages are in NVS, so a reboot before they were sent does not lose them */
+TEST_CASE(survivesReboot) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    {
+        SmsOutbox outbox(sender, engine);
+        outbox.begin();
+        outbox.enqueue(TEST_CONTACT_FIRST, "before reboot");
+        outbox.enqueue(TEST_CONTACT_SECOND, "before reboot");
+    }
+
+    SmsOutbox outbox(sender, engine);
+    CHECK_EQ(outbox.begin(), 2U);
+    CHECK_EQ(outbox.depth(), 2U);
+    runFor(outbox, 10000U);
+    CHECK_EQ(outbox.stats().sent, 2U);
+    CHECK_EQ(modem.count("AT+CMGS="), 2U);
+
+    SmsOutbox rebooted(sender, engine);
+    CHECK_EQ(rebooted.begin(), 0U);
+}
+
+/* A full outbox refuses new recipients and counts them as dropped */
+TEST_CASE(countsMessagesDroppedWhenFull) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+
+    char number[16];
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        snprintf(number, sizeof(number), "+8490000001%u", (unsigned)i);
+        CHECK(outbox.enqueue(number, "queued"));
+    }
+    CHECK(!outbox.enqueue(TEST_CONTACT_FIRST, "one too many"));
+    CHECK(!outbox.enqueue("", "no recipient"));
+    CHECK_EQ(outbox.depth(), SMS_OUTBOX_DEPTH);
+    CHECK_EQ(outbox.stats().highWater, SMS_OUTBOX_DEPTH);
+    CHECK_EQ(outbox.stats().dropped, 2U);
+}
+
+/* An alert takes the slot of the oldest waiting message and is sent before the older ones */
+TEST_CASE(urgentEvictsOldestAndGoesFirst) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+
+    char number[16];
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        snprintf(number, sizeof(number), "+8490000001%u", (unsigned)i);
+        CHECK(outbox.enqueue(number, "queued"));
+    }
+    CHECK(outbox.enqueueUrgent(TEST_CONTACT_FIRST, "SOS test"));
+    CHECK_EQ(outbox.depth(), SMS_OUTBOX_DEPTH);
+    CHECK_EQ(outbox.stats().dropped, 1U);
+    CHECK_EQ(outbox.delivery("+84900000010"), SMS_DELIVERY_DROPPED);
+    CHECK_EQ(outbox.delivery("+84900000011"), SMS_DELIVERY_PENDING);
+
+    runFor(outbox, 2U * modem.timing().smsNetworkMs);
+    CHECK(modem.count("AT+CMGS=") >= 1U);
+    CHECK_EQ(modem.commands()[0].body, "SOS test");
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_FIRST), SMS_DELIVERY_SENT);
+}
+
+/* Alerts are never evicted: an outbox full of them refuses one more */
+TEST_CASE(urgentRefusedWhenAllUrgent) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+
+    char number[16];
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        snprintf(number, sizeof(number), "+8490000001%u", (unsigned)i);
+        CHECK(outbox.enqueueUrgent(number, "SOS test"));
+    }
+    CHECK(!outbox.enqueueUrgent(TEST_CONTACT_FIRST, "SOS test"));
+    CHECK(!outbox.enqueue(TEST_CONTACT_SECOND, "queued"));
+    CHECK_EQ(outbox.depth(), SMS_OUTBOX_DEPTH);
+    CHECK_EQ(outbox.stats().dropped, 2U);
+    CHECK_EQ(outbox.delivery("+84900000010"), SMS_DELIVERY_PENDING);
+}
+
+/* A due alert goes ahead of older messages already due, and waits for none in backoff */
+TEST_CASE(urgentOvertakesDueMessages) {
+    hostNvsClear();
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+
+    CHECK(outbox.enqueue(TEST_CONTACT_SECOND, "Battery low"));
+    CHECK(outbox.enqueue(TEST_CONTACT_FIRST, "Battery low"));
+    /* Start the first submission, then queue the alert while it is in flight */
+    outbox.poll();
+    CHECK(outbox.enqueueUrgent(TEST_CONTACT_FIRST, "SOS test"));
+    CHECK_EQ(outbox.depth(), 3U);
+
+    runFor(outbox, 10000U);
+    CHECK_EQ(modem.count("AT+CMGS="), 3U);
+    CHECK_EQ(modem.commands()[0].body, "Battery low");
+    CHECK_EQ(modem.commands()[1].body, "SOS test");
+    CHECK_EQ(modem.commands()[2].body, "Battery low");
+}
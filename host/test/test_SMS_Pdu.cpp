@@ -0,0 +1,213 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "AT_Engine.h"
+#include "SMS_Commands.h"
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/* Emergency contact the received commands come from */
+#define TEST_CONTACT              "+84900000001"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Dispatcher fed by the engine of the modem test, as dispatchGsmLine() does on the device */
+static UrcDispatcher testDispatcher;
+static AtEngine* testEngine = NULL;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Encodes one segment of a message; false if the text or the index is refused */
+static bool encode(const char* number, const char* text, uint8_t index, SmsPdu& pdu,
+                   uint8_t concatReference = 0U) {
+    SmsPduEncoder encoder;
+    return encoder.begin(number, text, concatReference) && encoder.encodeSegment(index, pdu);
+}
+
+/* Decodes a PDU given as hex text */
+static bool decode(const char* hex, SmsDeliver& message) {
+    return smsPduDecodeDeliver(hex, strlen(hex), message);
+}
+
+/* Unsolicited handler: URC lines to testDispatcher, with the +CMT body routed after them */
+static void dispatchLine(const char* line, size_t length, void*) {
+    testDispatcher.dispatch(line, length);
+    if (testDispatcher.expectsBody()) {
+        testEngine->routeNextLineUnsolicited();
+    }
+}
+
+/* Polls the engine for ms of virtual time */
+static void runFor(AtEngine& engine, uint32_t ms) {
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < ms) {
+        engine.poll();
+        delay(1);
+    }
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* The reference SMS-SUBMIT for "hellohello" (GSM 03.40 examples), without validity period */
+TEST_CASE(encodesGsm7) {
+    SmsPdu pdu;
+    CHECK(encode("+46708251358", "hellohello", 0U, pdu));
+    CHECK_EQ(pdu.hex, "0001000B916407281553F800000AE8329BFD4697D9EC37");
+    CHECK_EQ(pdu.tpduLength, 22U);
+}
+
+/* National numbers, extension characters (two septets) and UCS-2 for anything outside GSM 7 */
+TEST_CASE(encodesAddressesAndAlphabets) {
+    SmsPdu pdu;
+    CHECK(encode("0900123", "OK", 0U, pdu));
+    CHECK_EQ(pdu.hex, "0001000781900021F3000002CF25");
+    CHECK(encode("+84900000001", "a\xE2\x82\xAC b", 0U, pdu));
+    CHECK_EQ(pdu.hex, "0001000B914809000000F1000005E14D192406");
+    CHECK(encode("+84900000001", "T\xE1\xBB\x9Bi", 0U, pdu));
+    CHECK_EQ(pdu.hex, "0001000B914809000000F100080600541EDB0069");
+    CHECK_EQ(pdu.tpduLength, 19U);
+
+    SmsPduEncoder encoder;
+    CHECK(encoder.begin("+84900000001", "hellohello", 0U));
+    CHECK(encoder.fitsTextMode());
+    CHECK(encoder.begin("+84900000001", "T\xE1\xBB\x9Bi", 0U));
+    CHECK_EQ(encoder.encoding(), SMS_ENCODING_UCS2);
+    CHECK(!encoder.fitsTextMode());
+    CHECK(!encoder.begin("+8490000000A", "hi", 0U));
+}
+
+/* 161 characters: two segments with the concatenation header and its fill bit */
+TEST_CASE(encodesConcatenatedSegments) {
+    std::string text(161U, 'a');
+    SmsPduEncoder encoder;
+    CHECK(encoder.begin("+84900000001", text.c_str(), 7U));
+    CHECK_EQ(encoder.segmentCount(), 2U);
+    CHECK(!encoder.fitsTextMode());
+
+    SmsPdu pdu;
+    CHECK(encoder.encodeSegment(0U, pdu));
+    std::string body;
+    for (uint8_t i = 0; i < 18U; i++) {
+        body += "C3E170381C0E87";
+    }
+    CHECK_EQ(pdu.hex, "0041000B914809000000F10000A0050003070201C2E170381C0E87" + body + "C3");
+    CHECK_EQ(pdu.tpduLength, 153U);
+    CHECK(encoder.encodeSegment(1U, pdu));
+    CHECK_EQ(pdu.hex, "0041000B914809000000F100000F050003070202C2E170381C0E8701");
+    CHECK_EQ(pdu.tpduLength, 27U);
+    CHECK(!encoder.encodeSegment(2U, pdu));
+}
+
+/* An escape pair never straddles two segments; UCS-2 splits at 67 characters */
+TEST_CASE(splitsSegmentsWhole) {
+    std::string text = std::string(152U, 'a') + "\xE2\x82\xAC" + std::string(8U, 'b');
+    SmsPdu pdu;
+    CHECK(encode("+84900000001", text.c_str(), 0U, pdu));
+    CHECK_EQ(std::string(pdu.hex).substr(26, 2), "9F");
+    CHECK(encode("+84900000001", text.c_str(), 1U, pdu));
+    CHECK_EQ(std::string(pdu.hex).substr(26, 2), "11");
+
+    std::string unicode;
+    for (uint8_t i = 0; i < SMS_UCS2_SINGLE_CHARS + 1U; i++) {
+        unicode += "\xE1\xBB\x9B";
+    }
+    SmsPduEncoder encoder;
+    CHECK(encoder.begin("+84900000001", unicode.c_str(), 0U));
+    CHECK_EQ(encoder.segmentCount(), 2U);
+    CHECK(encoder.encodeSegment(0U, pdu));
+    CHECK_EQ(pdu.tpduLength, 13U + 6U + 2U * SMS_UCS2_SEGMENT_CHARS);
+
+    std::string tooLong(SMS_PDU_MAX_SEGMENTS * SMS_GSM7_SEGMENT_SEPTETS + 1U, 'a');
+    CHECK(!encoder.begin("+84900000001", tooLong.c_str(), 0U));
+}
+
+/* GSM 7-bit from an international number, with an SMSC field */
+TEST_CASE(decodesGsm7) {
+    SmsDeliver message;
+    CHECK(decode("07911326040000F0040B911346610089F60000208062917314080CC8329BFD065DDF72363904",
+                 message));
+    CHECK_EQ(message.sender, "+31641600986");
+    CHECK_EQ(message.text, "Hello World!");
+    CHECK_EQ(message.textLength, 12U);
+}
+
+/* Escaped septets come from the extension table */
+TEST_CASE(decodesGsm7Extension) {
+    SmsDeliver message;
+    CHECK(decode("00040B914809000000F10000620161015100800" "5E14D192406", message));
+    CHECK_EQ(message.sender, "+84900000001");
+    CHECK_EQ(message.text, "a\xE2\x82\xAC b");
+}
+
+/* UCS-2 text is converted to UTF-8 */
+TEST_CASE(decodesUcs2) {
+    SmsDeliver message;
+    CHECK(decode("00040B914809000000F100086201610151008006" "00541EDB0069", message));
+    CHECK_EQ(message.text, "T\xE1\xBB\x9Bi");
+}
+
+/* The concatenation header and its fill bit are skipped */
+TEST_CASE(skipsUserDataHeader) {
+    SmsDeliver message;
+    CHECK(decode("00440B914809000000F100006201610151008009" "050003AA0201D069", message));
+    CHECK_EQ(message.text, "hi");
+}
+
+/* An alphanumeric sender is GSM 7-bit text */
+TEST_CASE(decodesAlphanumericSender) {
+    SmsDeliver message;
+    CHECK(decode("00040DD0D674994E2FB30100006201610151008002E834", message));
+    CHECK_EQ(message.sender, "Viettel");
+    CHECK_EQ(message.text, "hi");
+}
+
+/* Truncated data, odd hex and anything but an SMS-DELIVER are refused */
+TEST_CASE(rejectsMalformedPdu) {
+    SmsDeliver message;
+    CHECK(!decode("07911326040000F0040B911346610089F60000208062917314080CC8329BFD065DDF7236",
+                  message));
+    CHECK(!decode("00040B914809000000F10008620161015100800", message));
+    CHECK(!decode("00010B914809000000F1000862016101510080020041", message));
+    CHECK(!decode("00040B914809000000F100086201610151008002004G", message));
+}
+
+/* After a Unicode alert left the modem in PDU mode, a command from a contact still runs */
+TEST_CASE(interpreterReadsPduModeCommand) {
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    testEngine = &engine;
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT);
+    SmsCommandInterpreter interpreter(smsOutbox, contacts);
+    interpreter.begin(testDispatcher);
+
+    AtHandle handle = engine.submit("AT+CMGF=0", AT_TIMEOUT_CONFIG_MS);
+    CHECK_EQ(engine.waitFor(handle), AT_RESULT_OK);
+    engine.release(handle);
+    CHECK_EQ(modem.setting("+CMGF"), "0");
+
+    modem.injectSms(TEST_CONTACT, "where");
+    modem.injectSms("+84900000099", "where", 500U);
+    modem.injectSms(TEST_CONTACT, "V\xE1\xBB\x8B tr\xC3\xAD?", 1000U);
+    runFor(engine, 2000U);
+
+    const SmsCommandStats& stats = interpreter.stats();
+    CHECK_EQ(stats.received, 3U);
+    CHECK_EQ(stats.rejected, 1U);
+    CHECK_EQ(stats.unknown, 1U);
+    testEngine = NULL;
+}
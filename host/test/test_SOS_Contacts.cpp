@@ -0,0 +1,63 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "SOS_Contacts.h"
+#include "Generic_API.h"
+#include <Preferences.h>
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Erases the stored list, as on a new device */
+static void eraseContacts() {
+    Preferences store;
+    store.begin(SOS_CONTACTS_NAMESPACE);
+    store.clear();
+    store.end();
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Nothing stored: the compiled-in number is the only contact */
+TEST_CASE(fallsBackToCompiledNumber) {
+    eraseContacts();
+    EmergencyContacts contacts;
+    CHECK_EQ(contacts.begin(), 1U);
+    CHECK_EQ(contacts.number(0), SOS_PHONE_NUMBER);
+}
+
+/* Added contacts keep their order and survive a restart */
+TEST_CASE(addedContactsArePersisted) {
+    eraseContacts();
+    EmergencyContacts contacts;
+    contacts.begin();
+    CHECK(contacts.add("+84900000001"));
+    CHECK(contacts.add("0900000002"));
+    CHECK(!contacts.add("+84900000002"));
+    CHECK(!contacts.add("12ab"));
+
+    EmergencyContacts restarted;
+    CHECK_EQ(restarted.begin(), 3U);
+    CHECK_EQ(restarted.number(1), "+84900000001");
+    CHECK(restarted.contains("+84900000002"));
+}
+
+/* The list never becomes empty: the only contact cannot be removed */
+TEST_CASE(lastContactIsKept) {
+    eraseContacts();
+    EmergencyContacts contacts;
+    contacts.begin();
+    CHECK(contacts.add("+84900000001"));
+    CHECK(!contacts.remove(2));
+    CHECK(contacts.remove(0));
+    CHECK_EQ(contacts.count(), 1U);
+    CHECK_EQ(contacts.number(0), "+84900000001");
+    CHECK(!contacts.remove(0));
+    CHECK_EQ(contacts.count(), 1U);
+
+    EmergencyContacts restarted;
+    CHECK_EQ(restarted.begin(), 1U);
+    CHECK_EQ(restarted.number(0), "+84900000001");
+}
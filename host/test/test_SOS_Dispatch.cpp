@@ -0,0 +1,431 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "FakeModem.h"
+#include "SOS_Dispatch.h"
+#include <Preferences.h>
+
+/******************************************************************************
+ * MACROS
+ ******************************************************************************/
+/* UART the tests run the engine on (UART 1 belongs to gsmSerialPort) */
+#define TEST_UART                 2
+
+/* Emergency contacts of the alert */
+#define TEST_CONTACT_FIRST        "+84900000001"
+#define TEST_CONTACT_SECOND       "+84900000002"
+#define TEST_CONTACT_THIRD        "+84900000003"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Dispatcher fed by the engine, as dispatchGsmLine() does on the device */
+static UrcDispatcher testDispatcher;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Unsolicited handler: every line to testDispatcher */
+static void dispatchLine(const char* line, size_t length, void*) {
+    testDispatcher.dispatch(line, length);
+}
+
+/* Stores the contact list and an outbox holding the alert of the previous run */
+static void seedStorage(uint8_t attemptsLeft) {
+    Preferences store;
+    store.begin(SOS_CONTACTS_NAMESPACE);
+    store.clear();
+    store.end();
+    store.begin(SMS_OUTBOX_NAMESPACE);
+    store.clear();
+    if (attemptsLeft > 0U) {
+        SmsOutboxRecord record;
+        memset(&record, 0, sizeof(record));
+        record.attempts = (uint8_t)(SMS_OUTBOX_MAX_ATTEMPTS - attemptsLeft);
+        record.urgent = true;
+        strcpy(record.recipient, TEST_CONTACT_FIRST);
+        strcpy(record.text, "SOS test");
+        store.putBytes("m0", &record, sizeof(record));
+    }
+    store.end();
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* A contact whose SMS the outbox gives up is not reported as notified */
+TEST_CASE(droppedSmsIsNotNotified) {
+    seedStorage(1U);
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setFix(21.028511, 105.804817);
+    modem.setSmsError(500);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT_FIRST);
+    contacts.add(TEST_CONTACT_SECOND);
+    CHECK(contacts.remove(0));
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    CHECK_EQ(outbox.begin(), 1U);
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    AtHandle handle = engine.submit("AT+CLCC=1", AT_TIMEOUT_CONFIG_MS);
+    CHECK_EQ(engine.waitFor(handle), AT_RESULT_OK);
+    engine.release(handle);
+
+    /* The outbox starts draining once the alert text is queued, so the text joins the message
+       of the previous alert, which has one attempt left */
+    CHECK(dispatcher.start());
+    while (dispatcher.isActive()) {
+        engine.poll();
+        if (dispatcher.report().locationMs != 0U) {
+            outbox.poll();
+        }
+        dispatcher.poll();
+        /* The network recovers after the message carrying the alert to the first contact */
+        if (outbox.delivery(TEST_CONTACT_FIRST) == SMS_DELIVERY_DROPPED) {
+            modem.setSmsError(0);
+        }
+        delay(1);
+    }
+
+    const SosReport& report = dispatcher.report();
+    CHECK(!report.timedOut);
+    CHECK_EQ(report.callContact, 0);
+    CHECK(report.dropped[0]);
+    CHECK(!report.notified[0]);
+    CHECK(report.notified[1]);
+    CHECK(!report.dropped[1]);
+    CHECK_EQ(report.allNotifiedMs, 0U);
+    CHECK_EQ(outbox.delivery(TEST_CONTACT_SECOND), SMS_DELIVERY_SENT);
+    CHECK_EQ(outbox.stats().dropped, 1U);
+}
+
+/* Every contact notified: the alert reports when the last SMS was accepted */
+TEST_CASE(allContactsNotified) {
+    seedStorage(0U);
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setFix(21.028511, 105.804817);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT_FIRST);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    CHECK(dispatcher.start());
+    while (dispatcher.isActive()) {
+        engine.poll();
+        outbox.poll();
+        dispatcher.poll();
+        delay(1);
+    }
+
+    const SosReport& report = dispatcher.report();
+    CHECK(!report.timedOut);
+    CHECK(report.notified[0] && report.notified[1]);
+    CHECK(report.allNotifiedMs >= report.notifiedMs[0]);
+    CHECK(report.allNotifiedMs >= report.notifiedMs[1]);
+    CHECK_EQ(outbox.stats().sent, 2U);
+}
+
+/* An outbox full of other messages still takes the alert for every contact, and sends it first */
+TEST_CASE(fullOutboxStillNotifies) {
+    seedStorage(0U);
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setFix(21.028511, 105.804817);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT_FIRST);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+    char number[16];
+    for (uint8_t i = 0; i < SMS_OUTBOX_DEPTH; i++) {
+        snprintf(number, sizeof(number), "+8490000001%u", (unsigned)i);
+        CHECK(outbox.enqueue(number, "Battery low"));
+    }
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    /* The outbox is held back until the alert text is queued, so nothing has gone out yet */
+    CHECK(dispatcher.start());
+    while (dispatcher.isActive()) {
+        engine.poll();
+        if (dispatcher.report().locationMs != 0U) {
+            outbox.poll();
+        }
+        dispatcher.poll();
+        delay(1);
+    }
+
+    const SosReport& report = dispatcher.report();
+    CHECK(!report.timedOut);
+    CHECK(report.notified[0] && report.notified[1]);
+    CHECK_EQ(outbox.stats().dropped, 2U);
+    CHECK_EQ(outbox.delivery("+84900000010"), SMS_DELIVERY_DROPPED);
+    CHECK_EQ(outbox.delivery("+84900000011"), SMS_DELIVERY_DROPPED);
+    const FakeModemCommand* first = NULL;
+    for (const FakeModemCommand& command : modem.commands()) {
+        if (command.text.compare(0, 8, "AT+CMGS=") == 0) {
+            first = &command;
+            break;
+        }
+    }
+    CHECK(first != NULL && first->body != "Battery low");
+}
+
+/* Three contacts: one call to the first, the SMS to all of them back to back in list order */
+TEST_CASE(textsEveryContactBackToBack) {
+    seedStorage(0U);
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setFix(21.028511, 105.804817);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT_FIRST);
+    contacts.add(TEST_CONTACT_SECOND);
+    CHECK(contacts.remove(0));
+    contacts.add(TEST_CONTACT_THIRD);
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    CHECK(dispatcher.start());
+    while (dispatcher.isActive()) {
+        engine.poll();
+        outbox.poll();
+        dispatcher.poll();
+        delay(1);
+    }
+
+    const SosReport& report = dispatcher.report();
+    CHECK(!report.timedOut);
+    CHECK_EQ(report.callContact, 0);
+    CHECK_EQ(report.dialAttempts, 1U);
+    CHECK_EQ(modem.count("ATD"), 1U);
+    CHECK_EQ(modem.last("ATD")->text, "ATD" TEST_CONTACT_FIRST ";");
+
+    std::vector<const FakeModemCommand*> messages;
+    for (const FakeModemCommand& command : modem.commands()) {
+        if (command.text.compare(0, 8, "AT+CMGS=") == 0) {
+            messages.push_back(&command);
+        }
+    }
+    CHECK_EQ(messages.size(), 3U);
+    CHECK_EQ(messages[0]->text, "AT+CMGS=\"" TEST_CONTACT_FIRST "\"");
+    CHECK_EQ(messages[1]->text, "AT+CMGS=\"" TEST_CONTACT_SECOND "\"");
+    CHECK_EQ(messages[2]->text, "AT+CMGS=\"" TEST_CONTACT_THIRD "\"");
+    uint32_t submitMs = modem.timing().promptMs + modem.timing().smsNetworkMs;
+    for (size_t i = 1U; i < messages.size(); i++) {
+        CHECK(messages[i]->atMs - messages[i - 1U]->atMs < submitMs + 100U);
+    }
+
+    CHECK(report.notified[0] && report.notified[1] && report.notified[2]);
+    CHECK(report.allNotifiedMs >= report.locationMs + 3U * submitMs);
+    CHECK(report.allNotifiedMs < report.locationMs + 3U * (submitMs + 100U));
+}
+
+/* A contact who does not answer within the ring timeout is hung up on and the next one called */
+TEST_CASE(escalatesToNextContact) {
+    seedStorage(0U);
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setFix(21.028511, 105.804817);
+    modem.setCallOutcome(FAKE_CALL_NO_ANSWER);
+    modem.timing().ringMs = 60000U;
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT_FIRST);
+    contacts.add(TEST_CONTACT_SECOND);
+    CHECK(contacts.remove(0));
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    calls.setRingTimeout(10000U);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    CHECK(dispatcher.start());
+    while (dispatcher.isActive()) {
+        engine.poll();
+        outbox.poll();
+        dispatcher.poll();
+        /* The second contact picks up after a few rings */
+        if (modem.count("ATD") == 1U) {
+            modem.setCallOutcome(FAKE_CALL_ANSWERED);
+            modem.timing().ringMs = 3000U;
+        }
+        delay(1);
+    }
+
+    const SosReport& report = dispatcher.report();
+    CHECK_EQ(report.dialAttempts, 2U);
+    CHECK_EQ(report.callContact, 1);
+    CHECK_EQ(modem.count("ATH"), 1U);
+    CHECK_EQ(modem.last("ATD")->text, "ATD" TEST_CONTACT_SECOND ";");
+    CHECK(modem.last("ATD")->atMs >= report.triggeredAtMs + 10000U);
+    CHECK(report.callAnsweredMs >= 10000U + modem.timing().alertingMs);
+    CHECK_EQ(calls.stats().noAnswer, 1U);
+    CHECK_EQ(calls.stats().answered, 1U);
+}
+
+/* With a cached location the alert text goes out at once, and the first fresh fix after the
+   trigger is sent as a follow-up */
+TEST_CASE(sendsCachedLocationThenFollowUp) {
+    seedStorage(0U);
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT_FIRST);
+    CHECK(contacts.remove(0));
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    const char* earlier = "+CGPSINFO: 2102.803320,N,10547.113320,E,161026,101500.0,15.2,0.0,";
+    CHECK_EQ(parser.feedLine(earlier, strlen(earlier)), 1U);
+    CHECK(cache.update(parser.fix()));
+    delay(600000);
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    /* Indoors: no fix until the user walks out, 20 s into the alert */
+    CHECK(dispatcher.start());
+    hostAfterMs(20000U, [&modem]() { modem.setFix(21.028511, 105.804817); });
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < 60000U) {
+        engine.poll();
+        outbox.poll();
+        gnss.poll();
+        dispatcher.poll();
+        delay(1);
+    }
+
+    const SosReport& report = dispatcher.report();
+    CHECK(report.locationCached);
+    CHECK(!report.locationFixed);
+    CHECK(report.locationMs < 5U);
+    CHECK(report.followUpMs >= 20000U);
+    CHECK(report.followUpMs < 20000U + GNSS_POLL_ACQUIRE_MS + 500U);
+
+    std::vector<const FakeModemCommand*> messages;
+    for (const FakeModemCommand& command : modem.commands()) {
+        if (command.text.compare(0, 8, "AT+CMGS=") == 0) {
+            messages.push_back(&command);
+        }
+    }
+    CHECK_EQ(messages.size(), 2U);
+    CHECK_EQ(messages[0]->body, "SOS! Last known location (10 min old): "
+                                "https://www.google.com/maps?q=21.046722,105.785222");
+    CHECK_EQ(messages[1]->body, "SOS update, my location now: "
+                                "https://www.google.com/maps?q=21.028511,105.804817");
+}
+
+/* A fresh fix that confirms a recent cached location is not followed up */
+TEST_CASE(skipsFollowUpConfirmingRecentCache) {
+    seedStorage(0U);
+    HardwareSerial port(TEST_UART);
+    port.begin(115200);
+    FakeModem modem(port);
+    modem.setFix(21.028551, 105.804817);
+    AtEngine engine(port);
+    engine.setUnsolicitedHandler(dispatchLine, NULL);
+
+    EmergencyContacts contacts;
+    contacts.begin();
+    contacts.add(TEST_CONTACT_FIRST);
+    CHECK(contacts.remove(0));
+    SmsSender sender(engine);
+    SmsOutbox outbox(sender, engine);
+    outbox.begin();
+    CallTracker calls(engine);
+    calls.begin(testDispatcher);
+    GnssParser parser;
+    GnssPoller gnss(engine, parser);
+    LocationCache cache;
+    GnssFix recent;
+    memset(&recent, 0, sizeof(recent));
+    recent.valid = true;
+    recent.position.latitudeE6 = 21028511;
+    recent.position.longitudeE6 = 105804817;
+    recent.updatedMs = millis();
+    CHECK(cache.update(recent));
+    delay(30000);
+    SosDispatcher dispatcher(engine, calls, outbox, contacts, gnss, cache);
+
+    CHECK(dispatcher.start());
+    uint32_t startMs = millis();
+    while ((uint32_t)(millis() - startMs) < 30000U) {
+        engine.poll();
+        outbox.poll();
+        gnss.poll();
+        dispatcher.poll();
+        delay(1);
+    }
+
+    const SosReport& report = dispatcher.report();
+    CHECK(report.locationCached);
+    CHECK(report.locationMs < 5U);
+    CHECK_EQ(report.followUpMs, 0U);
+    CHECK_EQ(modem.count("AT+CMGS="), 1U);
+    CHECK_EQ(modem.last("AT+CMGS=")->body, "SOS! Last known location (30 s old): "
+                                           "https://www.google.com/maps?q=21.028511,105.804817");
+}
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "TASK_Scheduler.h"
+#include <HostSim.h>
+
+/******************************************************************************
+ * TYPES
+ ******************************************************************************/
+/* What a test tasklet saw */
+typedef struct {
+    std::vector<uint32_t> runsAtMs;   /* millis() of every run */
+    uint32_t busyMs;                  /* Time each run takes */
+    uint32_t rescheduleMs;            /* runIn() delay asked at every run, 0 for none */
+    TaskletScheduler* scheduler;
+    TaskletId id;
+} TestTasklet;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+static void runTestTasklet(void* context) {
+    TestTasklet* tasklet = static_cast<TestTasklet*>(context);
+    tasklet->runsAtMs.push_back(millis());
+    if (tasklet->busyMs > 0U) {
+        delay(tasklet->busyMs);
+    }
+    if (tasklet->rescheduleMs > 0U) {
+        tasklet->scheduler->runIn(tasklet->id, tasklet->rescheduleMs);
+    }
+}
+
+/* Adds a test tasklet */
+static TaskletId addTasklet(TaskletScheduler& scheduler, TestTasklet& tasklet, uint32_t periodMs,
+                            uint32_t deadlineMs) {
+    tasklet.busyMs = 0U;
+    tasklet.rescheduleMs = 0U;
+    tasklet.scheduler = &scheduler;
+    tasklet.id = scheduler.add("test", runTestTasklet, &tasklet, periodMs, deadlineMs);
+    return tasklet.id;
+}
+
+/* Calls runOnce() until ms of virtual time have passed; returns the number of calls */
+static uint32_t runFor(TaskletScheduler& scheduler, uint32_t ms) {
+    uint32_t startMs = millis();
+    uint32_t calls = 0U;
+    while ((uint32_t)(millis() - startMs) < ms) {
+        scheduler.runOnce();
+        calls++;
+    }
+    return calls;
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Periodic tasklets run at their own rate, and the loop sleeps exactly until the next one */
+TEST_CASE(runsPeriodicTaskletsOnTime) {
+    TaskletScheduler scheduler;
+    scheduler.begin();
+    TestTasklet fast;
+    TestTasklet slow;
+    addTasklet(scheduler, fast, 100U, 10U);
+    addTasklet(scheduler, slow, 250U, 10U);
+
+    uint32_t startMs = millis();
+    uint32_t calls = runFor(scheduler, 1000U);
+    CHECK_EQ(fast.runsAtMs.size(), 10U);
+    CHECK_EQ(slow.runsAtMs.size(), 4U);
+    CHECK_EQ(fast.runsAtMs[3] - startMs, 300U);
+    CHECK_EQ(slow.runsAtMs[3] - startMs, 750U);
+    CHECK_EQ(calls, 12U);
+    CHECK_EQ(scheduler.stats(fast.id)->maxLateMs, 0U);
+    CHECK_EQ(scheduler.stats(slow.id)->deadlineMisses, 0U);
+    CHECK_EQ(scheduler.runDue(), 100U);
+    CHECK_EQ(fast.runsAtMs.size(), 11U);
+}
+
+/* A trigger from an interrupt ends the sleep at once */
+TEST_CASE(triggerWakesImmediately) {
+    TaskletScheduler scheduler;
+    scheduler.begin();
+    TestTasklet button;
+    TaskletId id = addTasklet(scheduler, button, 0U, 10U);
+
+    uint32_t startMs = millis();
+    hostAfterMs(37U, [&scheduler, id]() { scheduler.trigger(id); });
+    hostAfterMs(512U, [&scheduler, id]() { scheduler.trigger(id); });
+    runFor(scheduler, 600U);
+    CHECK_EQ(button.runsAtMs.size(), 2U);
+    CHECK_EQ(button.runsAtMs[0] - startMs, 37U);
+    CHECK_EQ(button.runsAtMs[1] - startMs, 512U);
+    CHECK_EQ(scheduler.stats(id)->maxLateMs, 0U);
+}
+
+/* runIn() moves a tasklet to the time it asks for */
+TEST_CASE(runInReschedules) {
+    TaskletScheduler scheduler;
+    scheduler.begin();
+    TestTasklet poller;
+    addTasklet(scheduler, poller, 0U, 10U);
+    poller.rescheduleMs = 70U;
+    scheduler.runIn(poller.id, 0U);
+
+    uint32_t startMs = millis();
+    runFor(scheduler, 300U);
+    CHECK_EQ(poller.runsAtMs.size(), 5U);
+    CHECK_EQ(poller.runsAtMs[4] - startMs, 280U);
+    CHECK_EQ(runFor(scheduler, 0U), 0U);
+}
+
+/* A tasklet that blocks makes the others late; lateness, run time and misses are recorded */
+TEST_CASE(recordsLatenessAndRunTime) {
+    TaskletScheduler scheduler;
+    scheduler.begin();
+    TestTasklet blocking;
+    TestTasklet urgent;
+    addTasklet(scheduler, blocking, 200U, 50U);
+    addTasklet(scheduler, urgent, 10U, 5U);
+    blocking.busyMs = 30U;
+
+    runFor(scheduler, 1000U);
+    const TaskletStats* blockingStats = scheduler.stats(blocking.id);
+    const TaskletStats* urgentStats = scheduler.stats(urgent.id);
+    CHECK_EQ(blockingStats->runs, 5U);
+    CHECK_EQ(blockingStats->maxRunUs, 30000U);
+    CHECK_EQ(blockingStats->totalRunUs, 5U * 30000U);
+    CHECK_EQ(blockingStats->deadlineMisses, 0U);
+    CHECK_EQ(urgentStats->maxLateMs, 30U);
+    CHECK_EQ(urgentStats->deadlineMisses, 5U);
+    CHECK(urgentStats->runs < 100U);
+
+    scheduler.resetStats();
+    CHECK_EQ(scheduler.stats(urgent.id)->runs, 0U);
+    CHECK(scheduler.stats(TASKLET_MAX_COUNT) == NULL);
+}
+
+/* Run time keeps adding up past the 2^32 us (about 71 minutes) a 32-bit counter holds */
+TEST_CASE(runTimeOutlastsSeventyOneMinutes) {
+    TaskletScheduler scheduler;
+    scheduler.begin();
+    TestTasklet blocking;
+    addTasklet(scheduler, blocking, 60000U, 60000U);
+    blocking.busyMs = 59000U;
+
+    runFor(scheduler, 75U * 60000U);
+    const TaskletStats* stats = scheduler.stats(blocking.id);
+    CHECK_EQ(stats->runs, 75U);
+    CHECK_EQ(stats->totalRunUs, 75ULL * 59000000ULL);
+
+    hostCaptureConsole(true);
+    scheduler.printStats(Serial);
+    std::string output = hostTakeConsole();
+    hostCaptureConsole(false);
+    CHECK(output.find("run avg 59000000") != std::string::npos);
+    CHECK(output.find("loop busy 98.3%") != std::string::npos);
+}
+
+/* The table is fixed: a tasklet beyond TASKLET_MAX_COUNT is refused */
+TEST_CASE(refusesTaskletsBeyondTable) {
+    TaskletScheduler scheduler;
+    TestTasklet tasklets[TASKLET_MAX_COUNT + 1U];
+    for (uint8_t i = 0; i < TASKLET_MAX_COUNT; i++) {
+        CHECK_EQ(addTasklet(scheduler, tasklets[i], 100U, 10U), i);
+    }
+    CHECK_EQ(addTasklet(scheduler, tasklets[TASKLET_MAX_COUNT], 100U, 10U), TASKLET_INVALID_ID);
+    CHECK_EQ(scheduler.add("null", NULL, NULL, 100U, 10U), TASKLET_INVALID_ID);
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "UART_Framer.h"
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Feeds text to the framer */
+static void feedText(LineFramer& framer, const char* text) {
+    framer.feed((const uint8_t*)text, (uint16_t)strlen(text));
+}
+
+/* Next framed line as text, or "(none)" */
+static std::string nextText(LineFramer& framer) {
+    LineView line;
+    return framer.nextLine(line) ? std::string(line.data, line.length) : std::string("(none)");
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Indices wrap around the capacity; bytes that do not fit are counted, not stored */
+TEST_CASE(ringWrapsAndCountsDrops) {
+    RingBuffer<8> ring;
+    const uint8_t data[] = { 1, 2, 3, 4, 5, 6 };
+    uint8_t value = 0U;
+    for (uint16_t round = 0; round < 20000U; round++) {
+        CHECK_EQ(ring.write(data, 6U), 6U);
+        for (uint8_t i = 0; i < 6U; i++) {
+            ring.pop(value);
+        }
+    }
+    CHECK_EQ(value, 6U);
+    CHECK_EQ(ring.write(data, 6U), 6U);
+    CHECK_EQ(ring.write(data, 6U), 2U);
+    CHECK_EQ(ring.size(), 8U);
+    CHECK_EQ(ring.droppedBytes(), 4U);
+    CHECK(ring.pop(value));
+    CHECK_EQ(value, 1U);
+    ring.clear();
+    CHECK(!ring.pop(value));
+}
+
+/* CR/LF framing skips empty lines and leading blanks; a line may arrive in pieces */
+TEST_CASE(framesLines) {
+    LineFramer framer;
+    feedText(framer, "\r\nOK\r\n\r\n  +CSQ: 21,99\r\n+CM");
+    CHECK_EQ(nextText(framer), "OK");
+    CHECK_EQ(nextText(framer), "+CSQ: 21,99");
+    CHECK_EQ(nextText(framer), "(none)");
+    feedText(framer, "TI: \"SM\",3\r\n");
+    CHECK_EQ(nextText(framer), "+CMTI: \"SM\",3");
+    CHECK_EQ(framer.linesFramed(), 3U);
+    CHECK_EQ(framer.bytesReceived(), 38U);
+}
+
+/* The unterminated "> " prompt is its own line */
+TEST_CASE(reportsPrompt) {
+    LineFramer framer;
+    feedText(framer, "\r\n> ");
+    LineView line;
+    CHECK(framer.nextLine(line));
+    CHECK(line.isPrompt);
+    CHECK_EQ(line.data, ">");
+    feedText(framer, "\r\n+CMGS: 12\r\n");
+    CHECK(framer.nextLine(line));
+    CHECK(!line.isPrompt);
+    CHECK_EQ(line.data, "+CMGS: 12");
+}
+
+/* Overlong lines are cut at UART_LINE_MAX_LEN and counted */
+TEST_CASE(truncatesLongLines) {
+    LineFramer framer;
+    std::string longLine(UART_LINE_MAX_LEN + 40U, 'A');
+    feedText(framer, (longLine + "\r\nOK\r\n").c_str());
+    LineView line;
+    CHECK(framer.nextLine(line));
+    CHECK_EQ(line.length, UART_LINE_MAX_LEN);
+    CHECK_EQ(framer.truncatedLines(), 1U);
+    CHECK_EQ(nextText(framer), "OK");
+}
+
+/* reset() drops the partial line as well as the buffered bytes */
+TEST_CASE(resetDiscardsPartialLine) {
+    LineFramer framer;
+    feedText(framer, "garbage\xFF\xFE");
+    CHECK_EQ(nextText(framer), "(none)");
+    feedText(framer, "more");
+    framer.reset();
+    feedText(framer, "OK\r\n");
+    CHECK_EQ(nextText(framer), "OK");
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "TestCheck.h"
+#include "URC_Dispatcher.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* What the last handler call saw */
+static UrcType seenType = URC_COUNT;
+static std::vector<std::string> seenFields;
+static std::string seenBody;
+static unsigned seenCalls = 0U;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/* Records the event; the pointers are only valid during the call */
+static void recordEvent(const UrcEvent& event, void* context) {
+    (void)context;
+    seenType = event.type;
+    seenFields.clear();
+    for (uint8_t i = 0; i < event.fieldCount; i++) {
+        seenFields.push_back(std::string(event.fields[i].data, event.fields[i].length));
+    }
+    seenBody = (event.body != NULL) ? std::string(event.body, event.bodyLength) : "(none)";
+    seenCalls++;
+}
+
+/* Dispatcher with recordEvent() registered for every URC type */
+static void registerAll(UrcDispatcher& dispatcher) {
+    for (int type = 0; type < URC_COUNT; type++) {
+        dispatcher.registerHandler((UrcType)type, recordEvent, NULL);
+    }
+    seenCalls = 0U;
+}
+
+/* Dispatches a NUL-terminated line */
+static bool dispatchText(UrcDispatcher& dispatcher, const char* line) {
+    return dispatcher.dispatch(line, strlen(line));
+}
+
+/******************************************************************************
+ * TEST CASES
+ ******************************************************************************/
+/* Every known URC reaches the handler of its type */
+TEST_CASE(recognisesEveryType) {
+    static const struct {
+        const char* line;
+        UrcType     type;
+    } CASES[] = {
+        { "RING", URC_RING },
+        { "+CLIP: \"+84900000001\",145,\"\",0,\"\",0", URC_CLIP },
+        { "+CMTI: \"SM\",3", URC_CMTI },
+        { "+CSQ: 20,99", URC_CSQ },
+        { "+CLCC: 1,0,3,0,0,\"+84900000001\",145", URC_CLCC },
+        { "NO CARRIER", URC_NO_CARRIER },
+        { "BUSY", URC_BUSY },
+        { "NO ANSWER", URC_NO_ANSWER },
+        { "+CPIN: READY", URC_CPIN },
+        { "+CGPSINFO: 2101.710660,N,10548.289020,E,161026,101500.0,12.3,0.0,0.0", URC_CGPSINFO },
+        { "+CGNSINF: 1,1,20261016101500.000,21.028511,105.804817", URC_CGNSINF }
+    };
+    UrcDispatcher dispatcher;
+    registerAll(dispatcher);
+    for (const auto& test : CASES) {
+        seenType = URC_COUNT;
+        CHECK(dispatchText(dispatcher, test.line));
+        CHECK_EQ(seenType, test.type);
+    }
+    CHECK_EQ(seenCalls, sizeof(CASES) / sizeof(CASES[0]));
+    CHECK_EQ(dispatcher.dispatchedCount(), sizeof(CASES) / sizeof(CASES[0]));
+}
+
+/* Fields are split at commas with blanks and quotes removed */
+TEST_CASE(decodesFields) {
+    UrcDispatcher dispatcher;
+    registerAll(dispatcher);
+    CHECK(dispatchText(dispatcher, "+CLIP: \"+84900000001\", 145,,\"Mom, home\""));
+    CHECK_EQ(seenFields.size(), 4U);
+    CHECK_EQ(seenFields[0], "+84900000001");
+    CHECK_EQ(seenFields[1], "145");
+    CHECK_EQ(seenFields[2], "");
+    CHECK_EQ(seenFields[3], "Mom, home");
+
+    UrcField fields[URC_MAX_FIELDS];
+    const char* response = "+CSQ: 17,99";
+    CHECK_EQ(UrcDispatcher::decodeFields(response, strlen(response), fields, URC_MAX_FIELDS), 2U);
+    CHECK_EQ(UrcDispatcher::fieldToInt(fields[0], -1), 17);
+    UrcField empty = { "", 0U };
+    CHECK_EQ(UrcDispatcher::fieldToInt(empty, -1), -1);
+    char buffer[4];
+    UrcDispatcher::fieldToString(fields[0], buffer, sizeof(buffer));
+    CHECK_EQ(buffer, "17");
+    UrcField number = { "+84900000001", 12U };
+    UrcDispatcher::fieldToString(number, buffer, sizeof(buffer));
+    CHECK_EQ(buffer, "+84");
+}
+
+/* +CMT is held until its body line, which is delivered with it */
+TEST_CASE(joinsCmtWithBody) {
+    UrcDispatcher dispatcher;
+    registerAll(dispatcher);
+    CHECK(dispatchText(dispatcher, "+CMT: \"+84900000001\",\"\",\"26/10/16,10:15:00+28\""));
+    CHECK_EQ(seenCalls, 0U);
+    CHECK(dispatcher.expectsBody());
+    CHECK(dispatchText(dispatcher, "OK"));
+    CHECK(!dispatcher.expectsBody());
+    CHECK_EQ(seenCalls, 1U);
+    CHECK_EQ(seenType, URC_CMT);
+    CHECK_EQ(seenFields[0], "+84900000001");
+    CHECK_EQ(seenBody, "OK");
+}
+
+/* Responses and unknown lines are ignored; unregistered types are recognised but not handled */
+TEST_CASE(ignoresOtherLines) {
+    UrcDispatcher dispatcher;
+    registerAll(dispatcher);
+    CHECK(!dispatchText(dispatcher, "OK"));
+    CHECK(!dispatchText(dispatcher, "+CSQX: 1"));
+    CHECK(!dispatchText(dispatcher, "RINGING"));
+    CHECK(!dispatchText(dispatcher, ""));
+    CHECK_EQ(seenCalls, 0U);
+    CHECK_EQ(dispatcher.ignoredCount(), 4U);
+
+    CHECK(dispatcher.registerHandler(URC_RING, NULL, NULL));
+    CHECK(!dispatcher.registerHandler(URC_COUNT, recordEvent, NULL));
+    dispatchText(dispatcher, "RING");
+    CHECK_EQ(seenCalls, 0U);
+}